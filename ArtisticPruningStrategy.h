@@ -2,7 +2,7 @@
 #define ARTISTIC_PRUNING_STRATEGY_H
 
 #include "CareStrategy.h"
-#include <iostream>
+#include "Logger.h"
 
 class ArtisticPruningStrategy : public CareStrategy
 {
@@ -11,11 +11,11 @@ public:
     {
         if (careType == "prune_artistic")
         {
-            std::cout << "Pruning artistically based on style with " << amount << " cuts." << std::endl;
+            GH_LOG_DEBUG(Logger::CARE, "Pruning artistically based on style with " << amount << " cuts.");
         }
         else
         {
-            std::cout << "ArtisticPruningStrategy does not handle care type: " << careType << std::endl;
+            GH_LOG_WARN(Logger::CARE, "ArtisticPruningStrategy does not handle care type: " << careType);
         }
     }
     std::string getName() const override { return "Artistic Pruning"; }
@@ -0,0 +1,551 @@
+#include "AsyncPaymentProcessor.h"
+#include "IdGenerator.h"
+#include "Logger.h"
+#include "PaymentLedger.h"
+#include "SettlementEngine.h"
+
+#include <algorithm>
+
+namespace
+{
+    std::chrono::steady_clock::duration fromMillis(double millis)
+    {
+        return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>(millis));
+    }
+}
+
+AsyncPaymentProcessor::Config::Config()
+    : maxInFlight(32), maxQueued(1024), attemptTimeoutMillis(2000.0), maxAttempts(3), retryBaseMillis(100.0),
+      retryMaxMillis(2000.0), breakerFailureThreshold(5), breakerOpenMillis(5000.0), method("GATEWAY")
+{
+}
+
+AsyncPaymentProcessor::Stats::Stats()
+    : submitted(0), approved(0), declined(0), failed(0), rejected(0), attempts(0), retries(0), timeouts(0),
+      lateAnswers(0), lateApprovals(0), unmatchedApprovals(0), peakInFlight(0), totalMillis(0.0)
+{
+}
+
+AsyncPaymentProcessor::AsyncPaymentProcessor(PaymentGateway *gateway, const Config &config)
+    : gateway(gateway), config(config), liveness(std::make_shared<Liveness>()), stopping(false), inFlight(0),
+      nextAttempt(0), rng(std::random_device{}()), breaker(CLOSED), consecutiveFailures(0), probeAtGateway(false)
+{
+    liveness->alive = true;
+    if (this->config.maxInFlight == 0)
+    {
+        this->config.maxInFlight = 1;
+    }
+    if (this->config.maxAttempts < 1)
+    {
+        this->config.maxAttempts = 1;
+    }
+    scheduler = std::thread(&AsyncPaymentProcessor::runScheduler, this);
+}
+
+AsyncPaymentProcessor::~AsyncPaymentProcessor()
+{
+    shutdown();
+    std::lock_guard<std::recursive_mutex> lock(liveness->mutex);
+    liveness->alive = false;
+}
+
+const char *AsyncPaymentProcessor::getStatusName(PaymentResult::Status status)
+{
+    switch (status)
+    {
+    case PaymentResult::APPROVED:
+        return "Approved";
+    case PaymentResult::DECLINED:
+        return "Declined";
+    case PaymentResult::TIMED_OUT:
+        return "Timed Out";
+    case PaymentResult::GATEWAY_UNAVAILABLE:
+        return "Gateway Unavailable";
+    case PaymentResult::CIRCUIT_OPEN:
+        return "Circuit Open";
+    case PaymentResult::REJECTED:
+        return "Rejected";
+    default:
+        return "Unknown";
+    }
+}
+
+std::future<PaymentResult> AsyncPaymentProcessor::submit(const PaymentRequest &request)
+{
+    Payment *payment = new Payment();
+    payment->request = request;
+    payment->promise.reset(new std::promise<PaymentResult>());
+    std::future<PaymentResult> result = payment->promise->get_future();
+    enqueue(payment, false);
+    return result;
+}
+
+void AsyncPaymentProcessor::submit(const PaymentRequest &request, const Callback &done)
+{
+    Payment *payment = new Payment();
+    payment->request = request;
+    payment->callback = done;
+    enqueue(payment, false);
+}
+
+bool AsyncPaymentProcessor::processPayment(double amount, const std::string &customerId, const std::string &payload)
+{
+    PaymentRequest request;
+    request.amount = amount;
+    request.customerId = customerId;
+    request.payload = payload;
+    return processRequest(request);
+}
+
+bool AsyncPaymentProcessor::processRequest(const PaymentRequest &request)
+{
+    return submit(request).get().status == PaymentResult::APPROVED;
+}
+
+std::vector<bool> AsyncPaymentProcessor::processPayments(const std::vector<PaymentRequest> &requests)
+{
+    // Everything goes in first (waiting for queue space rather than being rejected), then is collected
+    std::vector<std::future<PaymentResult> > pending;
+    pending.reserve(requests.size());
+    for (const PaymentRequest &request : requests)
+    {
+        Payment *payment = new Payment();
+        payment->request = request;
+        payment->promise.reset(new std::promise<PaymentResult>());
+        pending.push_back(payment->promise->get_future());
+        enqueue(payment, true);
+    }
+    std::vector<bool> results;
+    results.reserve(pending.size());
+    for (std::future<PaymentResult> &result : pending)
+    {
+        results.push_back(result.get().status == PaymentResult::APPROVED);
+    }
+    return results;
+}
+
+void AsyncPaymentProcessor::enqueue(Payment *payment, bool waitForSpace)
+{
+    std::uint64_t paymentId = IdGenerator::getInstance().next();
+    payment->idempotencyKey = IdGenerator::format("PAY-", paymentId);
+    payment->submitted = Clock::now();
+    payment->attempts = 0;
+    payment->unanswered = 0;
+    payment->attempt = 0;
+    payment->atGateway = false;
+    payment->probe = false;
+    payment->lastFailure = PaymentResult::REJECTED;
+
+    Actions actions;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ++stats.submitted;
+        if (waitForSpace)
+        {
+            queueSpace.wait(lock, [this]() { return stopping || queued.size() < config.maxQueued; });
+        }
+        payments[paymentId] = payment;
+        if (stopping || queued.size() >= config.maxQueued)
+        {
+            finishLocked(paymentId, payment, PaymentResult::REJECTED, std::string(), actions);
+        }
+        else
+        {
+            queued.push_back(paymentId);
+            dispatchLocked(actions);
+        }
+    }
+    perform(actions);
+}
+
+void AsyncPaymentProcessor::dispatchLocked(Actions &actions)
+{
+    bool dequeued = false;
+    while (inFlight < config.maxInFlight && !queued.empty())
+    {
+        std::uint64_t paymentId = queued.front();
+        queued.pop_front();
+        dequeued = true;
+        startAttemptLocked(paymentId, payments[paymentId], actions);
+    }
+    if (dequeued)
+    {
+        queueSpace.notify_all();
+    }
+}
+
+void AsyncPaymentProcessor::startAttemptLocked(std::uint64_t paymentId, Payment *payment, Actions &actions)
+{
+    Clock::time_point now = Clock::now();
+    if (breaker == OPEN && now - breakerOpenedAt >= fromMillis(config.breakerOpenMillis))
+    {
+        breaker = HALF_OPEN;
+    }
+    if (breaker == OPEN || (breaker == HALF_OPEN && probeAtGateway))
+    {
+        finishLocked(paymentId, payment, PaymentResult::CIRCUIT_OPEN, std::string(), actions);
+        return;
+    }
+    payment->probe = breaker == HALF_OPEN;
+    if (payment->probe)
+    {
+        probeAtGateway = true;
+    }
+
+    payment->attempt = ++nextAttempt;
+    payment->atGateway = true;
+    ++payment->attempts;
+    ++stats.attempts;
+    ++inFlight;
+    stats.peakInFlight = std::max(stats.peakInFlight, inFlight);
+
+    Timer timeout;
+    timeout.retry = false;
+    timeout.paymentId = paymentId;
+    timeout.attempt = payment->attempt;
+    timers.insert(std::make_pair(now + fromMillis(config.attemptTimeoutMillis), timeout));
+    wakeScheduler.notify_one();
+
+    Launch launch;
+    launch.paymentId = paymentId;
+    launch.attempt = payment->attempt;
+    launch.idempotencyKey = payment->idempotencyKey;
+    launch.request = payment->request;
+    actions.launches.push_back(launch);
+}
+
+void AsyncPaymentProcessor::attemptFailedLocked(std::uint64_t paymentId, Payment *payment,
+                                                PaymentResult::Status reason, Actions &actions)
+{
+    payment->lastFailure = reason;
+    ++consecutiveFailures;
+    if (payment->probe || (breaker == CLOSED && consecutiveFailures >= config.breakerFailureThreshold))
+    {
+        breaker = OPEN;
+        breakerOpenedAt = Clock::now();
+    }
+    if (payment->probe)
+    {
+        probeAtGateway = false;
+    }
+
+    if (stopping || payment->attempts >= config.maxAttempts)
+    {
+        finishLocked(paymentId, payment, reason, std::string(), actions);
+        return;
+    }
+    // Full jitter: anywhere between no delay and the exponential backoff for this retry
+    double backoff = config.retryBaseMillis * (1 << std::min(payment->attempts - 1, 20));
+    double ceiling = std::min(config.retryMaxMillis, backoff);
+    double delay = std::uniform_real_distribution<double>(0.0, std::max(ceiling, 0.0))(rng);
+    ++stats.retries;
+
+    Timer retry;
+    retry.retry = true;
+    retry.paymentId = paymentId;
+    retry.attempt = payment->attempt;
+    timers.insert(std::make_pair(Clock::now() + fromMillis(delay), retry));
+    wakeScheduler.notify_one();
+}
+
+void AsyncPaymentProcessor::finishLocked(std::uint64_t paymentId, Payment *payment, PaymentResult::Status status,
+                                         const std::string &reference, Actions &actions)
+{
+    PaymentResult result;
+    result.status = status;
+    result.reference = reference;
+    result.attempts = payment->attempts;
+    result.elapsedMillis = std::chrono::duration<double, std::milli>(Clock::now() - payment->submitted).count();
+
+    switch (status)
+    {
+    case PaymentResult::APPROVED:
+        ++stats.approved;
+        break;
+    case PaymentResult::DECLINED:
+        ++stats.declined;
+        break;
+    case PaymentResult::TIMED_OUT:
+    case PaymentResult::GATEWAY_UNAVAILABLE:
+        ++stats.failed;
+        break;
+    default:
+        ++stats.rejected;
+        break;
+    }
+    stats.totalMillis += result.elapsedMillis;
+
+    payments.erase(paymentId);
+    if (payment->atGateway)
+    {
+        // Finished by an earlier attempt's approval while this one is still out
+        payment->atGateway = false;
+        --inFlight;
+        ++payment->unanswered;
+    }
+    if (payment->unanswered > 0)
+    {
+        Settled &outcome = settled[paymentId];
+        outcome.approved = status == PaymentResult::APPROVED;
+        outcome.unanswered = payment->unanswered;
+        if (settled.size() > config.maxQueued)
+        {
+            settled.erase(settled.begin());
+        }
+    }
+    actions.finished.push_back(std::make_pair(payment, result));
+    if (stopping && payments.empty())
+    {
+        wakeScheduler.notify_one();
+    }
+}
+
+void AsyncPaymentProcessor::perform(Actions &actions)
+{
+    for (const Launch &launch : actions.launches)
+    {
+        std::shared_ptr<Liveness> live = liveness;
+        std::uint64_t paymentId = launch.paymentId;
+        std::uint64_t attempt = launch.attempt;
+        gateway->charge(launch.request, launch.idempotencyKey,
+                        [this, live, paymentId, attempt](PaymentGateway::Response response, const std::string &reference) {
+                            std::lock_guard<std::recursive_mutex> lock(live->mutex);
+                            if (live->alive)
+                            {
+                                onAnswer(paymentId, attempt, response, reference);
+                            }
+                        });
+    }
+    for (const std::pair<std::string, std::string> &reversal : actions.reversals)
+    {
+        gateway->reverse(reversal.first, reversal.second);
+    }
+    for (std::size_t i = 0; i < actions.finished.size(); ++i)
+    {
+        Payment *payment = actions.finished[i].first;
+        recordOutcome(payment->request, actions.finished[i].second);
+        if (payment->promise)
+        {
+            payment->promise->set_value(actions.finished[i].second);
+        }
+        if (payment->callback)
+        {
+            payment->callback(actions.finished[i].second);
+        }
+        delete payment;
+    }
+    actions.launches.clear();
+    actions.finished.clear();
+    actions.reversals.clear();
+}
+
+void AsyncPaymentProcessor::recordOutcome(const PaymentRequest &request, const PaymentResult &result) const
+{
+    if (result.status == PaymentResult::APPROVED)
+    {
+        SettlementEngine::getInstance().recordAuthorization(result.reference, config.method, request.orderId,
+                                                            request.customerId, request.amount);
+        PaymentLedger::getInstance().recordPayment(config.method, result.reference, request.orderId,
+                                                   request.customerId, request.amount, request.plantUnits);
+    }
+    else
+    {
+        PaymentLedger::getInstance().recordDecline(config.method, request.orderId, request.customerId,
+                                                   request.amount);
+    }
+}
+
+void AsyncPaymentProcessor::onAnswer(std::uint64_t paymentId, std::uint64_t attempt,
+                                     PaymentGateway::Response response, const std::string &reference)
+{
+    Actions actions;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unordered_map<std::uint64_t, Payment *>::iterator found = payments.find(paymentId);
+        if (found == payments.end() || found->second->attempt != attempt || !found->second->atGateway)
+        {
+            lateAnswerLocked(paymentId, response, reference, actions);
+        }
+        else
+        {
+            Payment *payment = found->second;
+            payment->atGateway = false;
+            --inFlight;
+
+            if (response == PaymentGateway::UNAVAILABLE)
+            {
+                attemptFailedLocked(paymentId, payment, PaymentResult::GATEWAY_UNAVAILABLE, actions);
+            }
+            else
+            {
+                // Declines come from a healthy gateway, so they count towards closing the breaker too
+                consecutiveFailures = 0;
+                if (payment->probe)
+                {
+                    probeAtGateway = false;
+                    breaker = CLOSED;
+                }
+                finishLocked(paymentId, payment,
+                             response == PaymentGateway::APPROVED ? PaymentResult::APPROVED : PaymentResult::DECLINED,
+                             reference, actions);
+            }
+        }
+        dispatchLocked(actions);
+    }
+    perform(actions);
+}
+
+// An answer to an attempt that had timed out. A charge approved after all must not go unaccounted for: it either
+// completes the payment or, if the payment has already failed, is given back
+void AsyncPaymentProcessor::lateAnswerLocked(std::uint64_t paymentId, PaymentGateway::Response response,
+                                             const std::string &reference, Actions &actions)
+{
+    ++stats.lateAnswers;
+    std::unordered_map<std::uint64_t, Payment *>::iterator live = payments.find(paymentId);
+    if (live != payments.end())
+    {
+        Payment *payment = live->second;
+        --payment->unanswered;
+        if (response != PaymentGateway::APPROVED)
+        {
+            return; // the attempt still out, or the retry to come, decides
+        }
+        std::deque<std::uint64_t>::iterator waiting = std::find(queued.begin(), queued.end(), paymentId);
+        if (waiting != queued.end())
+        {
+            queued.erase(waiting);
+        }
+        consecutiveFailures = 0;
+        if (payment->probe && payment->atGateway)
+        {
+            probeAtGateway = false;
+            breaker = CLOSED;
+        }
+        finishLocked(paymentId, payment, PaymentResult::APPROVED, reference, actions);
+        return;
+    }
+
+    std::map<std::uint64_t, Settled>::iterator finished = settled.find(paymentId);
+    bool remembered = finished != settled.end();
+    bool approved = remembered && finished->second.approved;
+    if (remembered && --finished->second.unanswered <= 0)
+    {
+        settled.erase(finished);
+    }
+    if (response != PaymentGateway::APPROVED || approved)
+    {
+        return; // a failure, or a repeat of the approval the payment finished with
+    }
+    std::string idempotencyKey = IdGenerator::format("PAY-", paymentId);
+    if (!remembered)
+    {
+        ++stats.unmatchedApprovals;
+        GH_LOG_WARN(Logger::PAYMENTS, "Approval " << reference << " for payment " << idempotencyKey
+                                                  << " came after its outcome was forgotten; check it with the provider");
+        return;
+    }
+    ++stats.lateApprovals;
+    actions.reversals.push_back(std::make_pair(reference, idempotencyKey));
+}
+
+void AsyncPaymentProcessor::runScheduler()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!(stopping && payments.empty()))
+    {
+        if (timers.empty())
+        {
+            wakeScheduler.wait(lock);
+            continue;
+        }
+        Clock::time_point due = timers.begin()->first;
+        if (Clock::now() < due)
+        {
+            wakeScheduler.wait_until(lock, due);
+            continue;
+        }
+
+        Actions actions;
+        while (!timers.empty() && timers.begin()->first <= Clock::now())
+        {
+            Timer timer = timers.begin()->second;
+            timers.erase(timers.begin());
+            std::unordered_map<std::uint64_t, Payment *>::iterator found = payments.find(timer.paymentId);
+            if (found == payments.end() || found->second->attempt != timer.attempt)
+            {
+                continue; // the payment finished or moved on to another attempt
+            }
+            Payment *payment = found->second;
+            if (!timer.retry)
+            {
+                if (payment->atGateway)
+                {
+                    payment->atGateway = false;
+                    --inFlight;
+                    ++payment->unanswered;
+                    ++stats.timeouts;
+                    attemptFailedLocked(timer.paymentId, payment, PaymentResult::TIMED_OUT, actions);
+                }
+            }
+            else if (stopping)
+            {
+                finishLocked(timer.paymentId, payment, payment->lastFailure, std::string(), actions);
+            }
+            else
+            {
+                queued.push_front(timer.paymentId); // retries go ahead of new payments
+            }
+        }
+        dispatchLocked(actions);
+        lock.unlock();
+        perform(actions);
+        lock.lock();
+    }
+}
+
+void AsyncPaymentProcessor::shutdown()
+{
+    Actions actions;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        while (!queued.empty())
+        {
+            std::uint64_t paymentId = queued.front();
+            queued.pop_front();
+            finishLocked(paymentId, payments[paymentId], PaymentResult::REJECTED, std::string(), actions);
+        }
+        queueSpace.notify_all();
+        wakeScheduler.notify_one();
+    }
+    perform(actions);
+    if (scheduler.joinable())
+    {
+        scheduler.join();
+    }
+}
+
+AsyncPaymentProcessor::Stats AsyncPaymentProcessor::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+AsyncPaymentProcessor::BreakerState AsyncPaymentProcessor::getBreakerState() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return breaker;
+}
+
+std::size_t AsyncPaymentProcessor::getInFlightCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return inFlight;
+}
+
+std::size_t AsyncPaymentProcessor::getQueuedCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return queued.size();
+}
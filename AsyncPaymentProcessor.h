@@ -0,0 +1,261 @@
+#ifndef ASYNC_PAYMENT_PROCESSOR_H
+#define ASYNC_PAYMENT_PROCESSOR_H
+
+#include "PaymentGateway.h"
+#include "PaymentProcessor.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Final answer for one payment submitted to an AsyncPaymentProcessor
+ */
+struct PaymentResult
+{
+    enum Status
+    {
+        APPROVED,
+        DECLINED,
+        TIMED_OUT,           // the last attempt got no answer in time
+        GATEWAY_UNAVAILABLE, // the last attempt was answered UNAVAILABLE
+        CIRCUIT_OPEN,        // not attempted (again) because the circuit breaker is open
+        REJECTED             // queue full or processor shut down; never attempted
+    };
+
+    Status status;
+    std::string reference; // gateway reference when approved
+    int attempts;
+    double elapsedMillis; // from submission to the final answer
+
+    PaymentResult() : status(REJECTED), attempts(0), elapsedMillis(0.0) {}
+};
+
+/**
+ * @class AsyncPaymentProcessor
+ * @brief Non-blocking payments over a PaymentGateway, with timeouts, retries and a circuit breaker
+ *
+ * submit() returns straight away with a future (or calls back) and the
+ * payment runs in the background:
+ * - at most maxInFlight charges are outstanding at the gateway; further
+ *   payments wait in a queue of up to maxQueued, beyond which they are
+ *   rejected;
+ * - an attempt not answered within attemptTimeoutMillis counts as failed;
+ * - failed attempts (timeouts and UNAVAILABLE answers) are retried up to
+ *   maxAttempts in total, after a random delay of up to
+ *   retryBaseMillis * 2^(retry - 1), capped at retryMaxMillis ("full jitter",
+ *   so clients that failed together do not retry together). Declines are
+ *   final. Every attempt reuses the payment's idempotency key;
+ * - after breakerFailureThreshold failed attempts in a row the circuit
+ *   breaker opens and payments fail fast with CIRCUIT_OPEN. Once
+ *   breakerOpenMillis has passed, one probe attempt is let through
+ *   (half-open); its success closes the breaker again.
+ *
+ * Like the till processors, every outcome is recorded under config.method:
+ * approvals as a SettlementEngine authorization and a PaymentLedger payment
+ * (keyed by the gateway reference and the request's orderId), anything else
+ * as a ledger decline. Both happen before the caller hears the result, so a
+ * caller that voids the order afterwards finds the payment to reverse.
+ *
+ * An attempt that timed out may still be approved. If another attempt of the
+ * payment is still running, that approval completes the payment. If the
+ * payment has already failed, the charge is given back through
+ * PaymentGateway::reverse() and counted in lateApprovals, so the customer is
+ * never charged for a payment reported as failed. Outcomes are remembered
+ * for the last maxQueued finished payments with attempts still unanswered;
+ * an approval for an older one is logged as a warning and counted in
+ * unmatchedApprovals for someone to check by hand.
+ *
+ * Timeouts and retry delays run on one scheduler thread; gateway answers
+ * are handled on whichever thread the gateway calls back on. Futures are
+ * fulfilled and callbacks run on those threads too, so callbacks should be
+ * quick and must not destroy the processor.
+ *
+ * Also a PaymentProcessor: processPayment() waits for its payment, and
+ * processPayments() has the whole batch in flight at once, so it can be
+ * plugged into BatchCheckout. The gateway must outlive the processor.
+ */
+class AsyncPaymentProcessor : public PaymentProcessor
+{
+public:
+    typedef std::function<void(const PaymentResult &)> Callback;
+
+    enum BreakerState
+    {
+        CLOSED,
+        OPEN,
+        HALF_OPEN
+    };
+
+    struct Config
+    {
+        std::size_t maxInFlight;
+        std::size_t maxQueued;
+        double attemptTimeoutMillis;
+        int maxAttempts;
+        double retryBaseMillis;
+        double retryMaxMillis;
+        int breakerFailureThreshold;
+        double breakerOpenMillis;
+        std::string method; // payment method in the ledger and settlement; "GATEWAY" by default
+
+        Config();
+    };
+
+    struct Stats
+    {
+        std::uint64_t submitted;
+        std::uint64_t approved;
+        std::uint64_t declined;
+        std::uint64_t failed;   // timed out or unavailable after all attempts
+        std::uint64_t rejected; // queue full, circuit open or shut down
+        std::uint64_t attempts;
+        std::uint64_t retries;
+        std::uint64_t timeouts;
+        std::uint64_t lateAnswers;   // answers to attempts that had already timed out
+        std::uint64_t lateApprovals; // ...of which approvals for a payment that had failed; each one reversed
+        std::uint64_t unmatchedApprovals; // ...approvals for a payment whose outcome was no longer remembered
+        std::size_t peakInFlight;
+        double totalMillis; // summed elapsed time of finished payments
+
+        Stats();
+    };
+
+    explicit AsyncPaymentProcessor(PaymentGateway *gateway, const Config &config = Config());
+    ~AsyncPaymentProcessor();
+
+    AsyncPaymentProcessor(const AsyncPaymentProcessor &) = delete;
+    AsyncPaymentProcessor &operator=(const AsyncPaymentProcessor &) = delete;
+
+    std::future<PaymentResult> submit(const PaymentRequest &request);
+    void submit(const PaymentRequest &request, const Callback &done);
+
+    bool processPayment(double amount, const std::string &customerId, const std::string &payload) override;
+    bool processRequest(const PaymentRequest &request) override;
+    std::vector<bool> processPayments(const std::vector<PaymentRequest> &requests) override;
+
+    /**
+     * @brief Stops accepting payments and waits for those already started
+     *
+     * Queued payments are rejected; payments with an attempt at the gateway
+     * finish normally (at worst by timing out), and payments waiting to
+     * retry end with their last failure. Called by the destructor.
+     */
+    void shutdown();
+
+    Stats getStats() const;
+    BreakerState getBreakerState() const;
+    std::size_t getInFlightCount() const;
+    std::size_t getQueuedCount() const;
+
+    static const char *getStatusName(PaymentResult::Status status);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Payment
+    {
+        std::string idempotencyKey;
+        PaymentRequest request;
+        std::unique_ptr<std::promise<PaymentResult> > promise;
+        Callback callback;
+        Clock::time_point submitted;
+        int attempts;
+        int unanswered;        // attempts that timed out and may still be answered
+        std::uint64_t attempt; // current attempt number, for recognising stale answers
+        bool atGateway;
+        bool probe; // the half-open breaker's trial attempt
+        PaymentResult::Status lastFailure;
+    };
+
+    struct Timer
+    {
+        bool retry; // otherwise an attempt timeout
+        std::uint64_t paymentId;
+        std::uint64_t attempt;
+    };
+
+    struct Launch
+    {
+        std::uint64_t paymentId;
+        std::uint64_t attempt;
+        std::string idempotencyKey;
+        PaymentRequest request;
+    };
+
+    // A finished payment some of whose attempts may still be answered
+    struct Settled
+    {
+        bool approved;
+        int unanswered;
+    };
+
+    // Work decided under the lock and carried out after it is released
+    struct Actions
+    {
+        std::vector<Launch> launches;
+        std::vector<std::pair<Payment *, PaymentResult> > finished;
+        std::vector<std::pair<std::string, std::string> > reversals; // gateway reference, idempotency key
+    };
+
+    // Outlives the processor inside gateway callbacks, so late answers find it gone instead of dangling
+    struct Liveness
+    {
+        std::recursive_mutex mutex;
+        bool alive;
+    };
+
+    PaymentGateway *gateway;
+    Config config;
+    std::shared_ptr<Liveness> liveness;
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeScheduler;
+    std::condition_variable queueSpace;
+    std::thread scheduler;
+    bool stopping;
+
+    std::unordered_map<std::uint64_t, Payment *> payments;
+    std::deque<std::uint64_t> queued;
+    std::map<std::uint64_t, Settled> settled; // by payment ID, so the oldest comes first
+    std::multimap<Clock::time_point, Timer> timers;
+    std::size_t inFlight;
+    std::uint64_t nextAttempt;
+    std::mt19937 rng;
+    Stats stats;
+
+    BreakerState breaker;
+    int consecutiveFailures;
+    Clock::time_point breakerOpenedAt;
+    bool probeAtGateway;
+
+    void enqueue(Payment *payment, bool waitForSpace);
+    void dispatchLocked(Actions &actions);
+    void startAttemptLocked(std::uint64_t paymentId, Payment *payment, Actions &actions);
+    void attemptFailedLocked(std::uint64_t paymentId, Payment *payment, PaymentResult::Status reason,
+                             Actions &actions);
+    void finishLocked(std::uint64_t paymentId, Payment *payment, PaymentResult::Status status,
+                      const std::string &reference, Actions &actions);
+    void perform(Actions &actions);
+    void recordOutcome(const PaymentRequest &request, const PaymentResult &result) const;
+    void lateAnswerLocked(std::uint64_t paymentId, PaymentGateway::Response response, const std::string &reference,
+                          Actions &actions);
+    void onAnswer(std::uint64_t paymentId, std::uint64_t attempt, PaymentGateway::Response response,
+                  const std::string &reference);
+    void runScheduler();
+};
+
+#endif // ASYNC_PAYMENT_PROCESSOR_H
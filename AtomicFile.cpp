@@ -0,0 +1,41 @@
+#include "AtomicFile.h"
+
+#include <cstdio>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+bool replaceFile(const std::string &tempPath, const std::string &path)
+{
+#ifdef _WIN32
+    if (MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+    {
+        return true;
+    }
+#else
+    if (std::rename(tempPath.c_str(), path.c_str()) == 0)
+    {
+        return true;
+    }
+#endif
+    std::remove(tempPath.c_str());
+    return false;
+}
+
+bool writeFileAtomically(const std::string &path, const std::string &content)
+{
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(content.data(), static_cast<std::streamsize>(content.size()));
+        out.close();
+        if (!out)
+        {
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    return replaceFile(tempPath, path);
+}
@@ -0,0 +1,32 @@
+#ifndef ATOMIC_FILE_H
+#define ATOMIC_FILE_H
+
+#include <string>
+
+/**
+ * @file AtomicFile.h
+ * @brief Whole-file rewrites that never leave a half-written or missing file
+ *
+ * The persistence layers (inventory snapshots, the order store, the payment
+ * ledger, settlement batches and the notification outbox) write the new
+ * content beside the target as path + ".tmp" and then move it over the
+ * target, so a reader or a crash sees either the old file or the new one.
+ *
+ * On POSIX, rename() replaces an existing target in one step. Windows'
+ * rename() refuses to, so there the move uses MoveFileEx with
+ * MOVEFILE_REPLACE_EXISTING instead of removing the target first.
+ */
+
+/**
+ * @brief Moves tempPath over path, replacing path if it exists
+ * @return false if the move failed; path is then left as it was
+ */
+bool replaceFile(const std::string &tempPath, const std::string &path);
+
+/**
+ * @brief Writes content to path + ".tmp" and moves it over path
+ * @return false if the temporary file could not be written or moved; path is then left as it was
+ */
+bool writeFileAtomically(const std::string &path, const std::string &content);
+
+#endif // ATOMIC_FILE_H
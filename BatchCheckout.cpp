@@ -0,0 +1,271 @@
+#include "BatchCheckout.h"
+#include "CashAdaptee.h"
+#include "CashAdapter.h"
+#include "CreditCardAdaptee.h"
+#include "CreditCardAdapter.h"
+#include "EFTAdaptee.h"
+#include "EFTAdapter.h"
+#include "FlattenedOrder.h"
+#include "Order.h"
+#include "OrderStore.h"
+#include "PaymentLedger.h"
+#include "PaymentProcessor.h"
+#include "SettlementEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    double millisSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+}
+
+BatchCheckout::Stats::Stats()
+    : orders(0), completed(0), rejectedForStock(0), declined(0), otherFailures(0), plantUnitsRequested(0),
+      plantUnitsSold(0), revenue(0.0), reserveMillis(0.0), paymentMillis(0.0), commitMillis(0.0), totalMillis(0.0)
+{
+}
+
+double BatchCheckout::Stats::getOrdersPerSecond() const
+{
+    return totalMillis > 0.0 ? orders * 1000.0 / totalMillis : 0.0;
+}
+
+BatchCheckout::BatchCheckout()
+    : cashSystem(new CashAdaptee()), creditCardSystem(new CreditCardAdaptee()), eftSystem(new EFTAdaptee())
+{
+    ownedProcessors.push_back(processors["CASH"] = new CashAdapter(cashSystem));
+    ownedProcessors.push_back(processors["CREDIT_CARD"] = new CreditCardAdapter(creditCardSystem));
+    ownedProcessors.push_back(processors["EFT"] = new EFTAdapter(eftSystem));
+}
+
+BatchCheckout::~BatchCheckout()
+{
+    for (PaymentProcessor *processor : ownedProcessors)
+    {
+        delete processor;
+    }
+    delete cashSystem;
+    delete creditCardSystem;
+    delete eftSystem;
+}
+
+void BatchCheckout::setPaymentProcessor(const std::string &paymentType, PaymentProcessor *processor)
+{
+    processors[paymentType] = processor;
+}
+
+const BatchCheckout::Stats &BatchCheckout::getLastStats() const
+{
+    return lastStats;
+}
+
+const char *BatchCheckout::getOutcomeName(Outcome outcome)
+{
+    switch (outcome)
+    {
+    case COMPLETED:
+        return "Completed";
+    case INSUFFICIENT_STOCK:
+        return "Insufficient Stock";
+    case PAYMENT_DECLINED:
+        return "Payment Declined";
+    case UNSUPPORTED_PAYMENT:
+        return "Unsupported Payment Type";
+    case COMMIT_FAILED:
+        return "Inventory Commit Failed";
+    case INVALID_ORDER:
+        return "Invalid Order";
+    default:
+        return "Unknown";
+    }
+}
+
+// Smallest orders first, then by order ID, so the allocation depends only on the batch's contents
+std::vector<std::size_t> BatchCheckout::allocationOrder(const std::vector<Request> &batch,
+                                                        const std::vector<Result> &results) const
+{
+    std::vector<std::size_t> order;
+    order.reserve(batch.size());
+    for (std::size_t i = 0; i < batch.size(); ++i)
+    {
+        if (batch[i].order)
+        {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&results](std::size_t a, std::size_t b) {
+        if (results[a].plantUnits != results[b].plantUnits)
+        {
+            return results[a].plantUnits < results[b].plantUnits;
+        }
+        if (results[a].orderId != results[b].orderId)
+        {
+            return results[a].orderId < results[b].orderId;
+        }
+        return a < b;
+    });
+    return order;
+}
+
+std::vector<BatchCheckout::Result> BatchCheckout::checkout(const std::vector<Request> &batch)
+{
+    InventoryManager &inventory = InventoryManager::getInstance();
+    Clock::time_point start = Clock::now();
+    lastStats = Stats();
+    lastStats.orders = batch.size();
+
+    std::vector<Result> results(batch.size());
+    for (std::size_t i = 0; i < batch.size(); ++i)
+    {
+        Order *order = batch[i].order;
+        if (!order)
+        {
+            continue;
+        }
+        results[i].orderId = order->getOrderId();
+        results[i].plantUnits = order->getFlattened().getPlantUnits();
+        results[i].amount = order->calculateTotalAmount();
+        lastStats.plantUnitsRequested += results[i].plantUnits;
+    }
+
+    // Pass 1: reserve everything in allocation order under a single inventory lock
+    std::vector<std::size_t> allocation = allocationOrder(batch, results);
+    std::vector<const FlattenedOrder *> demand;
+    demand.reserve(allocation.size());
+    for (std::size_t index : allocation)
+    {
+        Order *order = batch[index].order;
+        if (order->getReservationId() != 0)
+        {
+            inventory.releaseReservation(order->getReservationId());
+            order->setReservationId(0);
+        }
+        // Empty orders and orders with unsupported payments reserve nothing
+        bool payable = processors.find(batch[index].paymentType) != processors.end();
+        demand.push_back(payable && order->getItemCount() > 0 ? &order->getFlattened() : nullptr);
+    }
+    std::vector<std::uint64_t> reservationIds;
+    std::vector<std::vector<InventoryManager::StockShortage> > shortages;
+    inventory.reserveOrders(demand, reservationIds, &shortages);
+    lastStats.reserveMillis = millisSince(start);
+
+    // Pass 2: one bulk payment call per payment type, in allocation order
+    Clock::time_point paymentStart = Clock::now();
+    std::map<std::string, std::vector<std::size_t> > byType;
+    for (std::size_t k = 0; k < allocation.size(); ++k)
+    {
+        std::size_t index = allocation[k];
+        Order *order = batch[index].order;
+        Result &result = results[index];
+        if (!demand[k])
+        {
+            result.outcome = order->getItemCount() > 0 ? UNSUPPORTED_PAYMENT : INVALID_ORDER;
+            continue;
+        }
+        if (reservationIds[k] == 0)
+        {
+            result.outcome = INSUFFICIENT_STOCK;
+            result.shortages.swap(shortages[k]);
+            continue;
+        }
+        order->setReservationId(reservationIds[k]);
+        byType[batch[index].paymentType].push_back(index);
+    }
+    for (std::map<std::string, std::vector<std::size_t> >::const_iterator group = byType.begin(); group != byType.end();
+         ++group)
+    {
+        std::vector<PaymentRequest> requests;
+        requests.reserve(group->second.size());
+        for (std::size_t index : group->second)
+        {
+            PaymentRequest request;
+            request.amount = results[index].amount;
+            request.customerId = batch[index].order->getCustomerName();
+            request.payload = batch[index].paymentDetails;
+            request.orderId = results[index].orderId;
+            request.plantUnits = results[index].plantUnits;
+            requests.push_back(request);
+        }
+        std::vector<bool> paid = processors[group->first]->processPayments(requests);
+        for (std::size_t j = 0; j < group->second.size(); ++j)
+        {
+            results[group->second[j]].outcome = j < paid.size() && paid[j] ? COMPLETED : PAYMENT_DECLINED;
+        }
+    }
+    lastStats.paymentMillis = millisSince(paymentStart);
+
+    // Pass 3: hand paid stock over and give declined reservations back
+    Clock::time_point commitStart = Clock::now();
+    for (std::size_t i = 0; i < batch.size(); ++i)
+    {
+        Order *order = batch[i].order;
+        if (!order)
+        {
+            continue;
+        }
+        Result &result = results[i];
+        if (order->getReservationId() != 0)
+        {
+            if (result.outcome != COMPLETED)
+            {
+                inventory.releaseReservation(order->getReservationId());
+            }
+            else if (!inventory.commitReservation(order->getReservationId()))
+            {
+                result.outcome = COMMIT_FAILED;
+                inventory.releaseReservation(order->getReservationId()); // a failed commit sells nothing
+                // Card and EFT authorizations are not settled yet; cash was taken, so the ledger reverses it
+                SettlementEngine::getInstance().voidOrder(result.orderId);
+                PaymentLedger::getInstance().recordOrderVoid(result.orderId);
+            }
+            order->setReservationId(0);
+        }
+        finish(order, result);
+    }
+    lastStats.commitMillis = millisSince(commitStart);
+    lastStats.totalMillis = millisSince(start);
+
+    std::cout << "[BATCH CHECKOUT] " << lastStats.orders << " orders: " << lastStats.completed << " completed, "
+              << lastStats.rejectedForStock << " short of stock, " << lastStats.declined << " declined, "
+              << lastStats.otherFailures << " other failures; " << lastStats.plantUnitsSold << "/"
+              << lastStats.plantUnitsRequested << " plants sold in " << lastStats.totalMillis << " ms ("
+              << lastStats.getOrdersPerSecond() << " orders/s)" << std::endl;
+    return results;
+}
+
+void BatchCheckout::finish(Order *order, const Result &result)
+{
+    switch (result.outcome)
+    {
+    case COMPLETED:
+        ++lastStats.completed;
+        lastStats.plantUnitsSold += result.plantUnits;
+        lastStats.revenue += result.amount;
+        order->setStatus("Completed - Paid");
+        break;
+    case INSUFFICIENT_STOCK:
+        ++lastStats.rejectedForStock;
+        order->setStatus("Rejected - Insufficient Stock");
+        break;
+    case PAYMENT_DECLINED:
+        ++lastStats.declined;
+        order->setStatus("Payment Failed");
+        break;
+    case COMMIT_FAILED:
+        ++lastStats.otherFailures;
+        order->setStatus("Payment Voided - Stock Unavailable");
+        break;
+    default:
+        ++lastStats.otherFailures;
+        order->setStatus(std::string("Rejected - ") + getOutcomeName(result.outcome));
+        break;
+    }
+    OrderStore::getInstance().append(*order);
+}
@@ -0,0 +1,119 @@
+#ifndef BATCH_CHECKOUT_H
+#define BATCH_CHECKOUT_H
+
+#include "InventoryManager.h"
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+class Order;
+class PaymentProcessor;
+class CashAdaptee;
+class CreditCardAdaptee;
+class EFTAdaptee;
+
+/**
+ * @class BatchCheckout
+ * @brief Checks out many orders at once, e.g. a bulk or B2B purchase
+ *
+ * Instead of running every order through the handler chain on its own, a
+ * batch goes through three passes:
+ * @code
+ * reserve (one locked InventoryManager pass) -> pay (one bulk call per payment type) -> commit/release
+ * @endcode
+ * When the batch asks for more stock than the sales floor holds, orders are
+ * allocated smallest first (fewest plant units, then order ID). That fills
+ * as many orders as possible, and because it only depends on the orders
+ * themselves, the same batch always gets the same allocation however it was
+ * put together. Each order is still all or nothing.
+ *
+ * Payment types are the keys Customer uses ("CASH", "CREDIT_CARD", "EFT");
+ * other gateways can be registered with setPaymentProcessor().
+ * Not thread-safe: use one BatchCheckout per thread.
+ */
+class BatchCheckout
+{
+public:
+    struct Request
+    {
+        Order *order;
+        std::string paymentType;
+        std::string paymentDetails; // payload for PaymentProcessor::processPayment()
+    };
+
+    enum Outcome
+    {
+        COMPLETED,
+        INSUFFICIENT_STOCK,
+        PAYMENT_DECLINED,
+        UNSUPPORTED_PAYMENT,
+        COMMIT_FAILED, // paid, but the held stock went missing; every payment method is reversed
+        INVALID_ORDER
+    };
+
+    struct Result
+    {
+        std::string orderId;
+        Outcome outcome;
+        int plantUnits;
+        double amount;
+        std::vector<InventoryManager::StockShortage> shortages; // set for INSUFFICIENT_STOCK
+
+        Result() : outcome(INVALID_ORDER), plantUnits(0), amount(0.0) {}
+    };
+
+    /** @brief Totals and per-pass timings of the last checkout() */
+    struct Stats
+    {
+        std::size_t orders;
+        std::size_t completed;
+        std::size_t rejectedForStock;
+        std::size_t declined;
+        std::size_t otherFailures;
+        long plantUnitsRequested;
+        long plantUnitsSold;
+        double revenue;
+        double reserveMillis;
+        double paymentMillis;
+        double commitMillis;
+        double totalMillis;
+
+        Stats();
+        double getOrdersPerSecond() const;
+    };
+
+    BatchCheckout();
+    ~BatchCheckout();
+
+    BatchCheckout(const BatchCheckout &) = delete;
+    BatchCheckout &operator=(const BatchCheckout &) = delete;
+
+    /** @brief Routes a payment type to another processor; the processor is not owned */
+    void setPaymentProcessor(const std::string &paymentType, PaymentProcessor *processor);
+
+    /**
+     * @brief Reserves, charges and commits every order in the batch
+     * @return One result per request, in request order
+     */
+    std::vector<Result> checkout(const std::vector<Request> &batch);
+
+    const Stats &getLastStats() const;
+
+    static const char *getOutcomeName(Outcome outcome);
+
+private:
+    CashAdaptee *cashSystem;
+    CreditCardAdaptee *creditCardSystem;
+    EFTAdaptee *eftSystem;
+    std::vector<PaymentProcessor *> ownedProcessors;
+    std::map<std::string, PaymentProcessor *> processors;
+    Stats lastStats;
+
+    std::vector<std::size_t> allocationOrder(const std::vector<Request> &batch,
+                                             const std::vector<Result> &results) const;
+    void finish(Order *order, const Result &result);
+};
+
+#endif // BATCH_CHECKOUT_H
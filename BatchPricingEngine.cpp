@@ -0,0 +1,280 @@
+#include "BatchPricingEngine.h"
+#include "Order.h"
+#include "PlantBundle.h"
+#include "SinglePlant.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const std::int64_t BASIS_POINTS = 10000; // 100%
+    const std::int64_t NO_OVERRIDE = -1;
+
+    // Integer division rounding halves away from zero, like std::llround
+    std::int64_t roundDiv(std::int64_t numerator, std::int64_t denominator)
+    {
+        return numerator >= 0 ? (numerator + denominator / 2) / denominator
+                              : -((-numerator + denominator / 2) / denominator);
+    }
+
+    // Builds an id-indexed lookup table (shifted by one so id -1 maps to "no override")
+    std::vector<std::int64_t> buildOverrideTable(const std::unordered_map<std::string, std::int64_t> &prices,
+                                                 const std::unordered_map<std::string, std::int32_t> &ids,
+                                                 std::size_t idCount)
+    {
+        std::vector<std::int64_t> table(idCount + 1, NO_OVERRIDE);
+        for (std::unordered_map<std::string, std::int64_t>::const_iterator it = prices.begin(); it != prices.end(); ++it)
+        {
+            std::unordered_map<std::string, std::int32_t>::const_iterator id = ids.find(it->first);
+            if (id != ids.end())
+            {
+                table[id->second + 1] = it->second;
+            }
+        }
+        return table;
+    }
+}
+
+BatchPricingEngine::BatchPricingEngine()
+{
+}
+
+void BatchPricingEngine::clear()
+{
+    orderSlot.clear();
+    parent.clear();
+    quantity.clear();
+    plantType.clear();
+    potType.clear();
+    childCount.clear();
+    isBundle.clear();
+    capturedUnitCents.clear();
+    capturedPotCents.clear();
+    capturedDiscountBp.clear();
+    unitCents.clear();
+    potCents.clear();
+    discountBp.clear();
+    amount.clear();
+    orderIds.clear();
+    orderAmount.clear();
+    orderTotalCents.clear();
+    plantTypeIds.clear();
+    potTypeIds.clear();
+    plantTypeNames.clear();
+    potTypeNames.clear();
+}
+
+void BatchPricingEngine::reserve(std::size_t orders, std::size_t items)
+{
+    orderSlot.reserve(items);
+    parent.reserve(items);
+    quantity.reserve(items);
+    plantType.reserve(items);
+    potType.reserve(items);
+    childCount.reserve(items);
+    isBundle.reserve(items);
+    capturedUnitCents.reserve(items);
+    capturedPotCents.reserve(items);
+    capturedDiscountBp.reserve(items);
+    orderIds.reserve(orders);
+}
+
+std::int32_t BatchPricingEngine::intern(std::unordered_map<std::string, std::int32_t> &ids,
+                                        std::vector<std::string> &names, const std::string &name)
+{
+    std::pair<std::unordered_map<std::string, std::int32_t>::iterator, bool> inserted =
+        ids.insert(std::make_pair(name, static_cast<std::int32_t>(names.size())));
+    if (inserted.second)
+    {
+        names.push_back(name);
+    }
+    return inserted.first->second;
+}
+
+std::size_t BatchPricingEngine::addOrder(const Order &order)
+{
+    std::int32_t slot = static_cast<std::int32_t>(orderIds.size());
+    orderIds.push_back(order.getOrderId());
+
+    // The order's flattening is already in pre-order with parent links; only the indexes need rebasing
+    const std::vector<FlattenedOrder::Node> &nodes = order.getFlattened().getNodes();
+    const std::int32_t base = static_cast<std::int32_t>(quantity.size());
+    for (const FlattenedOrder::Node &node : nodes)
+    {
+        orderSlot.push_back(slot);
+        parent.push_back(node.parent >= 0 ? base + node.parent : -1);
+        quantity.push_back(node.item->getQuantity());
+        childCount.push_back(node.childCount);
+
+        if (const SinglePlant *plant = node.plant)
+        {
+            isBundle.push_back(0);
+            plantType.push_back(intern(plantTypeIds, plantTypeNames, plant->getPlantType()));
+            potType.push_back(plant->hasPlantPot() ? intern(potTypeIds, potTypeNames, plant->getPotType()) : -1);
+            capturedUnitCents.push_back(toCents(plant->getUnitPrice()));
+            capturedPotCents.push_back(plant->hasPlantPot() ? toCents(plant->getPotPrice()) : 0);
+            capturedDiscountBp.push_back(0);
+        }
+        else
+        {
+            isBundle.push_back(1);
+            plantType.push_back(-1);
+            potType.push_back(-1);
+            capturedUnitCents.push_back(0);
+            capturedPotCents.push_back(0);
+            capturedDiscountBp.push_back(toBasisPoints(node.bundle->getDiscount()));
+        }
+    }
+    return static_cast<std::size_t>(slot);
+}
+
+void BatchPricingEngine::resetPrices()
+{
+    unitCents = capturedUnitCents;
+    potCents = capturedPotCents;
+    discountBp = capturedDiscountBp;
+}
+
+void BatchPricingEngine::applyPriceList(const PriceList &prices)
+{
+    const std::size_t n = quantity.size();
+    unitCents.resize(n);
+    potCents.resize(n);
+    discountBp = capturedDiscountBp;
+
+    // Gather loops: one table lookup and a select per item, no per-item hashing
+    std::vector<std::int64_t> plantTable = buildOverrideTable(prices.plantCents, plantTypeIds, plantTypeNames.size());
+    std::vector<std::int64_t> potTable = buildOverrideTable(prices.potCents, potTypeIds, potTypeNames.size());
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        std::int64_t unit = plantTable[plantType[i] + 1];
+        unitCents[i] = unit != NO_OVERRIDE ? unit : capturedUnitCents[i];
+    }
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        std::int64_t pot = potTable[potType[i] + 1];
+        potCents[i] = pot != NO_OVERRIDE ? pot : capturedPotCents[i];
+    }
+
+    if (prices.bundleTiers.empty())
+    {
+        return;
+    }
+    std::vector<DiscountTier> tiers = prices.bundleTiers;
+    std::sort(tiers.begin(), tiers.end(),
+              [](const DiscountTier &a, const DiscountTier &b) { return a.minItems > b.minItems; });
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (!isBundle[i])
+        {
+            continue;
+        }
+        std::int32_t bp = 0;
+        for (const DiscountTier &tier : tiers)
+        {
+            if (childCount[i] >= tier.minItems)
+            {
+                bp = tier.basisPoints;
+                break;
+            }
+        }
+        discountBp[i] = bp;
+    }
+}
+
+void BatchPricingEngine::computeTotals()
+{
+    const std::size_t n = quantity.size();
+    if (unitCents.size() != n)
+    {
+        // Items added since the last price list: extend the columns with captured prices
+        std::size_t priced = unitCents.size();
+        unitCents.insert(unitCents.end(), capturedUnitCents.begin() + priced, capturedUnitCents.end());
+        potCents.insert(potCents.end(), capturedPotCents.begin() + priced, capturedPotCents.end());
+        discountBp.insert(discountBp.end(), capturedDiscountBp.begin() + priced, capturedDiscountBp.end());
+    }
+    amount.resize(n);
+    orderAmount.assign(orderIds.size(), 0);
+    orderTotalCents.resize(orderIds.size());
+
+    // Pass 1 (vectorisable): every line's own amount; bundles start at zero
+    std::int64_t *lineAmount = amount.data();
+    const std::int64_t *unit = unitCents.data();
+    const std::int64_t *pot = potCents.data();
+    const std::int32_t *qty = quantity.data();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        lineAmount[i] = (unit[i] + pot[i]) * qty[i] * SCALE;
+    }
+
+    // Pass 2: children follow their bundle, so a reverse sweep finishes each bundle before its parent sees it
+    for (std::size_t i = n; i-- > 0;)
+    {
+        std::int64_t value = lineAmount[i];
+        if (isBundle[i])
+        {
+            value = roundDiv(value * (BASIS_POINTS - discountBp[i]), BASIS_POINTS) * qty[i];
+            lineAmount[i] = value;
+        }
+        if (parent[i] >= 0)
+        {
+            lineAmount[parent[i]] += value;
+        }
+        else
+        {
+            orderAmount[orderSlot[i]] += value;
+        }
+    }
+
+    // Pass 3 (vectorisable): one rounding to cents per order
+    for (std::size_t o = 0; o < orderAmount.size(); ++o)
+    {
+        orderTotalCents[o] = roundDiv(orderAmount[o], SCALE);
+    }
+}
+
+std::int64_t BatchPricingEngine::getOrderTotalCents(std::size_t slot) const
+{
+    return slot < orderTotalCents.size() ? orderTotalCents[slot] : 0;
+}
+
+const std::vector<std::int64_t> &BatchPricingEngine::getOrderTotalsCents() const
+{
+    return orderTotalCents;
+}
+
+std::int64_t BatchPricingEngine::getGrandTotalCents() const
+{
+    std::int64_t total = 0;
+    for (std::size_t o = 0; o < orderTotalCents.size(); ++o)
+    {
+        total += orderTotalCents[o];
+    }
+    return total;
+}
+
+const std::string &BatchPricingEngine::getOrderId(std::size_t slot) const
+{
+    return orderIds.at(slot);
+}
+
+std::size_t BatchPricingEngine::getOrderCount() const
+{
+    return orderIds.size();
+}
+
+std::size_t BatchPricingEngine::getItemCount() const
+{
+    return quantity.size();
+}
+
+std::int64_t BatchPricingEngine::toCents(double amount)
+{
+    return static_cast<std::int64_t>(std::llround(amount * 100.0));
+}
+
+std::int32_t BatchPricingEngine::toBasisPoints(double percent)
+{
+    return static_cast<std::int32_t>(std::llround(percent * 100.0));
+}
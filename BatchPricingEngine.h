@@ -0,0 +1,119 @@
+#ifndef BATCH_PRICING_ENGINE_H
+#define BATCH_PRICING_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Order;
+
+/**
+ * @class BatchPricingEngine
+ * @brief Reprices many orders at once from flattened, columnar item data
+ *
+ * addOrder() copies an order's flattening (see FlattenedOrder) into parallel
+ * arrays in pre-order (every bundle before its children): quantity, unit and
+ * pot price in integer cents, bundle discount in basis points, and the parent
+ * index. Totals are
+ * then computed with straight loops over those arrays instead of virtual
+ * getPrice() calls, so tens of thousands of carts can be requoted whenever
+ * the price list or discount tiers change.
+ *
+ * Arithmetic is exact integer fixed point: line amounts are carried in
+ * 1/10000ths of a cent, a single level of bundle discount is applied without
+ * any rounding, and each order total is rounded to the nearest cent (halves
+ * up) once at the end. This is Order::calculateTotalAmount() rounded to
+ * cents, except that an exact half-cent total, which the double sum may land
+ * just under, always rounds up here. (Bundles nested inside discounted
+ * bundles round at 1/10000 of a cent.)
+ */
+class BatchPricingEngine
+{
+public:
+    /** @brief Bundle discount applied when a bundle has at least minItems direct items */
+    struct DiscountTier
+    {
+        int minItems;
+        int basisPoints; // 1500 = 15%
+    };
+
+    /**
+     * @brief Price overrides applied by applyPriceList()
+     *
+     * Plant and pot types missing from the maps keep the price captured from
+     * the order. A non-empty tier list replaces every bundle's own discount.
+     */
+    struct PriceList
+    {
+        std::unordered_map<std::string, std::int64_t> plantCents;
+        std::unordered_map<std::string, std::int64_t> potCents;
+        std::vector<DiscountTier> bundleTiers;
+    };
+
+    static const std::int64_t SCALE = 10000; // internal units per cent
+
+    BatchPricingEngine();
+
+    void clear();
+    void reserve(std::size_t orders, std::size_t items);
+
+    /**
+     * @brief Flattens the order's items; returns the slot its totals are reported under
+     *
+     * Orders added after applyPriceList() start at their captured prices until it is applied again.
+     */
+    std::size_t addOrder(const Order &order);
+
+    /** @brief Re-prices every flattened item against the price list (captured prices are kept) */
+    void applyPriceList(const PriceList &prices);
+
+    /** @brief Returns every item to the prices captured from its order */
+    void resetPrices();
+
+    /** @brief Computes all order totals from the current columns */
+    void computeTotals();
+
+    std::int64_t getOrderTotalCents(std::size_t slot) const;
+    const std::vector<std::int64_t> &getOrderTotalsCents() const;
+    std::int64_t getGrandTotalCents() const;
+    const std::string &getOrderId(std::size_t slot) const;
+    std::size_t getOrderCount() const;
+    std::size_t getItemCount() const;
+
+    static std::int64_t toCents(double amount);
+    static std::int32_t toBasisPoints(double percent);
+
+private:
+    // One entry per flattened item, in pre-order
+    std::vector<std::int32_t> orderSlot;
+    std::vector<std::int32_t> parent; // -1 for top-level items
+    std::vector<std::int32_t> quantity;
+    std::vector<std::int32_t> plantType; // interned; -1 for bundles
+    std::vector<std::int32_t> potType;   // interned; -1 if no pot
+    std::vector<std::int32_t> childCount;
+    std::vector<std::uint8_t> isBundle;
+    std::vector<std::int64_t> capturedUnitCents;
+    std::vector<std::int64_t> capturedPotCents;
+    std::vector<std::int32_t> capturedDiscountBp;
+    std::vector<std::int64_t> unitCents;
+    std::vector<std::int64_t> potCents;
+    std::vector<std::int32_t> discountBp;
+    std::vector<std::int64_t> amount; // scratch for computeTotals, in 1/SCALE cents
+
+    // One entry per order
+    std::vector<std::string> orderIds;
+    std::vector<std::int64_t> orderAmount;
+    std::vector<std::int64_t> orderTotalCents;
+
+    std::unordered_map<std::string, std::int32_t> plantTypeIds;
+    std::unordered_map<std::string, std::int32_t> potTypeIds;
+    std::vector<std::string> plantTypeNames;
+    std::vector<std::string> potTypeNames;
+
+    std::int32_t intern(std::unordered_map<std::string, std::int32_t> &ids, std::vector<std::string> &names,
+                        const std::string &name);
+};
+
+#endif // BATCH_PRICING_ENGINE_H
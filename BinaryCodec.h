@@ -0,0 +1,155 @@
+#ifndef BINARY_CODEC_H
+#define BINARY_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/**
+ * @file BinaryCodec.h
+ * @brief Little helpers shared by the binary file formats
+ *
+ * BinaryWriter appends fixed-width values and length-prefixed strings to a
+ * std::string buffer; BinaryReader walks the same layout over a raw byte
+ * range (typically a MappedFile) with bounds checks on every read. Values are
+ * stored in host byte order - each format writes an endian marker in its
+ * header and refuses files produced on a machine with the other order.
+ */
+
+class BinaryWriter
+{
+private:
+    std::string &buffer;
+
+public:
+    explicit BinaryWriter(std::string &out) : buffer(out) {}
+
+    void writeBytes(const void *bytes, std::size_t count)
+    {
+        buffer.append(static_cast<const char *>(bytes), count);
+    }
+
+    void writeU8(std::uint8_t value) { writeBytes(&value, sizeof(value)); }
+    void writeU16(std::uint16_t value) { writeBytes(&value, sizeof(value)); }
+    void writeU32(std::uint32_t value) { writeBytes(&value, sizeof(value)); }
+    void writeU64(std::uint64_t value) { writeBytes(&value, sizeof(value)); }
+    void writeI32(std::int32_t value) { writeBytes(&value, sizeof(value)); }
+    void writeI64(std::int64_t value) { writeBytes(&value, sizeof(value)); }
+    void writeDouble(double value) { writeBytes(&value, sizeof(value)); }
+
+    void writeString(const std::string &value)
+    {
+        writeU32(static_cast<std::uint32_t>(value.size()));
+        buffer.append(value);
+    }
+
+    std::size_t size() const { return buffer.size(); }
+
+    // Overwrites a previously written u32 (used to back-patch lengths)
+    void patchU32(std::size_t offset, std::uint32_t value)
+    {
+        std::memcpy(&buffer[offset], &value, sizeof(value));
+    }
+};
+
+class BinaryReader
+{
+private:
+    const char *cursor;
+    const char *end;
+    bool valid;
+
+    bool readRaw(void *out, std::size_t count)
+    {
+        if (!valid || static_cast<std::size_t>(end - cursor) < count)
+        {
+            valid = false;
+            return false;
+        }
+        std::memcpy(out, cursor, count);
+        cursor += count;
+        return true;
+    }
+
+public:
+    BinaryReader(const char *begin, std::size_t length) : cursor(begin), end(begin + length), valid(begin != nullptr || length == 0) {}
+
+    bool readU8(std::uint8_t &value) { return readRaw(&value, sizeof(value)); }
+    bool readU16(std::uint16_t &value) { return readRaw(&value, sizeof(value)); }
+    bool readU32(std::uint32_t &value) { return readRaw(&value, sizeof(value)); }
+    bool readU64(std::uint64_t &value) { return readRaw(&value, sizeof(value)); }
+    bool readI32(std::int32_t &value) { return readRaw(&value, sizeof(value)); }
+    bool readI64(std::int64_t &value) { return readRaw(&value, sizeof(value)); }
+    bool readDouble(double &value) { return readRaw(&value, sizeof(value)); }
+
+    bool readString(std::string &value)
+    {
+        std::uint32_t length = 0;
+        if (!readU32(length) || static_cast<std::size_t>(end - cursor) < length)
+        {
+            valid = false;
+            return false;
+        }
+        value.assign(cursor, length);
+        cursor += length;
+        return true;
+    }
+
+    bool skip(std::size_t count)
+    {
+        if (!valid || static_cast<std::size_t>(end - cursor) < count)
+        {
+            valid = false;
+            return false;
+        }
+        cursor += count;
+        return true;
+    }
+
+    const char *position() const { return cursor; }
+    std::size_t remaining() const { return static_cast<std::size_t>(end - cursor); }
+    bool ok() const { return valid; }
+    bool atEnd() const { return valid && cursor == end; }
+};
+
+struct Crc32Table
+{
+    std::uint32_t entries[256];
+
+    Crc32Table()
+    {
+        for (std::uint32_t i = 0; i < 256; ++i)
+        {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k)
+            {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            entries[i] = c;
+        }
+    }
+};
+
+/**
+ * @brief CRC-32 (IEEE 802.3 polynomial) used to detect torn or corrupted records
+ * @param bytes Data to checksum
+ * @param count Number of bytes
+ * @param seed Previous CRC when checksumming in pieces
+ */
+inline std::uint32_t computeCrc32(const char *bytes, std::size_t count, std::uint32_t seed = 0)
+{
+    static const Crc32Table table; // Thread-safe one-time initialisation (C++11)
+
+    std::uint32_t crc = seed ^ 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        crc = table.entries[(crc ^ static_cast<unsigned char>(bytes[i])) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Written into every header; reads back differently on a machine of the other byte order
+const std::uint32_t BINARY_ENDIAN_MARKER = 0x01020304u;
+
+#endif // BINARY_CODEC_H
@@ -0,0 +1,104 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+/**
+ * @class BoundedQueue
+ * @brief Blocking multi-producer, multi-consumer FIFO with a fixed capacity
+ *
+ * push() waits while the queue is full, which is how a slow consumer slows
+ * its producers down (backpressure) instead of letting work pile up without
+ * bound. close() wakes everyone: further pushes fail, and pop() keeps
+ * returning queued items until the queue is drained, then returns false.
+ */
+template <typename T>
+class BoundedQueue
+{
+private:
+    std::deque<T> items;
+    const std::size_t capacity;
+    bool closed;
+    mutable std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+
+public:
+    explicit BoundedQueue(std::size_t capacity) : capacity(capacity > 0 ? capacity : 1), closed(false)
+    {
+    }
+
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+    /** @brief Waits for room, then appends; false if the queue was closed */
+    bool push(const T &item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed)
+        {
+            return false;
+        }
+        items.push_back(item);
+        lock.unlock();
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /** @brief Appends only if there is room right now */
+    bool tryPush(const T &item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (closed || items.size() >= capacity)
+        {
+            return false;
+        }
+        items.push_back(item);
+        lock.unlock();
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /** @brief Waits for an item; false once the queue is closed and empty */
+    bool pop(T &item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty())
+        {
+            return false;
+        }
+        item = items.front();
+        items.pop_front();
+        lock.unlock();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return items.size();
+    }
+
+    std::size_t getCapacity() const
+    {
+        return capacity;
+    }
+};
+
+#endif // BOUNDED_QUEUE_H
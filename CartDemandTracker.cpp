@@ -0,0 +1,265 @@
+#include "CartDemandTracker.h"
+#include "OrderItem.h"
+
+#include <algorithm>
+#include <climits>
+
+CartDemandTracker::CartDemandTracker(InventoryManager &inventory)
+    : inventory(inventory), listenerId(0), shortLines(0), plantUnits(0), rechecks(0)
+{
+    listenerId = inventory.getChangeStream().addListener(
+        [this](const InventoryChangeEvent &event) { onInventoryChange(event); });
+}
+
+CartDemandTracker::~CartDemandTracker()
+{
+    inventory.getChangeStream().removeListener(listenerId);
+}
+
+void CartDemandTracker::updateItem(const OrderItem *item)
+{
+    if (!item)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    scratch.build(item);
+    Contribution next;
+    next.plants.assign(scratch.getSpeciesDemand().begin(), scratch.getSpeciesDemand().end());
+    next.pots.assign(scratch.getPotDemand().begin(), scratch.getPotDemand().end());
+    next.plantUnits = scratch.getPlantUnits();
+
+    // The new share goes on before the old comes off, so lines the item keeps are never dropped and re-read
+    Contribution &current = contributions[item];
+    applyLocked(next, 1);
+    applyLocked(current, -1);
+    current = next;
+}
+
+void CartDemandTracker::removeItem(const OrderItem *item)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<const OrderItem *, Contribution>::iterator it = contributions.find(item);
+    if (it != contributions.end())
+    {
+        applyLocked(it->second, -1);
+        contributions.erase(it);
+    }
+}
+
+void CartDemandTracker::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    contributions.clear();
+    plants.clear();
+    pots.clear();
+    stalePlants.clear();
+    stalePots.clear();
+    shortLines = 0;
+    plantUnits = 0;
+}
+
+bool CartDemandTracker::isSatisfiable()
+{
+    refresh();
+    std::lock_guard<std::mutex> lock(mutex);
+    return shortLines == 0;
+}
+
+std::vector<InventoryManager::StockShortage> CartDemandTracker::getShortages()
+{
+    refresh();
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<InventoryManager::StockShortage> shortages;
+    for (const Lines::value_type &line : plants)
+    {
+        if (line.second.isShort)
+        {
+            InventoryManager::StockShortage shortage = {line.first, false, line.second.demand, line.second.available};
+            shortages.push_back(shortage);
+        }
+    }
+    for (const Lines::value_type &line : pots)
+    {
+        if (line.second.isShort)
+        {
+            InventoryManager::StockShortage shortage = {line.first, true, line.second.demand, line.second.available};
+            shortages.push_back(shortage);
+        }
+    }
+    std::sort(shortages.begin(), shortages.end(),
+              [](const InventoryManager::StockShortage &a, const InventoryManager::StockShortage &b) {
+                  return a.isPot != b.isPot ? b.isPot : a.itemType < b.itemType;
+              });
+    return shortages;
+}
+
+int CartDemandTracker::getPlantUnits() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return plantUnits;
+}
+
+std::size_t CartDemandTracker::getLineCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return plants.size() + pots.size();
+}
+
+std::uint64_t CartDemandTracker::getRecheckCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return rechecks;
+}
+
+// Runs on whichever thread changed the inventory, with the inventory locked: only flags the line
+void CartDemandTracker::onInventoryChange(const InventoryChangeEvent &event)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!event.species.empty())
+    {
+        markStaleLocked(plants, stalePlants, event.species);
+    }
+    if (!event.potType.empty())
+    {
+        markStaleLocked(pots, stalePots, event.potType);
+    }
+}
+
+void CartDemandTracker::applyLocked(const Contribution &contribution, int sign)
+{
+    for (const std::pair<std::string, int> &plant : contribution.plants)
+    {
+        adjustLocked(plants, stalePlants, plant.first, sign * plant.second);
+    }
+    for (const std::pair<std::string, int> &pot : contribution.pots)
+    {
+        adjustLocked(pots, stalePots, pot.first, sign * pot.second);
+    }
+    plantUnits += sign * contribution.plantUnits;
+}
+
+void CartDemandTracker::adjustLocked(Lines &lines, std::vector<std::string> &stale, const std::string &type,
+                                     int delta)
+{
+    Lines::iterator it = lines.find(type);
+    if (it == lines.end())
+    {
+        if (delta <= 0)
+        {
+            return;
+        }
+        Line line = {0, 0, false, false};
+        it = lines.insert(std::make_pair(type, line)).first;
+        markStaleLocked(lines, stale, type); // nothing known about its stock yet
+    }
+
+    Line &line = it->second;
+    line.demand += delta;
+    if (line.demand <= 0)
+    {
+        if (line.isShort)
+        {
+            --shortLines;
+        }
+        lines.erase(it); // refresh() skips it if it is still listed as stale
+        return;
+    }
+    if (!line.stale)
+    {
+        setAvailableLocked(line, line.available);
+    }
+}
+
+void CartDemandTracker::markStaleLocked(Lines &lines, std::vector<std::string> &stale, const std::string &type)
+{
+    Lines::iterator it = lines.find(type);
+    if (it != lines.end() && !it->second.stale)
+    {
+        it->second.stale = true;
+        stale.push_back(type);
+    }
+}
+
+void CartDemandTracker::setAvailableLocked(Line &line, int available)
+{
+    line.available = available;
+    bool isShort = line.demand > available;
+    if (isShort != line.isShort)
+    {
+        line.isShort = isShort;
+        if (isShort)
+        {
+            ++shortLines;
+        }
+        else
+        {
+            --shortLines;
+        }
+    }
+}
+
+void CartDemandTracker::refresh()
+{
+    std::vector<std::string> plantTypes;
+    std::vector<std::string> potTypes;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stalePlants.empty() && stalePots.empty())
+        {
+            return;
+        }
+        plantTypes.swap(stalePlants);
+        potTypes.swap(stalePots);
+        for (const std::string &type : plantTypes)
+        {
+            Lines::iterator it = plants.find(type);
+            if (it != plants.end())
+            {
+                it->second.stale = false;
+            }
+        }
+        for (const std::string &type : potTypes)
+        {
+            Lines::iterator it = pots.find(type);
+            if (it != pots.end())
+            {
+                it->second.stale = false;
+            }
+        }
+    }
+
+    // Read without holding the lock, since the inventory calls onInventoryChange() while holding its own
+    std::vector<int> plantCounts;
+    std::vector<int> potCounts;
+    plantCounts.reserve(plantTypes.size());
+    potCounts.reserve(potTypes.size());
+    for (const std::string &type : plantTypes)
+    {
+        plantCounts.push_back(inventory.getAvailablePlantCount(type));
+    }
+    for (const std::string &type : potTypes)
+    {
+        potCounts.push_back(inventory.isStockedPotType(type) ? inventory.getAvailablePotCount(type) : INT_MAX);
+    }
+
+    // A line that moved again meanwhile has been flagged again and is read once more next time
+    std::lock_guard<std::mutex> lock(mutex);
+    for (std::size_t i = 0; i < plantTypes.size(); ++i)
+    {
+        Lines::iterator it = plants.find(plantTypes[i]);
+        if (it != plants.end())
+        {
+            setAvailableLocked(it->second, plantCounts[i]);
+        }
+    }
+    for (std::size_t i = 0; i < potTypes.size(); ++i)
+    {
+        Lines::iterator it = pots.find(potTypes[i]);
+        if (it != pots.end())
+        {
+            setAvailableLocked(it->second, potCounts[i]);
+        }
+    }
+    rechecks += plantTypes.size() + potTypes.size();
+}
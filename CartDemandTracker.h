@@ -0,0 +1,105 @@
+#ifndef CART_DEMAND_TRACKER_H
+#define CART_DEMAND_TRACKER_H
+
+#include "FlattenedOrder.h"
+#include "InventoryChangeStream.h"
+#include "InventoryManager.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class OrderItem;
+
+/**
+ * @class CartDemandTracker
+ * @brief Live stock check for an order that is still being built
+ *
+ * Keeps the cart's plant and pot demand as a running total, updated one
+ * top-level item at a time as lines are added, edited or removed, and keeps
+ * the sales-floor availability of every species and pot type in the cart
+ * next to it. An edit only looks at the lines whose demand it changed, and
+ * only lines that are new to the cart are read from the inventory.
+ *
+ * Availability is not polled: the tracker listens on the inventory's
+ * InventoryChangeStream and marks a line stale when stock of that type moves
+ * (sold, reserved, released, added or removed). isSatisfiable() re-reads just
+ * the stale lines, so on an unchanged floor it answers in constant time.
+ *
+ * Order::trackDemand() attaches one to a cart; OrderValidationHandler then
+ * rejects a short cart without touching the inventory. The answer is advisory:
+ * stock can still move before checkout, which is why checkout goes on to
+ * reserve the order atomically.
+ */
+class CartDemandTracker
+{
+public:
+    explicit CartDemandTracker(InventoryManager &inventory = InventoryManager::getInstance());
+    ~CartDemandTracker();
+
+    CartDemandTracker(const CartDemandTracker &) = delete;
+    CartDemandTracker &operator=(const CartDemandTracker &) = delete;
+
+    /** @brief Sets a top-level item's share of the demand to what it holds now (new, or edited since) */
+    void updateItem(const OrderItem *item);
+    void removeItem(const OrderItem *item);
+    void clear();
+
+    /** @brief Whether stock on the floor covers the whole cart */
+    bool isSatisfiable();
+
+    /** @brief Every species and pot type the cart needs more of than is available, by name */
+    std::vector<InventoryManager::StockShortage> getShortages();
+
+    int getPlantUnits() const;
+    std::size_t getLineCount() const;
+    /** @brief Lines read from the inventory so far, whether new to the cart or invalidated */
+    std::uint64_t getRecheckCount() const;
+
+private:
+    struct Line
+    {
+        int demand;
+        int available;
+        bool isShort;
+        bool stale; // availability must be read again before it is trusted
+    };
+    typedef std::unordered_map<std::string, Line> Lines;
+
+    /** @brief What one top-level item adds to the cart */
+    struct Contribution
+    {
+        std::vector<std::pair<std::string, int> > plants;
+        std::vector<std::pair<std::string, int> > pots;
+        int plantUnits;
+
+        Contribution() : plantUnits(0) {}
+    };
+
+    InventoryManager &inventory;
+    InventoryChangeStream::ListenerId listenerId;
+
+    std::unordered_map<const OrderItem *, Contribution> contributions;
+    Lines plants;
+    Lines pots;
+    std::vector<std::string> stalePlants;
+    std::vector<std::string> stalePots;
+    std::size_t shortLines;
+    int plantUnits;
+    std::uint64_t rechecks;
+    FlattenedOrder scratch; // reused to flatten one item at a time
+    mutable std::mutex mutex;
+
+    void onInventoryChange(const InventoryChangeEvent &event);
+    void applyLocked(const Contribution &contribution, int sign);
+    void adjustLocked(Lines &lines, std::vector<std::string> &stale, const std::string &type, int delta);
+    void markStaleLocked(Lines &lines, std::vector<std::string> &stale, const std::string &type);
+    void setAvailableLocked(Line &line, int available);
+    void refresh();
+};
+
+#endif // CART_DEMAND_TRACKER_H
@@ -1,5 +1,6 @@
 // CashAdaptee.cpp
 #include "CashAdaptee.h"
+#include "IdGenerator.h"
 #include <string>
 
 CashAdaptee::CashAdaptee() {}
@@ -7,8 +8,7 @@ CashAdaptee::~CashAdaptee() {}
 
 bool CashAdaptee::processCashTransaction(double amount, std::string& receiptId)
 {
-    static int counter = 0;
-    receiptId = "CASH-" + std::to_string(++counter);
+    receiptId = IdGenerator::getInstance().nextId("CASH-");
     // For demo: always succeed
     return true;
 }
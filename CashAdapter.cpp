@@ -1,6 +1,7 @@
 // CashAdapter.cpp
 #include "CashAdapter.h"
 #include "CashAdaptee.h"
+#include "PaymentLedger.h"
 #include <iostream>
 
 using std::cout;
@@ -11,16 +12,32 @@ CashAdapter::~CashAdapter() = default;
 
 bool CashAdapter::processPayment(double amount, const std::string& customerId, const std::string& payload)
 {
+    PaymentRequest request;
+    request.amount = amount;
+    request.customerId = customerId;
+    request.payload = payload;
+    return processRequest(request);
+}
+
+bool CashAdapter::processRequest(const PaymentRequest& request)
+{
+    const double amount = request.amount;
+    const std::string& customerId = request.customerId;
+    const std::string& payload = request.payload;
+
     // treat "CASH" or empty as cash payment
     if (payload == "CASH" || payload.empty()) {
         std::string receipt;
         bool ok = adaptee->processCashTransaction(amount, receipt);
         if (ok) {
+            PaymentLedger::getInstance().recordPayment("CASH", receipt, request.orderId, customerId, amount,
+                                                       request.plantUnits);
             cout << "[CashAdapter] Cash payment processed for " << customerId
                  << ", amount: R" << amount << ", receipt: " << receipt << endl;
             return true;
         }
         cout << "[CashAdapter] Cash payment failed for " << customerId << endl;
+        PaymentLedger::getInstance().recordDecline("CASH", request.orderId, customerId, amount);
         return false;
     }
 
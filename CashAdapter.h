@@ -39,6 +39,13 @@ public:
      * @return true on successful processing, false otherwise
      */
     bool processPayment(double amount, const std::string& customerId, const std::string& payload) override;
+
+    /**
+     * @brief Process a cash payment for a known order, recording it in the PaymentLedger
+     * @param request Amount, customer, payload, order and plant count of the payment
+     * @return true on successful processing, false otherwise
+     */
+    bool processRequest(const PaymentRequest& request) override;
 };
 
 #endif // CASHADAPTER_H
@@ -2,9 +2,7 @@
 #include "Command.h"
 #include "MoveToSalesFloorCommand.h"
 #include "Customer.h"
-#include "OrderItem.h"
-#include "SinglePlant.h"
-#include "PlantBundle.h"
+#include "Order.h"
 #include "InventoryManager.h"
 #include <iostream>
 #include <thread>
@@ -86,57 +84,6 @@ bool Cashier::validateOrder(Order* order, Customer* customer) {
         return false;
     }
     
-    // Get available plants from inventory
-    InventoryManager& inventory = InventoryManager::getInstance();
-    std::vector<PlantProduct*> availablePlants = inventory.getReadyForSalePlants();
-    
-    if (availablePlants.empty()) {
-        return false;
-    }
-    
-    // Validate each order item
-    std::vector<OrderItem*> orderItems = order->getOrderItems();
-    for (size_t i = 0; i < orderItems.size(); ++i) {
-        OrderItem* item = orderItems[i];
-        
-        // Check if it's a SinglePlant
-        SinglePlant* singlePlant = dynamic_cast<SinglePlant*>(item);
-        if (singlePlant) {
-            // Count matching plants in inventory
-            int availableCount = 0;
-            for (size_t j = 0; j < availablePlants.size(); ++j) {
-                if (availablePlants[j]->getProfile()->getSpeciesName() == singlePlant->getPlantType()) {
-                    ++availableCount;
-                }
-            }
-            
-            if (availableCount < singlePlant->getQuantity()) {
-                return false;
-            }
-        }
-        
-        // Check if it's a PlantBundle
-        PlantBundle* bundle = dynamic_cast<PlantBundle*>(item);
-        if (bundle) {
-            std::vector<OrderItem*> bundleItems = bundle->getItems();
-            
-            for (size_t j = 0; j < bundleItems.size(); ++j) {
-                SinglePlant* bundlePlant = dynamic_cast<SinglePlant*>(bundleItems[j]);
-                if (bundlePlant) {
-                    int availableCount = 0;
-                    for (size_t k = 0; k < availablePlants.size(); ++k) {
-                        if (availablePlants[k]->getProfile()->getSpeciesName() == bundlePlant->getPlantType()) {
-                            ++availableCount;
-                        }
-                    }
-                    
-                    if (availableCount < bundlePlant->getQuantity()) {
-                        return false;
-                    }
-                }
-            }
-        }
-    }
-    
-    return true;
+    // Indexed per-species and per-pot counts against the order's totals; nothing is held here
+    return InventoryManager::getInstance().checkOrderStock(order->getFlattened(), nullptr);
 }
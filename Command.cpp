@@ -1,12 +1,29 @@
 #include "Command.h"
+#include "IdGenerator.h"
 
 // Definition and initialization of the static map from the Command base class.
 std::map<std::string, Command*> Command::prototypes;
 
-Command::Command() : plantReceiver(nullptr) {}
+Command::Command() : plantReceiver(nullptr), commandId(IdGenerator::getInstance().next()) {}
+
+Command::Command(const Command& other)
+    : plantReceiver(other.plantReceiver), commandId(IdGenerator::getInstance().next()) {}
+
+Command& Command::operator=(const Command& other) {
+    plantReceiver = other.plantReceiver; // keeps its own ID
+    return *this;
+}
 
 Command::~Command() {}
 
+std::uint64_t Command::getCommandId() const {
+    return commandId;
+}
+
+std::string Command::getCommandIdString() const {
+    return IdGenerator::format("CMD-", commandId);
+}
+
 void Command::registerCommand(const std::string& type, Command* prototype) {
     prototypes[type] = prototype;
 }
@@ -2,6 +2,7 @@
 #define COMMAND_H
 
 #include "PlantProduct.h"
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <map>
@@ -16,12 +17,18 @@ class Command {
 
     protected:
         PlantProduct* plantReceiver;
+        std::uint64_t commandId; // from IdGenerator; also orders commands by creation time
 
     public:
         Command();
+        Command(const Command& other); // clones get their own ID
+        Command& operator=(const Command& other);
        
         virtual ~Command();
 
+        std::uint64_t getCommandId() const;
+        std::string getCommandIdString() const; // "CMD-..." form for logs
+
         virtual void execute() = 0;
         
         virtual std::string getType() const = 0;
@@ -2,11 +2,10 @@
 #include "Order.h"
 #include "SinglePlant.h"
 #include "PlantBundle.h"
-#include <sstream>
-#include <ctime>
+#include "IdGenerator.h"
 
 ConcreteOrderBuilder::ConcreteOrderBuilder(const std::string& customerName)
-    : currentOrder(nullptr), customerName(customerName), orderCounter(0) {
+    : currentOrder(nullptr), customerName(customerName) {
     // Don't create an order until it's actually needed - this prevents memory leaks
 }
 
@@ -15,10 +14,9 @@ ConcreteOrderBuilder::~ConcreteOrderBuilder() {
     delete currentOrder;
 }
 
+// Shared across builders and threads, so concurrent customers never collide
 std::string ConcreteOrderBuilder::generateOrderId() {
-    std::ostringstream oss;
-    oss << "ORD-" << time(nullptr) << "-" << (++orderCounter);
-    return oss.str();
+    return IdGenerator::getInstance().nextId("ORD-");
 }
 
 void ConcreteOrderBuilder::buildPlant(const std::string& plantType, int quantity) {
@@ -26,7 +24,7 @@ void ConcreteOrderBuilder::buildPlant(const std::string& plantType, int quantity
         reset();
     }
     
-    SinglePlant* plant = new SinglePlant(plantType, 25.99, quantity);
+    SinglePlant* plant = new (currentOrder->getItemArena()) SinglePlant(plantType, 25.99, quantity);
     currentOrder->addOrderItem(plant);
 }
 
@@ -37,7 +35,7 @@ void ConcreteOrderBuilder::buildPlantPot(const std::string& potType, int quantit
         reset();
     }
     
-    SinglePlant* pot = new SinglePlant(potType + " Pot", 12.99, quantity);
+    SinglePlant* pot = new (currentOrder->getItemArena()) SinglePlant(potType + " Pot", 12.99, quantity);
     currentOrder->addOrderItem(pot);
 }
 
@@ -46,7 +44,7 @@ void ConcreteOrderBuilder::buildBundle(const std::string& bundleType, int quanti
         reset();
     }
     
-    PlantBundle* bundle = new PlantBundle(bundleType, bundleType, quantity, 15.0);
+    PlantBundle* bundle = new (currentOrder->getItemArena()) PlantBundle(bundleType, bundleType, quantity, 15.0);
     currentOrder->addOrderItem(bundle);
 }
 
@@ -73,7 +71,7 @@ void ConcreteOrderBuilder::buildPlantWithPot(const std::string& plantType,
         reset();
     }
     
-    SinglePlant* plant = new SinglePlant(plantType, 25.99, quantity, size);
+    SinglePlant* plant = new (currentOrder->getItemArena()) SinglePlant(plantType, 25.99, quantity, size);
     plant->addPot(potType, 12.99);
     currentOrder->addOrderItem(plant);
 }
@@ -85,7 +83,7 @@ void ConcreteOrderBuilder::buildCustomBundle(const std::string& bundleName,
         reset();
     }
     
-    PlantBundle* bundle = new PlantBundle(bundleName, bundleType, 1, discount);
+    PlantBundle* bundle = new (currentOrder->getItemArena()) PlantBundle(bundleName, bundleType, 1, discount);
     currentOrder->addOrderItem(bundle);
 }
 
@@ -104,7 +102,7 @@ void ConcreteOrderBuilder::addPlantToCurrentBundle(const std::string& plantType,
     
     // Check if it's a bundle
     if (PlantBundle* bundle = dynamic_cast<PlantBundle*>(lastItem)) {
-        SinglePlant* plant = new SinglePlant(plantType, 25.99, quantity, size);
+        SinglePlant* plant = new (currentOrder->getItemArena()) SinglePlant(plantType, 25.99, quantity, size);
         bundle->addItem(plant);
     }
 }
@@ -123,7 +121,7 @@ void ConcreteOrderBuilder::addPlantWithPotToCurrentBundle(const std::string& pla
     OrderItem* lastItem = items.back();
     
     if (PlantBundle* bundle = dynamic_cast<PlantBundle*>(lastItem)) {
-        SinglePlant* plant = new SinglePlant(plantType, 25.99, quantity, size);
+        SinglePlant* plant = new (currentOrder->getItemArena()) SinglePlant(plantType, 25.99, quantity, size);
         plant->addPot(potType, 12.99);
         bundle->addItem(plant);
     }
@@ -133,6 +131,10 @@ bool ConcreteOrderBuilder::hasCurrentOrder() const {
     return currentOrder != nullptr && !currentOrder->isEmpty();
 }
 
+Order* ConcreteOrderBuilder::getCurrentOrder() const {
+    return currentOrder;
+}
+
 std::string ConcreteOrderBuilder::getCurrentCustomerName() const {
     return customerName;
 }
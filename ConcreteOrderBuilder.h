@@ -17,7 +17,6 @@ class ConcreteOrderBuilder : public OrderBuilder {
 private:
     Order* currentOrder;
     std::string customerName;
-    int orderCounter;
     
     // Helper method to generate unique order ID
     std::string generateOrderId();
@@ -49,6 +48,7 @@ public:
     
     // Utility methods
     bool hasCurrentOrder() const;
+    Order* getCurrentOrder() const; // the order being built, still owned by the builder; may be null
     std::string getCurrentCustomerName() const;
 };
 
@@ -1,5 +1,6 @@
 // CreditCardAdaptee.cpp
 #include "CreditCardAdaptee.h"
+#include "IdGenerator.h"
 #include <string>
 
 CreditCardAdaptee::CreditCardAdaptee() {}
@@ -7,8 +8,7 @@ CreditCardAdaptee::~CreditCardAdaptee() {}
 
 bool CreditCardAdaptee::processCreditCardTransaction(const std::string& cardNumber,const std::string& expiry,const std::string& cvc,double amount,std::string& receiptId)
 {
-    static int counter = 0;
-    receiptId = "CC-" + std::to_string(++counter);
-    // For demo: always succeed
+    receiptId = IdGenerator::getInstance().nextId("CC-");
+    // For demo: always authorize; SettlementEngine settles authorizations in batches
     return true;
 }
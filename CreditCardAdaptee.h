@@ -8,7 +8,7 @@ class CreditCardAdaptee {
 public:
     CreditCardAdaptee();
     ~CreditCardAdaptee();
-    // returns true on success, writes receiptId
+    // authorizes (does not settle) the charge; returns true on success, writes the authorization code to receiptId
     bool processCreditCardTransaction(const std::string& cardNumber,const std::string& expiry,const std::string& cvc,double amount,std::string& receiptId);
 };
 
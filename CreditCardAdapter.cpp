@@ -1,6 +1,8 @@
 // CreditCardAdapter.cpp
 #include "CreditCardAdapter.h"
 #include "CreditCardAdaptee.h"
+#include "PaymentLedger.h"
+#include "SettlementEngine.h"
 #include <iostream>
 
 using namespace std;
@@ -11,11 +13,24 @@ CreditCardAdapter::CreditCardAdapter(CreditCardAdaptee* adaptee) : adaptee(adapt
 CreditCardAdapter::~CreditCardAdapter() {}
 
 bool CreditCardAdapter::processPayment(double amount, const std::string& customerId, const std::string& payload) {
+    PaymentRequest request;
+    request.amount = amount;
+    request.customerId = customerId;
+    request.payload = payload;
+    return processRequest(request);
+}
+
+bool CreditCardAdapter::processRequest(const PaymentRequest& request) {
+    const double amount = request.amount;
+    const std::string& customerId = request.customerId;
+    const std::string& payload = request.payload;
+
     // expect payload format "cardNumber;expiry;cvc"
     size_t pos1 = payload.find(';');
     size_t pos2 = payload.rfind(';');
     if (pos1 == std::string::npos || pos2 == std::string::npos || pos1 == pos2) {
         cout << "[CreditCardAdapter] Invalid payload format for credit card." << endl;
+        PaymentLedger::getInstance().recordDecline("CREDIT_CARD", request.orderId, customerId, amount);
         return false;
     }
 
@@ -26,11 +41,15 @@ bool CreditCardAdapter::processPayment(double amount, const std::string& custome
     std::string receipt;
     bool ok = adaptee->processCreditCardTransaction(card, expiry, cvc, amount, receipt);
     if (ok) {
-        cout << "[CreditCardAdapter] Credit card payment processed for " << customerId
-             << ", amount: R" << amount << ", receipt: " << receipt << endl;
+        SettlementEngine::getInstance().recordAuthorization(receipt, "CREDIT_CARD", request.orderId, customerId, amount);
+        PaymentLedger::getInstance().recordPayment("CREDIT_CARD", receipt, request.orderId, customerId, amount,
+                                                   request.plantUnits);
+        cout << "[CreditCardAdapter] Credit card payment authorized for " << customerId
+             << ", amount: R" << amount << ", authorization: " << receipt << endl;
         return true;
     }
 
     cout << "[CreditCardAdapter] Credit card payment failed for " << customerId << endl;
+    PaymentLedger::getInstance().recordDecline("CREDIT_CARD", request.orderId, customerId, amount);
     return false;
 }
\ No newline at end of file
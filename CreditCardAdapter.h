@@ -11,7 +11,9 @@ class CreditCardAdaptee;
  * @brief Adapter for credit/debit card payment integration
  *
  * Translates the generic PaymentProcessor interface into calls against
- * the legacy CreditCardAdaptee implementation.
+ * the legacy CreditCardAdaptee implementation. The card is only authorized;
+ * the authorization is recorded with the SettlementEngine, which settles it
+ * in the next settlement batch.
  */
 class CreditCardAdapter : public PaymentProcessor {
 private:
@@ -39,6 +41,13 @@ public:
      * @return true on success, false otherwise
      */
     bool processPayment(double amount, const std::string& customerId, const std::string& payload) override;
+
+    /**
+     * @brief Authorize a card payment for a known order
+     * @param request Amount, customer, card details and the order being paid for
+     * @return true if the card was authorized
+     */
+    bool processRequest(const PaymentRequest& request) override;
 };
 
 #endif // CREDITCARDADAPTER_H test_memento_adapter
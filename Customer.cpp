@@ -9,7 +9,9 @@
 #include "CustomerObserver.h"
 #include "PlantSpeciesProfile.h"
 #include "OrderHistory.h"
+#include "OrderStore.h"
 #include "StaffManager.h"
+#include "SuggestionTemplate/BouquetSuggestionFactory.h"
 #include <iostream>
 #include <iomanip>
 
@@ -143,67 +145,12 @@ bool Customer::addPlantToOrder(int plantIndex, int quantity) {
     return uiFacade->addPlantToOrderWithAutoDiscount(plantIndex, quantity);
 }
 
-bool Customer::addBundleToOrder(const std::string& bundleName, const std::vector<int>& plantIndices, double discount) {
-    auto availablePlants = getAvailablePlantsFromInventory();
-    
-    if (plantIndices.empty()) {
-        std::cout << "[ERROR] Bundle must contain at least one plant." << std::endl;
-        return false;
-    }
-    
-    // Validate all indices
-    for (int index : plantIndices) {
-        if (index < 1 || index > static_cast<int>(availablePlants.size())) {
-            std::cout << "[ERROR] Invalid plant number " << index << ". Please choose between 1 and " 
-                      << availablePlants.size() << std::endl;
-            return false;
-        }
-    }
-    
-    std::cout << "\n[BUNDLE] Creating bundle: " << bundleName << " with " << discount << "% discount" << std::endl;
-    
-    // Notify staff of bundle creation
-    notifyStaffOfInteraction("BundleCreation", 
-        "Customer creating " + bundleName + " with " + std::to_string(plantIndices.size()) + " plants");
-    
-    // Use builder to create bundle
-    ConcreteOrderBuilder* concreteBuilder = dynamic_cast<ConcreteOrderBuilder*>(orderBuilder);
-    if (concreteBuilder) {
-        concreteBuilder->buildCustomBundle(bundleName, "Mixed", discount);
-        
-        // Add each plant to the bundle
-        for (int index : plantIndices) {
-            PlantProduct* plant = availablePlants[index - 1];
-            std::string plantType = plant->getProfile()->getSpeciesName();
-            concreteBuilder->addPlantToCurrentBundle(plantType, 1);
-            std::cout << "  [OK] Added " << plantType << " to bundle" << std::endl;
-        }
-    }
-    
-    std::cout << "[BUNDLE] Bundle created successfully!" << std::endl;
+bool Customer::addBundleToOrder(const std::string& bundleName, const std::vector<int>& plantIndices) {
+    // Delegate to facade which validates the indices, picks the automatic bundle
+    // discount, notifies staff and builds the bundle via the builder
     return uiFacade->addBundleToOrderWithAutoDiscount(bundleName, plantIndices);
 }
 
-void Customer::viewCurrentOrder() {
-    ConcreteOrderBuilder* concreteBuilder = dynamic_cast<ConcreteOrderBuilder*>(orderBuilder);
-    if (!concreteBuilder || !concreteBuilder->hasCurrentOrder()) {
-        std::cout << "\n[ORDER] Your order is currently empty." << std::endl;
-        std::cout << "[INFO] Use displayAvailableItems() to see what's available!" << std::endl;
-        return;
-    }
-    
-    std::cout << "\n=== YOUR CURRENT ORDER ===" << std::endl;
-    // Get a temporary order to display
-    Order* tempOrder = orderBuilder->getOrder();
-    if (tempOrder && !tempOrder->isEmpty()) {
-        std::cout << tempOrder->getOrderSummary() << std::endl;
-        std::cout << "[TOTAL] Total: $" << std::fixed << std::setprecision(2) 
-                  << tempOrder->getTotalAmount() << std::endl;
-    } else {
-        std::cout << "[ORDER] Order is empty." << std::endl;
-    }
-}
-
 bool Customer::finalizeOrder() {
     ConcreteOrderBuilder* concreteBuilder = dynamic_cast<ConcreteOrderBuilder*>(orderBuilder);
     if (!concreteBuilder || !concreteBuilder->hasCurrentOrder()) {
@@ -229,11 +176,19 @@ bool Customer::finalizeOrder() {
     return true;
 }
 
+OrderUIFacade* Customer::getUIFacade() {
+    return uiFacade;
+}
+
 // Public method to get access to the builder for building the order
 ConcreteOrderBuilder* Customer::getOrderBuilder() {
     return dynamic_cast<ConcreteOrderBuilder*>(orderBuilder);
 }
 
+Order* Customer::getCurrentOrder() const {
+    return orderProduct;
+}
+
 // ============= Observer Pattern Implementation (Pure Pattern) =============
 
 // Override from CustomerSubject - notifies all observers
@@ -280,25 +235,30 @@ void Customer::attachObserver(CustomerObserver* observer) {
     std::cout << "[SYSTEM] Staff observer registered for customer: " << name << std::endl;
 }
 
-void Customer::displayPlantDetails(const PlantProduct* plant, int index) {
-    std::cout << std::setw(3) << index << ". ";
+void Customer::detachObserver(CustomerObserver* observer) {
+    detach(observer);
+    if (observer == staffObserver) {
+        staffObserver = 0;
+    }
+    std::cout << "[SYSTEM] Staff observer removed for customer: " << name << std::endl;
+}
+
+// ============= Director-based Construction =============
+
+Order* Customer::construct() {
+    std::cout << "\n=== Constructing Order via Director ===" << std::endl;
     
-    if (plant && plant->getProfile()) {
-        std::cout << std::setw(15) << plant->getProfile()->getSpeciesName();
-        std::cout << " | State: " << std::setw(12) << plant->getCurrentStateName();
-        
-        // Display plant care requirements if available
-        std::string waterNeeds = plant->getProfile()->getProperty("idealWater");
-        std::string sunNeeds = plant->getProfile()->getProperty("idealSunlight");
-        
-        if (!waterNeeds.empty()) {
-            std::cout << " | Water: " << waterNeeds;
-        }
-        if (!sunNeeds.empty()) {
-            std::cout << " | Sun: " << sunNeeds;
-        }
-        
-        std::cout << " | $15.99"; // Default price - could be enhanced
+    // Clean up any previous order
+    cleanupPreviousOrder();
+    
+    // Notify observers
+    notifyInteraction("ORDER_CONSTRUCTION", "Constructing order via Director");
+    
+    // Use director to construct
+    orderProduct = orderDirector->construct();
+    
+    if (orderProduct) {
+        std::cout << "Order constructed successfully via Director!" << std::endl;
     } else {
         std::cout << "Failed to construct order via Director." << std::endl;
         notifyInteraction("ORDER_CONSTRUCTION_FAILED", "Director failed to build order");
@@ -401,12 +361,37 @@ void Customer::restoreLastOrder()
 
 void Customer::viewOrderHistory()
 {
-        std::cout << "\n=== ORDER HISTORY ===" << std::endl;
-    std::cout << "You can restore previous order states using restoreLastOrder()" << std::endl;
+    std::cout << "\n=== ORDER HISTORY ===" << std::endl;
+
+    // Past orders come from the on-disk order store, so they include earlier sessions
+    std::vector<StoredOrder> pastOrders = OrderStore::getInstance().getOrdersForCustomer(name);
+    if (pastOrders.empty())
+    {
+        std::cout << "No completed orders on record." << std::endl;
+    }
+    for (const StoredOrder& past : pastOrders)
+    {
+        std::cout << past.orderDate << "  " << past.orderId << "  " << past.itemCount << " item(s)  R"
+                  << std::fixed << std::setprecision(2) << past.totalAmount << "  [" << past.status << "]" << std::endl;
+    }
+
+    std::cout << "\nYou can restore previous order states using restoreLastOrder()" << std::endl;
     std::cout << "Current order: " << std::endl;
     viewCurrentOrder();
 }
 
+// Template Method pattern - event bouquet suggestions
+void Customer::browseBouquetSuggestions(const std::string& eventType) {
+    BouquetSuggestionTemplate* tmpl = BouquetSuggestionFactory::getInstance().getTemplate(eventType);
+    if (!tmpl) {
+        std::cout << "[ERROR] No bouquet suggestions for event: " << eventType << std::endl;
+        return;
+    }
+    
+    notifyInteraction("BouquetBrowsing", "Browsing " + eventType + " bouquet suggestions");
+    tmpl->generateSuggestions();
+}
+
 // Adapter pattern - payment processing //
 void Customer::initializePaymentSystems()
 {
@@ -439,7 +424,7 @@ void Customer::cleanupPaymentSystems() {
 }
 
 bool Customer::processPayment(const std::string& paymentType, double amount, 
-                              const std::string& paymentDetails) {
+                              const std::string& paymentDetails, const std::string& orderId, int plantUnits) {
     std::cout << "\n╔════════════════════════════════════════╗" << std::endl;
     std::cout << "║     PROCESSING PAYMENT                ║" << std::endl;
     std::cout << "╚════════════════════════════════════════╝" << std::endl;
@@ -458,7 +443,13 @@ bool Customer::processPayment(const std::string& paymentType, double amount,
     
     // Process payment through the adapter
     std::cout << "\n[Processing] Using " << paymentType << " adapter..." << std::endl;
-    bool success = it->second->processPayment(amount, email, paymentDetails);
+    PaymentRequest request;
+    request.amount = amount;
+    request.customerId = email;
+    request.payload = paymentDetails;
+    request.orderId = orderId;
+    request.plantUnits = plantUnits;
+    bool success = it->second->processRequest(request);
     
     if (success) {
         std::cout << "\n✓ Payment processed successfully!" << std::endl;
@@ -516,7 +507,8 @@ bool Customer::executeOrderWithPayment(const std::string& paymentType,
     // Step 5: Process payment (Adapter pattern)
     std::cout << "\n[Step 5] Processing payment..." << std::endl;
     double totalAmount = orderProduct->getTotalAmount();
-    bool paymentSuccess = processPayment(paymentType, totalAmount, paymentDetails);
+    bool paymentSuccess = processPayment(paymentType, totalAmount, paymentDetails, orderProduct->getOrderId(),
+                                         orderProduct->getFlattened().getPlantUnits());
     
     if (!paymentSuccess) {
         std::cout << "\n[ERROR] Payment processing failed." << std::endl;
@@ -528,6 +520,7 @@ bool Customer::executeOrderWithPayment(const std::string& paymentType,
     // Step 6: Finalize order
     std::cout << "\n[Step 6] Finalizing order..." << std::endl;
     orderProduct->setStatus("Completed - Paid");
+    OrderStore::getInstance().append(*orderProduct);
     
     std::cout << "\n╔════════════════════════════════════════╗" << std::endl;
     std::cout << "║     ORDER COMPLETED SUCCESSFULLY!     ║" << std::endl;
@@ -591,4 +584,14 @@ bool Customer::requestStaffValidation(Order* order) {
     // Delegate to the main Observer pattern validation method
     // This eliminates code duplication and maintains consistent behavior
     return requestValidation(order);
-}
\ No newline at end of file
+}
+
+// ============= Private Helpers =============
+
+void Customer::cleanupPreviousOrder() {
+    // The command refers to the order, so it goes first
+    delete placeOrderCommand;
+    placeOrderCommand = 0;
+    delete orderProduct;
+    orderProduct = 0;
+}
@@ -85,6 +85,7 @@ class Customer : public CustomerSubject {
         // Access methods for facade and components (Current implementation)
         OrderUIFacade* getUIFacade(); // Get UI facade for terminal operations
         class ConcreteOrderBuilder* getOrderBuilder(); // Access to order builder
+        Order* getCurrentOrder() const; // The finalized order (still owned by the customer), or nullptr
         
         // Observer pattern methods - Override from CustomerSubject (Current implementation)
         void notifyInteraction(const std::string& interactionType, 
@@ -109,7 +110,10 @@ class Customer : public CustomerSubject {
     void browseBouquetSuggestions(const std::string& eventType);
 
         // Adapter pattern - payment processing
-        bool processPayment(const std::string& paymentType, double amount, const std::string& paymentDetails = "");
+        // orderId ties card/EFT authorizations to the order for settlement reconciliation;
+        // orderId and plantUnits are kept with the payment in the PaymentLedger
+        bool processPayment(const std::string& paymentType, double amount, const std::string& paymentDetails = "",
+                            const std::string& orderId = "", int plantUnits = 0);
         void showPaymentOptions() const;
         bool isPaymentMethodSupported(const std::string& paymentType) const;
         bool executeOrderWithPayment(const std::string& paymentType, const std::string& paymentDetails = "");
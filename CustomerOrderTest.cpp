@@ -22,6 +22,7 @@
 #include "StaffMember.h"
 #include "OrderValidationHandler.h"
 #include "PaymentProcessHandler.h"
+#include "InventoryCommitHandler.h"
 #include "NotificationHandler.h"
 #include "OrderProcessHandler.h"
 #include "Command.h"
@@ -402,17 +403,20 @@ int main() {
                 cout << "Your order will go through:\n";
                 cout << "1. Validation (Check inventory)\n";
                 cout << "2. Payment Processing\n";
-                cout << "3. Customer Notification\n" << endl;
+                cout << "3. Inventory Update\n";
+                cout << "4. Customer Notification\n" << endl;
                 
                 // Create handler chain
                 OrderValidationHandler* validator = new OrderValidationHandler();
                 PaymentProcessHandler* paymentProcessor = new PaymentProcessHandler();
+                InventoryCommitHandler* inventoryCommitter = new InventoryCommitHandler();
                 NotificationHandler* successNotifier = new NotificationHandler(false);
                 NotificationHandler* failureNotifier = new NotificationHandler(true);
                 
-                // Set up success chain: Validation -> Payment -> Success Notification
+                // Set up success chain: Validation -> Payment -> Inventory -> Success Notification
                 validator->setNext(paymentProcessor);
-                paymentProcessor->setNext(successNotifier);
+                paymentProcessor->setNext(inventoryCommitter);
+                inventoryCommitter->setNext(successNotifier);
                 
                 cout << "=== Starting Order Processing ===" << endl;
                 
@@ -442,9 +446,13 @@ int main() {
                     cout << "\nA confirmation email has been sent to " << customer->getEmail() << endl;
                 }
                 
+                // Let the outbox deliver this order's messages before the next prompt
+                NotificationOutbox::getInstance().waitUntilIdle(std::chrono::seconds(2));
+                
                 // Cleanup handlers
                 delete validator;
                 delete paymentProcessor;
+                delete inventoryCommitter;
                 delete successNotifier;
                 delete failureNotifier;
                 
@@ -24,6 +24,8 @@
 #include "NotificationHandler.h"
 #include "OrderProcessHandler.h"
 #include "Command.h"
+#include "PaymentLedger.h"
+#include "SettlementEngine.h"
 #include "SuggestionTemplate/BouquetSuggestionFactory.h"
 
 using std::cout;
@@ -598,24 +600,22 @@ void checkoutOrder(Order*& currentOrder, Customer* customer, ConcreteOrderBuilde
     showLoadingBar("Processing payment", 1200);
     
     double totalAmount = currentOrder->getTotalAmount();
-    bool paymentSuccess = customer->processPayment(paymentType, totalAmount, paymentDetails);
+    bool paymentSuccess = customer->processPayment(paymentType, totalAmount, paymentDetails,
+                                                   currentOrder->getOrderId(),
+                                                   currentOrder->getFlattened().getPlantUnits());
     
-    if (paymentSuccess) {
-        // Payment successful - update inventory
-        InventoryManager& inventory = InventoryManager::getInstance();
-        
-        // Remove sold plants from inventory
-        for (auto* item : currentOrder->getOrderItems()) {
-            if (SinglePlant* plant = dynamic_cast<SinglePlant*>(item)) {
-                inventory.sellPlants(plant->getPlantType(), plant->getQuantity());
-            } else if (PlantBundle* bundle = dynamic_cast<PlantBundle*>(item)) {
-                for (auto* bundleItem : bundle->getItems()) {
-                    if (SinglePlant* bplant = dynamic_cast<SinglePlant*>(bundleItem)) {
-                        inventory.sellPlants(bplant->getPlantType(), bplant->getQuantity());
-                    }
-                }
-            }
-        }
+    // Payment successful - sell the stock validation reserved for this order (all or nothing)
+    InventoryManager& inventory = InventoryManager::getInstance();
+    bool stockCommitted = paymentSuccess && inventory.commitReservation(currentOrder->getReservationId());
+    if (paymentSuccess && !stockCommitted) {
+        // Held stock went missing after payment: void card and EFT authorizations before they settle,
+        // then reverse whatever is left (cash) in the ledger
+        SettlementEngine::getInstance().voidOrder(currentOrder->getOrderId());
+        PaymentLedger::getInstance().recordOrderVoid(currentOrder->getOrderId());
+    }
+    
+    if (stockCommitted) {
+        currentOrder->setReservationId(0);
         
         currentOrder->setStatus("Completed - Paid");
         
@@ -630,13 +630,27 @@ void checkoutOrder(Order*& currentOrder, Customer* customer, ConcreteOrderBuilde
         cout << "    Amount Paid: R" << std::fixed << std::setprecision(2) << totalAmount << "\n";
         cout << "    A confirmation has been sent to your email.\n";
     } else {
+        // Let other customers have the held stock; a retry validates (and reserves) again
+        inventory.releaseReservation(currentOrder->getReservationId());
+        currentOrder->setReservationId(0);
+        
         cout << "\n" << RED << BOLD;
         cout << "    ╔══════════════════════════════════════════════════════════════════╗\n";
-        cout << "    ║                  ✗ PAYMENT FAILED                                ║\n";
+        if (paymentSuccess) {
+            cout << "    ║                  ✗ STOCK UNAVAILABLE                             ║\n";
+        } else {
+            cout << "    ║                  ✗ PAYMENT FAILED                                ║\n";
+        }
         cout << "    ╚══════════════════════════════════════════════════════════════════╝\n";
         cout << RESET << "\n";
-        cout << "    Payment could not be processed.\n";
-        cout << "    Please check your payment details and try again.\n";
+        if (paymentSuccess) {
+            currentOrder->setStatus("Payment Voided - Stock Unavailable");
+            cout << "    Some of the reserved stock is no longer available.\n";
+            cout << "    Your payment has been voided; please review your order and try again.\n";
+        } else {
+            cout << "    Payment could not be processed.\n";
+            cout << "    Please check your payment details and try again.\n";
+        }
     }
     
     cout << "\n    " << CYAN << "Press Enter to continue..." << RESET;
@@ -1,13 +1,14 @@
 #include "DripWateringStrategy.h"
+#include "Logger.h"
 
 void DripWateringStrategy::applyCare(int amount, const std::string &careType){
     if (careType == "drip" || careType == "water" || careType == "watering")
     {
-        std::cout << "Applying " << amount << " ml of water via Drip System." << std::endl;
+        GH_LOG_DEBUG(Logger::CARE, "Applying " << amount << " ml of water via Drip System.");
     }
     else
     {
-        std::cout << "DripWateringStrategy does not handle care type: " << careType << std::endl;
+        GH_LOG_WARN(Logger::CARE, "DripWateringStrategy does not handle care type: " << careType);
     }
 }
 
@@ -1,4 +1,5 @@
 #include "EFTAdaptee.h"
+#include "IdGenerator.h"
 
 EFTAdaptee::EFTAdaptee() {}
 
@@ -6,7 +7,6 @@ EFTAdaptee::~EFTAdaptee() {}
 
 bool EFTAdaptee::processEFTTransaction(const std::string& bankAccount, double amount, std::string& outRef)
 {
-    static int counter = 0;
-    outRef = "EFT-" + std::to_string(++counter);
+    outRef = IdGenerator::getInstance().nextId("EFT-");
     return true;
 }
\ No newline at end of file
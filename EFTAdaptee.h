@@ -7,6 +7,7 @@ class EFTAdaptee {
 public:
     EFTAdaptee();
     ~EFTAdaptee();
+    // authorizes (does not settle) the transfer; returns true on success, writes the reference to outRef
     bool processEFTTransaction(const std::string& bankAccount, double amount, std::string& outRef);
 };
 
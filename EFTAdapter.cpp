@@ -1,5 +1,7 @@
 #include "EFTAdapter.h"
 #include "EFTAdaptee.h" 
+#include "PaymentLedger.h"
+#include "SettlementEngine.h"
 #include <iostream>
 
 EFTAdapter::EFTAdapter(EFTAdaptee* adaptee) : adaptee(adaptee) {}
@@ -8,16 +10,30 @@ EFTAdapter::~EFTAdapter() {}
 
 bool EFTAdapter::processPayment(double amount, const std::string& customerId, const std::string& payload)
 {
-    if (payload == "EFT")
+    PaymentRequest request;
+    request.amount = amount;
+    request.customerId = customerId;
+    request.payload = payload;
+    return processRequest(request);
+}
+
+bool EFTAdapter::processRequest(const PaymentRequest& request)
+{
+    if (request.payload == "EFT")
     {
         std::string ref;
-        bool success = adaptee->processEFTTransaction("ZA123456789", amount, ref);
+        bool success = adaptee->processEFTTransaction("ZA123456789", request.amount, ref);
         if (success)
         {
-            std::cout << "[EFTAdapter] EFT payment processed for " << customerId
-                 << ", amount: R" << amount << ", reference: " << ref << std::endl;
+            SettlementEngine::getInstance().recordAuthorization(ref, "EFT", request.orderId, request.customerId,
+                                                                request.amount);
+            PaymentLedger::getInstance().recordPayment("EFT", ref, request.orderId, request.customerId,
+                                                       request.amount, request.plantUnits);
+            std::cout << "[EFTAdapter] EFT payment authorized for " << request.customerId
+                 << ", amount: R" << request.amount << ", reference: " << ref << std::endl;
             return true;
         }
     }
+    PaymentLedger::getInstance().recordDecline("EFT", request.orderId, request.customerId, request.amount);
     return false;
 }
\ No newline at end of file
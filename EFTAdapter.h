@@ -9,7 +9,9 @@ class EFTAdaptee;  // Forward declaration
 /**
  * @brief Adapter for Electronic Funds Transfer (EFT) payment systems
  *
- * Converts PaymentProcessor calls into the concrete EFTAdaptee API.
+ * Converts PaymentProcessor calls into the concrete EFTAdaptee API. The
+ * transfer is only authorized here; the SettlementEngine settles it in the
+ * next settlement batch.
  */
 class EFTAdapter : public PaymentProcessor {
 private:
@@ -38,6 +40,13 @@ public:
      * @return true on success
      */
     virtual bool processPayment(double amount, const std::string& customerId, const std::string& payload) override;
+
+    /**
+     * @brief Authorize an EFT payment for a known order
+     * @param request Amount, customer, payload and the order being paid for
+     * @return true on success
+     */
+    virtual bool processRequest(const PaymentRequest& request) override;
 };
 
 #endif // EFTADAPTER_H
\ No newline at end of file
@@ -2,7 +2,7 @@
 #define FERTILIZINGSTRATEGY_H
 
 #include "CareStrategy.h"
-#include <iostream>
+#include "Logger.h"
 
 /**
  * @class FertilizingStrategy
@@ -18,11 +18,11 @@ public:
     {
         if (careType == "fertilize")
         {
-            std::cout << "Applying " << amount << " grams of fertilizer blend to replenish nutrients." << std::endl;
+            GH_LOG_DEBUG(Logger::CARE, "Applying " << amount << " grams of fertilizer blend to replenish nutrients.");
         }
         else
         {
-            std::cout << "FertilizingStrategy does not handle care type: " << careType << std::endl;
+            GH_LOG_WARN(Logger::CARE, "FertilizingStrategy does not handle care type: " << careType);
         }
     }
     std::string getName() const override { return "Fertilizing"; }
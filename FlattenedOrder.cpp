@@ -0,0 +1,129 @@
+#include "FlattenedOrder.h"
+#include "OrderItemVisitor.h"
+#include "PlantBundle.h"
+#include "SinglePlant.h"
+
+// Appends each visited item as a node and descends into bundles
+class FlattenedOrder::Collector : public OrderItemVisitor
+{
+public:
+    Collector(FlattenedOrder &flat) : flat(flat), parent(-1), multiplier(1)
+    {
+    }
+
+    void visitSinglePlant(const SinglePlant &plant) override
+    {
+        Node &node = append(plant);
+        node.plant = &plant;
+
+        flat.speciesDemand[plant.getPlantType()] += node.units;
+        if (plant.hasPlantPot())
+        {
+            flat.potDemand[plant.getPotType()] += node.units;
+        }
+        flat.plantUnits += node.units;
+    }
+
+    void visitPlantBundle(const PlantBundle &bundle) override
+    {
+        Node &node = append(bundle);
+        node.bundle = &bundle;
+
+        std::int32_t index = static_cast<std::int32_t>(flat.nodes.size() - 1);
+        std::int32_t savedParent = parent;
+        int savedMultiplier = multiplier;
+        parent = index;
+        multiplier = node.units;
+        for (const OrderItem *child : bundle.getChildren())
+        {
+            child->accept(*this);
+        }
+        parent = savedParent;
+        multiplier = savedMultiplier;
+    }
+
+private:
+    FlattenedOrder &flat;
+    std::int32_t parent;
+    int multiplier;
+
+    Node &append(const OrderItem &item)
+    {
+        if (parent >= 0)
+        {
+            ++flat.nodes[parent].childCount;
+        }
+        Node node;
+        node.item = &item;
+        node.plant = nullptr;
+        node.bundle = nullptr;
+        node.parent = parent;
+        node.childCount = 0;
+        node.units = item.getQuantity() * multiplier;
+        flat.nodes.push_back(node);
+        return flat.nodes.back();
+    }
+};
+
+FlattenedOrder::FlattenedOrder() : topLevelCount(0), plantUnits(0)
+{
+}
+
+void FlattenedOrder::build(const std::vector<OrderItem *> &items)
+{
+    clear();
+    Collector collector(*this);
+    for (const OrderItem *item : items)
+    {
+        if (item)
+        {
+            item->accept(collector);
+            ++topLevelCount;
+        }
+    }
+}
+
+void FlattenedOrder::build(const OrderItem *item)
+{
+    clear();
+    if (item)
+    {
+        Collector collector(*this);
+        item->accept(collector);
+        ++topLevelCount;
+    }
+}
+
+void FlattenedOrder::clear()
+{
+    nodes.clear(); // keeps its capacity for the next build
+    topLevelCount = 0;
+    speciesDemand.clear();
+    potDemand.clear();
+    plantUnits = 0;
+}
+
+const std::vector<FlattenedOrder::Node> &FlattenedOrder::getNodes() const
+{
+    return nodes;
+}
+
+std::size_t FlattenedOrder::getTopLevelCount() const
+{
+    return topLevelCount;
+}
+
+const std::map<std::string, int> &FlattenedOrder::getSpeciesDemand() const
+{
+    return speciesDemand;
+}
+
+const std::map<std::string, int> &FlattenedOrder::getPotDemand() const
+{
+    return potDemand;
+}
+
+int FlattenedOrder::getPlantUnits() const
+{
+    return plantUnits;
+}
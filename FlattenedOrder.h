@@ -0,0 +1,69 @@
+#ifndef FLATTENED_ORDER_H
+#define FLATTENED_ORDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+class OrderItem;
+class SinglePlant;
+class PlantBundle;
+
+/**
+ * @class FlattenedOrder
+ * @brief One typed, pre-order pass over an order's item tree
+ *
+ * Validation, payment, inventory updates, memento encoding and batch pricing
+ * all need the same facts about an order: which concrete item each node is,
+ * where it sits in the tree, and how many plants of each species and pots of
+ * each type it takes in total. build() gathers all of it in a single walk
+ * driven by OrderItemVisitor, so consumers read the nodes and demand maps
+ * instead of re-walking the tree with dynamic_cast.
+ *
+ * Order::getFlattened() keeps one of these per order and rebuilds it only
+ * after the items have changed.
+ */
+class FlattenedOrder
+{
+public:
+    /** @brief One item, listed before its children; exactly one of plant and bundle is set */
+    struct Node
+    {
+        const OrderItem *item;
+        const SinglePlant *plant;
+        const PlantBundle *bundle;
+        std::int32_t parent;     // index of the enclosing bundle; -1 for top-level items
+        std::int32_t childCount; // direct children (bundles only)
+        int units;               // quantity multiplied through every enclosing bundle
+    };
+
+    FlattenedOrder();
+
+    /** @brief Replaces the contents with a flattening of the given top-level items */
+    void build(const std::vector<OrderItem *> &items);
+    /** @brief Same, for one item (e.g. a single cart line, see CartDemandTracker) */
+    void build(const OrderItem *item);
+    void clear();
+
+    const std::vector<Node> &getNodes() const;
+    std::size_t getTopLevelCount() const;
+
+    /** @brief Plants needed per species, counting every copy of every bundle */
+    const std::map<std::string, int> &getSpeciesDemand() const;
+    /** @brief Pots needed per pot type, counted the same way */
+    const std::map<std::string, int> &getPotDemand() const;
+    int getPlantUnits() const;
+
+private:
+    class Collector;
+
+    std::vector<Node> nodes;
+    std::size_t topLevelCount;
+    std::map<std::string, int> speciesDemand;
+    std::map<std::string, int> potDemand;
+    int plantUnits;
+};
+
+#endif // FLATTENED_ORDER_H
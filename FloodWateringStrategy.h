@@ -2,7 +2,7 @@
 #define FLOOD_WATERING_STRATEGY_H
 
 #include "CareStrategy.h"
-#include <iostream>
+#include "Logger.h"
 
 class FloodWateringStrategy : public CareStrategy
 {
@@ -11,11 +11,11 @@ public:
     {
         if (careType == "flood")
         {
-            std::cout << "Applying " << amount << " ml of water by Flooding." << std::endl;
+            GH_LOG_DEBUG(Logger::CARE, "Applying " << amount << " ml of water by Flooding.");
         }
         else
         {
-            std::cout << "FloodWateringStrategy does not handle care type: " << careType << std::endl;
+            GH_LOG_WARN(Logger::CARE, "FloodWateringStrategy does not handle care type: " << careType);
         }
     }
     std::string getName() const override { return "Flood Watering"; }
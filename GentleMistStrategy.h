@@ -2,7 +2,7 @@
 #define GENTLEMISTSTRATEGY_H
 
 #include "CareStrategy.h"
-#include <iostream>
+#include "Logger.h"
 
 /**
  * @class GentleMistStrategy
@@ -18,11 +18,11 @@ public:
     {
         if (careType == "mist")
         {
-            std::cout << "Gently misting to maintain humidity level: " << amount << " ml" << std::endl;
+            GH_LOG_DEBUG(Logger::CARE, "Gently misting to maintain humidity level: " << amount << " ml");
         }
         else
         {
-            std::cout << "GentleMistStrategy does not handle care type: " << careType << std::endl;
+            GH_LOG_WARN(Logger::CARE, "GentleMistStrategy does not handle care type: " << careType);
         }
     }
     std::string getName() const override { return "Gentle Mist"; }
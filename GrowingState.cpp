@@ -1,21 +1,21 @@
 #include "GrowingState.h"
+#include "Logger.h"
 #include "PlantProduct.h"
 #include "ReadyForSaleState.h"
 #include "PlantSpeciesProfile.h"
-#include <iostream>
 
 void GrowingState::onEnter(PlantProduct *plant)
 {
-    PlantSpeciesProfile *profile = plant->getProfile();
-    int duration = profile ? profile->getStateDurationSeconds("Growing", 20) : 20;
-
-    std::cout << "[STATE] Plant entered Growing state (" << duration << " seconds)" << std::endl;
+    GH_LOG_INFO(Logger::PLANT_STATE,
+                "Plant entered Growing state ("
+                    << (plant->getProfile() ? plant->getProfile()->getStateDurationSeconds("Growing", 20) : 20)
+                    << " seconds)");
     careCount = 0;
 }
 
 void GrowingState::onExit(PlantProduct *plant)
 {
-    std::cout << "[STATE] Plant exiting Growing state" << std::endl;
+    GH_LOG_DEBUG(Logger::PLANT_STATE, "Plant exiting Growing state");
 }
 
 void GrowingState::advanceState(PlantProduct *plant)
@@ -42,12 +42,12 @@ void GrowingState::advanceState(PlantProduct *plant)
     {
         if (careCount % 2 == 0)
         {
-            std::cout << "[GROWING] Requesting water (interval: " << wateringInterval << "s)..." << std::endl;
+            GH_LOG_DEBUG(Logger::PLANT_STATE, "Growing: requesting water (interval: " << wateringInterval << "s)");
             plant->notify("Watering");
         }
         else
         {
-            std::cout << "[GROWING] Requesting pruning (interval: " << pruningInterval << "s)..." << std::endl;
+            GH_LOG_DEBUG(Logger::PLANT_STATE, "Growing: requesting pruning (interval: " << pruningInterval << "s)");
             plant->notify("Pruning");
         }
         careCount++;
@@ -64,7 +64,7 @@ void GrowingState::advanceState(PlantProduct *plant)
     // Advance to next state when duration is complete
     if (secondsInState >= growingDuration)
     {
-        std::cout << "[GROWING] Plant mature. Moving to ReadyForSale." << std::endl;
+        GH_LOG_INFO(Logger::PLANT_STATE, "Growing: plant mature. Moving to ReadyForSale.");
         plant->transitionTo(new ReadyForSaleState());
     }
 }
\ No newline at end of file
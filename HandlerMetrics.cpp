@@ -0,0 +1,154 @@
+#include "HandlerMetrics.h"
+#include "Timestamp.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+const char *const HandlerMetrics::CHAIN_STAGE = "Order Chain (end-to-end)";
+const char *const HandlerMetrics::PIPELINE_STAGE = "Order Pipeline (end-to-end)";
+
+namespace
+{
+    const double NANOS_PER_MILLI = 1e6;
+
+    double toMillis(std::uint64_t nanos)
+    {
+        return static_cast<double>(nanos) / NANOS_PER_MILLI;
+    }
+}
+
+HandlerMetrics::Stage::Stage(const std::string &name) : name(name), succeeded(0), failed(0)
+{
+}
+
+void HandlerMetrics::Stage::record(std::uint64_t nanos, bool success)
+{
+    latency.record(nanos);
+    (success ? succeeded : failed).fetch_add(1, std::memory_order_relaxed);
+}
+
+void HandlerMetrics::Stage::reset()
+{
+    latency.reset();
+    succeeded.store(0, std::memory_order_relaxed);
+    failed.store(0, std::memory_order_relaxed);
+}
+
+HandlerMetrics::HandlerMetrics()
+{
+}
+
+HandlerMetrics::~HandlerMetrics()
+{
+    for (Stage *stage : stages)
+    {
+        delete stage;
+    }
+}
+
+HandlerMetrics &HandlerMetrics::getInstance()
+{
+    static HandlerMetrics instance;
+    return instance;
+}
+
+HandlerMetrics::Stage &HandlerMetrics::getStage(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<std::string, Stage *>::iterator it = stagesByName.find(name);
+    if (it != stagesByName.end())
+    {
+        return *it->second;
+    }
+    Stage *stage = new Stage(name);
+    stages.push_back(stage);
+    stagesByName[name] = stage;
+    return *stage;
+}
+
+std::vector<const HandlerMetrics::Stage *> HandlerMetrics::getStages() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::vector<const Stage *>(stages.begin(), stages.end());
+}
+
+void HandlerMetrics::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Stage *stage : stages)
+    {
+        stage->reset();
+    }
+}
+
+void HandlerMetrics::print(std::ostream &out) const
+{
+    std::vector<const Stage *> snapshot = getStages();
+    out << "[HANDLER METRICS] Latency per step (ms):" << std::endl;
+    std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(3);
+    for (const Stage *stage : snapshot)
+    {
+        const LatencyHistogram &latency = stage->latency;
+        if (latency.getCount() == 0)
+        {
+            continue;
+        }
+        out << "  " << std::left << std::setw(30) << stage->name << std::right
+            << " n=" << latency.getCount()
+            << " ok=" << stage->succeeded.load(std::memory_order_relaxed)
+            << " failed=" << stage->failed.load(std::memory_order_relaxed)
+            << " p50=" << toMillis(latency.getValueAtPercentile(50.0))
+            << " p99=" << toMillis(latency.getValueAtPercentile(99.0))
+            << " max=" << toMillis(latency.getMax()) << std::endl;
+    }
+    out.flags(flags);
+}
+
+bool HandlerMetrics::exportTo(const std::string &path, bool append) const
+{
+    bool writeHeader = true;
+    if (append)
+    {
+        std::ifstream existing(path.c_str(), std::ios::binary | std::ios::ate);
+        writeHeader = !existing || existing.tellg() <= 0;
+    }
+
+    std::ofstream out(path.c_str(), append ? std::ios::app : std::ios::trunc);
+    if (!out)
+    {
+        std::cout << "[HANDLER METRICS] Cannot write " << path << "." << std::endl;
+        return false;
+    }
+    if (writeHeader)
+    {
+        out << "exported_at,stage,count,succeeded,failed,mean_ms,p50_ms,p90_ms,p99_ms,p999_ms,max_ms\n";
+    }
+
+    std::string exportedAt = currentTimestamp();
+    out << std::fixed << std::setprecision(3);
+    for (const Stage *stage : getStages())
+    {
+        const LatencyHistogram &latency = stage->latency;
+        out << exportedAt << ',' << stage->name << ',' << latency.getCount() << ','
+            << stage->succeeded.load(std::memory_order_relaxed) << ','
+            << stage->failed.load(std::memory_order_relaxed) << ',' << latency.getMean() / NANOS_PER_MILLI << ','
+            << toMillis(latency.getValueAtPercentile(50.0)) << ',' << toMillis(latency.getValueAtPercentile(90.0))
+            << ',' << toMillis(latency.getValueAtPercentile(99.0)) << ','
+            << toMillis(latency.getValueAtPercentile(99.9)) << ',' << toMillis(latency.getMax()) << '\n';
+    }
+    out.flush();
+    if (!out)
+    {
+        std::cout << "[HANDLER METRICS] Failed writing " << path << "." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::uint64_t HandlerMetrics::elapsedNanos(Clock::time_point since)
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - since).count());
+}
@@ -0,0 +1,90 @@
+#ifndef HANDLER_METRICS_H
+#define HANDLER_METRICS_H
+
+#include "LatencyHistogram.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class HandlerMetrics
+ * @brief Process-wide latency and outcome figures for each order-processing step
+ *
+ * OrderProcessHandler::handleOrder() times every processOrder() call with a
+ * monotonic clock and records it, with whether it succeeded, under the
+ * handler's name; the handler at the head of a chain also records the whole
+ * chain under CHAIN_STAGE, and OrderPipeline records submit-to-outcome time
+ * under PIPELINE_STAGE. Handlers of the same name (e.g. one per pipeline
+ * worker) share one Stage.
+ *
+ * Recording is lock-free (see LatencyHistogram); only the first lookup of a
+ * name takes the registry lock, and handlers look theirs up once, when they
+ * are constructed. exportTo() writes one CSV row per stage so runs can be
+ * kept side by side and compared for p99 regressions:
+ * @code
+ * exported_at,stage,count,succeeded,failed,mean_ms,p50_ms,p90_ms,p99_ms,p999_ms,max_ms
+ * @endcode
+ * Singleton like InventoryManager.
+ */
+class HandlerMetrics
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    static const char *const CHAIN_STAGE;
+    static const char *const PIPELINE_STAGE;
+
+    /** @brief Figures for one step; latencies are in nanoseconds */
+    struct Stage
+    {
+        const std::string name;
+        LatencyHistogram latency;
+        std::atomic<std::uint64_t> succeeded;
+        std::atomic<std::uint64_t> failed;
+
+        explicit Stage(const std::string &name);
+
+        void record(std::uint64_t nanos, bool success);
+        void reset();
+    };
+
+    HandlerMetrics(const HandlerMetrics &) = delete;
+    HandlerMetrics &operator=(const HandlerMetrics &) = delete;
+
+    static HandlerMetrics &getInstance();
+
+    /** @brief The stage with this name, created on first use; the reference stays valid for the process */
+    Stage &getStage(const std::string &name);
+
+    /** @brief Every stage, in the order they were first used */
+    std::vector<const Stage *> getStages() const;
+
+    /** @brief Clears every stage's figures (stages themselves are kept) */
+    void reset();
+
+    void print(std::ostream &out) const;
+
+    /**
+     * @brief Writes the current figures as CSV
+     * @param append Adds rows to an existing file (header only if it is empty) instead of replacing it
+     */
+    bool exportTo(const std::string &path, bool append = false) const;
+
+    static std::uint64_t elapsedNanos(Clock::time_point since);
+
+private:
+    std::vector<Stage *> stages;
+    std::unordered_map<std::string, Stage *> stagesByName;
+    mutable std::mutex mutex;
+
+    HandlerMetrics();
+    ~HandlerMetrics();
+};
+
+#endif // HANDLER_METRICS_H
@@ -0,0 +1,67 @@
+#include "IdGenerator.h"
+
+#include <chrono>
+
+namespace
+{
+    const char CROCKFORD_DIGITS[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+
+    std::uint64_t millisSinceEpoch()
+    {
+        std::int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                               std::chrono::system_clock::now().time_since_epoch())
+                               .count();
+        std::int64_t since = now - static_cast<std::int64_t>(IdGenerator::EPOCH_MILLIS);
+        return since > 0 ? static_cast<std::uint64_t>(since) : 0;
+    }
+}
+
+IdGenerator::IdGenerator() : lastId(0)
+{
+}
+
+IdGenerator &IdGenerator::getInstance()
+{
+    static IdGenerator instance;
+    return instance;
+}
+
+std::uint64_t IdGenerator::next()
+{
+    std::uint64_t candidate = millisSinceEpoch() << SEQUENCE_BITS;
+    std::uint64_t last = lastId.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        std::uint64_t id = candidate > last ? candidate : last + 1;
+        if (lastId.compare_exchange_weak(last, id, std::memory_order_relaxed))
+        {
+            return id;
+        }
+        // `last` now holds the value another thread published; retry against it
+    }
+}
+
+std::string IdGenerator::nextId(const std::string &prefix)
+{
+    return format(prefix, next());
+}
+
+std::string IdGenerator::format(const std::string &prefix, std::uint64_t id)
+{
+    char digits[FORMATTED_DIGITS];
+    for (std::size_t i = FORMATTED_DIGITS; i-- > 0;)
+    {
+        digits[i] = CROCKFORD_DIGITS[id & 31];
+        id >>= 5;
+    }
+    std::string formatted;
+    formatted.reserve(prefix.size() + FORMATTED_DIGITS);
+    formatted.append(prefix);
+    formatted.append(digits, FORMATTED_DIGITS);
+    return formatted;
+}
+
+std::uint64_t IdGenerator::timestampMillis(std::uint64_t id)
+{
+    return (id >> SEQUENCE_BITS) + EPOCH_MILLIS;
+}
@@ -0,0 +1,58 @@
+#ifndef ID_GENERATOR_H
+#define ID_GENERATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class IdGenerator
+ * @brief Process-wide source of unique, time-ordered 64-bit IDs
+ *
+ * Each ID is the milliseconds since EPOCH_MILLIS shifted above a
+ * SEQUENCE_BITS-wide sequence number:
+ * @code
+ * | 42 bits: ms since 2024-01-01 UTC | 22 bits: sequence within that ms |
+ * @endcode
+ * next() is a single compare-and-swap loop on the last ID issued: it returns
+ * the larger of "last + 1" and "now with sequence 0". IDs are therefore
+ * strictly increasing across all threads, never repeat within a process,
+ * and sort by creation time. A burst of more than 2^22 IDs in one
+ * millisecond, or a clock stepping backwards, just borrows from the
+ * following milliseconds instead of blocking.
+ *
+ * format() renders an ID as a prefix plus 13 fixed-width Crockford base-32
+ * digits (e.g. "ORD-0A8S2R1000000"), which keeps string IDs sorting in the
+ * same order as the numbers. Singleton like InventoryManager.
+ */
+class IdGenerator
+{
+private:
+    std::atomic<std::uint64_t> lastId;
+
+    IdGenerator();
+
+public:
+    static const int SEQUENCE_BITS = 22;
+    static const std::uint64_t EPOCH_MILLIS = 1704067200000ULL; // 2024-01-01T00:00:00Z
+    static const std::size_t FORMATTED_DIGITS = 13;
+
+    IdGenerator(const IdGenerator &) = delete;
+    IdGenerator &operator=(const IdGenerator &) = delete;
+
+    static IdGenerator &getInstance();
+
+    /** @brief Next ID; lock-free and safe to call from any thread */
+    std::uint64_t next();
+
+    /** @brief Next ID already formatted with the given prefix */
+    std::string nextId(const std::string &prefix);
+
+    static std::string format(const std::string &prefix, std::uint64_t id);
+
+    /** @brief Unix time in milliseconds encoded in an ID (approximate once a burst has borrowed ahead) */
+    static std::uint64_t timestampMillis(std::uint64_t id);
+};
+
+#endif // ID_GENERATOR_H
@@ -1,21 +1,21 @@
 #include "InNurseryState.h"
+#include "Logger.h"
 #include "PlantProduct.h"
 #include "GrowingState.h"
 #include "PlantSpeciesProfile.h"
-#include <iostream>
 
 void InNurseryState::onEnter(PlantProduct *plant)
 {
-    PlantSpeciesProfile *profile = plant->getProfile();
-    int duration = profile ? profile->getStateDurationSeconds("InNursery", 20) : 20;
-
-    std::cout << "[STATE] Plant entered InNursery state (" << duration << " seconds)" << std::endl;
+    GH_LOG_INFO(Logger::PLANT_STATE,
+                "Plant entered InNursery state ("
+                    << (plant->getProfile() ? plant->getProfile()->getStateDurationSeconds("InNursery", 20) : 20)
+                    << " seconds)");
     lastWasWater = false;
 }
 
 void InNurseryState::onExit(PlantProduct *plant)
 {
-    std::cout << "[STATE] Plant exiting InNursery state" << std::endl;
+    GH_LOG_DEBUG(Logger::PLANT_STATE, "Plant exiting InNursery state");
 }
 
 void InNurseryState::advanceState(PlantProduct *plant)
@@ -44,13 +44,14 @@ void InNurseryState::advanceState(PlantProduct *plant)
     {
         if (lastWasWater)
         {
-            std::cout << "[IN_NURSERY] Requesting fertilizer (interval: " << requestInterval << "s)..." << std::endl;
+            GH_LOG_DEBUG(Logger::PLANT_STATE,
+                         "InNursery: requesting fertilizer (interval: " << requestInterval << "s)");
             plant->notify("Fertilizing");
             lastWasWater = false;
         }
         else
         {
-            std::cout << "[IN_NURSERY] Requesting water (interval: " << requestInterval << "s)..." << std::endl;
+            GH_LOG_DEBUG(Logger::PLANT_STATE, "InNursery: requesting water (interval: " << requestInterval << "s)");
             plant->notify("Watering");
             lastWasWater = true;
         }
@@ -67,7 +68,7 @@ void InNurseryState::advanceState(PlantProduct *plant)
     // Advance to next state when duration is complete
     if (secondsInState >= nurseryDuration)
     {
-        std::cout << "[IN_NURSERY] Growth stage complete. Moving to Growing." << std::endl;
+        GH_LOG_INFO(Logger::PLANT_STATE, "InNursery: growth stage complete. Moving to Growing.");
         plant->transitionTo(new GrowingState());
     }
 }
\ No newline at end of file
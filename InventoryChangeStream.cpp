@@ -0,0 +1,138 @@
+#include "InventoryChangeStream.h"
+
+const char *InventoryChangeEvent::typeName(Type type)
+{
+    switch (type)
+    {
+    case PLANT_ADDED:
+        return "PlantAdded";
+    case PLANT_MOVED:
+        return "PlantMoved";
+    case PLANT_REMOVED:
+        return "PlantRemoved";
+    case PLANT_STATE_CHANGED:
+        return "PlantStateChanged";
+    case PLANT_SOLD:
+        return "PlantSold";
+    case PLANTS_RESERVED:
+        return "PlantsReserved";
+    case PLANTS_RELEASED:
+        return "PlantsReleased";
+    case POT_ADDED:
+        return "PotAdded";
+    case POT_REMOVED:
+        return "PotRemoved";
+    case POTS_RESERVED:
+        return "PotsReserved";
+    case POTS_RELEASED:
+        return "PotsReleased";
+    }
+    return "Unknown";
+}
+
+InventoryChangeStream::InventoryChangeStream(size_t capacity)
+    : ring(capacity > 0 ? capacity : 1), nextSequence(0), nextListenerId(1), listenerCount(0)
+{
+}
+
+std::uint64_t InventoryChangeStream::publish(const InventoryChangeEvent &event)
+{
+    InventoryChangeEvent stamped;
+    bool notify = listenerCount.load(std::memory_order_acquire) > 0;
+    std::uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        InventoryChangeEvent &slot = ring[nextSequence % ring.size()];
+        slot = event;
+        slot.sequence = nextSequence;
+        slot.time = std::chrono::steady_clock::now();
+        if (notify)
+        {
+            stamped = slot;
+        }
+        sequence = nextSequence++;
+    }
+
+    if (notify)
+    {
+        std::lock_guard<std::mutex> lock(listenerMutex);
+        for (const std::pair<ListenerId, Listener> &listener : listeners)
+        {
+            listener.second(stamped);
+        }
+    }
+    return sequence;
+}
+
+InventoryChangeStream::Cursor InventoryChangeStream::subscribe() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Cursor cursor;
+    cursor.next = nextSequence;
+    return cursor;
+}
+
+bool InventoryChangeStream::poll(Cursor &cursor, std::vector<InventoryChangeEvent> &out, size_t maxEvents) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Anything older than the last `capacity` events has been overwritten
+    bool complete = true;
+    std::uint64_t oldest = nextSequence > ring.size() ? nextSequence - ring.size() : 0;
+    if (cursor.next < oldest)
+    {
+        cursor.next = oldest;
+        complete = false;
+    }
+
+    std::uint64_t end = nextSequence;
+    if (maxEvents > 0 && end - cursor.next > maxEvents)
+    {
+        end = cursor.next + maxEvents;
+    }
+    for (; cursor.next < end; ++cursor.next)
+    {
+        out.push_back(ring[cursor.next % ring.size()]);
+    }
+    return complete;
+}
+
+std::uint64_t InventoryChangeStream::lag(const Cursor &cursor) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return nextSequence > cursor.next ? nextSequence - cursor.next : 0;
+}
+
+std::uint64_t InventoryChangeStream::getPublishedCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return nextSequence;
+}
+
+size_t InventoryChangeStream::getCapacity() const
+{
+    return ring.size();
+}
+
+InventoryChangeStream::ListenerId InventoryChangeStream::addListener(const Listener &listener)
+{
+    std::lock_guard<std::mutex> lock(listenerMutex);
+    ListenerId id = nextListenerId++;
+    listeners.push_back(std::make_pair(id, listener));
+    listenerCount.store(listeners.size(), std::memory_order_release);
+    return id;
+}
+
+void InventoryChangeStream::removeListener(ListenerId id)
+{
+    std::lock_guard<std::mutex> lock(listenerMutex);
+    for (std::vector<std::pair<ListenerId, Listener> >::iterator it = listeners.begin(); it != listeners.end(); ++it)
+    {
+        if (it->first == id)
+        {
+            listeners.erase(it);
+            break;
+        }
+    }
+    listenerCount.store(listeners.size(), std::memory_order_release);
+}
@@ -0,0 +1,132 @@
+#ifndef INVENTORY_CHANGE_STREAM_H
+#define INVENTORY_CHANGE_STREAM_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class PlantProduct;
+class Pot;
+
+/**
+ * @brief One inventory delta published by InventoryManager
+ *
+ * Only the fields that make sense for the event type are filled in; the rest
+ * keep their defaults (null pointers, empty strings, location -1, quantity 0).
+ */
+struct InventoryChangeEvent
+{
+    enum Type
+    {
+        PLANT_ADDED,         // entered `location`
+        PLANT_MOVED,         // moved onto the sales floor (`location`)
+        PLANT_REMOVED,       // left `location`
+        PLANT_STATE_CHANGED, // now in `state`
+        PLANT_SOLD,
+        PLANTS_RESERVED, // `quantity` of `species` held for an order
+        PLANTS_RELEASED,
+        POT_ADDED,
+        POT_REMOVED,
+        POTS_RESERVED, // `quantity` pots of material `potType`
+        POTS_RELEASED
+    };
+
+    std::uint64_t sequence;
+    Type type;
+    std::chrono::steady_clock::time_point time;
+
+    PlantProduct *plant;
+    Pot *pot;
+    std::string species;
+    std::string state;
+    std::string potType;
+    int location; // InventoryManager::PlantLocation
+    int quantity;
+
+    InventoryChangeEvent()
+        : sequence(0), type(PLANT_ADDED), plant(nullptr), pot(nullptr), location(-1), quantity(0) {}
+
+    static const char *typeName(Type type);
+};
+
+/**
+ * @class InventoryChangeStream
+ * @brief Bounded ring buffer of InventoryChangeEvents read through cursors
+ *
+ * InventoryManager publishes one event per mutation. Consumers (live views,
+ * reports) keep their own Cursor and poll for what happened since their last
+ * read instead of re-reading whole inventories. The buffer keeps the newest
+ * `capacity` events; a consumer that falls further behind is told it lagged,
+ * its cursor jumps to the oldest retained event, and it should rebuild its
+ * view from the inventory once before continuing incrementally.
+ *
+ * Consumers that must react straight away (e.g. CartDemandTracker
+ * invalidating a cart's stock check) add a Listener instead, which is called
+ * with each event as it is published.
+ *
+ * Publishing, polling and adding or removing listeners are thread-safe.
+ */
+class InventoryChangeStream
+{
+public:
+    static const size_t DEFAULT_CAPACITY = 4096;
+
+    /** @brief Position of one consumer in the stream (next sequence to read) */
+    struct Cursor
+    {
+        std::uint64_t next;
+        Cursor() : next(0) {}
+    };
+
+    /**
+     * @brief Push subscriber, called on the publishing thread
+     *
+     * InventoryManager publishes while holding its own lock, so a listener
+     * must be quick and must not call back into the inventory or remove
+     * itself; record what changed and act on it later.
+     */
+    typedef std::function<void(const InventoryChangeEvent &)> Listener;
+    typedef std::uint64_t ListenerId;
+
+    explicit InventoryChangeStream(size_t capacity = DEFAULT_CAPACITY);
+
+    /** @brief Stamps the event with the next sequence number and stores it */
+    std::uint64_t publish(const InventoryChangeEvent &event);
+
+    /** @brief Cursor that will only see events published from now on */
+    Cursor subscribe() const;
+
+    /**
+     * @brief Appends up to maxEvents unread events to `out` and advances the cursor
+     * @return false if events were overwritten before this consumer read them
+     */
+    bool poll(Cursor &cursor, std::vector<InventoryChangeEvent> &out, size_t maxEvents = 0) const;
+
+    /** @brief Number of events published but not yet read through `cursor` */
+    std::uint64_t lag(const Cursor &cursor) const;
+
+    std::uint64_t getPublishedCount() const;
+    size_t getCapacity() const;
+
+    /** @brief Calls `listener` with every event published from now on */
+    ListenerId addListener(const Listener &listener);
+
+    /** @brief Once this returns the listener is not running and will not be called again */
+    void removeListener(ListenerId id);
+
+private:
+    std::vector<InventoryChangeEvent> ring;
+    std::uint64_t nextSequence;
+    mutable std::mutex mutex;
+
+    std::vector<std::pair<ListenerId, Listener> > listeners;
+    ListenerId nextListenerId;
+    std::atomic<size_t> listenerCount; // lets publish() skip the listener lock when nobody is listening
+    std::mutex listenerMutex;          // held while listeners run, never together with `mutex`
+};
+
+#endif // INVENTORY_CHANGE_STREAM_H
@@ -0,0 +1,80 @@
+#ifndef INVENTORYCOMMITHANDLER_H
+#define INVENTORYCOMMITHANDLER_H
+
+#include "OrderProcessHandler.h"
+#include "InventoryManager.h"
+#include "PaymentLedger.h"
+#include "SettlementEngine.h"
+#include <cstdint>
+#include <iostream>
+#include <map>
+
+/**
+ * @brief Concrete handler that takes a paid order's plants off the sales floor
+ * Commits the stock OrderValidationHandler reserved for the order; orders that
+ * were never reserved sell their plants by species instead. If the stock is
+ * gone, nothing is sold and the order's payment is voided, as at the tills
+ * and in BatchCheckout
+ */
+class InventoryCommitHandler : public OrderProcessHandler {
+public:
+    InventoryCommitHandler() : OrderProcessHandler("Inventory Commit") {}
+    
+protected:
+    bool processOrder(Order* order, Customer* customer) override {
+        (void)customer;
+        logStep("Updating inventory - removing sold plants from sales floor...");
+        if (removeSoldPlantsFromInventory(order)) {
+            logStep("Inventory updated successfully");
+            return true;
+        }
+        std::cout << "[ERROR] Stock no longer available after payment - voiding payment" << std::endl;
+        // Card and EFT authorizations are not settled yet; cash was taken, so the ledger reverses it
+        SettlementEngine::getInstance().voidOrder(order->getOrderId());
+        PaymentLedger::getInstance().recordOrderVoid(order->getOrderId());
+        order->setStatus("Payment Voided - Stock Unavailable");
+        return false;
+    }
+    
+private:
+    /**
+     * @brief Removes sold plants from the sales floor inventory
+     * @param order The order containing the plants to remove
+     * @return true if all plants were removed; false if none were, because stock ran short
+     */
+    bool removeSoldPlantsFromInventory(Order* order) {
+        InventoryManager& inventory = InventoryManager::getInstance();
+        
+        // Stock held at validation is sold as one unit
+        if (order->getReservationId() != 0) {
+            std::uint64_t reservationId = order->getReservationId();
+            order->setReservationId(0);
+            if (inventory.commitReservation(reservationId)) {
+                return true;
+            }
+            // Nothing was sold; give the hold back rather than leave it stranded
+            inventory.releaseReservation(reservationId);
+            return false;
+        }
+        
+        // Plants by type across the whole order, bundles included; checked first so a shortage sells nothing
+        const std::map<std::string, int>& demand = order->getFlattened().getSpeciesDemand();
+        for (const auto& pair : demand) {
+            if (!inventory.isPlantAvailableForSale(pair.first, pair.second)) {
+                std::cout << "[ERROR] Only " << inventory.getAvailablePlantCount(pair.first) << " " << pair.first
+                          << " left for " << pair.second << " ordered" << std::endl;
+                return false;
+            }
+        }
+        bool allSold = true;
+        for (const auto& pair : demand) {
+            if (!inventory.sellPlants(pair.first, pair.second)) {
+                std::cout << "[ERROR] Could not sell " << pair.second << " " << pair.first << std::endl;
+                allSold = false;
+            }
+        }
+        return allSold;
+    }
+};
+
+#endif
@@ -0,0 +1,438 @@
+#include "InventoryIndex.h"
+#include "Pot.h"
+#include <algorithm>
+#include <cmath>
+
+InventoryIndex::InventoryIndex() : nextPotSequence(0)
+{
+}
+
+long long InventoryIndex::toCents(double price)
+{
+    return std::llround(price * 100.0);
+}
+
+// ==================== Plants ====================
+
+const InventoryIndex::PlantRecord *InventoryIndex::findPlant(PlantProduct *plant) const
+{
+    std::unordered_map<PlantProduct *, PlantRecord>::const_iterator it = plants.find(plant);
+    return it != plants.end() ? &it->second : nullptr;
+}
+
+const std::unordered_map<PlantProduct *, InventoryIndex::PlantRecord> &InventoryIndex::getPlantRecords() const
+{
+    return plants;
+}
+
+// Inserts or erases the plant in every bucket its record belongs to
+void InventoryIndex::indexPlant(PlantProduct *plant, const PlantRecord &record, bool insert)
+{
+    AgeKey key(record.stateStart, plant);
+    AgeBucket *buckets[] = {&plantsByCategory[record.category], &plantsBySpecies[record.species], &plantsByState[record.state]};
+    for (AgeBucket *bucket : buckets)
+    {
+        if (insert)
+            bucket->insert(key);
+        else
+            bucket->erase(key);
+    }
+    if (!insert)
+    {
+        if (plantsByCategory[record.category].empty())
+            plantsByCategory.erase(record.category);
+        if (plantsBySpecies[record.species].empty())
+            plantsBySpecies.erase(record.species);
+        if (plantsByState[record.state].empty())
+            plantsByState.erase(record.state);
+    }
+
+    for (int location = 0; location < LOCATION_COUNT; location++)
+    {
+        if (record.locations & (1u << location))
+        {
+            if (insert)
+                plantsByLocation[location].insert(key);
+            else
+                plantsByLocation[location].erase(key);
+        }
+    }
+}
+
+void InventoryIndex::addPlant(PlantProduct *plant, const PlantRecord &record)
+{
+    if (plants.count(plant))
+    {
+        return;
+    }
+    PlantRecord &stored = plants[plant];
+    stored = record;
+    stored.priceCents = toCents(record.price);
+    indexPlant(plant, stored, true);
+    plantsByPrice.insert(std::make_pair(stored.priceCents, plant));
+}
+
+void InventoryIndex::removePlant(PlantProduct *plant)
+{
+    std::unordered_map<PlantProduct *, PlantRecord>::iterator it = plants.find(plant);
+    if (it == plants.end())
+    {
+        return;
+    }
+    indexPlant(plant, it->second, false);
+    plantsByPrice.erase(std::make_pair(it->second.priceCents, plant));
+    plants.erase(it);
+}
+
+void InventoryIndex::setLocations(PlantProduct *plant, unsigned int locations)
+{
+    std::unordered_map<PlantProduct *, PlantRecord>::iterator it = plants.find(plant);
+    if (it == plants.end())
+    {
+        return;
+    }
+    PlantRecord &record = it->second;
+    AgeKey key(record.stateStart, plant);
+    for (int location = 0; location < LOCATION_COUNT; location++)
+    {
+        unsigned int bit = 1u << location;
+        if ((locations & bit) && !(record.locations & bit))
+            plantsByLocation[location].insert(key);
+        else if (!(locations & bit) && (record.locations & bit))
+            plantsByLocation[location].erase(key);
+    }
+    record.locations = locations;
+}
+
+// Age keys embed the state start time, so a transition re-files the plant
+void InventoryIndex::changeState(PlantProduct *plant, const std::string &state, TimePoint stateStart)
+{
+    std::unordered_map<PlantProduct *, PlantRecord>::iterator it = plants.find(plant);
+    if (it == plants.end())
+    {
+        return;
+    }
+    PlantRecord &record = it->second;
+    indexPlant(plant, record, false);
+    record.state = state;
+    record.stateStart = stateStart;
+    indexPlant(plant, record, true);
+}
+
+void InventoryIndex::reservePlants(size_t additional)
+{
+    plants.reserve(plants.size() + additional);
+}
+
+void InventoryIndex::clearPlants()
+{
+    plants.clear();
+    plantsByCategory.clear();
+    plantsBySpecies.clear();
+    plantsByState.clear();
+    for (int location = 0; location < LOCATION_COUNT; location++)
+    {
+        plantsByLocation[location].clear();
+    }
+    plantsByPrice.clear();
+}
+
+bool InventoryIndex::matches(const PlantRecord &record, const PlantQuery &query, TimePoint now)
+{
+    if (!query.category.empty() && record.category != query.category)
+        return false;
+    if (!query.species.empty() && record.species != query.species)
+        return false;
+    if (!query.state.empty() && record.state != query.state)
+        return false;
+    if (query.location != PlantQuery::ANY_LOCATION && !(record.locations & (1u << query.location)))
+        return false;
+    if (query.minPrice >= 0.0 && record.priceCents < toCents(query.minPrice))
+        return false;
+    if (query.maxPrice >= 0.0 && record.priceCents > toCents(query.maxPrice))
+        return false;
+    if (query.minSecondsInState >= 0 && record.stateStart > now - std::chrono::seconds(query.minSecondsInState))
+        return false;
+    if (query.maxSecondsInState >= 0 && record.stateStart < now - std::chrono::seconds(query.maxSecondsInState))
+        return false;
+    return true;
+}
+
+std::vector<PlantProduct *> InventoryIndex::findPlants(const PlantQuery &query, TimePoint now) const
+{
+    std::vector<PlantProduct *> results;
+    const size_t limit = query.limit ? query.limit : plants.size();
+
+    // Inverted windows would make the range scans below run backwards
+    if (query.minSecondsInState >= 0 && query.maxSecondsInState >= 0 && query.minSecondsInState > query.maxSecondsInState)
+        return results;
+    if (query.minPrice >= 0.0 && query.maxPrice >= 0.0 && toCents(query.minPrice) > toCents(query.maxPrice))
+        return results;
+
+    // Drive the scan from the smallest equality bucket; a missing key means no matches
+    const AgeBucket *driver = nullptr;
+    const std::pair<const std::unordered_map<std::string, AgeBucket> *, const std::string *> keyed[] = {
+        std::make_pair(&plantsByCategory, &query.category),
+        std::make_pair(&plantsBySpecies, &query.species),
+        std::make_pair(&plantsByState, &query.state)};
+    for (size_t i = 0; i < sizeof(keyed) / sizeof(keyed[0]); i++)
+    {
+        if (keyed[i].second->empty())
+            continue;
+        std::unordered_map<std::string, AgeBucket>::const_iterator bucket = keyed[i].first->find(*keyed[i].second);
+        if (bucket == keyed[i].first->end())
+            return results;
+        if (!driver || bucket->second.size() < driver->size())
+            driver = &bucket->second;
+    }
+    if (query.location != PlantQuery::ANY_LOCATION)
+    {
+        if (query.location < 0 || query.location >= LOCATION_COUNT)
+            return results;
+        if (!driver || plantsByLocation[query.location].size() < driver->size())
+            driver = &plantsByLocation[query.location];
+    }
+
+    const bool byAge = query.sort == PlantQuery::OLDEST_FIRST || query.sort == PlantQuery::NEWEST_FIRST;
+    const bool byPrice = query.sort == PlantQuery::CHEAPEST_FIRST || query.sort == PlantQuery::PRICIEST_FIRST;
+
+    if (driver)
+    {
+        // Restrict to the time-in-state window: older plants have earlier start times
+        AgeBucket::const_iterator first = driver->begin();
+        AgeBucket::const_iterator last = driver->end();
+        if (query.maxSecondsInState >= 0)
+            first = driver->lower_bound(AgeKey(now - std::chrono::seconds(query.maxSecondsInState), nullptr));
+        if (query.minSecondsInState >= 0)
+            last = driver->lower_bound(AgeKey(now - std::chrono::seconds(query.minSecondsInState) + TimePoint::duration(1), nullptr));
+
+        const bool stopEarly = !byPrice;
+        if (query.sort == PlantQuery::NEWEST_FIRST)
+        {
+            for (AgeBucket::const_reverse_iterator it(last); it != AgeBucket::const_reverse_iterator(first) && results.size() < limit; ++it)
+            {
+                if (matches(plants.find(it->second)->second, query, now))
+                    results.push_back(it->second);
+            }
+        }
+        else
+        {
+            for (AgeBucket::const_iterator it = first; it != last && (!stopEarly || results.size() < limit); ++it)
+            {
+                if (matches(plants.find(it->second)->second, query, now))
+                    results.push_back(it->second);
+            }
+        }
+    }
+    else
+    {
+        // No equality filter: walk the price index over the requested price range
+        std::set<std::pair<long long, PlantProduct *> >::const_iterator first = plantsByPrice.begin();
+        std::set<std::pair<long long, PlantProduct *> >::const_iterator last = plantsByPrice.end();
+        if (query.minPrice >= 0.0)
+            first = plantsByPrice.lower_bound(std::make_pair(toCents(query.minPrice), static_cast<PlantProduct *>(nullptr)));
+        if (query.maxPrice >= 0.0)
+            last = plantsByPrice.lower_bound(std::make_pair(toCents(query.maxPrice) + 1, static_cast<PlantProduct *>(nullptr)));
+
+        const bool stopEarly = !byAge;
+        if (query.sort == PlantQuery::PRICIEST_FIRST)
+        {
+            typedef std::set<std::pair<long long, PlantProduct *> >::const_reverse_iterator ReverseIt;
+            for (ReverseIt it(last); it != ReverseIt(first) && results.size() < limit; ++it)
+            {
+                if (matches(plants.find(it->second)->second, query, now))
+                    results.push_back(it->second);
+            }
+        }
+        else
+        {
+            for (std::set<std::pair<long long, PlantProduct *> >::const_iterator it = first; it != last && (!stopEarly || results.size() < limit); ++it)
+            {
+                if (matches(plants.find(it->second)->second, query, now))
+                    results.push_back(it->second);
+            }
+        }
+    }
+
+    // The scan order did not match the requested order, so sort what was collected
+    if ((driver && byPrice) || (!driver && byAge))
+    {
+        const std::unordered_map<PlantProduct *, PlantRecord> &records = plants;
+        PlantQuery::SortOrder sort = query.sort;
+        std::stable_sort(results.begin(), results.end(), [&records, sort](PlantProduct *a, PlantProduct *b)
+                         {
+            const PlantRecord &ra = records.find(a)->second;
+            const PlantRecord &rb = records.find(b)->second;
+            switch (sort)
+            {
+            case PlantQuery::OLDEST_FIRST:
+                return ra.stateStart < rb.stateStart;
+            case PlantQuery::NEWEST_FIRST:
+                return rb.stateStart < ra.stateStart;
+            case PlantQuery::CHEAPEST_FIRST:
+                return ra.priceCents < rb.priceCents;
+            default:
+                return rb.priceCents < ra.priceCents;
+            } });
+        if (results.size() > limit)
+            results.resize(limit);
+    }
+    return results;
+}
+
+// ==================== Pots ====================
+
+void InventoryIndex::addPot(Pot *pot, double price)
+{
+    std::unordered_map<Pot *, PotRecord>::iterator it = pots.find(pot);
+    if (it != pots.end())
+    {
+        it->second.copies++;
+        return;
+    }
+
+    PotRecord &record = pots[pot];
+    record.material = pot->getPotType();
+    pot->getDecorations(record.decorations);
+    record.priceCents = toCents(price);
+    record.sequence = nextPotSequence++;
+    record.copies = 1;
+
+    PotKey key(record.sequence, pot);
+    potsByMaterial[record.material].insert(key);
+    for (const Attribute &attribute : record.decorations)
+    {
+        potsByAttribute[attribute].insert(key);
+    }
+    potsByAge.insert(key);
+    potsByPrice.insert(std::make_pair(record.priceCents, key));
+}
+
+void InventoryIndex::removePot(Pot *pot)
+{
+    std::unordered_map<Pot *, PotRecord>::iterator it = pots.find(pot);
+    if (it == pots.end() || --it->second.copies > 0)
+    {
+        return;
+    }
+
+    const PotRecord &record = it->second;
+    PotKey key(record.sequence, pot);
+    PotBucket &material = potsByMaterial[record.material];
+    material.erase(key);
+    if (material.empty())
+        potsByMaterial.erase(record.material);
+    for (const Attribute &attribute : record.decorations)
+    {
+        PotBucket &withAttribute = potsByAttribute[attribute];
+        withAttribute.erase(key);
+        if (withAttribute.empty())
+            potsByAttribute.erase(attribute);
+    }
+    potsByAge.erase(key);
+    potsByPrice.erase(std::make_pair(record.priceCents, key));
+    pots.erase(it);
+}
+
+bool InventoryIndex::matches(const PotRecord &record, const PotQuery &query)
+{
+    if (!query.material.empty() && record.material != query.material)
+        return false;
+    if (query.minPrice >= 0.0 && record.priceCents < toCents(query.minPrice))
+        return false;
+    if (query.maxPrice >= 0.0 && record.priceCents > toCents(query.maxPrice))
+        return false;
+    for (const Attribute &wanted : query.attributes)
+    {
+        if (std::find(record.decorations.begin(), record.decorations.end(), wanted) == record.decorations.end())
+            return false;
+    }
+    return true;
+}
+
+std::vector<Pot *> InventoryIndex::findPots(const PotQuery &query) const
+{
+    std::vector<Pot *> results;
+    const size_t limit = query.limit ? query.limit : pots.size();
+
+    if (query.minPrice >= 0.0 && query.maxPrice >= 0.0 && toCents(query.minPrice) > toCents(query.maxPrice))
+        return results;
+
+    // Smallest of the material / attribute buckets; a missing key means no matches
+    const PotBucket *driver = nullptr;
+    if (!query.material.empty())
+    {
+        std::unordered_map<std::string, PotBucket>::const_iterator it = potsByMaterial.find(query.material);
+        if (it == potsByMaterial.end())
+            return results;
+        driver = &it->second;
+    }
+    for (const Attribute &wanted : query.attributes)
+    {
+        std::map<Attribute, PotBucket>::const_iterator it = potsByAttribute.find(wanted);
+        if (it == potsByAttribute.end())
+            return results;
+        if (!driver || it->second.size() < driver->size())
+            driver = &it->second;
+    }
+
+    if (driver || query.sort == PotQuery::UNSORTED)
+    {
+        // Buckets are in insertion order, so an unsorted query is done once it has enough
+        const PotBucket &bucket = driver ? *driver : potsByAge;
+        const bool stopEarly = query.sort == PotQuery::UNSORTED;
+        for (PotBucket::const_iterator it = bucket.begin(); it != bucket.end() && (!stopEarly || results.size() < limit); ++it)
+        {
+            if (matches(pots.find(it->second)->second, query))
+                results.push_back(it->second);
+        }
+        if (stopEarly)
+            return results;
+
+        // Collected oldest first, so pots at the same price stay in that order
+        const std::unordered_map<Pot *, PotRecord> &records = pots;
+        bool cheapestFirst = query.sort == PotQuery::CHEAPEST_FIRST;
+        std::stable_sort(results.begin(), results.end(), [&records, cheapestFirst](Pot *a, Pot *b)
+                         {
+            long long pa = records.find(a)->second.priceCents;
+            long long pb = records.find(b)->second.priceCents;
+            return cheapestFirst ? pa < pb : pb < pa; });
+        if (results.size() > limit)
+            results.resize(limit);
+        return results;
+    }
+
+    // No equality filter but a price order: walk the price index over the requested range
+    PotPriceIndex::const_iterator first = potsByPrice.begin();
+    PotPriceIndex::const_iterator last = potsByPrice.end();
+    if (query.minPrice >= 0.0)
+        first = potsByPrice.lower_bound(std::make_pair(toCents(query.minPrice), PotKey(0, nullptr)));
+    if (query.maxPrice >= 0.0)
+        last = potsByPrice.lower_bound(std::make_pair(toCents(query.maxPrice) + 1, PotKey(0, nullptr)));
+
+    if (query.sort == PotQuery::CHEAPEST_FIRST)
+    {
+        for (PotPriceIndex::const_iterator it = first; it != last && results.size() < limit; ++it)
+        {
+            if (matches(pots.find(it->second.second)->second, query))
+                results.push_back(it->second.second);
+        }
+        return results;
+    }
+
+    // Highest price first, but oldest first within each price
+    PotPriceIndex::const_iterator groupEnd = last;
+    while (groupEnd != first && results.size() < limit)
+    {
+        PotPriceIndex::const_iterator previous = groupEnd;
+        --previous;
+        PotPriceIndex::const_iterator groupStart = potsByPrice.lower_bound(std::make_pair(previous->first, PotKey(0, nullptr)));
+        for (PotPriceIndex::const_iterator it = groupStart; it != groupEnd && results.size() < limit; ++it)
+        {
+            if (matches(pots.find(it->second.second)->second, query))
+                results.push_back(it->second.second);
+        }
+        groupEnd = groupStart;
+    }
+    return results;
+}
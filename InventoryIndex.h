@@ -0,0 +1,109 @@
+#ifndef INVENTORY_INDEX_H
+#define INVENTORY_INDEX_H
+
+#include "InventoryQuery.h"
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class PlantProduct;
+class Pot;
+
+/**
+ * @class InventoryIndex
+ * @brief Secondary indexes behind InventoryManager::findPlants / findPots
+ *
+ * Every tracked plant has a record (locations, category, species, state, price,
+ * state start time) and sits in one bucket per category, species, state and
+ * location. Buckets are ordered by state start time, so a query is answered by
+ * range-scanning the smallest matching bucket - results come out already sorted
+ * by age, and limited queries stop early. A price-ordered index covers queries
+ * with no equality filter. Pots are indexed by material, decoration and price;
+ * their buckets are ordered by when the pot was added, so unsorted results come
+ * out oldest first and limited pot queries stop early too.
+ *
+ * InventoryManager owns the only instance and keeps it in step with its
+ * vectors; records must be updated through changeState when a plant's state
+ * changes.
+ */
+class InventoryIndex
+{
+public:
+    typedef std::chrono::steady_clock::time_point TimePoint;
+
+    InventoryIndex();
+
+    static const int LOCATION_COUNT = 3; // matches InventoryManager::PlantLocation
+
+    struct PlantRecord
+    {
+        unsigned int locations; // bit per location
+        std::string category;
+        std::string species;
+        std::string state;
+        double price;
+        long long priceCents;
+        TimePoint stateStart;
+
+        PlantRecord() : locations(0), price(0.0), priceCents(0) {}
+    };
+
+    // --- Plants ---
+    const PlantRecord *findPlant(PlantProduct *plant) const;
+    const std::unordered_map<PlantProduct *, PlantRecord> &getPlantRecords() const;
+    void addPlant(PlantProduct *plant, const PlantRecord &record);
+    void removePlant(PlantProduct *plant);
+    void setLocations(PlantProduct *plant, unsigned int locations);
+    void changeState(PlantProduct *plant, const std::string &state, TimePoint stateStart);
+    void reservePlants(size_t additional);
+    void clearPlants();
+
+    std::vector<PlantProduct *> findPlants(const PlantQuery &query, TimePoint now) const;
+
+    // --- Pots ---
+    void addPot(Pot *pot, double price);
+    void removePot(Pot *pot);
+    std::vector<Pot *> findPots(const PotQuery &query) const;
+
+private:
+    typedef std::pair<TimePoint, PlantProduct *> AgeKey;
+    typedef std::set<AgeKey> AgeBucket;
+    typedef std::pair<std::string, std::string> Attribute;
+    typedef std::pair<unsigned long long, Pot *> PotKey; // insertion sequence, pot
+    typedef std::set<PotKey> PotBucket;
+    typedef std::set<std::pair<long long, PotKey> > PotPriceIndex;
+
+    struct PotRecord
+    {
+        std::string material;
+        std::vector<Attribute> decorations;
+        long long priceCents;
+        unsigned long long sequence;
+        int copies; // the same pot may be added to the inventory more than once
+    };
+
+    std::unordered_map<PlantProduct *, PlantRecord> plants;
+    std::unordered_map<std::string, AgeBucket> plantsByCategory;
+    std::unordered_map<std::string, AgeBucket> plantsBySpecies;
+    std::unordered_map<std::string, AgeBucket> plantsByState;
+    AgeBucket plantsByLocation[LOCATION_COUNT];
+    std::set<std::pair<long long, PlantProduct *> > plantsByPrice;
+
+    std::unordered_map<Pot *, PotRecord> pots;
+    std::unordered_map<std::string, PotBucket> potsByMaterial;
+    std::map<Attribute, PotBucket> potsByAttribute;
+    PotBucket potsByAge;
+    PotPriceIndex potsByPrice;
+    unsigned long long nextPotSequence;
+
+    void indexPlant(PlantProduct *plant, const PlantRecord &record, bool insert);
+    static long long toCents(double price);
+    static bool matches(const PlantRecord &record, const PlantQuery &query, TimePoint now);
+    static bool matches(const PotRecord &record, const PotQuery &query);
+};
+
+#endif // INVENTORY_INDEX_H
@@ -1,10 +1,18 @@
 #include "InventoryManager.h"
+#include "FlattenedOrder.h"
+#include "IdGenerator.h"
+#include "InventorySnapshot.h"
+#include "Logger.h"
 #include "PotDecorator/PotDecorator.h"
 #include "PlantProduct.h"
+#include "PlantSpeciesProfile.h"
 #include "Pot.h"
 #include <algorithm>
 #include <iostream>
 
+// Unit price used when a species profile carries no "price" property
+const double InventoryManager::DEFAULT_PLANT_PRICE = 25.99;
+
 // Private constructor
 InventoryManager::InventoryManager() : plantsInStock(0)
 {
@@ -21,8 +29,29 @@ InventoryManager::~InventoryManager()
 // Manual cleanup method - call before program exit
 void InventoryManager::cleanup()
 {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     std::cout << "Cleaning up InventoryManager resources..." << std::endl;
 
+    // Persist everything before it is deleted so the next start can restore it. Only once:
+    // the destructor runs cleanup() again after the plants are gone and must not overwrite it
+    if (!autoSnapshotPath.empty())
+    {
+        saveSnapshot(autoSnapshotPath);
+        autoSnapshotPath.clear();
+    }
+
+    // Plants are deleted below, so forget them before anything can notify us
+    for (const auto &entry : inventoryIndex.getPlantRecords())
+    {
+        entry.first->setInventoryObserver(nullptr);
+    }
+    inventoryIndex.clearPlants();
+
+    // Held stock refers to the plants and pots being dropped
+    reservations.clear();
+    heldPlants.clear();
+    heldPots.clear();
+
     // Clean up greenhouse plants
     for (PlantProduct *plant : greenHouseInventory)
     {
@@ -50,7 +79,15 @@ void InventoryManager::cleanup()
     // }
     // potInventory.clear();
 
+    // Profiles recreated from a snapshot outlive their plants, so delete them last
+    for (PlantSpeciesProfile *profile : restoredProfiles)
+    {
+        delete profile;
+    }
+    restoredProfiles.clear();
+
     plantsInStock = 0;
+    valuation.clearPlants(); // pots are not released here, so their totals stay
     std::cout << "InventoryManager cleanup complete." << std::endl;
 }
 
@@ -63,153 +100,282 @@ InventoryManager &InventoryManager::getInstance()
 
 void InventoryManager::update(PlantProduct *plant, const std::string &commandType)
 {
-    std::cout << "InventoryManager received update for plant with command: " << commandType << std::endl;
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    if (commandType == "StateChanged")
+    {
+        const InventoryIndex::PlantRecord *tracked = inventoryIndex.findPlant(plant);
+        if (tracked)
+        {
+            std::string newState = plant->getCurrentStateName();
+            if (tracked->locations & ((1u << IN_GREENHOUSE) | (1u << ON_SALES_FLOOR)))
+            {
+                valuation.changePlantState(tracked->species, tracked->state, newState, tracked->price);
+            }
+            inventoryIndex.changeState(plant, newState, plant->getStateStartTime());
+            publishPlantChange(InventoryChangeEvent::PLANT_STATE_CHANGED, plant, -1);
+        }
+        return;
+    }
+
+    GH_LOG_DEBUG(Logger::INVENTORY, "Received update for plant with command: " << commandType);
     // Handle lifecycle updates as needed
 }
 
 int InventoryManager::getStockCount() const
 {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     return readyForSalePlants.size();
 }
 
 std::vector<PlantProduct *> InventoryManager::getGreenHouseInventory() const
 {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     return greenHouseInventory;
 }
 
 std::vector<PlantProduct *> InventoryManager::getReadyForSalePlants() const
 {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     return readyForSalePlants;
 }
 
 std::vector<PlantProduct *> InventoryManager::getSoldPlants() const
 {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     return soldPlants;
 }
 
 std::vector<Pot *> InventoryManager::getPotInventory() const
 {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     return potInventory;
 }
 
 void InventoryManager::addPot(Pot *pot)
 {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     if (pot)
     {
         potInventory.push_back(pot);
+        updatePotCounts(pot, 1);
+        valuation.addPot(potValue(pot));
+        inventoryIndex.addPot(pot, potValue(pot));
+        publishPotChange(InventoryChangeEvent::POT_ADDED, pot, pot->getPotType(), 1);
     }
 }
 
 void InventoryManager::removePot(Pot *pot)
 {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     auto it = std::find(potInventory.begin(), potInventory.end(), pot);
     if (it != potInventory.end())
     {
         potInventory.erase(it);
+        updatePotCounts(pot, -1);
+        valuation.removePot(potValue(pot));
+        inventoryIndex.removePot(pot);
+        publishPotChange(InventoryChangeEvent::POT_REMOVED, pot, pot->getPotType(), 1);
+    }
+}
+
+// Walks the decorator chain once per add/remove; queries then read the maps directly
+void InventoryManager::updatePotCounts(const Pot *pot, int delta)
+{
+    trackedPotTypes.insert(pot->getPotType());
+    int &typeCount = potCountsByType[pot->getPotType()];
+    typeCount += delta;
+    if (typeCount <= 0)
+    {
+        potCountsByType.erase(pot->getPotType());
+    }
+
+    std::vector<std::pair<std::string, std::string> > decorations;
+    pot->getDecorations(decorations);
+    for (size_t i = 0; i < decorations.size(); i++)
+    {
+        std::map<std::string, int> &values = potCountsByAttribute[decorations[i].first];
+        int &valueCount = values[decorations[i].second];
+        valueCount += delta;
+        if (valueCount <= 0)
+        {
+            values.erase(decorations[i].second);
+        }
+        if (values.empty())
+        {
+            potCountsByAttribute.erase(decorations[i].first);
+        }
+    }
+}
+
+// A decorator's price covers its whole chain; undecorated pots carry the base price
+double InventoryManager::potValue(const Pot *pot)
+{
+    const PotDecorator *decorator = dynamic_cast<const PotDecorator *>(pot);
+    return decorator ? decorator->getPrice() : 10.0;
+}
+
+bool InventoryManager::isPlantAt(PlantProduct *plant, PlantLocation location) const
+{
+    const InventoryIndex::PlantRecord *tracked = inventoryIndex.findPlant(plant);
+    return tracked && (tracked->locations & (1u << location));
+}
+
+// Records a plant entering or leaving one location and keeps the valuation in step
+void InventoryManager::setPlantLocation(PlantProduct *plant, PlantLocation location, bool present)
+{
+    const unsigned int heldMask = (1u << IN_GREENHOUSE) | (1u << ON_SALES_FLOOR);
+    const unsigned int bit = 1u << location;
+
+    const InventoryIndex::PlantRecord *tracked = inventoryIndex.findPlant(plant);
+    if (!tracked)
+    {
+        if (!present)
+        {
+            return;
+        }
+        PlantSpeciesProfile *profile = plant->getProfile();
+        InventoryIndex::PlantRecord record;
+        record.category = profile ? profile->getProperty("category") : std::string();
+        record.species = profile ? profile->getSpeciesName() : std::string();
+        record.state = plant->getCurrentStateName();
+        record.price = profile ? profile->getUnitPrice(DEFAULT_PLANT_PRICE) : DEFAULT_PLANT_PRICE;
+        record.stateStart = plant->getStateStartTime();
+        inventoryIndex.addPlant(plant, record);
+        tracked = inventoryIndex.findPlant(plant);
+        plant->setInventoryObserver(this);
+    }
+
+    unsigned int locations = tracked->locations;
+    bool wasHeld = (locations & heldMask) != 0;
+    if (present == ((locations & bit) != 0))
+    {
+        return;
+    }
+
+    if (present)
+    {
+        locations |= bit;
+        valuation.addToLocation(location, tracked->species);
+    }
+    else
+    {
+        locations &= ~bit;
+        valuation.removeFromLocation(location, tracked->species);
+    }
+
+    bool isHeld = (locations & heldMask) != 0;
+    if (isHeld && !wasHeld)
+    {
+        valuation.addPlant(tracked->species, tracked->state, tracked->price);
+    }
+    else if (wasHeld && !isHeld)
+    {
+        valuation.removePlant(tracked->species, tracked->state, tracked->price);
+    }
+
+    if (locations == 0)
+    {
+        plant->setInventoryObserver(nullptr);
+        inventoryIndex.removePlant(plant);
+    }
+    else
+    {
+        inventoryIndex.setLocations(plant, locations);
     }
 }
 
 void InventoryManager::moveToSalesFloor(PlantProduct *plant)
 {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     if (plant)
     {
         // Check if plant is not already in sales floor
-        auto it = std::find(readyForSalePlants.begin(), readyForSalePlants.end(), plant);
-        if (it == readyForSalePlants.end())
+        if (!isPlantAt(plant, ON_SALES_FLOOR))
         {
             readyForSalePlants.push_back(plant);
             plantsInStock++;
-            std::cout << "Plant moved to sales floor inventory. Total plants ready for sale: "
-                      << readyForSalePlants.size() << std::endl;
+            setPlantLocation(plant, ON_SALES_FLOOR, true);
+            publishPlantChange(InventoryChangeEvent::PLANT_MOVED, plant, ON_SALES_FLOOR);
+            GH_LOG_INFO(Logger::INVENTORY, "Plant moved to sales floor inventory. Total plants ready for sale: "
+                                               << readyForSalePlants.size());
         }
         else
         {
-            std::cout << "Plant is already in sales floor inventory." << std::endl;
+            GH_LOG_DEBUG(Logger::INVENTORY, "Plant is already in sales floor inventory.");
         }
     }
 }
 
 void InventoryManager::addToGreenhouse(PlantProduct *plant)
 {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     if (plant)
     {
         // Check if plant is not already in greenhouse
-        auto it = std::find(greenHouseInventory.begin(), greenHouseInventory.end(), plant);
-        if (it == greenHouseInventory.end())
+        if (!isPlantAt(plant, IN_GREENHOUSE))
         {
             greenHouseInventory.push_back(plant);
-            std::cout << "Plant added to greenhouse inventory. Total plants in greenhouse: "
-                      << greenHouseInventory.size() << std::endl;
+            setPlantLocation(plant, IN_GREENHOUSE, true);
+            publishPlantChange(InventoryChangeEvent::PLANT_ADDED, plant, IN_GREENHOUSE);
+            GH_LOG_INFO(Logger::INVENTORY, "Plant added to greenhouse inventory. Total plants in greenhouse: "
+                                               << greenHouseInventory.size());
         }
         else
         {
-            std::cout << "Plant is already in greenhouse inventory." << std::endl;
+            GH_LOG_DEBUG(Logger::INVENTORY, "Plant is already in greenhouse inventory.");
         }
     }
 }
 
 void InventoryManager::removeFromGreenhouse(PlantProduct *plant)
 {
-    auto it = std::find(greenHouseInventory.begin(), greenHouseInventory.end(), plant);
-    if (it != greenHouseInventory.end())
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    if (isPlantAt(plant, IN_GREENHOUSE))
     {
-        greenHouseInventory.erase(it);
-        std::cout << "Plant removed from greenhouse inventory. Remaining plants in greenhouse: "
-                  << greenHouseInventory.size() << std::endl;
+        greenHouseInventory.erase(std::find(greenHouseInventory.begin(), greenHouseInventory.end(), plant));
+        setPlantLocation(plant, IN_GREENHOUSE, false);
+        publishPlantChange(InventoryChangeEvent::PLANT_REMOVED, plant, IN_GREENHOUSE);
+        GH_LOG_INFO(Logger::INVENTORY, "Plant removed from greenhouse inventory. Remaining plants in greenhouse: "
+                                           << greenHouseInventory.size());
     }
     else
     {
-        std::cout << "Plant not found in greenhouse inventory." << std::endl;
+        GH_LOG_WARN(Logger::INVENTORY, "Plant not found in greenhouse inventory.");
     }
 }
 
 bool InventoryManager::isPlantInGreenhouse(PlantProduct *plant) const
 {
-    auto it = std::find(greenHouseInventory.begin(), greenHouseInventory.end(), plant);
-    return it != greenHouseInventory.end();
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    return isPlantAt(plant, IN_GREENHOUSE);
 }
 
 // Order validation methods
 bool InventoryManager::isPlantAvailableForSale(const std::string &plantType, int quantity) const
 {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     return getAvailablePlantCount(plantType) >= quantity;
 }
 
 bool InventoryManager::isPotAvailable(const std::string &potType, int quantity) const
 {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     return getAvailablePotCount(potType) >= quantity;
 }
 
 std::vector<PlantProduct *> InventoryManager::getAvailablePlantsByType(const std::string &plantType) const
 {
-    std::vector<PlantProduct *> availablePlants;
-
-    for (PlantProduct *plant : readyForSalePlants)
-    {
-        if (plant && plant->getProfile() &&
-            plant->getProfile()->getSpeciesName() == plantType)
-        {
-            availablePlants.push_back(plant);
-        }
-    }
-
-    return availablePlants;
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    PlantQuery query;
+    query.species = plantType;
+    query.location = ON_SALES_FLOOR;
+    return findPlants(query);
 }
 
 int InventoryManager::getAvailablePlantCount(const std::string &plantType) const
 {
-    int count = 0;
-
-    for (PlantProduct *plant : readyForSalePlants)
-    {
-        if (plant && plant->getProfile() &&
-            plant->getProfile()->getSpeciesName() == plantType)
-        {
-            count++;
-        }
-    }
-
-    return count;
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    return valuation.getLocationCount(ON_SALES_FLOOR, plantType) - getHeldPlantCount(plantType);
 }
 
 // int InventoryManager::getAvailablePotCount(const std::string &potType) const
@@ -233,65 +399,228 @@ int InventoryManager::getAvailablePlantCount(const std::string &plantType) const
 
 int InventoryManager::getAvailablePotCount(const std::string &potType) const
 {
-    int count = 0;
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    std::map<std::string, int>::const_iterator it = potCountsByType.find(potType);
+    return (it != potCountsByType.end() ? it->second : 0) - getHeldPotCount(potType);
+}
+
+bool InventoryManager::isStockedPotType(const std::string &potType) const
+{
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    return trackedPotTypes.count(potType) != 0;
+}
 
-    for (Pot *pot : potInventory)
+int InventoryManager::getPotCountByAttribute(const std::string &attribute, const std::string &value) const
+{
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    std::map<std::string, std::map<std::string, int> >::const_iterator attr = potCountsByAttribute.find(attribute);
+    if (attr == potCountsByAttribute.end())
+    {
+        return 0;
+    }
+    std::map<std::string, int>::const_iterator it = attr->second.find(value);
+    return it != attr->second.end() ? it->second : 0;
+}
+
+// Each demand map is walked once against the indexed counts; no inventory vector is scanned
+bool InventoryManager::checkOrderStock(const FlattenedOrder &order, std::vector<StockShortage> *shortages) const
+{
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    bool available = true;
+    const std::map<std::string, int> &plants = order.getSpeciesDemand();
+    for (std::map<std::string, int>::const_iterator it = plants.begin(); it != plants.end(); ++it)
     {
-        if (pot && pot->getPotType() == potType)
+        int free = getAvailablePlantCount(it->first);
+        if (free < it->second)
         {
-            count++;
+            available = false;
+            if (shortages)
+            {
+                StockShortage shortage = {it->first, false, it->second, free};
+                shortages->push_back(shortage);
+            }
         }
     }
 
-    return count;
+    const std::map<std::string, int> &pots = order.getPotDemand();
+    for (std::map<std::string, int>::const_iterator it = pots.begin(); it != pots.end(); ++it)
+    {
+        if (trackedPotTypes.count(it->first) == 0)
+        {
+            continue; // not a stocked material (e.g. builder presets such as "Ceramic"), supplied with the order
+        }
+        int free = getAvailablePotCount(it->first);
+        if (free < it->second)
+        {
+            available = false;
+            if (shortages)
+            {
+                StockShortage shortage = {it->first, true, it->second, free};
+                shortages->push_back(shortage);
+            }
+        }
+    }
+    return available;
 }
 
-bool InventoryManager::reservePlantsForOrder(const std::string &plantType, int quantity)
+std::uint64_t InventoryManager::reserveOrder(const FlattenedOrder &order, std::vector<StockShortage> *shortages)
 {
-    std::vector<PlantProduct *> availablePlants = getAvailablePlantsByType(plantType);
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    if (!checkOrderStock(order, shortages))
+    {
+        return 0;
+    }
 
-    if (static_cast<int>(availablePlants.size()) >= quantity)
+    std::uint64_t reservationId = IdGenerator::getInstance().next();
+    Reservation &reservation = reservations[reservationId];
+    reservation.plants = order.getSpeciesDemand();
+    for (const auto &pot : order.getPotDemand())
     {
-        std::cout << "Reserved " << quantity << " " << plantType << " plants for order." << std::endl;
-        return true;
+        if (trackedPotTypes.count(pot.first) != 0)
+        {
+            reservation.pots.insert(pot);
+        }
     }
-    else
+
+    for (const auto &plant : reservation.plants)
     {
-        std::cout << "Cannot reserve " << quantity << " " << plantType
-                  << " plants. Only " << availablePlants.size() << " available." << std::endl;
-        return false;
+        adjustHold(heldPlants, plant.first, plant.second);
+        publishReservation(InventoryChangeEvent::PLANTS_RESERVED, plant.first, plant.second);
+    }
+    for (const auto &pot : reservation.pots)
+    {
+        adjustHold(heldPots, pot.first, pot.second);
+        publishReservation(InventoryChangeEvent::POTS_RESERVED, pot.first, pot.second);
     }
+    return reservationId;
 }
 
-bool InventoryManager::reservePotsForOrder(const std::string &potType, int quantity)
+void InventoryManager::reserveOrders(const std::vector<const FlattenedOrder *> &orders,
+                                     std::vector<std::uint64_t> &reservationIds,
+                                     std::vector<std::vector<StockShortage> > *shortages)
 {
-    int availablePots = getAvailablePotCount(potType);
-
-    if (availablePots >= quantity)
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    reservationIds.assign(orders.size(), 0);
+    if (shortages)
     {
-        std::cout << "Reserved " << quantity << " " << potType << " pots for order." << std::endl;
-        return true;
+        shortages->assign(orders.size(), std::vector<StockShortage>());
     }
-    else
+    for (std::size_t i = 0; i < orders.size(); ++i)
+    {
+        if (orders[i])
+        {
+            reservationIds[i] = reserveOrder(*orders[i], shortages ? &(*shortages)[i] : nullptr);
+        }
+    }
+}
+
+bool InventoryManager::commitReservation(std::uint64_t reservationId)
+{
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    std::unordered_map<std::uint64_t, Reservation>::iterator it = reservations.find(reservationId);
+    if (it == reservations.end())
     {
-        std::cout << "Cannot reserve " << quantity << " " << potType
-                  << " pots. Only " << availablePots << " available." << std::endl;
         return false;
     }
+
+    // Check every line before touching anything, so a failed commit leaves the reservation and its holds as they were
+    for (const auto &plant : it->second.plants)
+    {
+        if (valuation.getLocationCount(ON_SALES_FLOOR, plant.first) < plant.second)
+        {
+            GH_LOG_WARN(Logger::INVENTORY, "Cannot commit reservation " << reservationId << ": " << plant.second << " "
+                                                                        << plant.first << " held but fewer on the floor");
+            return false;
+        }
+    }
+    std::vector<Pot *> handedOver;
+    for (const auto &pot : it->second.pots)
+    {
+        PotQuery query;
+        query.material = pot.first;
+        query.limit = static_cast<size_t>(pot.second);
+        std::vector<Pot *> found = findPots(query);
+        if (static_cast<int>(found.size()) < pot.second)
+        {
+            GH_LOG_WARN(Logger::INVENTORY, "Cannot commit reservation " << reservationId << ": " << pot.second << " "
+                                                                        << pot.first << " pots held but fewer in stock");
+            return false;
+        }
+        handedOver.insert(handedOver.end(), found.begin(), found.end());
+    }
+
+    // Everything is there and the lock is held, so none of the steps below can fail
+    for (const auto &plant : it->second.plants)
+    {
+        adjustHold(heldPlants, plant.first, -plant.second);
+        sellFromSalesFloor(plant.first, plant.second);
+    }
+    for (const auto &pot : it->second.pots)
+    {
+        adjustHold(heldPots, pot.first, -pot.second);
+    }
+    reservations.erase(it);
+
+    // Orders only record a pot's type and price, so the sold pots leave the inventory for good
+    for (Pot *pot : handedOver)
+    {
+        removePot(pot);
+        if (std::find(potInventory.begin(), potInventory.end(), pot) == potInventory.end())
+        {
+            delete pot; // unless the same pot was added more than once
+        }
+    }
+    return true;
+}
+
+void InventoryManager::releaseReservation(std::uint64_t reservationId)
+{
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    std::unordered_map<std::uint64_t, Reservation>::iterator it = reservations.find(reservationId);
+    if (it == reservations.end())
+    {
+        return;
+    }
+    for (const auto &plant : it->second.plants)
+    {
+        adjustHold(heldPlants, plant.first, -plant.second);
+        publishReservation(InventoryChangeEvent::PLANTS_RELEASED, plant.first, plant.second);
+    }
+    for (const auto &pot : it->second.pots)
+    {
+        adjustHold(heldPots, pot.first, -pot.second);
+        publishReservation(InventoryChangeEvent::POTS_RELEASED, pot.first, pot.second);
+    }
+    reservations.erase(it);
+}
+
+void InventoryManager::adjustHold(std::map<std::string, int> &held, const std::string &itemType, int delta)
+{
+    int &count = held[itemType];
+    count += delta;
+    if (count <= 0)
+    {
+        held.erase(itemType);
+    }
 }
 
-void InventoryManager::releasePlantsFromOrder(const std::string &plantType, int quantity)
+int InventoryManager::getHeldPlantCount(const std::string &plantType) const
 {
-    std::cout << "Released " << quantity << " " << plantType << " plants from order reservation." << std::endl;
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    std::map<std::string, int>::const_iterator it = heldPlants.find(plantType);
+    return it != heldPlants.end() ? it->second : 0;
 }
 
-void InventoryManager::releasePotsFromOrder(const std::string &potType, int quantity)
+int InventoryManager::getHeldPotCount(const std::string &potType) const
 {
-    std::cout << "Released " << quantity << " " << potType << " pots from order reservation." << std::endl;
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    std::map<std::string, int>::const_iterator it = heldPots.find(potType);
+    return it != heldPots.end() ? it->second : 0;
 }
 
 void InventoryManager::printInventoryReport() const
 {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     std::cout << "\n=== INVENTORY DATABASE REPORT ===" << std::endl;
     std::cout << "Greenhouse Inventory: " << greenHouseInventory.size() << " plants" << std::endl;
     std::cout << "Sales Floor Inventory: " << readyForSalePlants.size() << " plants" << std::endl;
@@ -299,15 +628,19 @@ void InventoryManager::printInventoryReport() const
     std::cout << "Pot Inventory: " << potInventory.size() << " pots" << std::endl;
 
     // Group plants by type
-    std::cout << "\nPlants Ready for Sale by Type:" << std::endl;
-    for (PlantProduct *plant : readyForSalePlants)
+    std::cout << "\nPlants in Stock by Type (on sales floor / total value):" << std::endl;
+    const std::map<std::string, InventoryValuation::Totals> &speciesTotals = valuation.getAllSpeciesTotals();
+    for (const auto &species : speciesTotals)
     {
-        if (plant && plant->getProfile())
-        {
-            std::cout << "  - " << plant->getProfile()->getSpeciesName() << std::endl;
-        }
+        std::cout << "  - " << species.first << ": "
+                  << valuation.getLocationCount(ON_SALES_FLOOR, species.first) << " / R"
+                  << species.second.getValue() << std::endl;
     }
 
+    std::cout << "\nInventory Value:" << std::endl;
+    std::cout << "  Plants: R" << getTotalPlantInventoryValue() << std::endl;
+    std::cout << "  Pots: R" << getTotalPotInventoryValue() << std::endl;
+
     // ADDED SECTION FOR POTS
     std::cout << "\nPots in Inventory by Type:" << std::endl;
     std::cout << "  Clay: " << getAvailablePotCount("Clay") << std::endl;
@@ -315,32 +648,56 @@ void InventoryManager::printInventoryReport() const
     std::cout << "  Metal: " << getAvailablePotCount("Metal") << std::endl;
     std::cout << "  Plastic: " << getAvailablePotCount("Plastic") << std::endl;
     std::cout << "  Wooden: " << getAvailablePotCount("Wooden") << std::endl;
+
+    if (!potCountsByAttribute.empty())
+    {
+        std::cout << "\nPots by Decoration:" << std::endl;
+        for (const auto &attribute : potCountsByAttribute)
+        {
+            for (const auto &value : attribute.second)
+            {
+                std::cout << "  " << attribute.first << " " << value.first << ": " << value.second << std::endl;
+            }
+        }
+    }
     std::cout << "=================================" << std::endl;
 }
 
 bool InventoryManager::sellPlants(const std::string &plantType, int quantity)
 {
-    std::vector<PlantProduct *> plantsToSell;
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    if (quantity <= 0)
+    {
+        return false;
+    }
 
-    // Find the required quantity of plants
-    for (PlantProduct *plant : readyForSalePlants)
+    // Units held for other orders are not for sale
+    int available = getAvailablePlantCount(plantType);
+    if (available < quantity)
     {
-        if (plant && plant->getProfile() &&
-            plant->getProfile()->getSpeciesName() == plantType)
-        {
-            plantsToSell.push_back(plant);
-            if ((int)plantsToSell.size() >= quantity)
-            {
-                break;
-            }
-        }
+        GH_LOG_WARN(Logger::INVENTORY, "Cannot sell " << quantity << " " << plantType << " - only " << available
+                                                      << " available");
+        return false;
     }
 
+    return sellFromSalesFloor(plantType, quantity);
+}
+
+bool InventoryManager::sellFromSalesFloor(const std::string &plantType, int quantity)
+{
+    // Find the required quantity of plants, longest on the floor first
+    PlantQuery query;
+    query.species = plantType;
+    query.location = ON_SALES_FLOOR;
+    query.sort = PlantQuery::OLDEST_FIRST;
+    query.limit = quantity;
+    std::vector<PlantProduct *> plantsToSell = findPlants(query);
+
     // Check if we have enough
     if ((int)plantsToSell.size() < quantity)
     {
-        std::cout << "Cannot sell " << quantity << " " << plantType
-                  << " - only " << plantsToSell.size() << " available" << std::endl;
+        GH_LOG_WARN(Logger::INVENTORY, "Cannot sell " << quantity << " " << plantType << " - only "
+                                                      << plantsToSell.size() << " available");
         return false;
     }
 
@@ -351,33 +708,35 @@ bool InventoryManager::sellPlants(const std::string &plantType, int quantity)
         markAsSold(plant);
     }
 
-    std::cout << "Successfully sold " << quantity << " " << plantType << " plant(s)" << std::endl;
+    GH_LOG_INFO(Logger::INVENTORY, "Successfully sold " << quantity << " " << plantType << " plant(s)");
     return true;
 }
 
 void InventoryManager::removeFromSalesFloor(PlantProduct *plant)
 {
-    auto it = std::find(readyForSalePlants.begin(), readyForSalePlants.end(), plant);
-    if (it != readyForSalePlants.end())
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    if (isPlantAt(plant, ON_SALES_FLOOR))
     {
-        readyForSalePlants.erase(it);
+        readyForSalePlants.erase(std::find(readyForSalePlants.begin(), readyForSalePlants.end(), plant));
         plantsInStock--;
-        std::cout << "  [Removed from sales floor: "
-                  << plant->getProfile()->getSpeciesName() << "]" << std::endl;
+        setPlantLocation(plant, ON_SALES_FLOOR, false);
+        publishPlantChange(InventoryChangeEvent::PLANT_REMOVED, plant, ON_SALES_FLOOR);
+        GH_LOG_DEBUG(Logger::INVENTORY, "Removed from sales floor: " << plant->getProfile()->getSpeciesName());
     }
 }
 
 void InventoryManager::markAsSold(PlantProduct *plant)
 {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     if (plant)
     {
         // Check if not already in sold list
-        auto it = std::find(soldPlants.begin(), soldPlants.end(), plant);
-        if (it == soldPlants.end())
+        if (!isPlantAt(plant, SOLD))
         {
             soldPlants.push_back(plant);
-            std::cout << "  [Marked as sold: "
-                      << plant->getProfile()->getSpeciesName() << "]" << std::endl;
+            setPlantLocation(plant, SOLD, true);
+            publishPlantChange(InventoryChangeEvent::PLANT_SOLD, plant, SOLD);
+            GH_LOG_DEBUG(Logger::INVENTORY, "Marked as sold: " << plant->getProfile()->getSpeciesName());
         }
     }
 }
@@ -385,8 +744,13 @@ void InventoryManager::markAsSold(PlantProduct *plant)
 
 
 void InventoryManager::addCustomPot(Pot* pot) {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     if (pot) {
         potInventory.push_back(pot);
+        updatePotCounts(pot, 1);
+        valuation.addPot(potValue(pot));
+        inventoryIndex.addPot(pot, potValue(pot));
+        publishPotChange(InventoryChangeEvent::POT_ADDED, pot, pot->getPotType(), 1);
         std::cout << "[Inventory] Added pot: ";
         pot->print();
         std::cout << std::endl;
@@ -394,6 +758,7 @@ void InventoryManager::addCustomPot(Pot* pot) {
 }
 
 Pot* InventoryManager::getPotByIndex(int index) {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     if (index >= 0 && index < (int)potInventory.size()) {
         return potInventory[index];
     }
@@ -401,6 +766,7 @@ Pot* InventoryManager::getPotByIndex(int index) {
 }
 
 void InventoryManager::displayPotInventory() const {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     std::cout << "\n=== POT INVENTORY ===" << std::endl;
     std::cout << "Total: " << potInventory.size() << " pots" << std::endl;
     std::cout << std::string(70, '-') << std::endl;
@@ -421,18 +787,133 @@ void InventoryManager::displayPotInventory() const {
 }
 
 double InventoryManager::getTotalPotInventoryValue() const {
-    double total = 0.0;
-    for (Pot* pot : potInventory) {
-        PotDecorator* decorator = dynamic_cast<PotDecorator*>(pot);
-        if (decorator) {
-            total += decorator->getPrice();
-        } else {
-            total += 10.0;
-        }
-    }
-    return total;
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    return valuation.getTotalPotValue();
 }
 
 int InventoryManager::getPotInventoryCount() const {
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
     return potInventory.size();
-}
\ No newline at end of file
+}
+
+bool InventoryManager::saveSnapshot(const std::string &path) const
+{
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    return InventorySnapshot::save(*this, path);
+}
+
+bool InventoryManager::loadSnapshot(const std::string &path)
+{
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    return InventorySnapshot::load(*this, path);
+}
+
+InventoryValuation InventoryManager::getValuation() const
+{
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    return valuation;
+}
+
+double InventoryManager::getTotalPlantInventoryValue() const
+{
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    return valuation.getPlantTotals().getValue();
+}
+
+int InventoryManager::getPlantCount(PlantLocation location) const
+{
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    return valuation.getLocationCount(location);
+}
+
+std::vector<PlantProduct *> InventoryManager::findPlants(const PlantQuery &query) const
+{
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    return inventoryIndex.findPlants(query, std::chrono::steady_clock::now());
+}
+
+std::vector<Pot *> InventoryManager::findPots(const PotQuery &query) const
+{
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    return inventoryIndex.findPots(query);
+}
+
+InventoryChangeStream &InventoryManager::getChangeStream()
+{
+    return changeStream;
+}
+
+void InventoryManager::publishPlantChange(InventoryChangeEvent::Type type, PlantProduct *plant, int location)
+{
+    InventoryChangeEvent event;
+    event.type = type;
+    event.plant = plant;
+    event.location = location;
+    event.state = plant->getCurrentStateName();
+    if (plant->getProfile())
+    {
+        event.species = plant->getProfile()->getSpeciesName();
+    }
+    changeStream.publish(event);
+}
+
+void InventoryManager::publishPotChange(InventoryChangeEvent::Type type, Pot *pot, const std::string &potType, int quantity)
+{
+    InventoryChangeEvent event;
+    event.type = type;
+    event.pot = pot;
+    event.potType = potType;
+    event.quantity = quantity;
+    changeStream.publish(event);
+}
+
+void InventoryManager::publishReservation(InventoryChangeEvent::Type type, const std::string &itemType, int quantity)
+{
+    InventoryChangeEvent event;
+    event.type = type;
+    event.quantity = quantity;
+    if (type == InventoryChangeEvent::POTS_RESERVED || type == InventoryChangeEvent::POTS_RELEASED)
+    {
+        event.potType = itemType;
+    }
+    else
+    {
+        event.species = itemType;
+    }
+    changeStream.publish(event);
+}
+
+void InventoryManager::setAutoSnapshotPath(const std::string &path)
+{
+    std::lock_guard<std::recursive_mutex> lock(orderMutex);
+    autoSnapshotPath = path;
+}
+
+void InventoryManager::adoptProfiles(const std::vector<PlantSpeciesProfile *> &profiles)
+{
+    restoredProfiles.insert(restoredProfiles.end(), profiles.begin(), profiles.end());
+}
+
+void InventoryManager::reservePlants(size_t additional)
+{
+    inventoryIndex.reservePlants(additional);
+}
+
+void InventoryManager::restorePlant(PlantProduct *plant, PlantLocation location)
+{
+    switch (location)
+    {
+    case IN_GREENHOUSE:
+        greenHouseInventory.push_back(plant);
+        break;
+    case ON_SALES_FLOOR:
+        readyForSalePlants.push_back(plant);
+        plantsInStock++;
+        break;
+    case SOLD:
+        soldPlants.push_back(plant);
+        break;
+    }
+    setPlantLocation(plant, location, true);
+    publishPlantChange(InventoryChangeEvent::PLANT_ADDED, plant, location);
+}
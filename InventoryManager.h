@@ -1,11 +1,23 @@
 #ifndef INVENTORY_MANAGER_H
 #define INVENTORY_MANAGER_H
 
+#include "InventoryChangeStream.h"
+#include "InventoryIndex.h"
+#include "InventoryQuery.h"
+#include "InventoryValuation.h"
 #include "LifeCycleObserver.h"
 #include "PlantProduct.h"
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
+class FlattenedOrder;
 class Pot;
+class PlantSpeciesProfile;
 
 /**
  * @brief Singleton Database-like Inventory Manager with Reference-Only Access
@@ -19,6 +31,25 @@ class Pot;
  */
 class InventoryManager : public LifeCycleObserver
 {
+    friend class InventorySnapshot;
+
+public:
+    // Where a tracked plant currently lives
+    enum PlantLocation
+    {
+        IN_GREENHOUSE,
+        ON_SALES_FLOOR,
+        SOLD
+    };
+
+    // One plant species or pot material an order needs more of than is free
+    struct StockShortage
+    {
+        std::string itemType;
+        bool isPot;
+        int requested;
+        int available;
+    };
 
 private:
     // Private constructor - can't be instantiated externally
@@ -35,6 +66,61 @@ private:
 
     int plantsInStock;
 
+    // Pot counts kept in step with potInventory so availability checks never scan it
+    std::map<std::string, int> potCountsByType;                              // material -> count
+    std::map<std::string, std::map<std::string, int> > potCountsByAttribute; // "Color" -> "Red" -> count
+
+    std::set<std::string> trackedPotTypes; // every material ever stocked; other pot types are not inventory items
+
+    void updatePotCounts(const Pot *pot, int delta);
+
+    // Stock held for validated orders until they are paid for (commit) or abandoned (release).
+    // Held units stay on the floor but no longer count as available.
+    struct Reservation
+    {
+        std::map<std::string, int> plants;
+        std::map<std::string, int> pots;
+    };
+    std::unordered_map<std::uint64_t, Reservation> reservations;
+    std::map<std::string, int> heldPlants;
+    std::map<std::string, int> heldPots;
+
+    // Taken by every public operation - the vectors, index, valuation, pot counts and reservations all
+    // change together - so order pipeline workers, staff and care commands can call in concurrently.
+    // Recursive because operations call each other (commits sell, sales look up availability)
+    mutable std::recursive_mutex orderMutex;
+
+    void adjustHold(std::map<std::string, int> &held, const std::string &itemType, int delta);
+
+    // Moves the oldest plants of a type from the floor to sold, ignoring holds (callers check availability)
+    bool sellFromSalesFloor(const std::string &plantType, int quantity);
+
+    // Where each plant is and what it was last valued as, so membership checks,
+    // aggregate updates and queries never scan the inventory vectors
+    InventoryIndex inventoryIndex;
+    InventoryValuation valuation;
+
+    // Every mutation below is also published here for incremental consumers
+    InventoryChangeStream changeStream;
+    void publishPlantChange(InventoryChangeEvent::Type type, PlantProduct *plant, int location);
+    void publishPotChange(InventoryChangeEvent::Type type, Pot *pot, const std::string &potType, int quantity);
+    void publishReservation(InventoryChangeEvent::Type type, const std::string &itemType, int quantity);
+
+    void setPlantLocation(PlantProduct *plant, PlantLocation location, bool present);
+    bool isPlantAt(PlantProduct *plant, PlantLocation location) const;
+    static double potValue(const Pot *pot);
+
+    // Species profiles recreated by a snapshot restore (owned by the inventory)
+    std::vector<PlantSpeciesProfile *> restoredProfiles;
+
+    // Snapshot written automatically by cleanup(), empty when disabled
+    std::string autoSnapshotPath;
+
+    // Snapshot restore hooks - append without per-plant console output
+    void adoptProfiles(const std::vector<PlantSpeciesProfile *> &profiles);
+    void restorePlant(PlantProduct *plant, PlantLocation location);
+    void reservePlants(size_t additional);
+
 public:
     // Delete copy operations to maintain singleton property
     InventoryManager(const InventoryManager &) = delete;
@@ -69,6 +155,13 @@ public:
     void addPot(Pot *pot);
     void removePot(Pot *pot);
 
+    // Decorated pot management (Decorator pattern client)
+    void addCustomPot(Pot *pot);
+    Pot *getPotByIndex(int index);
+    void displayPotInventory() const;
+    double getTotalPotInventoryValue() const;
+    int getPotInventoryCount() const;
+
     // Methods for moving plants between greenhouse and sales floor
     void moveToSalesFloor(PlantProduct *plant);
     void addToGreenhouse(PlantProduct *plant);
@@ -80,21 +173,73 @@ public:
     bool isPotAvailable(const std::string &potType, int quantity) const;
     std::vector<PlantProduct *> getAvailablePlantsByType(const std::string &plantType) const;
 
-    // Reserve/release methods for order processing
-    bool reservePlantsForOrder(const std::string &plantType, int quantity);
-    bool reservePotsForOrder(const std::string &potType, int quantity);
-    void releasePlantsFromOrder(const std::string &plantType, int quantity);
-    void releasePotsFromOrder(const std::string &potType, int quantity);
+    /**
+     * @brief Checks a whole order's species and pot demand against the indexed counts
+     * @param shortages If given, receives every line that cannot be met
+     * @return true if everything the order needs is available
+     */
+    bool checkOrderStock(const FlattenedOrder &order, std::vector<StockShortage> *shortages) const;
+
+    /**
+     * @brief Checks and holds an order's entire demand in one step (all or nothing)
+     * @return Reservation ID for commitReservation/releaseReservation, or 0 if anything is short
+     */
+    std::uint64_t reserveOrder(const FlattenedOrder &order, std::vector<StockShortage> *shortages);
 
-    // Inventory search and reporting
+    /**
+     * @brief Reserves a batch of orders in one locked pass, in the given priority order
+     *
+     * Each order is all or nothing against whatever the orders before it left
+     * over, so the caller's ordering is the allocation policy.
+     * @param reservationIds Receives one ID per order, 0 where the order could not be met
+     * @param shortages If given, receives each order's shortages (same indexing)
+     */
+    void reserveOrders(const std::vector<const FlattenedOrder *> &orders, std::vector<std::uint64_t> &reservationIds,
+                       std::vector<std::vector<StockShortage> > *shortages);
+
+    /**
+     * @brief Sells the held plants and takes the held pots out of stock (all or nothing)
+     * @return false if the ID is unknown or held stock went missing; the reservation and its holds are then
+     *         left in place for the caller to release
+     */
+    bool commitReservation(std::uint64_t reservationId);
+
+    /** @brief Returns held stock to the available counts; unknown IDs are ignored */
+    void releaseReservation(std::uint64_t reservationId);
+
+    int getHeldPlantCount(const std::string &plantType) const;
+    int getHeldPotCount(const std::string &potType) const;
+
+    // Inventory search and reporting (available = in stock and not held for an order)
     int getAvailablePlantCount(const std::string &plantType) const;
     int getAvailablePotCount(const std::string &potType) const;
+    // Pot types that are not stocked (e.g. builder presets) come with the order and are never short
+    bool isStockedPotType(const std::string &potType) const;
+    int getPotCountByAttribute(const std::string &attribute, const std::string &value) const;
     void printInventoryReport() const;
 
+    // Running valuation aggregates - O(1) reads for dashboards and reports
+    static const double DEFAULT_PLANT_PRICE;
+    InventoryValuation getValuation() const; // a copy, so it stays consistent while the inventory changes
+    double getTotalPlantInventoryValue() const;
+    int getPlantCount(PlantLocation location) const;
+
+    // Indexed catalog queries (see InventoryQuery.h)
+    std::vector<PlantProduct *> findPlants(const PlantQuery &query) const;
+    std::vector<Pot *> findPots(const PotQuery &query) const;
+
+    // Change-data-capture: subscribe a cursor and poll for deltas instead of re-reading inventories
+    InventoryChangeStream &getChangeStream();
+
     // Methods for handling sold plants
     bool sellPlants(const std::string &plantType, int quantity);
     void removeFromSalesFloor(PlantProduct *plant);
     void markAsSold(PlantProduct *plant);
+
+    // Persistence - binary snapshot of all inventories (see InventorySnapshot)
+    bool saveSnapshot(const std::string &path) const;
+    bool loadSnapshot(const std::string &path);
+    void setAutoSnapshotPath(const std::string &path);
 };
 
 #endif // INVENTORY_MANAGER_H
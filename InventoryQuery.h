@@ -0,0 +1,84 @@
+#ifndef INVENTORY_QUERY_H
+#define INVENTORY_QUERY_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Filter, sort and limit for InventoryManager::findPlants
+ *
+ * Empty strings and negative numbers mean "no filter". For example, ready-for-sale
+ * succulents under R50 that have been on the floor more than 3 days, oldest first:
+ * @code
+ * PlantQuery query;
+ * query.category = "Succulent";
+ * query.state = "ReadyForSale";
+ * query.location = InventoryManager::ON_SALES_FLOOR;
+ * query.maxPrice = 50.0;
+ * query.minSecondsInState = 3 * 24 * 60 * 60;
+ * query.sort = PlantQuery::OLDEST_FIRST;
+ * std::vector<PlantProduct *> plants = InventoryManager::getInstance().findPlants(query);
+ * @endcode
+ */
+struct PlantQuery
+{
+    enum SortOrder
+    {
+        UNSORTED,
+        OLDEST_FIRST,  // longest time in current state first
+        NEWEST_FIRST,
+        CHEAPEST_FIRST,
+        PRICIEST_FIRST
+    };
+
+    static const int ANY_LOCATION = -1;
+
+    std::string category; // profile "category" property: Flower, Succulent, Tree
+    std::string species;
+    std::string state; // PlantState::getName(): Planted, InNursery, Growing, ReadyForSale, Withering
+    int location;      // InventoryManager::PlantLocation or ANY_LOCATION
+
+    double minPrice;
+    double maxPrice;
+    int minSecondsInState;
+    int maxSecondsInState;
+
+    SortOrder sort;
+    size_t limit; // 0 = no limit
+
+    PlantQuery()
+        : location(ANY_LOCATION), minPrice(-1.0), maxPrice(-1.0),
+          minSecondsInState(-1), maxSecondsInState(-1), sort(UNSORTED), limit(0) {}
+};
+
+/**
+ * @brief Filter, sort and limit for InventoryManager::findPots
+ *
+ * Every listed attribute must be present on the pot, e.g. ("Color", "Red").
+ * Unsorted results, and pots at the same price, come out in the order the pots
+ * were added.
+ */
+struct PotQuery
+{
+    enum SortOrder
+    {
+        UNSORTED,
+        CHEAPEST_FIRST,
+        PRICIEST_FIRST
+    };
+
+    std::string material; // Pot::getPotType(): Clay, Glass, Metal, Plastic, Wooden
+    std::vector<std::pair<std::string, std::string> > attributes;
+
+    double minPrice;
+    double maxPrice;
+
+    SortOrder sort;
+    size_t limit; // 0 = no limit
+
+    PotQuery() : minPrice(-1.0), maxPrice(-1.0), sort(UNSORTED), limit(0) {}
+};
+
+#endif // INVENTORY_QUERY_H
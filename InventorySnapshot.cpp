@@ -0,0 +1,389 @@
+#include "InventorySnapshot.h"
+#include "InventoryManager.h"
+#include "AtomicFile.h"
+#include "BinaryCodec.h"
+#include "MappedFile.h"
+#include "PlantProduct.h"
+#include "PlantSpeciesProfile.h"
+#include "SucculentProfile.h"
+#include "FlowerProfile.h"
+#include "TreeProfile.h"
+#include "PlantedState.h"
+#include "InNurseryState.h"
+#include "GrowingState.h"
+#include "ReadyForSaleState.h"
+#include "WitheringState.h"
+#include "Pot.h"
+#include "ClayPotFactory.h"
+#include "GlassPotFactory.h"
+#include "MetalPotFactory.h"
+#include "PlasticPotFactory.h"
+#include "WoodenPotFactory.h"
+#include "PotDecorator/ColorDecorator.h"
+#include "PotDecorator/FinishDecorator.h"
+#include "PotDecorator/TextureDecorator.h"
+#include "PotDecorator/PatternDecorator.h"
+#include "PotDecorator/FeatureDecorator.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    const char SNAPSHOT_MAGIC[8] = {'G', 'H', 'S', 'N', 'A', 'P', '0', '1'};
+    const std::uint32_t NO_PROFILE = 0xFFFFFFFFu;
+
+    enum SnapshotLocation
+    {
+        LOCATION_GREENHOUSE = 0,
+        LOCATION_SALES_FLOOR = 1,
+        LOCATION_SOLD = 2
+    };
+
+    // Lifecycle states are stored as codes rather than names
+    const char *const STATE_NAMES[] = {"Planted", "InNursery", "Growing", "ReadyForSale", "Withering"};
+    const std::uint8_t STATE_COUNT = 5;
+
+    std::uint8_t stateCodeFor(const std::string &stateName)
+    {
+        for (std::uint8_t code = 0; code < STATE_COUNT; ++code)
+        {
+            if (stateName == STATE_NAMES[code])
+            {
+                return code;
+            }
+        }
+        return 0; // Unknown states restart the lifecycle
+    }
+
+    PlantState *createStateForCode(std::uint8_t code)
+    {
+        switch (code)
+        {
+        case 1:
+            return new InNurseryState();
+        case 2:
+            return new GrowingState();
+        case 3:
+            return new ReadyForSaleState();
+        case 4:
+            return new WitheringState();
+        default:
+            return new PlantedState();
+        }
+    }
+
+    PlantSpeciesProfile *createProfileForCategory(const std::string &category, const std::string &species)
+    {
+        if (category == "Succulent")
+        {
+            return new SucculentProfile(species, "", "", "");
+        }
+        if (category == "Tree")
+        {
+            return new TreeProfile(species, "", "", "");
+        }
+        // Flowers and any unknown category - saved properties overwrite the defaults anyway
+        return new FlowerProfile(species, "", "", "");
+    }
+
+    Pot *createBasePot(const std::string &material, const std::string &size, const std::string &shape, bool drainage)
+    {
+        if (material == "Clay")
+            return ClayPotFactory().createPot(size, shape, drainage);
+        if (material == "Glass")
+            return GlassPotFactory().createPot(size, shape, drainage);
+        if (material == "Metal")
+            return MetalPotFactory().createPot(size, shape, drainage);
+        if (material == "Plastic")
+            return PlasticPotFactory().createPot(size, shape, drainage);
+        if (material == "Wooden")
+            return WoodenPotFactory().createPot(size, shape, drainage);
+        return nullptr;
+    }
+
+    Pot *applyDecoration(Pot *pot, const std::string &kind, const std::string &value)
+    {
+        if (kind == "Color")
+            return new ColorDecorator(pot, value);
+        if (kind == "Finish")
+            return new FinishDecorator(pot, value);
+        if (kind == "Texture")
+            return new TextureDecorator(pot, value);
+        if (kind == "Pattern")
+            return new PatternDecorator(pot, value);
+        if (kind == "Feature")
+            return new FeatureDecorator(pot, value);
+        return pot; // Unknown decorations are dropped rather than failing the restore
+    }
+
+    void writePlant(BinaryWriter &writer, PlantProduct *plant, std::uint8_t location,
+                    std::unordered_map<const PlantSpeciesProfile *, std::uint32_t> &profileIndex)
+    {
+        std::uint32_t profileRef = NO_PROFILE;
+        if (plant->getProfile())
+        {
+            profileRef = profileIndex[plant->getProfile()];
+        }
+
+        writer.writeString(plant->getId());
+        writer.writeU32(profileRef);
+        writer.writeU8(location);
+        writer.writeU8(stateCodeFor(plant->getCurrentStateName()));
+        writer.writeI32(plant->getDaysInCurrentState());
+        writer.writeI32(plant->getSecondsInCurrentState());
+        writer.writeI32(plant->getSecondsSinceLastCare());
+    }
+
+    struct RestoredPlant
+    {
+        PlantProduct *plant;
+        std::uint8_t location;
+    };
+
+    void discard(std::vector<RestoredPlant> &plants, std::vector<Pot *> &pots,
+                 std::vector<PlantSpeciesProfile *> &profiles)
+    {
+        for (size_t i = 0; i < plants.size(); ++i)
+            delete plants[i].plant;
+        for (size_t i = 0; i < pots.size(); ++i)
+            delete pots[i];
+        for (size_t i = 0; i < profiles.size(); ++i)
+            delete profiles[i];
+    }
+}
+
+bool InventorySnapshot::save(const InventoryManager &inventory, const std::string &path)
+{
+    // Collect the distinct species profiles so plants can reference them by index
+    std::vector<const PlantSpeciesProfile *> profiles;
+    std::unordered_map<const PlantSpeciesProfile *, std::uint32_t> profileIndex;
+    const std::vector<PlantProduct *> *collections[] = {&inventory.greenHouseInventory,
+                                                        &inventory.readyForSalePlants,
+                                                        &inventory.soldPlants};
+    size_t plantCount = 0;
+    for (int c = 0; c < 3; ++c)
+    {
+        plantCount += collections[c]->size();
+        for (size_t i = 0; i < collections[c]->size(); ++i)
+        {
+            const PlantSpeciesProfile *profile = (*collections[c])[i]->getProfile();
+            if (profile && profileIndex.find(profile) == profileIndex.end())
+            {
+                profileIndex[profile] = static_cast<std::uint32_t>(profiles.size());
+                profiles.push_back(profile);
+            }
+        }
+    }
+
+    std::string buffer;
+    buffer.reserve(64 + plantCount * 48 + inventory.potInventory.size() * 64);
+    BinaryWriter writer(buffer);
+
+    writer.writeBytes(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    writer.writeU32(FORMAT_VERSION);
+    writer.writeU32(BINARY_ENDIAN_MARKER);
+    writer.writeU32(static_cast<std::uint32_t>(profiles.size()));
+    writer.writeU32(static_cast<std::uint32_t>(plantCount));
+    writer.writeU32(static_cast<std::uint32_t>(inventory.potInventory.size()));
+
+    for (size_t i = 0; i < profiles.size(); ++i)
+    {
+        const std::map<std::string, std::string> &properties = profiles[i]->getProperties();
+        writer.writeString(profiles[i]->getProperty("category"));
+        writer.writeString(profiles[i]->getSpeciesName());
+        writer.writeU32(static_cast<std::uint32_t>(properties.size()));
+        for (std::map<std::string, std::string>::const_iterator it = properties.begin(); it != properties.end(); ++it)
+        {
+            writer.writeString(it->first);
+            writer.writeString(it->second);
+        }
+    }
+
+    const std::uint8_t locations[] = {LOCATION_GREENHOUSE, LOCATION_SALES_FLOOR, LOCATION_SOLD};
+    for (int c = 0; c < 3; ++c)
+    {
+        for (size_t i = 0; i < collections[c]->size(); ++i)
+        {
+            writePlant(writer, (*collections[c])[i], locations[c], profileIndex);
+        }
+    }
+
+    std::vector<std::pair<std::string, std::string> > decorations;
+    for (size_t i = 0; i < inventory.potInventory.size(); ++i)
+    {
+        Pot *pot = inventory.potInventory[i];
+        decorations.clear();
+        pot->getDecorations(decorations);
+
+        writer.writeString(pot->getPotType());
+        writer.writeString(pot->getSize());
+        writer.writeString(pot->getShape());
+        writer.writeU8(pot->getDrainage() == "Yes" ? 1 : 0);
+        writer.writeU32(static_cast<std::uint32_t>(decorations.size()));
+        for (size_t d = 0; d < decorations.size(); ++d)
+        {
+            writer.writeString(decorations[d].first);
+            writer.writeString(decorations[d].second);
+        }
+    }
+
+    writer.writeU32(computeCrc32(buffer.data(), buffer.size()));
+
+    // Written beside the target and moved over it, so a crash never leaves a half-written snapshot
+    if (!writeFileAtomically(path, buffer))
+    {
+        std::cout << "[SNAPSHOT] Failed to write snapshot to " << path << "." << std::endl;
+        return false;
+    }
+
+    std::cout << "[SNAPSHOT] Saved " << plantCount << " plants and " << inventory.potInventory.size()
+              << " pots to " << path << " (" << buffer.size() << " bytes)." << std::endl;
+    return true;
+}
+
+bool InventorySnapshot::load(InventoryManager &inventory, const std::string &path)
+{
+    MappedFile file;
+    if (!file.open(path))
+    {
+        std::cout << "[SNAPSHOT] No snapshot found at " << path << "." << std::endl;
+        return false;
+    }
+
+    const size_t headerSize = sizeof(SNAPSHOT_MAGIC) + 5 * sizeof(std::uint32_t);
+    if (file.getSize() < headerSize + sizeof(std::uint32_t) ||
+        std::memcmp(file.getData(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+    {
+        std::cout << "[SNAPSHOT] " << path << " is not an inventory snapshot." << std::endl;
+        return false;
+    }
+
+    size_t bodySize = file.getSize() - sizeof(std::uint32_t);
+    std::uint32_t storedCrc = 0;
+    std::memcpy(&storedCrc, file.getData() + bodySize, sizeof(storedCrc));
+    if (computeCrc32(file.getData(), bodySize) != storedCrc)
+    {
+        std::cout << "[SNAPSHOT] " << path << " failed its checksum - snapshot ignored." << std::endl;
+        return false;
+    }
+
+    BinaryReader reader(file.getData(), bodySize);
+    reader.skip(sizeof(SNAPSHOT_MAGIC));
+
+    std::uint32_t version = 0, endian = 0, profileCount = 0, plantCount = 0, potCount = 0;
+    reader.readU32(version);
+    reader.readU32(endian);
+    if (version != FORMAT_VERSION || endian != BINARY_ENDIAN_MARKER)
+    {
+        std::cout << "[SNAPSHOT] Unsupported snapshot version " << version << "." << std::endl;
+        return false;
+    }
+    reader.readU32(profileCount);
+    reader.readU32(plantCount);
+    reader.readU32(potCount);
+
+    std::vector<PlantSpeciesProfile *> profiles;
+    std::vector<RestoredPlant> plants;
+    std::vector<Pot *> pots;
+    // Counts come from the file, so never trust them beyond what the bytes could hold
+    profiles.reserve(std::min<size_t>(profileCount, reader.remaining() / 12));
+    plants.reserve(std::min<size_t>(plantCount, reader.remaining() / 22));
+    pots.reserve(std::min<size_t>(potCount, reader.remaining() / 17));
+
+    std::string category, species, key, value;
+    for (std::uint32_t i = 0; i < profileCount && reader.ok(); ++i)
+    {
+        std::uint32_t propertyCount = 0;
+        if (!reader.readString(category) || !reader.readString(species) || !reader.readU32(propertyCount))
+            break;
+
+        PlantSpeciesProfile *profile = createProfileForCategory(category, species);
+        profiles.push_back(profile);
+        for (std::uint32_t p = 0; p < propertyCount && reader.readString(key) && reader.readString(value); ++p)
+        {
+            profile->setProperty(key, value);
+        }
+    }
+
+    std::string id;
+    for (std::uint32_t i = 0; i < plantCount && reader.ok(); ++i)
+    {
+        std::uint32_t profileRef = 0;
+        std::uint8_t location = 0, stateCode = 0;
+        std::int32_t days = 0, secondsInState = 0, secondsSinceCare = 0;
+        reader.readString(id);
+        reader.readU32(profileRef);
+        reader.readU8(location);
+        reader.readU8(stateCode);
+        reader.readI32(days);
+        reader.readI32(secondsInState);
+        if (!reader.readI32(secondsSinceCare))
+            break;
+        if ((profileRef != NO_PROFILE && profileRef >= profiles.size()) || location > LOCATION_SOLD || stateCode >= STATE_COUNT)
+        {
+            reader.skip(reader.remaining() + 1); // Poison the reader
+            break;
+        }
+
+        PlantSpeciesProfile *profile = profileRef == NO_PROFILE ? nullptr : profiles[profileRef];
+        RestoredPlant restored;
+        restored.plant = new PlantProduct(id, profile, createStateForCode(stateCode));
+        restored.plant->restoreTimers(days, secondsInState, secondsSinceCare);
+        restored.location = location;
+        plants.push_back(restored);
+    }
+
+    std::string material, size, shape, kind;
+    for (std::uint32_t i = 0; i < potCount && reader.ok(); ++i)
+    {
+        std::uint8_t drainage = 0;
+        std::uint32_t decorationCount = 0;
+        reader.readString(material);
+        reader.readString(size);
+        reader.readString(shape);
+        reader.readU8(drainage);
+        if (!reader.readU32(decorationCount))
+            break;
+
+        Pot *pot = createBasePot(material, size, shape, drainage != 0);
+        for (std::uint32_t d = 0; d < decorationCount && reader.readString(kind) && reader.readString(value); ++d)
+        {
+            if (pot)
+                pot = applyDecoration(pot, kind, value);
+        }
+        if (pot)
+            pots.push_back(pot);
+    }
+
+    if (!reader.atEnd() || plants.size() != plantCount)
+    {
+        std::cout << "[SNAPSHOT] " << path << " is truncated or malformed - snapshot ignored." << std::endl;
+        discard(plants, pots, profiles);
+        return false;
+    }
+
+    inventory.adoptProfiles(profiles);
+    inventory.reservePlants(plants.size());
+    for (size_t i = 0; i < pots.size(); ++i)
+    {
+        inventory.addPot(pots[i]);
+    }
+    for (size_t i = 0; i < plants.size(); ++i)
+    {
+        InventoryManager::PlantLocation location = InventoryManager::IN_GREENHOUSE;
+        if (plants[i].location == LOCATION_SALES_FLOOR)
+            location = InventoryManager::ON_SALES_FLOOR;
+        else if (plants[i].location == LOCATION_SOLD)
+            location = InventoryManager::SOLD;
+        inventory.restorePlant(plants[i].plant, location);
+    }
+
+    std::cout << "[SNAPSHOT] Restored " << plants.size() << " plants, " << pots.size() << " pots and "
+              << profiles.size() << " species profiles from " << path << "." << std::endl;
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef INVENTORY_SNAPSHOT_H
+#define INVENTORY_SNAPSHOT_H
+
+#include <string>
+
+class InventoryManager;
+
+/**
+ * @class InventorySnapshot
+ * @brief Versioned binary snapshot of every InventoryManager collection
+ *
+ * Persists the greenhouse, sales floor, sold history and pot inventory so a
+ * restart does not lose the nursery. Each plant is stored with its lifecycle
+ * state, elapsed timers and a reference into a shared table of species
+ * profiles; each pot is stored as its base material plus its decoration chain.
+ *
+ * File layout (version 1, host byte order):
+ * @code
+ * header   : "GHSNAP01" | u32 version | u32 endian marker
+ *            | u32 profiles | u32 plants | u32 pots
+ * profiles : category | species | u32 n | n x (key | value)
+ * plants   : id | u32 profile | u8 location | u8 state
+ *            | i32 days | i32 secondsInState | i32 secondsSinceCare
+ * pots     : material | size | shape | u8 drainage | u32 n | n x (kind | value)
+ * trailer  : u32 CRC-32 of everything above
+ * @endcode
+ * Strings are u32 length-prefixed. Loading memory-maps the file and decodes it
+ * in a single forward pass; nothing is added to the inventory unless the whole
+ * file validates.
+ */
+class InventorySnapshot
+{
+public:
+    static const unsigned int FORMAT_VERSION = 1;
+
+    /**
+     * @brief Writes the full inventory to disk
+     * @param inventory Inventory to persist
+     * @param path Destination file (written to path + ".tmp" then renamed)
+     * @return true if the snapshot was written completely
+     */
+    static bool save(const InventoryManager &inventory, const std::string &path);
+
+    /**
+     * @brief Restores a snapshot into the inventory
+     * @param inventory Inventory that receives the restored plants and pots
+     * @param path Snapshot file to read
+     * @return false if the file is missing, truncated, corrupt or from another version
+     *
+     * Restored records are appended to whatever the inventory already holds.
+     * Species profiles are recreated from the snapshot and owned by the inventory.
+     */
+    static bool load(InventoryManager &inventory, const std::string &path);
+};
+
+#endif // INVENTORY_SNAPSHOT_H
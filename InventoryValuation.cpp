@@ -0,0 +1,176 @@
+#include "InventoryValuation.h"
+#include <cmath>
+
+InventoryValuation::InventoryValuation() : potValueCents(0), potCount(0)
+{
+    for (int i = 0; i < LOCATION_COUNT; i++)
+    {
+        locationCounts[i] = 0;
+    }
+}
+
+long long InventoryValuation::toCents(double price)
+{
+    return std::llround(price * 100.0);
+}
+
+void InventoryValuation::adjust(Totals &totals, int count, long long cents)
+{
+    totals.count += count;
+    totals.valueCents += cents;
+}
+
+// Adjusts a keyed total and drops the entry once nothing is left under it
+static void adjustKeyed(std::map<std::string, InventoryValuation::Totals> &totals,
+                        const std::string &key, int count, long long cents)
+{
+    InventoryValuation::Totals &entry = totals[key];
+    entry.count += count;
+    entry.valueCents += cents;
+    if (entry.count <= 0)
+    {
+        totals.erase(key);
+    }
+}
+
+// --- Pots ---
+
+void InventoryValuation::addPot(double price)
+{
+    potValueCents += toCents(price);
+    potCount++;
+}
+
+void InventoryValuation::removePot(double price)
+{
+    potValueCents -= toCents(price);
+    potCount--;
+}
+
+double InventoryValuation::getTotalPotValue() const
+{
+    return potValueCents / 100.0;
+}
+
+int InventoryValuation::getPotCount() const
+{
+    return potCount;
+}
+
+// --- Plants ---
+
+void InventoryValuation::addPlant(const std::string &species, const std::string &state, double price)
+{
+    long long cents = toCents(price);
+    adjust(plantTotals, 1, cents);
+    adjustKeyed(plantTotalsBySpeciesState[species], state, 1, cents);
+    adjustKeyed(plantTotalsBySpecies, species, 1, cents);
+    adjustKeyed(plantTotalsByState, state, 1, cents);
+}
+
+void InventoryValuation::removePlant(const std::string &species, const std::string &state, double price)
+{
+    long long cents = toCents(price);
+    adjust(plantTotals, -1, -cents);
+
+    std::map<std::string, Totals> &states = plantTotalsBySpeciesState[species];
+    adjustKeyed(states, state, -1, -cents);
+    if (states.empty())
+    {
+        plantTotalsBySpeciesState.erase(species);
+    }
+    adjustKeyed(plantTotalsBySpecies, species, -1, -cents);
+    adjustKeyed(plantTotalsByState, state, -1, -cents);
+}
+
+void InventoryValuation::changePlantState(const std::string &species, const std::string &fromState,
+                                          const std::string &toState, double price)
+{
+    if (fromState == toState)
+    {
+        return;
+    }
+    long long cents = toCents(price);
+
+    std::map<std::string, Totals> &states = plantTotalsBySpeciesState[species];
+    adjustKeyed(states, fromState, -1, -cents);
+    adjustKeyed(states, toState, 1, cents);
+    adjustKeyed(plantTotalsByState, fromState, -1, -cents);
+    adjustKeyed(plantTotalsByState, toState, 1, cents);
+}
+
+InventoryValuation::Totals InventoryValuation::getPlantTotals() const
+{
+    return plantTotals;
+}
+
+InventoryValuation::Totals InventoryValuation::getPlantTotals(const std::string &species, const std::string &state) const
+{
+    std::map<std::string, std::map<std::string, Totals> >::const_iterator bySpecies = plantTotalsBySpeciesState.find(species);
+    if (bySpecies == plantTotalsBySpeciesState.end())
+    {
+        return Totals();
+    }
+    std::map<std::string, Totals>::const_iterator it = bySpecies->second.find(state);
+    return it != bySpecies->second.end() ? it->second : Totals();
+}
+
+InventoryValuation::Totals InventoryValuation::getSpeciesTotals(const std::string &species) const
+{
+    std::map<std::string, Totals>::const_iterator it = plantTotalsBySpecies.find(species);
+    return it != plantTotalsBySpecies.end() ? it->second : Totals();
+}
+
+InventoryValuation::Totals InventoryValuation::getStateTotals(const std::string &state) const
+{
+    std::map<std::string, Totals>::const_iterator it = plantTotalsByState.find(state);
+    return it != plantTotalsByState.end() ? it->second : Totals();
+}
+
+const std::map<std::string, InventoryValuation::Totals> &InventoryValuation::getAllSpeciesTotals() const
+{
+    return plantTotalsBySpecies;
+}
+
+// --- Locations ---
+
+void InventoryValuation::addToLocation(int location, const std::string &species)
+{
+    locationCounts[location]++;
+    speciesLocationCounts[location][species]++;
+}
+
+void InventoryValuation::removeFromLocation(int location, const std::string &species)
+{
+    locationCounts[location]--;
+    std::map<std::string, int> &counts = speciesLocationCounts[location];
+    std::map<std::string, int>::iterator it = counts.find(species);
+    if (it != counts.end() && --it->second <= 0)
+    {
+        counts.erase(it);
+    }
+}
+
+int InventoryValuation::getLocationCount(int location) const
+{
+    return locationCounts[location];
+}
+
+int InventoryValuation::getLocationCount(int location, const std::string &species) const
+{
+    std::map<std::string, int>::const_iterator it = speciesLocationCounts[location].find(species);
+    return it != speciesLocationCounts[location].end() ? it->second : 0;
+}
+
+void InventoryValuation::clearPlants()
+{
+    plantTotals = Totals();
+    plantTotalsBySpeciesState.clear();
+    plantTotalsBySpecies.clear();
+    plantTotalsByState.clear();
+    for (int i = 0; i < LOCATION_COUNT; i++)
+    {
+        locationCounts[i] = 0;
+        speciesLocationCounts[i].clear();
+    }
+}
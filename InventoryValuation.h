@@ -0,0 +1,77 @@
+#ifndef INVENTORY_VALUATION_H
+#define INVENTORY_VALUATION_H
+
+#include <map>
+#include <string>
+
+/**
+ * @class InventoryValuation
+ * @brief Running totals for the InventoryManager dashboards
+ *
+ * InventoryManager feeds every mutation (pot added or removed, plant entering
+ * or leaving a location, plant changing state) into this class, so reports read
+ * the totals instead of walking the inventories. Values are kept in whole cents
+ * so that repeated add/remove pairs never drift.
+ *
+ * Plant value only covers plants the nursery still holds (greenhouse or sales
+ * floor); sold plants appear in the location counts only.
+ */
+class InventoryValuation
+{
+public:
+    static const int LOCATION_COUNT = 3; // matches InventoryManager::PlantLocation
+
+    struct Totals
+    {
+        int count;
+        long long valueCents;
+
+        Totals() : count(0), valueCents(0) {}
+        double getValue() const { return valueCents / 100.0; }
+    };
+
+    InventoryValuation();
+
+    // --- Pots ---
+    void addPot(double price);
+    void removePot(double price);
+    double getTotalPotValue() const;
+    int getPotCount() const;
+
+    // --- Plants held by the nursery, by species and lifecycle state ---
+    void addPlant(const std::string &species, const std::string &state, double price);
+    void removePlant(const std::string &species, const std::string &state, double price);
+    void changePlantState(const std::string &species, const std::string &fromState,
+                          const std::string &toState, double price);
+
+    Totals getPlantTotals() const;
+    Totals getPlantTotals(const std::string &species, const std::string &state) const;
+    Totals getSpeciesTotals(const std::string &species) const;
+    Totals getStateTotals(const std::string &state) const;
+    const std::map<std::string, Totals> &getAllSpeciesTotals() const;
+
+    // --- Plant counts per location ---
+    void addToLocation(int location, const std::string &species);
+    void removeFromLocation(int location, const std::string &species);
+    int getLocationCount(int location) const;
+    int getLocationCount(int location, const std::string &species) const;
+
+    void clearPlants();
+
+private:
+    long long potValueCents;
+    int potCount;
+
+    Totals plantTotals;
+    std::map<std::string, std::map<std::string, Totals> > plantTotalsBySpeciesState;
+    std::map<std::string, Totals> plantTotalsBySpecies;
+    std::map<std::string, Totals> plantTotalsByState;
+
+    int locationCounts[LOCATION_COUNT];
+    std::map<std::string, int> speciesLocationCounts[LOCATION_COUNT];
+
+    static long long toCents(double price);
+    static void adjust(Totals &totals, int count, long long cents);
+};
+
+#endif // INVENTORY_VALUATION_H
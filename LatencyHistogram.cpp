@@ -0,0 +1,141 @@
+#include "LatencyHistogram.h"
+
+#include <cmath>
+
+namespace
+{
+    const std::uint64_t LINEAR_LIMIT = std::uint64_t(1) << (LatencyHistogram::SUB_BUCKET_BITS + 1); // exact below
+    const std::uint64_t SUB_BUCKETS = std::uint64_t(1) << LatencyHistogram::SUB_BUCKET_BITS;
+
+    // Position of the highest set bit; value must be non-zero
+    int highestBit(std::uint64_t value)
+    {
+        int bit = 0;
+        for (int step = 32; step > 0; step >>= 1)
+        {
+            if (value >> step)
+            {
+                value >>= step;
+                bit += step;
+            }
+        }
+        return bit;
+    }
+}
+
+LatencyHistogram::LatencyHistogram()
+    : counts(new std::atomic<std::uint64_t>[getBucketCount()]), total(0), sum(0), min(UINT64_MAX), max(0)
+{
+    reset();
+}
+
+std::size_t LatencyHistogram::getBucketCount()
+{
+    return static_cast<std::size_t>(LINEAR_LIMIT + (MAX_MAGNITUDE - SUB_BUCKET_BITS) * SUB_BUCKETS);
+}
+
+std::size_t LatencyHistogram::bucketIndex(std::uint64_t value)
+{
+    if (value < LINEAR_LIMIT)
+    {
+        return static_cast<std::size_t>(value);
+    }
+    if (value > MAX_VALUE)
+    {
+        value = MAX_VALUE;
+    }
+    int magnitude = highestBit(value);            // >= SUB_BUCKET_BITS + 1
+    int shift = magnitude - SUB_BUCKET_BITS;      // keeps SUB_BUCKET_BITS bits below the top one
+    std::uint64_t sub = (value >> shift) - SUB_BUCKETS;
+    return static_cast<std::size_t>(LINEAR_LIMIT + (magnitude - SUB_BUCKET_BITS - 1) * SUB_BUCKETS + sub);
+}
+
+std::uint64_t LatencyHistogram::bucketHighestValue(std::size_t index)
+{
+    if (index < LINEAR_LIMIT)
+    {
+        return index;
+    }
+    std::uint64_t offset = index - LINEAR_LIMIT;
+    int shift = static_cast<int>(offset / SUB_BUCKETS) + 1;
+    std::uint64_t sub = SUB_BUCKETS + offset % SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(std::uint64_t value)
+{
+    counts[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+
+    std::uint64_t seen = max.load(std::memory_order_relaxed);
+    while (value > seen && !max.compare_exchange_weak(seen, value, std::memory_order_relaxed))
+    {
+    }
+    seen = min.load(std::memory_order_relaxed);
+    while (value < seen && !min.compare_exchange_weak(seen, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    for (std::size_t i = 0; i < getBucketCount(); ++i)
+    {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    min.store(UINT64_MAX, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::getCount() const
+{
+    return total.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::getMin() const
+{
+    std::uint64_t value = min.load(std::memory_order_relaxed);
+    return value == UINT64_MAX ? 0 : value;
+}
+
+std::uint64_t LatencyHistogram::getMax() const
+{
+    return max.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::getMean() const
+{
+    std::uint64_t count = getCount();
+    return count ? static_cast<double>(sum.load(std::memory_order_relaxed)) / count : 0.0;
+}
+
+std::uint64_t LatencyHistogram::getValueAtPercentile(double percentile) const
+{
+    std::uint64_t count = getCount();
+    if (count == 0)
+    {
+        return 0;
+    }
+    double clamped = percentile < 0.0 ? 0.0 : (percentile > 100.0 ? 100.0 : percentile);
+    std::uint64_t target = static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * count));
+    if (target == 0)
+    {
+        target = 1;
+    }
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < getBucketCount(); ++i)
+    {
+        seen += counts[i].load(std::memory_order_relaxed);
+        if (seen >= target)
+        {
+            // The bucket bound can overshoot the largest value actually recorded
+            std::uint64_t value = bucketHighestValue(i);
+            std::uint64_t largest = getMax();
+            return value < largest ? value : largest;
+        }
+    }
+    return getMax();
+}
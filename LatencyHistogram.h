@@ -0,0 +1,58 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @class LatencyHistogram
+ * @brief Fixed-precision histogram of latencies, in the style of HdrHistogram
+ *
+ * Values (nanoseconds, by convention) below 2^(SUB_BUCKET_BITS + 1) get a
+ * bucket each; above that every power of two is split into 2^SUB_BUCKET_BITS
+ * equal buckets, so any recorded value is reported within about 1.6% while
+ * the whole range up to MAX_VALUE fits in a few thousand counters. Values
+ * above MAX_VALUE are counted as MAX_VALUE.
+ *
+ * record() is a handful of relaxed atomic increments, so any number of
+ * threads can record into one histogram without locking. Readers see a
+ * consistent-enough view for reporting, not a snapshot.
+ */
+class LatencyHistogram
+{
+public:
+    static const int SUB_BUCKET_BITS = 6;
+    static const int MAX_MAGNITUDE = 47;                             // highest power of two tracked
+    static const std::uint64_t MAX_VALUE = (std::uint64_t(2) << MAX_MAGNITUDE) - 1; // ~78 hours in ns
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram &) = delete;
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+    void record(std::uint64_t value);
+    void reset();
+
+    std::uint64_t getCount() const;
+    std::uint64_t getMin() const;
+    std::uint64_t getMax() const;
+    double getMean() const;
+
+    /** @brief Smallest recorded bucket value that at least `percentile` percent of values fall at or below */
+    std::uint64_t getValueAtPercentile(double percentile) const;
+
+    static std::size_t bucketIndex(std::uint64_t value);
+    static std::uint64_t bucketHighestValue(std::size_t index);
+    static std::size_t getBucketCount();
+
+private:
+    std::unique_ptr<std::atomic<std::uint64_t>[]> counts;
+    std::atomic<std::uint64_t> total;
+    std::atomic<std::uint64_t> sum;
+    std::atomic<std::uint64_t> min;
+    std::atomic<std::uint64_t> max;
+};
+
+#endif // LATENCY_HISTOGRAM_H
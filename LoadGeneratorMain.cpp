@@ -0,0 +1,698 @@
+/**
+ * @file LoadGeneratorMain.cpp
+ * @brief Synthetic checkout load generator and throughput benchmark
+ *
+ * Creates a population of synthetic customers and pushes seeded random carts
+ * (single plants, plants with pots, custom bundles and bouquet kits) through
+ * the same path the interactive front ends use: the customer's
+ * ConcreteOrderBuilder, finalizeOrder() and executeOrderWithPayment().
+ *
+ * Two ways of applying load:
+ * - closed loop (default): --concurrency workers each start their next order
+ *   as soon as the last one finishes; latency is measured per checkout.
+ * - open loop (--rate R): orders arrive at R per second whether or not the
+ *   workers keep up; latency is measured from each order's scheduled arrival,
+ *   so time spent queued behind slow checkouts is counted instead of hidden.
+ *
+ * Each customer is only ever driven by one worker. The report gives orders/s,
+ * checkout latency percentiles, failures, and the units sold beyond the stock
+ * that was on the sales floor (executeOrderWithPayment does not touch
+ * inventory). --reserve runs the same checkout with InventoryManager
+ * reservations around it, which turns overselling into stock-outs.
+ * --pipeline sends each finalized order through a shared OrderPipeline
+ * (validation with reservation, gateway payment, inventory commit and
+ * notification on their own worker pools) instead; the worker waits for the
+ * outcome, so --concurrency is the number of orders in flight.
+ * --batch N is the wholesale path: each worker finalizes carts for up to N
+ * of its customers and checks them out together with BatchCheckout (one
+ * reservation pass, one bulk payment call per payment type, one commit pass).
+ * --gateway-latency MS sends the card and EFT payments of those batches to a
+ * MockPaymentGateway with a median delay of MS milliseconds, through an
+ * AsyncPaymentProcessor shared by all workers, so a batch's charges are in
+ * flight together; without --batch it checks out one order per batch.
+ *
+ * Build with `make load_generator`; the program is build/load_generator.
+ *
+ * Usage:
+ * @code
+ * LoadGenerator [--orders N] [--customers N] [--concurrency N] [--rate R]
+ *               [--seed S] [--stock N] [--pots N] [--bad-card-rate P]
+ *               [--reserve] [--pipeline] [--batch N] [--gateway-latency MS]
+ *               [--store PATH] [--csv PATH] [--verbose]
+ * @endcode
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AsyncPaymentProcessor.h"
+#include "BatchCheckout.h"
+#include "BoundedQueue.h"
+#include "ClayPot.h"
+#include "ConcreteOrderBuilder.h"
+#include "Customer.h"
+#include "FlattenedOrder.h"
+#include "FlowerProfile.h"
+#include "HandlerMetrics.h"
+#include "InventoryManager.h"
+#include "Logger.h"
+#include "MockPaymentGateway.h"
+#include "Order.h"
+#include "OrderPipeline.h"
+#include "OrderStore.h"
+#include "PlantProduct.h"
+#include "PlasticPot.h"
+#include "StaffManager.h"
+#include "SuggestionTemplate/BouquetSuggestionFactory.h"
+
+namespace {
+
+const char* const CHECKOUT_STAGE = "Customer Checkout (load)";
+
+struct Options {
+    int orders;
+    int customers;
+    int concurrency;
+    double rate;        // orders per second; 0 = closed loop
+    unsigned int seed;
+    int stockPerPlant;  // plants of every type put on the sales floor
+    int potsPerType;
+    double badCardRate; // fraction of card payments sent with a malformed card
+    bool reserve;
+    bool pipeline;      // check out through OrderPipeline; implies reserve
+    int batch;          // orders per BatchCheckout call; 0 = one at a time. Implies reserve
+    double gatewayLatency; // median mock gateway delay in ms for card and EFT; 0 = local processors
+    bool verbose;
+    std::string storePath;
+    std::string csvPath;
+
+    Options()
+        : orders(5000), customers(200), concurrency(8), rate(0.0), seed(42), stockPerPlant(2000),
+          potsPerType(500), badCardRate(0.02), reserve(false), pipeline(false),
+          batch(0), gatewayLatency(0.0), verbose(false) {}
+};
+
+enum CartKind {
+    SINGLE_PLANTS,
+    PLANT_WITH_POT,
+    CUSTOM_BUNDLE,
+    BOUQUET_KIT,
+    CART_KIND_COUNT
+};
+
+const char* cartKindName(int kind) {
+    switch (kind) {
+        case SINGLE_PLANTS: return "single plants";
+        case PLANT_WITH_POT: return "plant + pot";
+        case CUSTOM_BUNDLE: return "custom bundle";
+        case BOUQUET_KIT: return "bouquet kit";
+        default: return "unknown";
+    }
+}
+
+// What the carts are built from; filled once before any worker starts and read-only afterwards
+struct Catalog {
+    std::vector<std::string> plantTypes;
+    std::vector<std::string> potTypes;
+    std::vector<BouquetSuggestion> bouquets;
+};
+
+// Per-worker tallies, merged once the run is over
+struct WorkerTotals {
+    std::uint64_t completed;
+    std::uint64_t failed;     // declined payment or failed validation
+    std::uint64_t stockOuts;  // --reserve, --pipeline and --batch only
+    std::uint64_t cartErrors; // cart could not be finalized
+    std::uint64_t byKind[CART_KIND_COUNT];
+    double revenue;
+    std::map<std::string, int> plantsSold;
+    std::map<std::string, int> potsSold;
+
+    WorkerTotals() : completed(0), failed(0), stockOuts(0), cartErrors(0), revenue(0.0) {
+        std::fill(byKind, byKind + CART_KIND_COUNT, 0);
+    }
+};
+
+struct Arrival {
+    int index;
+    HandlerMetrics::Clock::time_point scheduledAt;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--reserve") {
+            options.reserve = true;
+        } else if (arg == "--pipeline") {
+            options.pipeline = true;
+            options.reserve = true; // the pipeline's validation stage reserves stock
+        } else if (arg == "--verbose") {
+            options.verbose = true;
+        } else if (arg == "--batch" && hasValue) {
+            options.batch = std::atoi(argv[++i]);
+            options.reserve = true; // BatchCheckout reserves the whole batch up front
+        } else if (arg == "--gateway-latency" && hasValue) {
+            options.gatewayLatency = std::atof(argv[++i]);
+        } else if (arg == "--orders" && hasValue) {
+            options.orders = std::atoi(argv[++i]);
+        } else if (arg == "--customers" && hasValue) {
+            options.customers = std::atoi(argv[++i]);
+        } else if (arg == "--concurrency" && hasValue) {
+            options.concurrency = std::atoi(argv[++i]);
+        } else if (arg == "--rate" && hasValue) {
+            options.rate = std::atof(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--stock" && hasValue) {
+            options.stockPerPlant = std::atoi(argv[++i]);
+        } else if (arg == "--pots" && hasValue) {
+            options.potsPerType = std::atoi(argv[++i]);
+        } else if (arg == "--bad-card-rate" && hasValue) {
+            options.badCardRate = std::atof(argv[++i]);
+        } else if (arg == "--store" && hasValue) {
+            options.storePath = argv[++i];
+        } else if (arg == "--csv" && hasValue) {
+            options.csvPath = argv[++i];
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        }
+    }
+    if (options.orders <= 0 || options.customers <= 0 || options.concurrency <= 0 || options.rate < 0.0 ||
+        options.batch < 0 || options.gatewayLatency < 0.0) {
+        std::cerr << "--orders, --customers and --concurrency must be positive, --rate, --batch and "
+                  << "--gateway-latency not negative" << std::endl;
+        return false;
+    }
+    if (options.pipeline && (options.batch > 0 || options.gatewayLatency > 0.0)) {
+        std::cerr << "--pipeline is a different checkout path from --batch and --gateway-latency; choose one" << std::endl;
+        return false;
+    }
+    // The gateway is reached through BatchCheckout, so a single checkout is a batch of one
+    if (options.gatewayLatency > 0.0 && options.batch == 0) {
+        options.batch = 1;
+        options.reserve = true;
+    }
+    // A worker needs at least one customer of its own
+    if (options.concurrency > options.customers) {
+        std::cerr << "--concurrency " << options.concurrency << " is more than --customers; running "
+                  << options.customers << " workers" << std::endl;
+        options.concurrency = options.customers;
+    }
+    return true;
+}
+
+void printUsage() {
+    std::cerr << "Usage: LoadGenerator [--orders N] [--customers N] [--concurrency N] [--rate R]\n"
+              << "                     [--seed S] [--stock N] [--pots N] [--bad-card-rate P]\n"
+              << "                     [--reserve] [--pipeline] [--batch N] [--gateway-latency MS]\n"
+              << "                     [--store PATH] [--csv PATH] [--verbose]" << std::endl;
+}
+
+Catalog buildCatalog() {
+    Catalog catalog;
+    const char* plants[] = {"Rose", "Tulip", "Orchid", "Lily", "Sunflower", "Aloe Vera", "Bonsai", "Echeveria"};
+    catalog.plantTypes.assign(plants, plants + sizeof(plants) / sizeof(plants[0]));
+    catalog.potTypes.push_back("Clay");
+    catalog.potTypes.push_back("Plastic");
+
+    // Every tier of every event, with its flowers added to what the nursery stocks
+    BouquetSuggestionFactory& factory = BouquetSuggestionFactory::getInstance();
+    for (const std::string& event : factory.getAvailableEvents()) {
+        BouquetSuggestionTemplate* tmpl = factory.getTemplate(event);
+        if (!tmpl) {
+            continue;
+        }
+        for (const BouquetSuggestion& bouquet : tmpl->generateSuggestions()) {
+            catalog.bouquets.push_back(bouquet);
+            for (const std::string& flower : bouquet.flowerTypes) {
+                if (std::find(catalog.plantTypes.begin(), catalog.plantTypes.end(), flower) == catalog.plantTypes.end()) {
+                    catalog.plantTypes.push_back(flower);
+                }
+            }
+        }
+    }
+    return catalog;
+}
+
+void stockInventory(const Catalog& catalog, const Options& options, std::vector<PlantSpeciesProfile*>& profiles) {
+    InventoryManager& inventory = InventoryManager::getInstance();
+    for (const std::string& type : catalog.plantTypes) {
+        PlantSpeciesProfile* profile = new FlowerProfile(type, "200ml", "Partial Sun", "Loamy");
+        profiles.push_back(profile);
+        for (int i = 0; i < options.stockPerPlant; ++i) {
+            inventory.moveToSalesFloor(new PlantProduct(type + "-" + std::to_string(i), profile));
+        }
+    }
+    for (int i = 0; i < options.potsPerType; ++i) {
+        inventory.addPot(new ClayPot("medium", "round", true));
+        inventory.addPot(new PlasticPot("medium", "round", true));
+    }
+}
+
+// Builds a random cart in the customer's builder and finalizes it; returns the kind of cart built
+int buildCart(Customer& customer, const Catalog& catalog, std::mt19937& rng) {
+    ConcreteOrderBuilder* builder = customer.getOrderBuilder();
+    builder->reset();
+
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<std::size_t> plantPick(0, catalog.plantTypes.size() - 1);
+    std::uniform_int_distribution<std::size_t> potPick(0, catalog.potTypes.size() - 1);
+    std::uniform_int_distribution<int> quantity(1, 3);
+
+    int roll = percent(rng);
+    int kind = roll < 40 ? SINGLE_PLANTS : roll < 65 ? PLANT_WITH_POT : roll < 85 ? CUSTOM_BUNDLE : BOUQUET_KIT;
+    if (kind == BOUQUET_KIT && catalog.bouquets.empty()) {
+        kind = CUSTOM_BUNDLE;
+    }
+
+    switch (kind) {
+        case SINGLE_PLANTS: {
+            int lines = std::uniform_int_distribution<int>(1, 3)(rng);
+            for (int i = 0; i < lines; ++i) {
+                builder->buildPlant(catalog.plantTypes[plantPick(rng)], quantity(rng));
+            }
+            break;
+        }
+        case PLANT_WITH_POT:
+            builder->buildPlantWithPot(catalog.plantTypes[plantPick(rng)], catalog.potTypes[potPick(rng)],
+                                       std::uniform_int_distribution<int>(1, 2)(rng));
+            break;
+        case CUSTOM_BUNDLE: {
+            builder->buildCustomBundle("Custom Bundle", "Custom Bundle", std::uniform_int_distribution<int>(5, 20)(rng));
+            int plants = std::uniform_int_distribution<int>(2, 4)(rng);
+            for (int i = 0; i < plants; ++i) {
+                builder->addPlantToCurrentBundle(catalog.plantTypes[plantPick(rng)], quantity(rng));
+            }
+            break;
+        }
+        default: {
+            const BouquetSuggestion& bouquet =
+                catalog.bouquets[std::uniform_int_distribution<std::size_t>(0, catalog.bouquets.size() - 1)(rng)];
+            builder->buildCustomBundle(bouquet.bouquetName, "Bouquet Kit", 10.0);
+            for (std::size_t i = 0; i < bouquet.flowerTypes.size() && i < bouquet.quantities.size(); ++i) {
+                builder->addPlantToCurrentBundle(bouquet.flowerTypes[i], bouquet.quantities[i]);
+            }
+            break;
+        }
+    }
+    return customer.finalizeOrder() ? kind : -1;
+}
+
+void pickPayment(std::mt19937& rng, double badCardRate, std::string& type, std::string& details) {
+    int roll = std::uniform_int_distribution<int>(0, 99)(rng);
+    if (roll < 30) {
+        type = "CASH";
+        details.clear();
+    } else if (roll < 80) {
+        type = "CREDIT_CARD";
+        bool malformed = std::uniform_real_distribution<double>(0.0, 1.0)(rng) < badCardRate;
+        details = malformed ? "4532123456789012" : "4532123456789012;12/27;123";
+    } else {
+        type = "EFT";
+        details = "EFT";
+    }
+}
+
+// Adds a completed order's takings and units to the worker's tallies
+void recordSale(const Order& order, WorkerTotals& totals) {
+    ++totals.completed;
+    totals.revenue += order.getTotalAmount();
+    const FlattenedOrder& demand = order.getFlattened();
+    for (const std::pair<const std::string, int>& plants : demand.getSpeciesDemand()) {
+        totals.plantsSold[plants.first] += plants.second;
+    }
+    for (const std::pair<const std::string, int>& pots : demand.getPotDemand()) {
+        totals.potsSold[pots.first] += pots.second;
+    }
+}
+
+/**
+ * @brief Runs one checkout for the customer and records its outcome
+ * @param startedAt When the order's latency clock starts (its arrival in open-loop runs)
+ * @param pipeline Checks the order out through the pipeline instead of the customer (--pipeline)
+ */
+void runCheckout(Customer& customer, const Catalog& catalog, const Options& options, std::mt19937& rng,
+                 HandlerMetrics::Clock::time_point startedAt, OrderPipeline* pipeline, WorkerTotals& totals) {
+    HandlerMetrics::Stage& checkout = HandlerMetrics::getInstance().getStage(CHECKOUT_STAGE);
+    int kind = buildCart(customer, catalog, rng);
+    Order* order = customer.getCurrentOrder();
+    if (kind < 0 || !order) {
+        ++totals.cartErrors;
+        checkout.record(HandlerMetrics::elapsedNanos(startedAt), false);
+        return;
+    }
+    ++totals.byKind[kind];
+
+    if (pipeline) {
+        // Validation reserves the stock and the commit stage sells it, so nothing is held here
+        OrderOutcome outcome = pipeline->submit(order, &customer).get();
+        checkout.record(HandlerMetrics::elapsedNanos(startedAt), outcome.success);
+        if (outcome.success) {
+            recordSale(*order, totals);
+        } else if (outcome.failedStage == OrderPipeline::getStageName(OrderPipeline::VALIDATION)) {
+            ++totals.stockOuts;
+        } else {
+            ++totals.failed;
+        }
+        return;
+    }
+
+    InventoryManager& inventory = InventoryManager::getInstance();
+    const FlattenedOrder& demand = order->getFlattened();
+    std::uint64_t reservation = 0;
+    if (options.reserve) {
+        reservation = inventory.reserveOrder(demand, nullptr);
+        if (reservation == 0) {
+            ++totals.stockOuts;
+            checkout.record(HandlerMetrics::elapsedNanos(startedAt), false);
+            return;
+        }
+        order->setReservationId(reservation);
+    }
+
+    std::string paymentType, paymentDetails;
+    pickPayment(rng, options.badCardRate, paymentType, paymentDetails);
+    bool paid = customer.executeOrderWithPayment(paymentType, paymentDetails);
+    bool completed = paid && (!options.reserve || inventory.commitReservation(reservation));
+    if (options.reserve && !completed) {
+        inventory.releaseReservation(reservation); // a failed commit leaves the hold in place
+    }
+    checkout.record(HandlerMetrics::elapsedNanos(startedAt), completed);
+
+    if (!completed) {
+        ++totals.failed;
+        return;
+    }
+    recordSale(*order, totals);
+}
+
+/**
+ * @brief Finalizes a cart for each customer and checks them all out in one BatchCheckout call
+ * @param startedAt Latency clock start per customer (same indexing)
+ */
+void runBatchCheckout(const std::vector<Customer*>& batchCustomers,
+                      const std::vector<HandlerMetrics::Clock::time_point>& startedAt, const Catalog& catalog,
+                      const Options& options, std::mt19937& rng, BatchCheckout& batchCheckout, WorkerTotals& totals) {
+    HandlerMetrics::Stage& checkout = HandlerMetrics::getInstance().getStage(CHECKOUT_STAGE);
+    std::vector<BatchCheckout::Request> requests;
+    std::vector<std::size_t> requestCustomer; // index into batchCustomers per request
+    for (std::size_t i = 0; i < batchCustomers.size(); ++i) {
+        int kind = buildCart(*batchCustomers[i], catalog, rng);
+        Order* order = batchCustomers[i]->getCurrentOrder();
+        if (kind < 0 || !order) {
+            ++totals.cartErrors;
+            checkout.record(HandlerMetrics::elapsedNanos(startedAt[i]), false);
+            continue;
+        }
+        ++totals.byKind[kind];
+        BatchCheckout::Request request;
+        request.order = order;
+        pickPayment(rng, options.badCardRate, request.paymentType, request.paymentDetails);
+        requests.push_back(request);
+        requestCustomer.push_back(i);
+    }
+    if (requests.empty()) {
+        return;
+    }
+
+    std::vector<BatchCheckout::Result> results = batchCheckout.checkout(requests);
+    for (std::size_t r = 0; r < results.size(); ++r) {
+        bool completed = results[r].outcome == BatchCheckout::COMPLETED;
+        checkout.record(HandlerMetrics::elapsedNanos(startedAt[requestCustomer[r]]), completed);
+        if (completed) {
+            recordSale(*requests[r].order, totals);
+        } else if (results[r].outcome == BatchCheckout::INSUFFICIENT_STOCK) {
+            ++totals.stockOuts;
+        } else {
+            ++totals.failed;
+        }
+    }
+}
+
+double percentileMillis(const LatencyHistogram& latency, double percentile) {
+    return latency.getValueAtPercentile(percentile) / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    // Customers narrate every step to std::cout; a failed stream makes each of those writes a no-op.
+    // The inventory and staff log goes to std::clog, so it is switched off as well.
+    if (!options.verbose) {
+        std::cout.setstate(std::ios::badbit);
+        Logger::getInstance().setLevel(Logger::LEVEL_OFF);
+    }
+
+    Catalog catalog = buildCatalog();
+    std::vector<PlantSpeciesProfile*> profiles;
+    stockInventory(catalog, options, profiles);
+    if (!options.storePath.empty()) {
+        OrderStore::getInstance().open(options.storePath);
+    }
+
+    std::map<std::string, int> plantStock, potStock;
+    for (const std::string& type : catalog.plantTypes) {
+        plantStock[type] = InventoryManager::getInstance().getAvailablePlantCount(type);
+    }
+    for (const std::string& type : catalog.potTypes) {
+        potStock[type] = InventoryManager::getInstance().getAvailablePotCount(type);
+    }
+
+    StaffManager staff(nullptr); // approves any non-empty order, as on the shop floor
+    std::vector<Customer*> customers;
+    for (int i = 0; i < options.customers; ++i) {
+        std::string id = std::to_string(i);
+        Customer* customer = new Customer("Load Customer " + id, "load" + id + "@greenhouse.test", "0820000000");
+        customer->setStaffObserver(&staff);
+        customers.push_back(customer);
+    }
+
+    OrderPipeline* pipeline = options.pipeline ? new OrderPipeline() : nullptr;
+
+    // --gateway-latency: one gateway and one processor for every worker's BatchCheckout
+    MockPaymentGateway* gateway = nullptr;
+    AsyncPaymentProcessor* gatewayPayments = nullptr;
+    if (options.gatewayLatency > 0.0) {
+        MockPaymentGateway::Config gatewayConfig;
+        gatewayConfig.latencyModel = MockPaymentGateway::LOG_NORMAL;
+        gatewayConfig.latencyMillis = options.gatewayLatency;
+        gatewayConfig.maxLatencyMillis = options.gatewayLatency * 4.0;
+        gatewayConfig.seed = options.seed;
+        gateway = new MockPaymentGateway(gatewayConfig);
+        gatewayPayments = new AsyncPaymentProcessor(gateway);
+    }
+
+    // Worker w owns customers w, w + concurrency, ...
+    std::vector<WorkerTotals> totals(options.concurrency);
+    std::vector<std::thread> workers;
+    std::atomic<int> nextOrder(0);
+    BoundedQueue<Arrival> arrivals(static_cast<std::size_t>(options.concurrency) * 64);
+    bool openLoop = options.rate > 0.0;
+
+    HandlerMetrics::Clock::time_point runStart = HandlerMetrics::Clock::now();
+    for (int w = 0; w < options.concurrency; ++w) {
+        workers.push_back(std::thread([&, w]() {
+            std::mt19937 rng(options.seed + static_cast<unsigned int>(w) * 7919u);
+            int ownCustomers = (options.customers - w + options.concurrency - 1) / options.concurrency;
+            if (ownCustomers <= 0) {
+                return; // parseOptions() keeps concurrency <= customers, so this is never expected
+            }
+            int turn = 0;
+            // --batch: a batch never holds the same customer twice, since each has only one open order
+            BatchCheckout* batchCheckout = options.batch > 0 ? new BatchCheckout() : nullptr;
+            if (batchCheckout && gatewayPayments) {
+                batchCheckout->setPaymentProcessor("CREDIT_CARD", gatewayPayments);
+                batchCheckout->setPaymentProcessor("EFT", gatewayPayments);
+            }
+            std::size_t batchSize = static_cast<std::size_t>(std::min(options.batch, ownCustomers));
+            std::vector<Customer*> batchCustomers;
+            std::vector<HandlerMetrics::Clock::time_point> batchStarts;
+            for (;;) {
+                HandlerMetrics::Clock::time_point startedAt;
+                if (openLoop) {
+                    Arrival arrival;
+                    if (!arrivals.pop(arrival)) {
+                        break;
+                    }
+                    startedAt = arrival.scheduledAt;
+                } else {
+                    if (nextOrder.fetch_add(1) >= options.orders) {
+                        break;
+                    }
+                    startedAt = HandlerMetrics::Clock::now();
+                }
+                Customer& customer = *customers[w + (turn++ % ownCustomers) * options.concurrency];
+                if (!batchCheckout) {
+                    runCheckout(customer, catalog, options, rng, startedAt, pipeline, totals[w]);
+                    continue;
+                }
+                batchCustomers.push_back(&customer);
+                batchStarts.push_back(startedAt);
+                if (batchCustomers.size() >= batchSize) {
+                    runBatchCheckout(batchCustomers, batchStarts, catalog, options, rng, *batchCheckout, totals[w]);
+                    batchCustomers.clear();
+                    batchStarts.clear();
+                }
+            }
+            if (batchCheckout && !batchCustomers.empty()) {
+                runBatchCheckout(batchCustomers, batchStarts, catalog, options, rng, *batchCheckout, totals[w]);
+            }
+            delete batchCheckout;
+        }));
+    }
+
+    if (openLoop) {
+        // Arrivals follow the schedule; if the queue is full the schedule slips and the report shows it
+        std::chrono::nanoseconds interval(static_cast<std::int64_t>(1e9 / options.rate));
+        for (int i = 0; i < options.orders; ++i) {
+            Arrival arrival;
+            arrival.index = i;
+            arrival.scheduledAt = runStart + interval * i;
+            std::this_thread::sleep_until(arrival.scheduledAt);
+            arrivals.push(arrival);
+        }
+        arrivals.close();
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    delete pipeline; // every submitted order has finished, so this only stops the stage workers
+    AsyncPaymentProcessor::Stats paymentStats;
+    MockPaymentGateway::Stats gatewayStats;
+    if (gatewayPayments) {
+        paymentStats = gatewayPayments->getStats();
+        delete gatewayPayments; // before the gateway it charges through
+        gatewayStats = gateway->getStats();
+        delete gateway;
+    }
+    double elapsedSeconds = HandlerMetrics::elapsedNanos(runStart) / 1e9;
+
+    WorkerTotals sum;
+    for (const WorkerTotals& worker : totals) {
+        sum.completed += worker.completed;
+        sum.failed += worker.failed;
+        sum.stockOuts += worker.stockOuts;
+        sum.cartErrors += worker.cartErrors;
+        sum.revenue += worker.revenue;
+        for (int kind = 0; kind < CART_KIND_COUNT; ++kind) {
+            sum.byKind[kind] += worker.byKind[kind];
+        }
+        for (const std::pair<const std::string, int>& sold : worker.plantsSold) {
+            sum.plantsSold[sold.first] += sold.second;
+        }
+        for (const std::pair<const std::string, int>& sold : worker.potsSold) {
+            sum.potsSold[sold.first] += sold.second;
+        }
+    }
+
+    Logger::getInstance().flush();
+    std::cout.clear();
+    const HandlerMetrics::Stage& checkout = HandlerMetrics::getInstance().getStage(CHECKOUT_STAGE);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n[LOAD] " << options.orders << " orders from " << options.customers << " customers, "
+              << options.concurrency << " workers, ";
+    if (openLoop) {
+        std::cout << "open loop at " << options.rate << " orders/s";
+    } else {
+        std::cout << "closed loop";
+    }
+    std::cout << ", seed " << options.seed << ", stock reservation " << (options.reserve ? "on" : "off");
+    if (options.pipeline) {
+        std::cout << ", order pipeline";
+    }
+    if (options.batch > 0) {
+        std::cout << ", batches of " << options.batch;
+    }
+    if (options.gatewayLatency > 0.0) {
+        std::cout << ", mock gateway at " << options.gatewayLatency << " ms";
+    }
+    std::cout << std::endl;
+
+    std::cout << "[LOAD] Carts:";
+    for (int kind = 0; kind < CART_KIND_COUNT; ++kind) {
+        std::cout << " " << cartKindName(kind) << "=" << sum.byKind[kind];
+    }
+    std::cout << std::endl;
+    std::cout << "[LOAD] Completed " << sum.completed << ", failed checkout " << sum.failed << ", out of stock "
+              << sum.stockOuts << ", cart errors " << sum.cartErrors << ", revenue R" << sum.revenue << std::endl;
+    std::cout << "[LOAD] Elapsed " << std::setprecision(3) << elapsedSeconds << " s, " << std::setprecision(1)
+              << (elapsedSeconds > 0.0 ? options.orders / elapsedSeconds : 0.0) << " orders/s attempted, "
+              << (elapsedSeconds > 0.0 ? sum.completed / elapsedSeconds : 0.0) << " orders/s completed" << std::endl;
+    std::cout << "[LOAD] Checkout latency (ms): p50=" << std::setprecision(3)
+              << percentileMillis(checkout.latency, 50.0) << " p90=" << percentileMillis(checkout.latency, 90.0)
+              << " p99=" << percentileMillis(checkout.latency, 99.0)
+              << " p99.9=" << percentileMillis(checkout.latency, 99.9)
+              << " max=" << checkout.latency.getMax() / 1e6 << std::endl;
+    if (options.gatewayLatency > 0.0) {
+        std::cout << "[LOAD] Gateway payments: submitted " << paymentStats.submitted << ", approved "
+                  << paymentStats.approved << ", declined " << paymentStats.declined << ", failed "
+                  << paymentStats.failed << ", rejected " << paymentStats.rejected << "; attempts "
+                  << paymentStats.attempts << " (" << paymentStats.retries << " retries, " << paymentStats.timeouts
+                  << " timeouts), late approvals reversed " << paymentStats.lateApprovals << ", peak in flight "
+                  << paymentStats.peakInFlight << ", mean "
+                  << (paymentStats.submitted > 0 ? paymentStats.totalMillis / paymentStats.submitted : 0.0)
+                  << " ms" << std::endl;
+        std::cout << "[LOAD] Mock gateway: charges " << gatewayStats.charges << ", approved " << gatewayStats.approved
+                  << ", declined " << gatewayStats.declined << ", errors " << gatewayStats.errors
+                  << ", duplicate charges " << gatewayStats.duplicates << ", reversals " << gatewayStats.reversals
+                  << ", peak pending " << gatewayStats.peakPending << std::endl;
+    }
+
+    // Units sold beyond what was on the floor when the run started
+    int oversoldUnits = 0;
+    std::string oversoldTypes;
+    for (const std::pair<const std::string, int>& sold : sum.plantsSold) {
+        int over = sold.second - plantStock[sold.first];
+        if (over > 0) {
+            oversoldUnits += over;
+            oversoldTypes += (oversoldTypes.empty() ? "" : ", ") + sold.first + " +" + std::to_string(over);
+        }
+    }
+    for (const std::pair<const std::string, int>& sold : sum.potsSold) {
+        int over = sold.second - potStock[sold.first];
+        if (over > 0) {
+            oversoldUnits += over;
+            oversoldTypes += (oversoldTypes.empty() ? "" : ", ") + sold.first + " pot +" + std::to_string(over);
+        }
+    }
+    std::cout << "[LOAD] Oversold units: " << oversoldUnits;
+    if (!oversoldTypes.empty()) {
+        std::cout << " (" << oversoldTypes << ")";
+    }
+    std::cout << std::endl;
+
+    if (!options.csvPath.empty() && HandlerMetrics::getInstance().exportTo(options.csvPath, true)) {
+        std::cout << "[LOAD] Latency figures appended to " << options.csvPath << std::endl;
+    }
+
+    if (!options.verbose) {
+        std::cout.setstate(std::ios::badbit);
+    }
+    for (Customer* customer : customers) {
+        delete customer;
+    }
+    OrderStore::getInstance().close();
+    InventoryManager::getInstance().cleanup();
+    for (PlantSpeciesProfile* profile : profiles) {
+        delete profile;
+    }
+    std::cout.clear();
+    return 0;
+}
@@ -0,0 +1,414 @@
+#include "Logger.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+const std::size_t DRAIN_BATCH = 256;            // lines formatted between writes to the sink
+const std::size_t BATCH_RESERVE = 64 * 1024;    // bytes
+const std::chrono::milliseconds IDLE_WAIT(100); // writer re-checks the ring at least this often
+}
+
+Logger::Logger()
+    : ring(RING_CAPACITY), tail(0), head(0), written(0), dropped(0), droppedReported(0), start(Clock::now()),
+      sink(&std::clog), sleeping(false), synchronous(false), flushTarget(0), flushedUpTo(0), unflushed(false),
+      running(true)
+{
+    for (std::size_t i = 0; i < RING_CAPACITY; ++i)
+    {
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < CATEGORY_COUNT; ++i)
+    {
+        thresholds[i].store(LEVEL_INFO, std::memory_order_relaxed);
+    }
+    batch.reserve(BATCH_RESERVE);
+    std::atexit(&Logger::shutdownAtExit);
+    writer = std::thread(&Logger::run, this);
+}
+
+Logger::~Logger()
+{
+    shutdown();
+}
+
+// Never destroyed: singletons torn down after main() returns still log from their destructors
+Logger &Logger::getInstance()
+{
+    static Logger *instance = new Logger();
+    return *instance;
+}
+
+void Logger::shutdownAtExit()
+{
+    getInstance().shutdown();
+}
+
+void Logger::setLevel(Level level)
+{
+    for (int i = 0; i < CATEGORY_COUNT; ++i)
+    {
+        thresholds[i].store(level, std::memory_order_relaxed);
+    }
+}
+
+void Logger::setLevel(Category category, Level level)
+{
+    thresholds[category].store(level, std::memory_order_relaxed);
+}
+
+Logger::Level Logger::getLevel(Category category) const
+{
+    return static_cast<Level>(thresholds[category].load(std::memory_order_relaxed));
+}
+
+void Logger::setSink(std::ostream &newSink)
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+    sink = &newSink;
+}
+
+void Logger::write(const LogLine &line)
+{
+    if (synchronous.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        format(elapsedMicros(), line.getLevel(), line.getCategory(), line.getText(), line.getLength());
+        written.fetch_add(1, std::memory_order_relaxed);
+        writeBatch(true);
+        return;
+    }
+
+    // Claim the next free slot; a slot still holding an unread line means the ring is full
+    std::uint64_t position = tail.load(std::memory_order_relaxed);
+    Slot *slot;
+    for (;;)
+    {
+        slot = &ring[position & (RING_CAPACITY - 1)];
+        std::uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        std::int64_t difference = static_cast<std::int64_t>(sequence - position);
+        if (difference == 0)
+        {
+            if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            position = tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->micros = elapsedMicros();
+    slot->level = static_cast<std::uint8_t>(line.getLevel());
+    slot->category = static_cast<std::uint8_t>(line.getCategory());
+    slot->length = static_cast<std::uint16_t>(line.getLength());
+    std::memcpy(slot->text, line.getText(), line.getLength());
+    slot->sequence.store(position + 1, std::memory_order_seq_cst);
+
+    // Paired with shutdown(): if it set synchronous after our first check, its final drain may have
+    // missed this slot, so the line is written here instead
+    if (synchronous.load(std::memory_order_seq_cst))
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        drainRemainingLocked();
+        return;
+    }
+
+    // Paired with run(): either the writer sees this line before it sleeps, or we see it sleeping
+    if (sleeping.load(std::memory_order_seq_cst))
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        wake.notify_one();
+    }
+}
+
+void Logger::flush()
+{
+    std::uint64_t target = tail.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(writerMutex);
+    if (!running)
+    {
+        writeBatch(true);
+        return;
+    }
+    if (target > flushTarget)
+    {
+        flushTarget = target;
+    }
+    wake.notify_one();
+    drained.wait(lock, [this, target]() { return flushedUpTo >= target || !running; });
+}
+
+void Logger::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        if (!running)
+        {
+            return;
+        }
+        running = false;
+        wake.notify_one();
+    }
+    writer.join();
+
+    // Lines queued while the writer was finishing; anything later is written by write() itself
+    std::lock_guard<std::mutex> lock(writerMutex);
+    synchronous.store(true, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    drainRemainingLocked();
+    drained.notify_all();
+}
+
+// Only once the writer has stopped: the caller holds writerMutex in place of being the writer thread
+void Logger::drainRemainingLocked()
+{
+    while (drainBatch() > 0)
+    {
+        writeBatch(false);
+    }
+    writeBatch(true);
+}
+
+std::uint64_t Logger::getWrittenCount() const
+{
+    return written.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Logger::getDroppedCount() const
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+void Logger::run()
+{
+    std::unique_lock<std::mutex> lock(writerMutex);
+    for (;;)
+    {
+        // Format without the lock so flush() and setSink() callers are not held up behind it
+        lock.unlock();
+        std::size_t count = drainBatch();
+        lock.lock();
+        if (count > 0)
+        {
+            // Under steady traffic the ring may never empty, so a waiting flush() is served as soon as it is covered
+            bool flushDue = flushTarget > flushedUpTo && head >= flushTarget;
+            writeBatch(flushDue);
+            if (flushDue)
+            {
+                flushedUpTo = head;
+                drained.notify_all();
+            }
+            continue;
+        }
+
+        writeBatch(true);
+        flushedUpTo = head;
+        drained.notify_all();
+        if (!running)
+        {
+            return;
+        }
+
+        sleeping.store(true, std::memory_order_seq_cst);
+        const Slot &next = ring[head & (RING_CAPACITY - 1)];
+        if (next.sequence.load(std::memory_order_seq_cst) != head + 1 && running)
+        {
+            wake.wait_for(lock, IDLE_WAIT);
+        }
+        sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+std::size_t Logger::drainBatch()
+{
+    std::size_t count = 0;
+    while (count < DRAIN_BATCH)
+    {
+        Slot &slot = ring[head & (RING_CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+        {
+            break;
+        }
+        format(slot.micros, slot.level, slot.category, slot.text, slot.length);
+        slot.sequence.store(head + RING_CAPACITY, std::memory_order_release);
+        ++head;
+        ++count;
+    }
+    written.fetch_add(count, std::memory_order_relaxed);
+
+    std::uint64_t lost = dropped.load(std::memory_order_relaxed);
+    if (lost != droppedReported)
+    {
+        char text[64];
+        int length = std::snprintf(text, sizeof(text), "%llu log lines dropped, ring full",
+                                   static_cast<unsigned long long>(lost - droppedReported));
+        format(elapsedMicros(), LEVEL_WARN, GENERAL, text, static_cast<std::size_t>(length));
+        droppedReported = lost;
+    }
+    return count;
+}
+
+void Logger::writeBatch(bool flushSink)
+{
+    if (!batch.empty())
+    {
+        sink->write(batch.data(), static_cast<std::streamsize>(batch.size()));
+        batch.clear();
+        unflushed = true;
+    }
+    if (flushSink && unflushed)
+    {
+        sink->flush();
+        unflushed = false;
+    }
+}
+
+void Logger::format(std::int64_t micros, int level, int category, const char *text, std::size_t length)
+{
+    char prefix[48];
+    int prefixLength = std::snprintf(prefix, sizeof(prefix), "[%5lld.%03lld] %-5s %-10s ",
+                                     static_cast<long long>(micros / 1000000),
+                                     static_cast<long long>(micros / 1000 % 1000),
+                                     getLevelName(static_cast<Level>(level)),
+                                     getCategoryName(static_cast<Category>(category)));
+    batch.append(prefix, static_cast<std::size_t>(prefixLength));
+    batch.append(text, length);
+    batch.push_back('\n');
+}
+
+std::int64_t Logger::elapsedMicros() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+}
+
+const char *Logger::getLevelName(Level level)
+{
+    switch (level)
+    {
+    case LEVEL_TRACE:
+        return "TRACE";
+    case LEVEL_DEBUG:
+        return "DEBUG";
+    case LEVEL_INFO:
+        return "INFO";
+    case LEVEL_WARN:
+        return "WARN";
+    case LEVEL_ERROR:
+        return "ERROR";
+    case LEVEL_OFF:
+        break;
+    }
+    return "OFF";
+}
+
+const char *Logger::getCategoryName(Category category)
+{
+    switch (category)
+    {
+    case GENERAL:
+        return "General";
+    case INVENTORY:
+        return "Inventory";
+    case STAFF:
+        return "Staff";
+    case PLANT_STATE:
+        return "PlantState";
+    case CARE:
+        return "Care";
+    case ORDERS:
+        return "Orders";
+    case PAYMENTS:
+        return "Payments";
+    case CATEGORY_COUNT:
+        break;
+    }
+    return "Unknown";
+}
+
+LogLine::LogLine(Logger::Level level, Logger::Category category) : level(level), category(category), length(0)
+{
+}
+
+LogLine &LogLine::operator<<(const char *value)
+{
+    if (value)
+    {
+        append(value, std::strlen(value));
+    }
+    return *this;
+}
+
+LogLine &LogLine::operator<<(const std::string &value)
+{
+    append(value.data(), value.size());
+    return *this;
+}
+
+LogLine &LogLine::operator<<(char c)
+{
+    append(&c, 1);
+    return *this;
+}
+
+LogLine &LogLine::operator<<(bool value)
+{
+    return *this << (value ? "true" : "false");
+}
+
+LogLine &LogLine::operator<<(const void *pointer)
+{
+    char digits[32];
+    int count = std::snprintf(digits, sizeof(digits), "%p", pointer);
+    append(digits, static_cast<std::size_t>(count));
+    return *this;
+}
+
+void LogLine::append(const char *data, std::size_t count)
+{
+    std::size_t room = Logger::MESSAGE_BYTES - length;
+    if (count <= room)
+    {
+        std::memcpy(text + length, data, count);
+        length += count;
+        return;
+    }
+    if (room == 0)
+    {
+        return; // already cut short
+    }
+    std::memcpy(text + length, data, room);
+    length = Logger::MESSAGE_BYTES;
+    std::memcpy(text + length - 3, "...", 3);
+}
+
+void LogLine::appendSigned(long long value)
+{
+    char digits[24];
+    int count = std::snprintf(digits, sizeof(digits), "%lld", value);
+    append(digits, static_cast<std::size_t>(count));
+}
+
+void LogLine::appendUnsigned(unsigned long long value)
+{
+    char digits[24];
+    int count = std::snprintf(digits, sizeof(digits), "%llu", value);
+    append(digits, static_cast<std::size_t>(count));
+}
+
+void LogLine::appendDouble(double value)
+{
+    char digits[32];
+    int count = std::snprintf(digits, sizeof(digits), "%.10g", value);
+    append(digits, static_cast<std::size_t>(count));
+}
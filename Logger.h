@@ -0,0 +1,283 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Numeric levels for GREENHOUSE_LOG_LEVEL, matching Logger::Level
+#define GH_LOG_LEVEL_TRACE 0
+#define GH_LOG_LEVEL_DEBUG 1
+#define GH_LOG_LEVEL_INFO 2
+#define GH_LOG_LEVEL_WARN 3
+#define GH_LOG_LEVEL_ERROR 4
+#define GH_LOG_LEVEL_OFF 5
+
+// Calls below this level are compiled out; build with e.g. -DGREENHOUSE_LOG_LEVEL=GH_LOG_LEVEL_WARN
+#ifndef GREENHOUSE_LOG_LEVEL
+#define GREENHOUSE_LOG_LEVEL GH_LOG_LEVEL_DEBUG
+#endif
+
+class LogLine;
+
+/**
+ * @class Logger
+ * @brief Leveled, categorised log that keeps console output off the hot paths
+ *
+ * Inventory moves, staff dispatch, plant state changes and care used to print
+ * straight to std::cout with std::endl, so every event paid for a formatted
+ * write and a flush on the calling thread. Those paths now log through the
+ * GH_LOG_* macros instead:
+ * @code
+ * GH_LOG_INFO(Logger::INVENTORY, "Plant moved to sales floor (" << count << " ready)");
+ * @endcode
+ * A call first checks the category's runtime level (one relaxed atomic load),
+ * so a quiet category costs a branch; calls below GREENHOUSE_LOG_LEVEL are
+ * compiled out and cost nothing at all.
+ *
+ * An enabled call formats into a fixed-size LogLine on the caller's stack and
+ * copies it into a bounded multi-producer ring (a slot is claimed with one
+ * compare-and-swap; no lock is taken). A background writer drains the ring in
+ * batches to the sink and flushes only once the ring is empty. If the ring is
+ * full the message is dropped and counted rather than blocking the caller;
+ * the writer reports how many were lost. Lines longer than MESSAGE_BYTES are
+ * cut short with "...".
+ *
+ * Output, with time measured from the first use of the logger:
+ * @code
+ * [   12.345] INFO  Inventory  Plant moved to sales floor (4 ready)
+ * @endcode
+ * Lines go to std::clog unless setSink() says otherwise, so the writer never
+ * lands in the middle of a menu or prompt the front ends print on std::cout.
+ *
+ * shutdown() drains and stops the writer; it is also registered with atexit().
+ * Anything logged after that (e.g. from other singletons' destructors) is
+ * written synchronously, and a line that was already on its way into the ring
+ * when shutdown() drained it is written by its own caller. The instance itself
+ * is never destroyed so that such late calls stay safe.
+ */
+class Logger
+{
+public:
+    enum Level
+    {
+        LEVEL_TRACE = GH_LOG_LEVEL_TRACE,
+        LEVEL_DEBUG = GH_LOG_LEVEL_DEBUG,
+        LEVEL_INFO = GH_LOG_LEVEL_INFO,
+        LEVEL_WARN = GH_LOG_LEVEL_WARN,
+        LEVEL_ERROR = GH_LOG_LEVEL_ERROR,
+        LEVEL_OFF = GH_LOG_LEVEL_OFF
+    };
+
+    /** @brief Subsystem a message comes from; each has its own runtime level */
+    enum Category
+    {
+        GENERAL,
+        INVENTORY,
+        STAFF,
+        PLANT_STATE,
+        CARE,
+        ORDERS,
+        PAYMENTS,
+        CATEGORY_COUNT
+    };
+
+    static const std::size_t MESSAGE_BYTES = 224;
+    static const std::size_t RING_CAPACITY = 8192; // slots; a power of two
+
+    Logger(const Logger &) = delete;
+    Logger &operator=(const Logger &) = delete;
+
+    static Logger &getInstance();
+
+    bool isEnabled(Level level, Category category) const
+    {
+        return static_cast<int>(level) >= thresholds[category].load(std::memory_order_relaxed);
+    }
+
+    /** @brief Sets the runtime level of every category; the default is LEVEL_INFO */
+    void setLevel(Level level);
+    void setLevel(Category category, Level level);
+    Level getLevel(Category category) const;
+
+    /** @brief Where the writer sends lines; std::clog by default. The stream must outlive its use */
+    void setSink(std::ostream &sink);
+
+    /** @brief Queues a formatted line for the writer; never blocks on I/O */
+    void write(const LogLine &line);
+
+    /** @brief Waits until every line queued before the call has been written and the sink flushed */
+    void flush();
+
+    /** @brief Drains the ring and stops the writer; later lines are written synchronously */
+    void shutdown();
+
+    std::uint64_t getWrittenCount() const;
+    std::uint64_t getDroppedCount() const;
+
+    static const char *getLevelName(Level level);
+    static const char *getCategoryName(Category category);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Slot
+    {
+        std::atomic<std::uint64_t> sequence; // == position when free, position + 1 once filled
+        std::int64_t micros;                 // since start
+        std::uint16_t length;
+        std::uint8_t level;
+        std::uint8_t category;
+        char text[MESSAGE_BYTES];
+    };
+
+    std::vector<Slot> ring;
+    std::atomic<std::uint64_t> tail; // next position a producer claims
+    char tailPadding[64];
+    std::uint64_t head; // next position the writer reads; writer thread only
+
+    std::atomic<int> thresholds[CATEGORY_COUNT];
+    std::atomic<std::uint64_t> written;
+    std::atomic<std::uint64_t> dropped;
+    std::uint64_t droppedReported; // writer thread only
+    const Clock::time_point start;
+
+    std::ostream *sink;
+    std::string batch; // writer's output buffer
+
+    std::mutex writerMutex; // guards the sink and the wake-up and flush handshakes below
+    std::condition_variable wake;
+    std::condition_variable drained;
+    std::atomic<bool> sleeping;
+    std::atomic<bool> synchronous; // set by shutdown()
+    std::uint64_t flushTarget; // highest position a flush() caller is waiting for
+    std::uint64_t flushedUpTo;
+    bool unflushed;
+    bool running;
+    std::thread writer;
+
+    Logger();
+    ~Logger();
+
+    void run();
+    std::size_t drainBatch();
+    void drainRemainingLocked();
+    void writeBatch(bool flushSink);
+    void format(std::int64_t micros, int level, int category, const char *text, std::size_t length);
+    std::int64_t elapsedMicros() const;
+    static void shutdownAtExit();
+};
+
+/**
+ * @class LogLine
+ * @brief One message under construction, formatted into a fixed buffer on the stack
+ *
+ * Supports the operator<< types the hot paths print: strings, characters,
+ * booleans, integers, floating point and pointers. Built by the GH_LOG macros;
+ * not normally used directly.
+ */
+class LogLine
+{
+public:
+    LogLine(Logger::Level level, Logger::Category category);
+
+    LogLine &operator<<(const char *text);
+    LogLine &operator<<(const std::string &text);
+    LogLine &operator<<(char c);
+    LogLine &operator<<(bool value);
+    LogLine &operator<<(const void *pointer);
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, LogLine &>::type
+    operator<<(T value)
+    {
+        appendSigned(static_cast<long long>(value));
+        return *this;
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value, LogLine &>::type
+    operator<<(T value)
+    {
+        appendUnsigned(static_cast<unsigned long long>(value));
+        return *this;
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value, LogLine &>::type operator<<(T value)
+    {
+        appendDouble(static_cast<double>(value));
+        return *this;
+    }
+
+    Logger::Level getLevel() const { return level; }
+    Logger::Category getCategory() const { return category; }
+    const char *getText() const { return text; }
+    std::size_t getLength() const { return length; }
+
+private:
+    Logger::Level level;
+    Logger::Category category;
+    std::size_t length;
+    char text[Logger::MESSAGE_BYTES];
+
+    void append(const char *data, std::size_t count);
+    void appendSigned(long long value);
+    void appendUnsigned(unsigned long long value);
+    void appendDouble(double value);
+};
+
+#define GH_LOG(level, category, message)                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (Logger::getInstance().isEnabled(level, category))                                                          \
+        {                                                                                                              \
+            LogLine ghLogLine(level, category);                                                                        \
+            ghLogLine << message;                                                                                      \
+            Logger::getInstance().write(ghLogLine);                                                                    \
+        }                                                                                                              \
+    } while (0)
+
+// Compiled out: the message is only type-checked (sizeof does not evaluate it), which also keeps
+// variables that exist just to be logged from tripping unused-variable warnings
+#define GH_LOG_DISABLED(category, message) ((void)sizeof(LogLine(Logger::LEVEL_OFF, category) << message))
+
+#if GREENHOUSE_LOG_LEVEL <= GH_LOG_LEVEL_TRACE
+#define GH_LOG_TRACE(category, message) GH_LOG(Logger::LEVEL_TRACE, category, message)
+#else
+#define GH_LOG_TRACE(category, message) GH_LOG_DISABLED(category, message)
+#endif
+
+#if GREENHOUSE_LOG_LEVEL <= GH_LOG_LEVEL_DEBUG
+#define GH_LOG_DEBUG(category, message) GH_LOG(Logger::LEVEL_DEBUG, category, message)
+#else
+#define GH_LOG_DEBUG(category, message) GH_LOG_DISABLED(category, message)
+#endif
+
+#if GREENHOUSE_LOG_LEVEL <= GH_LOG_LEVEL_INFO
+#define GH_LOG_INFO(category, message) GH_LOG(Logger::LEVEL_INFO, category, message)
+#else
+#define GH_LOG_INFO(category, message) GH_LOG_DISABLED(category, message)
+#endif
+
+#if GREENHOUSE_LOG_LEVEL <= GH_LOG_LEVEL_WARN
+#define GH_LOG_WARN(category, message) GH_LOG(Logger::LEVEL_WARN, category, message)
+#else
+#define GH_LOG_WARN(category, message) GH_LOG_DISABLED(category, message)
+#endif
+
+#if GREENHOUSE_LOG_LEVEL <= GH_LOG_LEVEL_ERROR
+#define GH_LOG_ERROR(category, message) GH_LOG(Logger::LEVEL_ERROR, category, message)
+#else
+#define GH_LOG_ERROR(category, message) GH_LOG_DISABLED(category, message)
+#endif
+
+#endif // LOGGER_H
@@ -0,0 +1,152 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() : data(nullptr), length(0), fileHandle(nullptr), mappingHandle(nullptr)
+{
+}
+
+bool MappedFile::open(const std::string &path)
+{
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    length = static_cast<std::size_t>(size.QuadPart);
+    if (length == 0)
+    {
+        return true; // Nothing to map
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping)
+    {
+        close();
+        return false;
+    }
+    mappingHandle = mapping;
+
+    data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data)
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data)
+    {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle)
+    {
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+    }
+    if (fileHandle)
+    {
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+    }
+    data = nullptr;
+    length = 0;
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+}
+
+bool MappedFile::isOpen() const
+{
+    return fileHandle != nullptr;
+}
+
+#else
+
+MappedFile::MappedFile() : data(nullptr), length(0), fd(-1)
+{
+}
+
+bool MappedFile::open(const std::string &path)
+{
+    close();
+
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close();
+        return false;
+    }
+
+    length = static_cast<std::size_t>(info.st_size);
+    if (length == 0)
+    {
+        return true; // mmap rejects zero-length mappings
+    }
+
+    void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED)
+    {
+        close();
+        return false;
+    }
+
+    // Restores read the file front to back exactly once
+    madvise(mapped, length, MADV_SEQUENTIAL);
+    data = static_cast<const char *>(mapped);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data)
+    {
+        munmap(const_cast<char *>(data), length);
+    }
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+    data = nullptr;
+    length = 0;
+    fd = -1;
+}
+
+bool MappedFile::isOpen() const
+{
+    return fd >= 0;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
@@ -0,0 +1,47 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a file on disk
+ *
+ * Used by the persistence layers (inventory snapshots, the order store and the
+ * payment ledger) to read large files without copying them through streams.
+ * The mapping is released when the object is destroyed or close() is called.
+ */
+class MappedFile
+{
+private:
+    const char *data;
+    std::size_t length;
+#ifdef _WIN32
+    void *fileHandle;
+    void *mappingHandle;
+#else
+    int fd;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * @brief Maps the whole file read-only
+     * @param path File to map
+     * @return true if the file exists and was mapped (empty files map to size 0)
+     */
+    bool open(const std::string &path);
+    void close();
+
+    bool isOpen() const;
+    const char *getData() const { return data; }
+    std::size_t getSize() const { return length; }
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,123 @@
+#include "MessageTemplate.h"
+
+#include <cstdio>
+
+MessageTemplate::MessageTemplate(const std::string &source, const std::vector<std::string> &fieldNames)
+    : fieldCount(fieldNames.size())
+{
+    std::string pending;
+    std::size_t pos = 0;
+    while (pos < source.size())
+    {
+        char c = source[pos];
+        if (c == '{' && pos + 1 < source.size() && source[pos + 1] == '{')
+        {
+            pending += '{';
+            pos += 2;
+            continue;
+        }
+        std::size_t close = c == '{' ? source.find('}', pos) : std::string::npos;
+        if (close == std::string::npos)
+        {
+            pending += c;
+            ++pos;
+            continue;
+        }
+
+        std::string name = source.substr(pos + 1, close - pos - 1);
+        int field = -1;
+        for (std::size_t i = 0; i < fieldNames.size(); ++i)
+        {
+            if (fieldNames[i] == name)
+            {
+                field = static_cast<int>(i);
+                break;
+            }
+        }
+        if (field < 0)
+        {
+            pending.append(source, pos, close - pos + 1);
+        }
+        else
+        {
+            addLiteral(pending);
+            pending.clear();
+            Segment segment;
+            segment.offset = 0;
+            segment.length = 0;
+            segment.field = field;
+            segments.push_back(segment);
+        }
+        pos = close + 1;
+    }
+    addLiteral(pending);
+}
+
+void MessageTemplate::addLiteral(const std::string &text)
+{
+    if (text.empty())
+    {
+        return;
+    }
+    Segment segment;
+    segment.offset = literals.size();
+    segment.length = text.size();
+    segment.field = -1;
+    literals += text;
+    segments.push_back(segment);
+}
+
+std::string MessageTemplate::render(const std::string *values) const
+{
+    std::size_t size = literals.size();
+    for (const Segment &segment : segments)
+    {
+        if (segment.field >= 0)
+        {
+            size += values[segment.field].size();
+        }
+    }
+
+    std::string out;
+    out.reserve(size);
+    for (const Segment &segment : segments)
+    {
+        if (segment.field >= 0)
+        {
+            out += values[segment.field];
+        }
+        else
+        {
+            out.append(literals, segment.offset, segment.length);
+        }
+    }
+    return out;
+}
+
+std::string MessageTemplate::render(const std::vector<std::string> &values) const
+{
+    if (values.size() < fieldCount)
+    {
+        std::vector<std::string> padded(values);
+        padded.resize(fieldCount);
+        return render(padded.data());
+    }
+    return render(values.data());
+}
+
+std::size_t MessageTemplate::getFieldCount() const
+{
+    return fieldCount;
+}
+
+std::size_t MessageTemplate::getSegmentCount() const
+{
+    return segments.size();
+}
+
+std::string MessageTemplate::formatAmount(double amount)
+{
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "R%.2f", amount);
+    return buf;
+}
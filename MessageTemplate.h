@@ -0,0 +1,55 @@
+#ifndef MESSAGE_TEMPLATE_H
+#define MESSAGE_TEMPLATE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @class MessageTemplate
+ * @brief Notification text compiled once into literal and field segments
+ *
+ * The source text names its fields in braces, e.g. "Dear {name},". The
+ * constructor resolves every placeholder to a position in the given field
+ * list, so render() only appends literal runs and field values into one
+ * pre-sized string: no parsing, lookups or stream formatting per message.
+ * "{{" stands for a literal brace; a placeholder naming no listed field is
+ * kept as literal text.
+ *
+ * Compiled templates are immutable, so one instance can be shared by any
+ * number of threads.
+ */
+class MessageTemplate
+{
+public:
+    MessageTemplate(const std::string &source, const std::vector<std::string> &fieldNames);
+
+    /**
+     * @brief Renders the template
+     * @param values One value per field, in the order the fields were listed
+     */
+    std::string render(const std::string *values) const;
+    std::string render(const std::vector<std::string> &values) const;
+
+    std::size_t getFieldCount() const;
+    std::size_t getSegmentCount() const;
+
+    /** @brief Formats a rand amount as "R1234.56" */
+    static std::string formatAmount(double amount);
+
+private:
+    struct Segment
+    {
+        std::size_t offset; // into literals; unused for fields
+        std::size_t length;
+        int field; // -1 for literal text
+    };
+
+    std::string literals; // all literal text, back to back
+    std::vector<Segment> segments;
+    std::size_t fieldCount;
+
+    void addLiteral(const std::string &text);
+};
+
+#endif // MESSAGE_TEMPLATE_H
@@ -1,6 +1,6 @@
 #ifndef MINIMAL_PRUNING_STRATEGY_H
 #define MINIMAL_PRUNING_STRATEGY_H
-#include <iostream>
+#include "Logger.h"
 
 #include "CareStrategy.h"
 
@@ -10,7 +10,7 @@ public:
     virtual void applyCare(int amount, const std::string &careType) override
     {
         // Implementation of minimal pruning logic
-        std::cout << "Applying minimal pruning of amount " << amount << " for care type: " << careType << std::endl;
+        GH_LOG_DEBUG(Logger::CARE, "Applying minimal pruning of amount " << amount << " for care type: " << careType);
     }
     std::string getName() const override;
 };
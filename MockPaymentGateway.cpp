@@ -0,0 +1,166 @@
+#include "MockPaymentGateway.h"
+#include "IdGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const double Z_99 = 2.3263; // standard normal 99th percentile
+}
+
+MockPaymentGateway::Config::Config()
+    : latencyModel(LOG_NORMAL), latencyMillis(120.0), maxLatencyMillis(800.0), declineRate(0.05), errorRate(0.02),
+      noResponseRate(0.0), seed(std::random_device{}())
+{
+}
+
+MockPaymentGateway::Stats::Stats()
+    : charges(0), approved(0), declined(0), errors(0), unanswered(0), duplicates(0), reversals(0), peakPending(0)
+{
+}
+
+MockPaymentGateway::MockPaymentGateway(const Config &config)
+    : config(config), rng(config.seed), sequence(0), stopping(false)
+{
+    worker = std::thread(&MockPaymentGateway::run, this);
+}
+
+MockPaymentGateway::~MockPaymentGateway()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+void MockPaymentGateway::setConfig(const Config &newConfig)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    config = newConfig;
+}
+
+MockPaymentGateway::Stats MockPaymentGateway::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+std::size_t MockPaymentGateway::getPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return answers.size();
+}
+
+double MockPaymentGateway::sampleLatencyMillis()
+{
+    switch (config.latencyModel)
+    {
+    case UNIFORM:
+    {
+        std::uniform_real_distribution<double> spread(config.latencyMillis,
+                                                      std::max(config.latencyMillis, config.maxLatencyMillis));
+        return spread(rng);
+    }
+    case LOG_NORMAL:
+    {
+        double median = std::max(config.latencyMillis, 0.001);
+        double sigma = std::log(std::max(config.maxLatencyMillis, median) / median) / Z_99;
+        std::normal_distribution<double> normal(0.0, 1.0);
+        return median * std::exp(sigma * normal(rng));
+    }
+    default:
+        return config.latencyMillis;
+    }
+}
+
+void MockPaymentGateway::charge(const PaymentRequest &request, const std::string &idempotencyKey, const Callback &done)
+{
+    (void)request;
+    std::unique_lock<std::mutex> lock(mutex);
+    ++stats.charges;
+
+    Answer answer;
+    answer.sequence = ++sequence;
+    answer.done = done;
+    answer.due = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                    std::chrono::duration<double, std::milli>(sampleLatencyMillis()));
+
+    std::unordered_map<std::string, std::string>::const_iterator approved = approvedKeys.find(idempotencyKey);
+    double roll = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    if (roll < config.noResponseRate)
+    {
+        // The provider may still have acted on it; only the answer is lost
+        ++stats.unanswered;
+        return;
+    }
+    if (approved != approvedKeys.end())
+    {
+        ++stats.duplicates;
+        answer.response = APPROVED;
+        answer.reference = approved->second;
+    }
+    else if (roll < config.noResponseRate + config.errorRate)
+    {
+        ++stats.errors;
+        answer.response = UNAVAILABLE;
+    }
+    else if (roll < config.noResponseRate + config.errorRate + config.declineRate)
+    {
+        ++stats.declined;
+        answer.response = DECLINED;
+    }
+    else
+    {
+        ++stats.approved;
+        answer.response = APPROVED;
+        answer.reference = IdGenerator::getInstance().nextId("GW-");
+        approvedKeys[idempotencyKey] = answer.reference;
+    }
+
+    bool soonest = answers.empty() || answer.due < answers.top().due;
+    answers.push(answer);
+    stats.peakPending = std::max(stats.peakPending, answers.size());
+    lock.unlock();
+    if (soonest)
+    {
+        wake.notify_one();
+    }
+}
+
+void MockPaymentGateway::reverse(const std::string &reference, const std::string &idempotencyKey)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<std::string, std::string>::iterator approved = approvedKeys.find(idempotencyKey);
+    if (approved != approvedKeys.end() && approved->second == reference)
+    {
+        approvedKeys.erase(approved);
+        ++stats.reversals;
+    }
+}
+
+void MockPaymentGateway::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping)
+    {
+        if (answers.empty())
+        {
+            wake.wait(lock);
+            continue;
+        }
+        Clock::time_point due = answers.top().due; // a copy: charge() may grow the heap while we wait
+        if (Clock::now() < due)
+        {
+            wake.wait_until(lock, due);
+            continue;
+        }
+        Answer answer = answers.top();
+        answers.pop();
+        lock.unlock();
+        answer.done(answer.response, answer.reference);
+        lock.lock();
+    }
+}
@@ -0,0 +1,120 @@
+#ifndef MOCK_PAYMENT_GATEWAY_H
+#define MOCK_PAYMENT_GATEWAY_H
+
+#include "PaymentGateway.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class MockPaymentGateway
+ * @brief In-process PaymentGateway that answers after a simulated network delay
+ *
+ * Lets checkout be measured against realistic gateway behaviour without a
+ * provider: every charge is answered from a timer thread after a delay drawn
+ * from the configured latency model, and a configurable share of charges are
+ * declined, fail as unavailable, or are never answered at all. Approvals are
+ * remembered by idempotency key, so a retried charge is answered with the
+ * original reference rather than charged twice.
+ *
+ * Answers are delivered on the gateway's own thread. Charges still pending
+ * when the gateway is destroyed are dropped unanswered.
+ */
+class MockPaymentGateway : public PaymentGateway
+{
+public:
+    enum LatencyModel
+    {
+        FIXED,     // always latencyMillis
+        UNIFORM,   // evenly spread over [latencyMillis, maxLatencyMillis]
+        LOG_NORMAL // median latencyMillis, 99th percentile maxLatencyMillis
+    };
+
+    struct Config
+    {
+        LatencyModel latencyModel;
+        double latencyMillis;
+        double maxLatencyMillis;
+        double declineRate;    // share of charges the provider declines
+        double errorRate;      // share answered UNAVAILABLE
+        double noResponseRate; // share never answered
+        unsigned int seed;
+
+        Config();
+    };
+
+    struct Stats
+    {
+        std::uint64_t charges;
+        std::uint64_t approved;
+        std::uint64_t declined;
+        std::uint64_t errors;
+        std::uint64_t unanswered;
+        std::uint64_t duplicates; // repeat charges of an already approved key
+        std::uint64_t reversals;
+        std::size_t peakPending;
+
+        Stats();
+    };
+
+    explicit MockPaymentGateway(const Config &config = Config());
+    ~MockPaymentGateway();
+
+    MockPaymentGateway(const MockPaymentGateway &) = delete;
+    MockPaymentGateway &operator=(const MockPaymentGateway &) = delete;
+
+    void charge(const PaymentRequest &request, const std::string &idempotencyKey, const Callback &done) override;
+    void reverse(const std::string &reference, const std::string &idempotencyKey) override;
+
+    /** @brief Changes behaviour for later charges, e.g. to simulate an outage mid-run */
+    void setConfig(const Config &config);
+
+    Stats getStats() const;
+    std::size_t getPendingCount() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Answer
+    {
+        Clock::time_point due;
+        std::uint64_t sequence; // keeps answers due at the same time in charge order
+        Callback done;
+        Response response;
+        std::string reference;
+    };
+
+    struct AnswersLater
+    {
+        bool operator()(const Answer &a, const Answer &b) const
+        {
+            return a.due != b.due ? a.due > b.due : a.sequence > b.sequence;
+        }
+    };
+
+    Config config;
+    Stats stats;
+    std::mt19937 rng;
+    std::priority_queue<Answer, std::vector<Answer>, AnswersLater> answers;
+    std::unordered_map<std::string, std::string> approvedKeys; // idempotency key -> reference
+    std::uint64_t sequence;
+    bool stopping;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::thread worker;
+
+    double sampleLatencyMillis();
+    void run();
+};
+
+#endif // MOCK_PAYMENT_GATEWAY_H
@@ -2,12 +2,15 @@
 #define NOTIFICATIONHANDLER_H
 
 #include "OrderProcessHandler.h"
-#include <sstream>
-#include <iomanip>
+#include "MessageTemplate.h"
+#include "NotificationOutbox.h"
+#include "OrderStore.h"
+#include <string>
+#include <vector>
 
 /**
  * @brief Concrete handler for customer notification
- * Sends order confirmation and updates to the customer
+ * Queues order confirmations and updates for the customer in the NotificationOutbox
  * Can be used for both success and failure notifications
  */
 class NotificationHandler : public OrderProcessHandler {
@@ -33,30 +36,117 @@ protected:
     }
     
 private:
+    // Fields shared by all the notification templates, in render order
+    enum Field { NAME, EMAIL, ORDER_ID, ORDER_DATE, STATUS, ITEMS, TOTAL, ISSUES, FIELD_COUNT };
+
+    static const std::vector<std::string>& fieldNames() {
+        static const std::vector<std::string> names = {
+            "name", "email", "orderId", "orderDate", "status", "items", "total", "issues"};
+        return names;
+    }
+
+    // Templates are compiled once, on first use, and shared by every handler
+    static const MessageTemplate& confirmationEmail() {
+        static const MessageTemplate compiled(
+            "Dear {name},\n\n"
+            "Thank you for your order at Green Garden Nursery!\n\n"
+            "ORDER DETAILS:\n"
+            "Order ID: {orderId}\n"
+            "Customer: {name}\n"
+            "Email: {email}\n"
+            "Order Date: {orderDate}\n\n"
+            "ITEMS ORDERED:\n"
+            "{items}\n"
+            "TOTAL AMOUNT: {total}\n\n"
+            "Your plants are ready for pickup or will be prepared for delivery.\n"
+            "Thank you for choosing Green Garden Nursery!\n\n"
+            "Best regards,\n"
+            "The Green Garden Team",
+            fieldNames());
+        return compiled;
+    }
+
+    static const MessageTemplate& confirmationSms() {
+        static const MessageTemplate compiled("Your order {orderId} has been confirmed! Total: {total}", fieldNames());
+        return compiled;
+    }
+
+    static const MessageTemplate& failureEmail() {
+        static const MessageTemplate compiled(
+            "Dear {name},\n\n"
+            "We're sorry, but we encountered an issue with your order.\n\n"
+            "ORDER DETAILS:\n"
+            "Order ID: {orderId}\n"
+            "Order Date: {orderDate}\n"
+            "Status: {status}\n\n"
+            "ISSUE(S) ENCOUNTERED:\n"
+            "{issues}"
+            "\nWHAT YOU CAN DO:\n"
+            "- Modify your order and try again\n"
+            "- Contact our staff for assistance\n"
+            "- Check our website for updated availability\n\n"
+            "If you need immediate assistance, please contact us:\n"
+            "Phone: (555) 123-4567\n"
+            "Email: support@greengarden.com\n\n"
+            "We apologize for any inconvenience.\n\n"
+            "Best regards,\n"
+            "The Green Garden Team",
+            fieldNames());
+        return compiled;
+    }
+
+    static const MessageTemplate& failureSms() {
+        static const MessageTemplate compiled(
+            "Your order {orderId} could not be processed. Please check your email for details.", fieldNames());
+        return compiled;
+    }
+
+    void fillFields(Order* order, Customer* customer, std::string* values) const {
+        values[NAME] = customer->getName();
+        values[EMAIL] = customer->getEmail();
+        values[ORDER_ID] = order->getOrderId();
+        values[ORDER_DATE] = order->getOrderDate();
+        values[STATUS] = order->getStatus();
+        values[TOTAL] = MessageTemplate::formatAmount(order->getTotalAmount());
+    }
+
+    void queueMessage(const std::string& channel, const std::string& recipient, const std::string& subject,
+                      const std::string& body, Order* order) {
+        OutboxMessage message;
+        message.channel = channel;
+        message.recipient = recipient;
+        message.subject = subject;
+        message.body = body;
+        message.orderId = order->getOrderId();
+        NotificationOutbox::getInstance().enqueue(message);
+    }
+
     bool sendSuccessNotification(Order* order, Customer* customer) {
         logStep("Preparing order confirmation for: " + customer->getName());
         
-        // Generate order confirmation
-        std::string confirmation = generateOrderConfirmation(order, customer);
+        std::string values[FIELD_COUNT];
+        fillFields(order, customer, values);
+        std::vector<OrderItem*> items = order->getOrderItems();
+        if (items.empty()) {
+            values[ITEMS] = "- (No items)\n";
+        }
+        for (size_t i = 0; i < items.size(); i++) {
+            values[ITEMS] += std::to_string(i + 1) + ". " + items[i]->getDescription() + " - " +
+                             MessageTemplate::formatAmount(items[i]->getPrice()) + "\n";
+        }
         
-        // Simulate sending notification
-        logStep("Sending confirmation email to: " + customer->getEmail());
-        std::cout << "\n" << std::string(50, '=') << std::endl;
-        std::cout << "[EMAIL CONFIRMATION]" << std::endl;
-        std::cout << std::string(50, '=') << std::endl;
-        std::cout << confirmation << std::endl;
-        std::cout << std::string(50, '=') << std::endl;
+        // Delivered by the outbox's worker; checkout does not wait for it
+        logStep("Queueing confirmation email to: " + customer->getEmail());
+        queueMessage("EMAIL", customer->getEmail(), "EMAIL CONFIRMATION", confirmationEmail().render(values), order);
         
-        // Simulate SMS notification if phone number is available
         if (!customer->getCellPhone().empty()) {
-            logStep("Sending SMS notification to: " + customer->getCellPhone());
-            std::cout << "\n[SMS]: Your order " << order->getOrderId() 
-                     << " has been confirmed! Total: R" << std::fixed << std::setprecision(2) 
-                     << order->getTotalAmount() << std::endl;
+            logStep("Queueing SMS notification to: " + customer->getCellPhone());
+            queueMessage("SMS", customer->getCellPhone(), "", confirmationSms().render(values), order);
         }
         
         // Update order status
         order->setStatus("Completed - Customer Notified");
+        OrderStore::getInstance().append(*order);
         logStep("Order processing completed successfully!");
         
         return true;
@@ -65,89 +155,31 @@ private:
     bool sendFailureNotification(Order* order, Customer* customer) {
         logStep("Preparing order failure notification for: " + customer->getName());
         
-        // Generate failure notification
-        std::string notification = generateFailureNotification(order, customer);
-        
-        // Send email notification
-        logStep("Sending failure notification email to: " + customer->getEmail());
-        std::cout << "\n" << std::string(50, '=') << std::endl;
-        std::cout << "[EMAIL NOTIFICATION - ORDER ISSUE]" << std::endl;
-        std::cout << std::string(50, '=') << std::endl;
-        std::cout << notification << std::endl;
-        std::cout << std::string(50, '=') << std::endl;
-        
-        // Send SMS if phone available
-        if (!customer->getCellPhone().empty()) {
-            logStep("Sending SMS notification to: " + customer->getCellPhone());
-            std::cout << "\n[SMS]: Your order " << order->getOrderId() 
-                     << " could not be processed. Please check your email for details." << std::endl;
-        }
-        
-        // Update order status
-        order->setStatus("Failed - Customer Notified");
-        logStep("Failure notification sent to customer");
-        
-        return true; // Notification sent successfully even though order failed
-    }
-    
-    std::string generateFailureNotification(Order* order, Customer* customer) {
-        std::ostringstream notification;
-        
-        notification << "Dear " << customer->getName() << ",\n\n";
-        notification << "We're sorry, but we encountered an issue with your order.\n\n";
-        notification << "ORDER DETAILS:\n";
-        notification << "Order ID: " << order->getOrderId() << "\n";
-        notification << "Order Date: " << order->getOrderDate() << "\n";
-        notification << "Status: " << order->getStatus() << "\n\n";
-        
-        notification << "ISSUE(S) ENCOUNTERED:\n";
+        std::string values[FIELD_COUNT];
+        fillFields(order, customer, values);
         if (errorMessages.empty()) {
-            notification << "- An unexpected error occurred during order processing.\n";
+            values[ISSUES] = "- An unexpected error occurred during order processing.\n";
         } else {
             for (size_t i = 0; i < errorMessages.size(); i++) {
-                notification << (i+1) << ". " << errorMessages[i] << "\n";
+                values[ISSUES] += std::to_string(i + 1) + ". " + errorMessages[i] + "\n";
             }
         }
         
-        notification << "\nWHAT YOU CAN DO:\n";
-        notification << "- Modify your order and try again\n";
-        notification << "- Contact our staff for assistance\n";
-        notification << "- Check our website for updated availability\n\n";
-        
-        notification << "If you need immediate assistance, please contact us:\n";
-        notification << "Phone: (555) 123-4567\n";
-        notification << "Email: support@greengarden.com\n\n";
-        
-        notification << "We apologize for any inconvenience.\n\n";
-        notification << "Best regards,\n";
-        notification << "The Green Garden Team";
+        logStep("Queueing failure notification email to: " + customer->getEmail());
+        queueMessage("EMAIL", customer->getEmail(), "EMAIL NOTIFICATION - ORDER ISSUE",
+                     failureEmail().render(values), order);
         
-        return notification.str();
-    }
-    
-    std::string generateOrderConfirmation(Order* order, Customer* customer) {
-        std::ostringstream confirmation;
-        
-        confirmation << "Dear " << customer->getName() << ",\n\n";
-        confirmation << "Thank you for your order at Green Garden Nursery!\n\n";
-        confirmation << "ORDER DETAILS:\n";
-        confirmation << "Order ID: " << order->getOrderId() << "\n";
-        confirmation << "Customer: " << customer->getName() << "\n";
-        confirmation << "Email: " << customer->getEmail() << "\n";
-        confirmation << "Order Date: " << order->getOrderDate() << "\n\n";
-        
-        confirmation << "ITEMS ORDERED:\n";
-        confirmation << order->getOrderSummary() << "\n";
-        
-        confirmation << "TOTAL AMOUNT: R" << std::fixed << std::setprecision(2) 
-                    << order->getTotalAmount() << "\n\n";
+        if (!customer->getCellPhone().empty()) {
+            logStep("Queueing SMS notification to: " + customer->getCellPhone());
+            queueMessage("SMS", customer->getCellPhone(), "", failureSms().render(values), order);
+        }
         
-        confirmation << "Your plants are ready for pickup or will be prepared for delivery.\n";
-        confirmation << "Thank you for choosing Green Garden Nursery!\n\n";
-        confirmation << "Best regards,\n";
-        confirmation << "The Green Garden Team";
+        // Update order status
+        order->setStatus("Failed - Customer Notified");
+        OrderStore::getInstance().append(*order);
+        logStep("Failure notification queued for customer");
         
-        return confirmation.str();
+        return true; // Notification sent successfully even though order failed
     }
 };
 
@@ -0,0 +1,366 @@
+#include "NotificationOutbox.h"
+#include "AtomicFile.h"
+#include "BinaryCodec.h"
+#include "IdGenerator.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace
+{
+    const char OUTBOX_MAGIC[8] = {'G', 'H', 'O', 'U', 'T', 'B', 'O', 'X'};
+    const std::size_t HEADER_SIZE = sizeof(OUTBOX_MAGIC) + 2 * sizeof(std::uint32_t);
+    const long RETRY_BASE_MILLIS = 200;
+    const long RETRY_MAX_MILLIS = 30000;
+
+    void writeHeader(std::string &out)
+    {
+        BinaryWriter writer(out);
+        writer.writeBytes(OUTBOX_MAGIC, sizeof(OUTBOX_MAGIC));
+        writer.writeU32(NotificationOutbox::FORMAT_VERSION);
+        writer.writeU32(BINARY_ENDIAN_MARKER);
+    }
+
+    // Only ENQUEUED records carry the message itself; the others just name it
+    void writeRecord(std::string &out, std::uint8_t kind, const OutboxMessage &message, bool includeMessage)
+    {
+        std::string payload;
+        BinaryWriter writer(payload);
+        writer.writeU8(kind);
+        writer.writeU64(message.id);
+        if (includeMessage)
+        {
+            writer.writeString(message.channel);
+            writer.writeString(message.recipient);
+            writer.writeString(message.subject);
+            writer.writeString(message.body);
+            writer.writeString(message.orderId);
+        }
+        BinaryWriter recordWriter(out);
+        recordWriter.writeU32(static_cast<std::uint32_t>(payload.size()));
+        recordWriter.writeU32(computeCrc32(payload.data(), payload.size()));
+        recordWriter.writeBytes(payload.data(), payload.size());
+    }
+}
+
+NotificationOutbox::NotificationOutbox() : recordsSinceCompaction(0), delivering(0), stopping(false)
+{
+}
+
+NotificationOutbox::~NotificationOutbox()
+{
+    close();
+}
+
+NotificationOutbox &NotificationOutbox::getInstance()
+{
+    static NotificationOutbox instance;
+    return instance;
+}
+
+bool NotificationOutbox::printToConsole(const OutboxMessage &message)
+{
+    // One write per message so concurrent output does not interleave mid-message
+    std::string text;
+    if (message.channel == "SMS")
+    {
+        text = "\n[SMS]: " + message.body + "\n";
+    }
+    else
+    {
+        std::string rule(50, '=');
+        text = "\n" + rule + "\n[" + message.subject + "]\n" + rule + "\n" + message.body + "\n" + rule + "\n";
+    }
+    std::cout << text << std::flush;
+    return true;
+}
+
+bool NotificationOutbox::open(const std::string &logPath)
+{
+    std::lock_guard<std::mutex> lifecycle(lifecycleMutex);
+    stopWorker();
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = false;
+    if (appendStream.is_open())
+    {
+        appendStream.close();
+    }
+
+    // Messages queued before the log was opened are kept and persisted along with the replayed ones
+    std::map<std::uint64_t, OutboxMessage> pending;
+    for (const OutboxMessage &message : ready)
+    {
+        pending[message.id] = message;
+    }
+    for (std::multimap<Clock::time_point, OutboxMessage>::const_iterator it = delayed.begin(); it != delayed.end(); ++it)
+    {
+        pending[it->second.id] = it->second;
+    }
+
+    std::size_t replayed = 0;
+    {
+        MappedFile mapping;
+        if (mapping.open(logPath) && mapping.getSize() > 0)
+        {
+            std::uint32_t version = 0, endian = 0;
+            BinaryReader header(mapping.getData(), mapping.getSize());
+            if (mapping.getSize() < HEADER_SIZE ||
+                std::memcmp(mapping.getData(), OUTBOX_MAGIC, sizeof(OUTBOX_MAGIC)) != 0 ||
+                !header.skip(sizeof(OUTBOX_MAGIC)) || !header.readU32(version) || !header.readU32(endian) ||
+                version != FORMAT_VERSION || endian != BINARY_ENDIAN_MARKER)
+            {
+                std::cout << "[OUTBOX] " << logPath << " is not a version " << FORMAT_VERSION << " outbox log."
+                          << std::endl;
+                startWorkerLocked();
+                return false;
+            }
+
+            // Replay up to the first record that does not check out; a torn tail is dropped by the rewrite
+            BinaryReader reader(mapping.getData() + HEADER_SIZE, mapping.getSize() - HEADER_SIZE);
+            for (;;)
+            {
+                std::uint32_t length = 0, crc = 0;
+                if (!reader.readU32(length) || !reader.readU32(crc) || reader.remaining() < length ||
+                    computeCrc32(reader.position(), length) != crc)
+                {
+                    break;
+                }
+                BinaryReader record(reader.position(), length);
+                reader.skip(length);
+                std::uint8_t kind = 0;
+                OutboxMessage message;
+                if (!record.readU8(kind) || !record.readU64(message.id))
+                {
+                    break;
+                }
+                if (kind == ENQUEUED)
+                {
+                    if (!record.readString(message.channel) || !record.readString(message.recipient) ||
+                        !record.readString(message.subject) || !record.readString(message.body) ||
+                        !record.readString(message.orderId))
+                    {
+                        break;
+                    }
+                    pending[message.id] = message;
+                }
+                else
+                {
+                    pending.erase(message.id);
+                }
+            }
+            replayed = pending.size() - std::min(pending.size(), ready.size() + delayed.size());
+        }
+    }
+
+    path = logPath;
+    if (!writeLogLocked(pending))
+    {
+        std::cout << "[OUTBOX] Cannot write outbox log at " << logPath << "." << std::endl;
+        path.clear();
+        startWorkerLocked();
+        return false;
+    }
+
+    ready.clear();
+    delayed.clear();
+    for (std::map<std::uint64_t, OutboxMessage>::const_iterator it = pending.begin(); it != pending.end(); ++it)
+    {
+        ready.push_back(it->second);
+    }
+    stats.replayed += replayed;
+    std::cout << "[OUTBOX] Opened " << path << " with " << replayed << " undelivered messages." << std::endl;
+    startWorkerLocked();
+    wake.notify_one();
+    return true;
+}
+
+void NotificationOutbox::close()
+{
+    std::lock_guard<std::mutex> lifecycle(lifecycleMutex);
+    stopWorker();
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = false; // the next enqueue() starts a new worker
+    if (appendStream.is_open())
+    {
+        appendStream.close();
+    }
+    appendStream.clear();
+    path.clear();
+    ready.clear();
+    delayed.clear();
+}
+
+// Rewrites the log so it holds only the given messages, beside the old one and moved into place
+bool NotificationOutbox::writeLogLocked(const std::map<std::uint64_t, OutboxMessage> &pending)
+{
+    if (appendStream.is_open())
+    {
+        appendStream.close();
+    }
+    appendStream.clear();
+
+    std::string content;
+    writeHeader(content);
+    for (std::map<std::uint64_t, OutboxMessage>::const_iterator it = pending.begin(); it != pending.end(); ++it)
+    {
+        writeRecord(content, ENQUEUED, it->second, true);
+    }
+
+    if (!writeFileAtomically(path, content))
+    {
+        return false;
+    }
+    appendStream.open(path.c_str(), std::ios::binary | std::ios::app);
+    recordsSinceCompaction = pending.size();
+    return static_cast<bool>(appendStream);
+}
+
+void NotificationOutbox::appendRecordLocked(RecordKind kind, const OutboxMessage &message)
+{
+    if (!appendStream.is_open())
+    {
+        return;
+    }
+    std::string record;
+    writeRecord(record, static_cast<std::uint8_t>(kind), message, kind == ENQUEUED);
+    appendStream.write(record.data(), static_cast<std::streamsize>(record.size()));
+    appendStream.flush();
+    ++recordsSinceCompaction;
+}
+
+std::uint64_t NotificationOutbox::enqueue(const OutboxMessage &message)
+{
+    OutboxMessage queued = message;
+    queued.id = IdGenerator::getInstance().next();
+    queued.attempts = 0;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    appendRecordLocked(ENQUEUED, queued);
+    ready.push_back(queued);
+    ++stats.enqueued;
+    startWorkerLocked();
+    wake.notify_one();
+    return queued.id;
+}
+
+void NotificationOutbox::setDeliverer(const Deliverer &newDeliverer)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    deliverer = newDeliverer;
+}
+
+bool NotificationOutbox::isIdleLocked() const
+{
+    return ready.empty() && delayed.empty() && delivering == 0;
+}
+
+bool NotificationOutbox::waitUntilIdle(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    return idle.wait_for(lock, timeout, [this]() { return isIdleLocked(); });
+}
+
+std::size_t NotificationOutbox::getPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return ready.size() + delayed.size() + delivering;
+}
+
+NotificationOutbox::Stats NotificationOutbox::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void NotificationOutbox::startWorkerLocked()
+{
+    if (!worker.joinable() && !stopping)
+    {
+        worker = std::thread(&NotificationOutbox::run, this);
+    }
+}
+
+// Called with lifecycleMutex held. The thread is moved out under the lock and joined without it, so
+// enqueue() never touches a thread object that is being joined; stopping stays set until the caller resets it
+void NotificationOutbox::stopWorker()
+{
+    std::thread finishing;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        finishing = std::move(worker);
+    }
+    wake.notify_all();
+    if (finishing.joinable())
+    {
+        finishing.join();
+    }
+}
+
+void NotificationOutbox::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping)
+    {
+        Clock::time_point now = Clock::now();
+        while (!delayed.empty() && delayed.begin()->first <= now)
+        {
+            ready.push_back(delayed.begin()->second);
+            delayed.erase(delayed.begin());
+        }
+        if (ready.empty())
+        {
+            if (delayed.empty())
+            {
+                wake.wait(lock);
+            }
+            else
+            {
+                Clock::time_point due = delayed.begin()->first;
+                wake.wait_until(lock, due);
+            }
+            continue;
+        }
+
+        OutboxMessage message = ready.front();
+        ready.pop_front();
+        ++delivering;
+        Deliverer deliver = deliverer;
+        lock.unlock();
+        bool delivered = deliver ? deliver(message) : printToConsole(message);
+        lock.lock();
+        --delivering;
+
+        if (delivered)
+        {
+            ++stats.delivered;
+            appendRecordLocked(DELIVERED, message);
+        }
+        else if (++message.attempts >= MAX_ATTEMPTS)
+        {
+            ++stats.abandoned;
+            appendRecordLocked(ABANDONED, message);
+            std::cout << "[OUTBOX] Giving up on " << message.channel << " to " << message.recipient << " after "
+                      << message.attempts << " attempts." << std::endl;
+        }
+        else
+        {
+            ++stats.retries;
+            long delay = std::min(RETRY_MAX_MILLIS, RETRY_BASE_MILLIS << std::min(message.attempts - 1, 16));
+            delayed.insert(std::make_pair(Clock::now() + std::chrono::milliseconds(delay), message));
+        }
+
+        if (isIdleLocked())
+        {
+            if (recordsSinceCompaction >= COMPACT_RECORDS && appendStream.is_open())
+            {
+                writeLogLocked(std::map<std::uint64_t, OutboxMessage>());
+            }
+            idle.notify_all();
+        }
+    }
+}
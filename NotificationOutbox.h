@@ -0,0 +1,142 @@
+#ifndef NOTIFICATION_OUTBOX_H
+#define NOTIFICATION_OUTBOX_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @brief One customer message waiting in the NotificationOutbox
+ */
+struct OutboxMessage
+{
+    std::uint64_t id; // assigned by enqueue()
+    std::string channel; // "EMAIL" or "SMS"
+    std::string recipient;
+    std::string subject;
+    std::string body;
+    std::string orderId;
+    int attempts;
+
+    OutboxMessage() : id(0), attempts(0) {}
+};
+
+/**
+ * @class NotificationOutbox
+ * @brief Durable queue of customer notifications, delivered by a background worker
+ *
+ * Checkout only enqueues its email and SMS messages; a worker thread hands
+ * them to the deliverer (printing to the console by default) so the order
+ * never waits on messaging. A delivery that fails is retried with growing
+ * delays, up to MAX_ATTEMPTS.
+ *
+ * Once open() has been given a log file, every message is written to it
+ * when enqueued and marked when delivered or abandoned. Messages still
+ * undelivered when the process stops are delivered after the next open().
+ * Without a log the outbox still works, but only in memory.
+ *
+ * Log layout (version 1, host byte order), CRC-checked like the OrderStore:
+ * @code
+ * header : "GHOUTBOX" | u32 version | u32 endian marker
+ * record : u32 payload bytes | u32 CRC-32 of payload | payload
+ * payload: u8 kind | u64 id | (ENQUEUED only) channel | recipient | subject | body | orderId
+ * @endcode
+ * open() rewrites the log to hold only undelivered messages, and the log is
+ * truncated again whenever the outbox drains after COMPACT_RECORDS records.
+ */
+class NotificationOutbox
+{
+public:
+    typedef std::function<bool(const OutboxMessage &)> Deliverer;
+
+    struct Stats
+    {
+        std::uint64_t enqueued;
+        std::uint64_t delivered;
+        std::uint64_t retries;
+        std::uint64_t abandoned;
+        std::uint64_t replayed; // undelivered messages picked up from the log by open()
+
+        Stats() : enqueued(0), delivered(0), retries(0), abandoned(0), replayed(0) {}
+    };
+
+    static const unsigned int FORMAT_VERSION = 1;
+    static const int MAX_ATTEMPTS = 5;
+    static const std::size_t COMPACT_RECORDS = 1024;
+
+    NotificationOutbox(const NotificationOutbox &) = delete;
+    NotificationOutbox &operator=(const NotificationOutbox &) = delete;
+
+    static NotificationOutbox &getInstance();
+
+    /**
+     * @brief Opens (or creates) the outbox log and queues the messages it still holds
+     * @return false if the file cannot be created or is not an outbox log
+     */
+    bool open(const std::string &path);
+
+    /** @brief Stops the worker; undelivered messages stay in the log for the next open() */
+    void close();
+
+    /** @brief Queues a message for delivery and returns its ID; never waits on delivery */
+    std::uint64_t enqueue(const OutboxMessage &message);
+
+    /** @brief Replaces the default console deliverer; return false from it to have the message retried */
+    void setDeliverer(const Deliverer &deliverer);
+
+    /** @brief Waits until every queued message has been delivered or abandoned */
+    bool waitUntilIdle(std::chrono::milliseconds timeout);
+
+    std::size_t getPendingCount() const;
+    Stats getStats() const;
+
+    /** @brief The default deliverer: prints the message as the handlers used to */
+    static bool printToConsole(const OutboxMessage &message);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    enum RecordKind
+    {
+        ENQUEUED = 1,
+        DELIVERED = 2,
+        ABANDONED = 3
+    };
+
+    std::string path;
+    std::ofstream appendStream;
+    std::size_t recordsSinceCompaction;
+
+    std::deque<OutboxMessage> ready;
+    std::multimap<Clock::time_point, OutboxMessage> delayed; // waiting to be retried
+    std::size_t delivering;
+    Deliverer deliverer;
+    Stats stats;
+
+    std::mutex lifecycleMutex; // serialises open() and close(): stopping the worker, then restarting it
+    mutable std::mutex mutex;  // everything else, including the worker thread object; taken after lifecycleMutex
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::thread worker;
+    bool stopping; // the worker is being joined; enqueue() does not start another until open() or close() is done
+
+    NotificationOutbox();
+    ~NotificationOutbox();
+
+    void startWorkerLocked();
+    void stopWorker();
+    void appendRecordLocked(RecordKind kind, const OutboxMessage &message);
+    bool writeLogLocked(const std::map<std::uint64_t, OutboxMessage> &pending);
+    bool isIdleLocked() const;
+    void run();
+};
+
+#endif // NOTIFICATION_OUTBOX_H
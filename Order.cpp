@@ -1,56 +1,118 @@
 #include "Order.h"
+#include "CartDemandTracker.h"
 #include "OrderMemento.h"
+#include "OrderMementoCodec.h"
+#include "OrderRegistry.h"
+#include "Timestamp.h"
 #include <sstream>
 #include <iomanip>
-#include <ctime>
 #include <algorithm>
+#include <iostream>
 
 #include "OrderItem.h"
-#include "SinglePlant.h"
-#include "PlantBundle.h"
-
-// Definition of static member
-std::vector<Order*> Order::allOrders;
 
 Order::Order(const std::string& orderId, const std::string& customerName)
-    : orderId(orderId), customerName(customerName), totalAmount(0.0), status("Pending") {
-    // Generate timestamp
-    time_t now = time(0);
-    char buf[80];
-    strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", localtime(&now));
-    orderDate = std::string(buf);
-    allOrders.push_back(this);
+    : orderId(orderId), customerName(customerName), totalAmount(0.0), itemsTotal(0.0), status("Pending"), flattenedCurrent(false), reservationId(0), traceId(0), demandTracker(nullptr) {
+    orderDate = currentTimestamp();
+    OrderRegistry::getInstance().registerOrder(this);
 }
 
 Order::~Order() {
-    // Delete all order items
+    stopTrackingDemand();
+
+    // Item destructors still run; their arena memory goes with itemArena
+    destroyItems();
+
+    OrderRegistry::getInstance().unregisterOrder(this);
+}
+
+// Destroys every item and releases the arena in one step
+void Order::destroyItems() {
     for (auto* item : orderItems) {
         delete item;
     }
     orderItems.clear();
+    itemArena.reset();
+    itemContentsChanged();
+    if (demandTracker) {
+        demandTracker->clear();
+    }
+}
 
-    auto it = std::find(allOrders.begin(), allOrders.end(), this);
-    if (it != allOrders.end()) allOrders.erase(it);
+OrderItemArena& Order::getItemArena() {
+    return itemArena;
 }
 
 void Order::addOrderItem(OrderItem* item) {
     if (item) {
         orderItems.push_back(item);
-        calculateTotalAmount();
+        item->setOwner(this);
+        itemSubtotalChanged(item->getPrice());
+        itemContentsChanged(item);
     }
 }
 
 void Order::removeOrderItem(OrderItem* item) {
     for (auto it = orderItems.begin(); it != orderItems.end(); ++it) {
         if (*it == item) {
+            double removed = item->getPrice();
+            if (demandTracker) {
+                demandTracker->removeItem(item);
+            }
             delete *it;
             orderItems.erase(it);
-            calculateTotalAmount();
+            itemSubtotalChanged(-removed);
+            itemContentsChanged();
             break;
         }
     }
 }
 
+// Called by top-level items (directly or via their bundles) whenever a subtotal moves
+void Order::itemSubtotalChanged(double delta) {
+    itemsTotal += delta;
+    if (orderItems.empty()) {
+        itemsTotal = 0.0; // drop any accumulated rounding once the order is empty
+    }
+    totalAmount = itemsTotal;
+}
+
+const FlattenedOrder& Order::getFlattened() const {
+    if (!flattenedCurrent) {
+        flattened.build(orderItems);
+        flattenedCurrent = true;
+    }
+    return flattened;
+}
+
+// Called by items (directly or via their bundles) whenever the tree's shape or contents change
+// topLevelItem is the order's own item that holds whatever changed, if known
+void Order::itemContentsChanged(const OrderItem* topLevelItem) {
+    flattenedCurrent = false;
+    if (demandTracker && topLevelItem) {
+        demandTracker->updateItem(topLevelItem);
+    }
+}
+
+CartDemandTracker* Order::trackDemand() {
+    if (!demandTracker) {
+        demandTracker = new CartDemandTracker();
+        for (auto* item : orderItems) {
+            demandTracker->updateItem(item);
+        }
+    }
+    return demandTracker;
+}
+
+void Order::stopTrackingDemand() {
+    delete demandTracker;
+    demandTracker = nullptr;
+}
+
+CartDemandTracker* Order::getDemandTracker() const {
+    return demandTracker;
+}
+
 std::vector<OrderItem*> Order::getOrderItems() const {
     return orderItems;
 }
@@ -79,11 +141,25 @@ void Order::setStatus(const std::string& newStatus) {
     status = newStatus;
 }
 
+std::uint64_t Order::getReservationId() const {
+    return reservationId;
+}
+
+void Order::setReservationId(std::uint64_t id) {
+    reservationId = id;
+}
+
+std::uint64_t Order::getTraceId() const {
+    return traceId;
+}
+
+void Order::setTraceId(std::uint64_t id) {
+    traceId = id;
+}
+
 double Order::calculateTotalAmount() {
-    totalAmount = 0.0;
-    for (const auto* item : orderItems) {
-        totalAmount += item->getPrice();
-    }
+    // Item subtotals are pushed up on every edit, so no walk is needed here
+    totalAmount = itemsTotal;
     return totalAmount;
 }
 
@@ -146,10 +222,8 @@ std::string Order::getOrderSummary() const {
 }
 
 void Order::clearOrder() {
-    for (auto* item : orderItems) {
-        delete item;
-    }
-    orderItems.clear();
+    destroyItems();
+    itemsTotal = 0.0;
     totalAmount = 0.0;
     status = "Pending";
 }
@@ -195,36 +269,39 @@ const std::vector<std::string>& Order::getItems() const
 //     return items;
 // }
 
+void Order::appendOrderDetails(std::ostream& details) const {
+    details << "Order ID: " << orderId << "\n";
+    details << "Customer Name: " << customerName << "\n";
+    details << "Items:\n";
+    for (const auto& item : items) details << "- " << item << "\n";
+    details << "Total Amount: R" << totalAmount << "\n";
+}
+
 std::string Order::getOrderDetails(const std::string& customerFilter) const {
     std::stringstream details;
 
     if (customerFilter.empty()) {
-        details << "Order ID: " << orderId << "\n";
-        details << "Customer Name: " << customerName << "\n";
-        details << "Items:\n";
-        for (const auto& item : items) details << "- " << item << "\n";
-        details << "Total Amount: R" << totalAmount << "\n";
+        appendOrderDetails(details);
         return details.str();
     }
 
+    // Every order is written straight into one stream rather than built as its own string
     if (customerFilter == "ALL") {
         details << "All orders for all customers:\n";
-        for (auto order : allOrders) {
+        OrderRegistry::getInstance().forEachOrder([&details](const Order* order) {
             details << "----------------------\n";
-            details << order->getOrderDetails("");
-        }
+            order->appendOrderDetails(details);
+        });
         return details.str();
     }
 
     details << "All orders for " << customerFilter << ":\n";
     bool found = false;
-    for (auto order : allOrders) {
-        if (order->getCustomerName() == customerFilter) {
-            found = true;
-            details << "----------------------\n";
-            details << order->getOrderDetails("");
-        }
-    }
+    OrderRegistry::getInstance().forEachOrderOf(customerFilter, [&details, &found](const Order* order) {
+        found = true;
+        details << "----------------------\n";
+        order->appendOrderDetails(details);
+    });
 
     if (!found) {
         details << "(no orders found for " << customerFilter << ")\n";
@@ -233,142 +310,18 @@ std::string Order::getOrderDetails(const std::string& customerFilter) const {
     return details.str();
 }
 
-OrderMemento* Order::createMemento() const {
-    std::stringstream state;
-    
-    // Save order metadata
-    state << orderId << "\n";
-    state << customerName << "\n";
-    state << orderDate << "\n";
-    state << status << "\n";
-    state << totalAmount << "\n";
-    
-    // Save number of order items
-    state << orderItems.size() << "\n";
-    
-    // Save each order item's description and details
-    for (const auto* item : orderItems) {
-        // Check if it's a SinglePlant or PlantBundle
-        if (const SinglePlant* plant = dynamic_cast<const SinglePlant*>(item)) {
-            state << "PLANT|" << plant->getPlantType() << "|" 
-                  << plant->getQuantity() << "|" << plant->getPrice() / plant->getQuantity() 
-                  << "|" << plant->getSize() << "\n";
-        } else if (const PlantBundle* bundle = dynamic_cast<const PlantBundle*>(item)) {
-            state << "BUNDLE|" << bundle->getName() << "|" 
-                  << bundle->getQuantity() << "|" << bundle->getDiscount() 
-                  << "|" << bundle->getItemCount() << "\n";
-            
-            // Save bundle items
-            for (const auto* bundleItem : bundle->getItems()) {
-                if (const SinglePlant* bplant = dynamic_cast<const SinglePlant*>(bundleItem)) {
-                    state << "  BPLANT|" << bplant->getPlantType() << "|" 
-                          << bplant->getQuantity() << "|" << bplant->getPrice() / bplant->getQuantity() 
-                          << "|" << bplant->getSize() << "\n";
-                }
-            }
-        }
-    }
-    
-    return new OrderMemento(state.str());
+OrderMemento* Order::createMemento(const OrderMemento* basis) const {
+    return new OrderMemento(OrderMementoCodec::encode(*this, basis));
 }
 
 void Order::restoreState(const OrderMemento* memento) {
     if (!memento) return;
 
-    std::string s = memento->getState();
-    std::stringstream state(s);
-    
-    // Restore order metadata
-    std::getline(state, orderId);
-    std::getline(state, customerName);
-    std::getline(state, orderDate);
-    std::getline(state, status);
-    state >> totalAmount;
-    state.ignore(); // eat newline after totalAmount
-    
-    // Clear existing order items
-    for (auto* item : orderItems) {
-        delete item;
-    }
-    orderItems.clear();
-    
-    // Restore number of items
-    size_t numItems;
-    state >> numItems;
-    state.ignore(); // eat newline
-    
-    // Restore each order item
-    for (size_t i = 0; i < numItems; i++) {
-        std::string line;
-        std::getline(state, line);
-        
-        std::stringstream lineStream(line);
-        std::string itemType;
-        std::getline(lineStream, itemType, '|');
-        
-        if (itemType == "PLANT") {
-            std::string plantType, size;
-            int quantity;
-            double price;
-            
-            std::getline(lineStream, plantType, '|');
-            lineStream >> quantity;
-            lineStream.ignore(); // skip '|'
-            lineStream >> price;
-            lineStream.ignore(); // skip '|'
-            std::getline(lineStream, size);
-            
-            SinglePlant* plant = new SinglePlant(plantType, price, quantity, size);
-            orderItems.push_back(plant);
-            
-        } else if (itemType == "BUNDLE") {
-            std::string bundleName;
-            int quantity, itemCount;
-            double discount;
-            
-            std::getline(lineStream, bundleName, '|');
-            lineStream >> quantity;
-            lineStream.ignore(); // skip '|'
-            lineStream >> discount;
-            lineStream.ignore(); // skip '|'
-            lineStream >> itemCount;
-            
-            PlantBundle* bundle = new PlantBundle(bundleName, "Mixed", quantity, discount);
-            
-            // Restore bundle items
-            for (int j = 0; j < itemCount; j++) {
-                std::string bline;
-                std::getline(state, bline);
-                
-                std::stringstream blineStream(bline);
-                std::string bitemType;
-                std::getline(blineStream, bitemType, '|');
-                
-                if (bitemType == "  BPLANT") {
-                    std::string bplantType, bsize;
-                    int bquantity;
-                    double bprice;
-                    
-                    std::getline(blineStream, bplantType, '|');
-                    blineStream >> bquantity;
-                    blineStream.ignore();
-                    blineStream >> bprice;
-                    blineStream.ignore();
-                    std::getline(blineStream, bsize);
-                    
-                    SinglePlant* bplant = new SinglePlant(bplantType, bprice, bquantity, bsize);
-                    bundle->addItem(bplant);
-                }
-            }
-            
-            orderItems.push_back(bundle);
-        }
+    if (!OrderMementoCodec::decode(memento->getState(), *this)) {
+        std::cout << "[MEMENTO] Order memento is malformed or from an unsupported version - order left unchanged." << std::endl;
     }
-    
-    // Recalculate total
-    calculateTotalAmount();
 }
-const std::vector<Order*>& Order::getAllOrders()
+std::vector<Order*> Order::getAllOrders()
 {
-    return allOrders;
+    return OrderRegistry::getInstance().getAllOrders();
 }
\ No newline at end of file
@@ -1,26 +1,41 @@
 #ifndef ORDER_H
 #define ORDER_H
 
+#include <cstdint>
+#include <ostream>
 #include <string>
 #include <vector>
+#include "FlattenedOrder.h"
 #include "OrderItem.h"
+#include "OrderItemArena.h"
 
 class OrderMemento;
+class CartDemandTracker;
 
 /**
  * @brief Order class that contains order items and manages the order
  */
 class Order {
+    friend class OrderMementoCodec;
+
 private:
     std::string orderId;
     std::vector<OrderItem*> orderItems;
     std::string customerName;
     std::string orderDate;
     double totalAmount;
+    double itemsTotal; // sum of top-level OrderItem subtotals
     std::string status;
     std::vector<std::string> items;
+    OrderItemArena itemArena; // backs the order's item tree; released with the order
+    mutable FlattenedOrder flattened;
+    mutable bool flattenedCurrent; // cleared by itemContentsChanged()
+    std::uint64_t reservationId; // stock held by InventoryManager::reserveOrder, 0 if none
+    std::uint64_t traceId; // ties together the handler timings of one checkout, 0 until the first handler runs
+    CartDemandTracker* demandTracker; // live stock check while the order is a cart; owned, null unless tracked
 
-    static std::vector<Order*> allOrders;
+    void destroyItems();
+    void appendOrderDetails(std::ostream& out) const;
 
 public:
     Order(const std::string& orderId, const std::string& customerName);
@@ -30,6 +45,16 @@ public:
     void addOrderItem(OrderItem* item);
     void removeOrderItem(OrderItem* item);
     std::vector<OrderItem*> getOrderItems() const;
+    OrderItemArena& getItemArena();
+
+    // Typed single-pass view of the item tree and its plant/pot demand, rebuilt only after items change
+    const FlattenedOrder& getFlattened() const;
+    void itemContentsChanged(const OrderItem* topLevelItem = nullptr);
+
+    // Live stock check of the order's demand, kept current item by item (see CartDemandTracker)
+    CartDemandTracker* trackDemand();
+    void stopTrackingDemand();
+    CartDemandTracker* getDemandTracker() const;
     
     // Getters and setters
     std::string getOrderId() const;
@@ -38,10 +63,15 @@ public:
     void setOrderDate(const std::string& date);
     std::string getStatus() const;
     void setStatus(const std::string& status);
+    std::uint64_t getReservationId() const;
+    void setReservationId(std::uint64_t reservationId);
+    std::uint64_t getTraceId() const;
+    void setTraceId(std::uint64_t traceId);
     
-    // Price calculation
+    // Price calculation - the total is cached and kept current as items change
     double calculateTotalAmount();
     double getTotalAmount() const;
+    void itemSubtotalChanged(double delta);
     
     // Order operations
     std::string getOrderSummary() const;
@@ -51,15 +81,15 @@ public:
     // Check if order is empty
     bool isEmpty() const;
 
-    // Memento pattern methods
-    OrderMemento* createMemento() const;
+    // Memento pattern methods (state is encoded by OrderMementoCodec)
+    OrderMemento* createMemento(const OrderMemento* basis = nullptr) const; // basis: earlier snapshot to share unchanged state with
     void addItem(const std::string& item, double price);
     void removeItem(const std::string& item);
     void clearItems();
     const std::vector<std::string>& getItems() const;
     std::string getOrderDetails(const std::string& customerFilter = "") const;
     void restoreState(const OrderMemento* memento);
-    static const std::vector<Order*>& getAllOrders();
+    static std::vector<Order*> getAllOrders(); // see OrderRegistry for indexed lookups
 
 };
 
@@ -3,6 +3,7 @@
 #include "Order.h"
 
 #include <stdexcept>
+#include <unordered_set>
 
 OrderHistory::OrderHistory()
 {}
@@ -51,7 +52,7 @@ void OrderHistory::saveOrder(Order* order)
     {
         return;
     }
-    OrderMemento* m = order->createMemento();
+    OrderMemento* m = order->createMemento(history.empty() ? nullptr : history.back());
     addMemento(m);
 }
 
@@ -64,3 +65,20 @@ void OrderHistory::undo(Order* order)
     order->restoreState(m);
     removeMemento(history.size() - 1);
 }
+
+std::size_t OrderHistory::getRetainedBytes() const
+{
+    std::unordered_set<const std::string*> seen;
+    std::size_t bytes = 0;
+    for (const OrderMemento* m : history)
+    {
+        for (const OrderMemento::Chunk& chunk : m->getChunks())
+        {
+            if (seen.insert(chunk.get()).second)
+            {
+                bytes += chunk->size();
+            }
+        }
+    }
+    return bytes;
+}
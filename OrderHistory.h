@@ -17,8 +17,9 @@ public:
     void addMemento(OrderMemento* memento);
     void removeMemento(std::size_t index);
     OrderMemento* getMemento(std::size_t index) const;
-    void saveOrder(Order* order);
+    void saveOrder(Order* order); // shares unchanged state with the previous snapshot
     void undo(Order* order);
+    std::size_t getRetainedBytes() const; // state memory held by the history, shared chunks counted once
 };
 
 #endif // ORDERHISTORY_H
@@ -1,8 +1,22 @@
 #include "OrderItem.h"
+#include "Order.h"
+#include "OrderItemArena.h"
+#include <new>
 #include <stdexcept>
 
+namespace {
+    // Every item is preceded by a header naming the arena that owns it (nullptr for the heap),
+    // padded so the item itself keeps the arena's alignment
+    const std::size_t ALLOCATION_HEADER = OrderItemArena::ALIGNMENT;
+
+    void* placeItem(void* memory, OrderItemArena* arena) {
+        *static_cast<OrderItemArena**>(memory) = arena;
+        return static_cast<char*>(memory) + ALLOCATION_HEADER;
+    }
+}
+
 OrderItem::OrderItem(const std::string& name, double price, int quantity)
-    : name(name), price(price), quantity(quantity) {}
+    : name(name), price(price), quantity(quantity), parent(nullptr), owner(nullptr) {}
 
 OrderItem::~OrderItem() {}
 
@@ -16,7 +30,10 @@ int OrderItem::getQuantity() const {
 
 void OrderItem::setQuantity(int newQuantity) {
     if (newQuantity > 0) {
+        double oldSubtotal = getPrice();
         quantity = newQuantity;
+        notifySubtotalChanged(oldSubtotal);
+        notifyContentsChanged();
     }
 }
 
@@ -35,3 +52,71 @@ std::vector<OrderItem*> OrderItem::getItems() const {
     // Leaf nodes return empty vector
     return std::vector<OrderItem*>();
 }
+
+void OrderItem::childSubtotalChanged(double delta) {
+    // Leaf nodes have no children
+    (void)delta;
+}
+
+// Only the path from this node to the order is touched, so an edit costs O(depth)
+void OrderItem::notifySubtotalChanged(double oldSubtotal) {
+    double delta = getPrice() - oldSubtotal;
+    if (delta == 0.0) {
+        return;
+    }
+    if (parent) {
+        parent->childSubtotalChanged(delta);
+    } else if (owner) {
+        owner->itemSubtotalChanged(delta);
+    }
+}
+
+// Unlike subtotals nothing is cached per bundle, so only the order needs to hear about it
+void OrderItem::notifyContentsChanged() {
+    const OrderItem* node = this;
+    while (node->parent) {
+        node = node->parent;
+    }
+    if (node->owner) {
+        node->owner->itemContentsChanged(node);
+    }
+}
+
+void OrderItem::setParent(OrderItem* newParent) {
+    parent = newParent;
+    owner = nullptr;
+}
+
+void OrderItem::setOwner(Order* newOwner) {
+    owner = newOwner;
+    parent = nullptr;
+}
+
+OrderItem* OrderItem::getParent() const {
+    return parent;
+}
+
+void* OrderItem::operator new(std::size_t size) {
+    return placeItem(::operator new(size + ALLOCATION_HEADER), nullptr);
+}
+
+void* OrderItem::operator new(std::size_t size, OrderItemArena& arena) {
+    return placeItem(arena.allocate(size + ALLOCATION_HEADER), &arena);
+}
+
+// Arena memory is only reclaimed when the arena is reset or destroyed
+void OrderItem::operator delete(void* memory) {
+    if (!memory) {
+        return;
+    }
+    char* base = static_cast<char*>(memory) - ALLOCATION_HEADER;
+    if (*reinterpret_cast<OrderItemArena**>(base) == nullptr) {
+        ::operator delete(base);
+    }
+}
+
+// Only called if a constructor throws during `new (arena)`
+void OrderItem::operator delete(void* memory, OrderItemArena& arena) {
+    (void)memory;
+    (void)arena;
+}
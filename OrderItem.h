@@ -1,9 +1,14 @@
 #ifndef ORDERITEM_H
 #define ORDERITEM_H
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
+class Order;
+class OrderItemArena;
+class OrderItemVisitor;
+
 /**
  * @brief Abstract base class for order items (Composite pattern)
  * This is the Component in the Composite pattern
@@ -14,6 +19,15 @@ protected:
     double price;
     int quantity;
 
+    // Where subtotal changes are reported: the enclosing bundle, or the order for top-level items
+    OrderItem* parent;
+    Order* owner;
+
+    // Call after changing anything getPrice() depends on; passes the difference up the tree
+    void notifySubtotalChanged(double oldSubtotal);
+    // Call after changing anything an order's flattened view records (see FlattenedOrder)
+    void notifyContentsChanged();
+
 public:
     OrderItem(const std::string& name, double price, int quantity);
     virtual ~OrderItem();
@@ -28,9 +42,25 @@ public:
     virtual void addItem(OrderItem* item);
     virtual void removeItem(OrderItem* item);
     virtual std::vector<OrderItem*> getItems() const;
+
+    // Cached-subtotal propagation (composites override to fold a child's change into their own)
+    virtual void childSubtotalChanged(double delta);
+    void setParent(OrderItem* parent);
+    void setOwner(Order* owner);
+    OrderItem* getParent() const;
     
     // Display/description method
     virtual std::string getDescription() const = 0;
+
+    // Typed dispatch: calls the visitor method for this item's concrete type
+    virtual void accept(OrderItemVisitor& visitor) const = 0;
+
+    // Items are heap-allocated by plain `new`, or placed in an order's arena with
+    // `new (order->getItemArena()) SinglePlant(...)`; `delete` works for both
+    static void* operator new(std::size_t size);
+    static void* operator new(std::size_t size, OrderItemArena& arena);
+    static void operator delete(void* memory);
+    static void operator delete(void* memory, OrderItemArena& arena);
 };
 
 #endif
@@ -0,0 +1,82 @@
+#include "OrderItemArena.h"
+#include <new>
+#include <utility>
+
+namespace {
+    const std::size_t MAX_BLOCK_SIZE = 256 * 1024;
+
+    std::size_t alignUp(std::size_t bytes) {
+        return (bytes + OrderItemArena::ALIGNMENT - 1) & ~(OrderItemArena::ALIGNMENT - 1);
+    }
+}
+
+OrderItemArena::OrderItemArena(std::size_t firstBlockSize)
+    : cursor(nullptr), remaining(0), nextBlockSize(alignUp(firstBlockSize > 0 ? firstBlockSize : ALIGNMENT)),
+      bytesAllocated(0) {
+    // The first block is only created on the first allocation, so empty orders cost nothing
+}
+
+OrderItemArena::~OrderItemArena() {
+    for (char* block : blocks) {
+        ::operator delete(block);
+    }
+}
+
+// Blocks double in size (up to MAX_BLOCK_SIZE) so large orders need few of them
+void OrderItemArena::addBlock(std::size_t minimumBytes) {
+    std::size_t size = nextBlockSize;
+    if (size < minimumBytes) {
+        size = alignUp(minimumBytes);
+    }
+    char* block = static_cast<char*>(::operator new(size));
+    blocks.push_back(block);
+    blockSizes.push_back(size);
+    cursor = block;
+    remaining = size;
+    if (nextBlockSize < MAX_BLOCK_SIZE) {
+        nextBlockSize *= 2;
+    }
+}
+
+void* OrderItemArena::allocate(std::size_t bytes) {
+    bytes = alignUp(bytes);
+    if (bytes > remaining) {
+        addBlock(bytes);
+    }
+    void* result = cursor;
+    cursor += bytes;
+    remaining -= bytes;
+    bytesAllocated += bytes;
+    return result;
+}
+
+void OrderItemArena::reset() {
+    // Keep the first block for reuse and release the rest in one pass
+    for (std::size_t i = 1; i < blocks.size(); ++i) {
+        ::operator delete(blocks[i]);
+    }
+    if (!blocks.empty()) {
+        blocks.resize(1);
+        blockSizes.resize(1);
+        cursor = blocks[0];
+        remaining = blockSizes[0];
+    }
+    bytesAllocated = 0;
+}
+
+void OrderItemArena::swap(OrderItemArena& other) {
+    blocks.swap(other.blocks);
+    blockSizes.swap(other.blockSizes);
+    std::swap(cursor, other.cursor);
+    std::swap(remaining, other.remaining);
+    std::swap(nextBlockSize, other.nextBlockSize);
+    std::swap(bytesAllocated, other.bytesAllocated);
+}
+
+std::size_t OrderItemArena::getBytesAllocated() const {
+    return bytesAllocated;
+}
+
+std::size_t OrderItemArena::getBlockCount() const {
+    return blocks.size();
+}
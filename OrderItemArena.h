@@ -0,0 +1,52 @@
+#ifndef ORDERITEMARENA_H
+#define ORDERITEMARENA_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Monotonic memory arena for the OrderItem tree of one Order
+ *
+ * Items are bump-allocated out of a few large blocks instead of one heap
+ * allocation each. Deleting an arena item still runs its destructor but does
+ * not return memory; everything is released at once by reset() or when the
+ * arena (and so its Order) is destroyed. Allocate with
+ * `new (order->getItemArena()) SinglePlant(...)`; such items must stay inside
+ * that order and never outlive it.
+ *
+ * Not thread-safe - an order is built by one thread at a time.
+ */
+class OrderItemArena {
+private:
+    std::vector<char*> blocks;
+    std::vector<std::size_t> blockSizes;
+    char* cursor;
+    std::size_t remaining;
+    std::size_t nextBlockSize;
+    std::size_t bytesAllocated;
+
+    void addBlock(std::size_t minimumBytes);
+
+public:
+    static const std::size_t ALIGNMENT = 16;
+
+    explicit OrderItemArena(std::size_t firstBlockSize = 4096);
+    ~OrderItemArena();
+
+    OrderItemArena(const OrderItemArena&) = delete;
+    OrderItemArena& operator=(const OrderItemArena&) = delete;
+
+    // Returns ALIGNMENT-aligned storage valid until reset() or destruction
+    void* allocate(std::size_t bytes);
+
+    // Releases every allocation at once; no object from this arena may still be alive
+    void reset();
+
+    // Exchanges the blocks of two arenas (objects keep pointing at their own memory)
+    void swap(OrderItemArena& other);
+
+    std::size_t getBytesAllocated() const;
+    std::size_t getBlockCount() const;
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef ORDERITEMVISITOR_H
+#define ORDERITEMVISITOR_H
+
+class SinglePlant;
+class PlantBundle;
+
+/**
+ * @brief Typed visitor over order items (Visitor pattern)
+ * OrderItem::accept() calls back with the concrete item type, so code walking
+ * an order tree does not need a dynamic_cast per node. Visiting a bundle does
+ * not descend into it; visitors that want its contents call accept() on
+ * PlantBundle::getChildren() themselves.
+ */
+class OrderItemVisitor {
+public:
+    virtual ~OrderItemVisitor() {}
+
+    virtual void visitSinglePlant(const SinglePlant& plant) = 0;
+    virtual void visitPlantBundle(const PlantBundle& bundle) = 0;
+};
+
+#endif
@@ -1,10 +1,38 @@
 #include "OrderMemento.h"
 
-OrderMemento::OrderMemento(const std::string& savedState)
-    : state(savedState)
+#include <utility>
+
+OrderMemento::OrderMemento(std::string savedState)
+{
+    chunks.push_back(std::make_shared<const std::string>(std::move(savedState)));
+}
+
+OrderMemento::OrderMemento(std::vector<Chunk> stateChunks)
+    : chunks(std::move(stateChunks))
 {}
 
 std::string OrderMemento::getState() const
 {
+    std::string state;
+    state.reserve(getStateSize());
+    for (const Chunk& chunk : chunks)
+    {
+        state += *chunk;
+    }
     return state;
 }
+
+const std::vector<OrderMemento::Chunk>& OrderMemento::getChunks() const
+{
+    return chunks;
+}
+
+std::size_t OrderMemento::getStateSize() const
+{
+    std::size_t size = 0;
+    for (const Chunk& chunk : chunks)
+    {
+        size += chunk->size();
+    }
+    return size;
+}
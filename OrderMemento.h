@@ -1,31 +1,51 @@
 #ifndef ORDERMEMENTO_H
 #define ORDERMEMENTO_H
 
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <vector>
 
 /**
  * @brief Memento object for storing Order state snapshots
  *
- * This class holds an opaque string representation of an Order's state
- * so the caretaker can save and restore order snapshots without exposing
- * the internals of the Order class.
+ * This class holds an opaque representation of an Order's state so the
+ * caretaker can save and restore order snapshots without exposing the
+ * internals of the Order class. The state is kept as a list of immutable,
+ * reference-counted chunks; consecutive snapshots of the same order share
+ * every chunk that did not change, so a long undo history only pays for
+ * what was edited between saves.
  */
 class OrderMemento {
+public:
+    typedef std::shared_ptr<const std::string> Chunk;
+
 private:
-    std::string state;
+    std::vector<Chunk> chunks;
 
 public:
     /**
      * @brief Create an OrderMemento with a serialized state
      * @param savedState Serialized representation of the order state
      */
-    OrderMemento(const std::string& savedState);
+    OrderMemento(std::string savedState);
+
+    /**
+     * @brief Create an OrderMemento from state chunks (possibly shared with other mementos)
+     * @param stateChunks Pieces whose concatenation is the serialized state
+     */
+    OrderMemento(std::vector<Chunk> stateChunks);
 
     /**
      * @brief Retrieve the saved state
-     * @return The serialized state string
+     * @return The serialized state (binary, see OrderMementoCodec)
      */
     std::string getState() const;
+
+    const std::vector<Chunk>& getChunks() const;
+
+    /** @brief Size of the serialized state, counting shared chunks in full */
+    std::size_t getStateSize() const;
 };
 
 #endif // ORDERMEMENTO_H
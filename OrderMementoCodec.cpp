@@ -0,0 +1,326 @@
+#include "OrderMementoCodec.h"
+#include "BinaryCodec.h"
+#include "Order.h"
+#include "OrderMemento.h"
+#include "OrderRegistry.h"
+#include "PlantBundle.h"
+#include "SinglePlant.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+    const char MEMENTO_MAGIC[4] = {'O', 'R', 'D', 'M'};
+
+    enum ItemKind
+    {
+        KIND_PLANT = 1,
+        KIND_BUNDLE = 2
+    };
+
+    // Smallest possible item record: kind + payload length
+    const std::size_t MIN_ITEM_BYTES = 5;
+
+    // On average one top-level item in CHUNK_BOUNDARY_MASK + 1 ends a chunk
+    const std::uint64_t CHUNK_BOUNDARY_MASK = 15;
+
+    // Word-at-a-time multiplicative hash; only used to pick chunk boundaries and bucket chunks for sharing
+    std::uint64_t hashBytes(const char *bytes, std::size_t count)
+    {
+        const std::uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+        std::uint64_t hash = count * multiplier;
+        std::size_t i = 0;
+        for (; i + sizeof(std::uint64_t) <= count; i += sizeof(std::uint64_t))
+        {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            hash = (hash ^ word) * multiplier;
+            hash ^= hash >> 29;
+        }
+        for (; i < count; ++i)
+        {
+            hash = (hash ^ static_cast<unsigned char>(bytes[i])) * multiplier;
+        }
+        return hash ^ (hash >> 32);
+    }
+
+    /**
+     * Hands out chunks, returning the basis memento's copy whenever an identical
+     * chunk already exists there.
+     */
+    class ChunkSharer
+    {
+    private:
+        std::unordered_multimap<std::uint64_t, OrderMemento::Chunk> known;
+
+    public:
+        explicit ChunkSharer(const OrderMemento *basis)
+        {
+            if (!basis)
+            {
+                return;
+            }
+            known.reserve(basis->getChunks().size());
+            for (const OrderMemento::Chunk &chunk : basis->getChunks())
+            {
+                known.insert(std::make_pair(hashBytes(chunk->data(), chunk->size()), chunk));
+            }
+        }
+
+        OrderMemento::Chunk share(const std::string &bytes)
+        {
+            if (known.empty())
+            {
+                return std::make_shared<const std::string>(bytes);
+            }
+            typedef std::unordered_multimap<std::uint64_t, OrderMemento::Chunk>::const_iterator Iterator;
+            std::pair<Iterator, Iterator> range = known.equal_range(hashBytes(bytes.data(), bytes.size()));
+            for (Iterator it = range.first; it != range.second; ++it)
+            {
+                if (*it->second == bytes)
+                {
+                    return it->second;
+                }
+            }
+            return std::make_shared<const std::string>(bytes);
+        }
+    };
+
+    typedef std::vector<FlattenedOrder::Node> Nodes;
+
+    // Writes the record for nodes[index] and its subtree; returns the index just past the subtree
+    std::size_t encodeNode(BinaryWriter &out, const Nodes &nodes, std::size_t index)
+    {
+        const FlattenedOrder::Node &node = nodes[index++];
+        std::size_t lengthAt;
+        if (const SinglePlant *plant = node.plant)
+        {
+            out.writeU8(KIND_PLANT);
+            lengthAt = out.size();
+            out.writeU32(0);
+            out.writeString(plant->getPlantType());
+            out.writeString(plant->getSize());
+            out.writeI32(plant->getQuantity());
+            out.writeDouble(plant->getUnitPrice());
+            out.writeU8(plant->hasPlantPot() ? 1 : 0);
+            out.writeString(plant->getPotType());
+            out.writeDouble(plant->getPotPrice());
+        }
+        else
+        {
+            const PlantBundle *bundle = node.bundle;
+            out.writeU8(KIND_BUNDLE);
+            lengthAt = out.size();
+            out.writeU32(0);
+            out.writeString(bundle->getName());
+            out.writeString(bundle->getBundleType());
+            out.writeI32(bundle->getQuantity());
+            out.writeDouble(bundle->getDiscount());
+            out.writeU32(static_cast<std::uint32_t>(node.childCount));
+            for (std::int32_t child = 0; child < node.childCount; ++child)
+            {
+                index = encodeNode(out, nodes, index);
+            }
+        }
+        out.patchU32(lengthAt, static_cast<std::uint32_t>(out.size() - lengthAt - sizeof(std::uint32_t)));
+        return index;
+    }
+
+    /**
+     * Reads one item record and builds it in the arena. On failure nothing is
+     * handed back and anything built for this record has been deleted.
+     */
+    bool decodeItem(BinaryReader &in, OrderItemArena &arena, int depth, OrderItem *&built);
+
+    // Children go into the bundle, or into topLevel for the order's own list (caller cleans up on failure)
+    bool decodeItems(BinaryReader &in, OrderItemArena &arena, int depth, PlantBundle *bundle, std::vector<OrderItem *> *topLevel)
+    {
+        std::uint32_t count = 0;
+        if (!in.readU32(count) || count > in.remaining() / MIN_ITEM_BYTES)
+        {
+            return false;
+        }
+        if (topLevel)
+        {
+            topLevel->reserve(count);
+        }
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            OrderItem *item = nullptr;
+            if (!decodeItem(in, arena, depth, item))
+            {
+                return false;
+            }
+            if (bundle)
+            {
+                bundle->addItem(item);
+            }
+            else
+            {
+                topLevel->push_back(item);
+            }
+        }
+        return true;
+    }
+
+    bool decodeItem(BinaryReader &in, OrderItemArena &arena, int depth, OrderItem *&built)
+    {
+        built = nullptr;
+        std::uint8_t kind = 0;
+        std::uint32_t length = 0;
+        if (depth > OrderMementoCodec::MAX_DEPTH || !in.readU8(kind) || !in.readU32(length) || length > in.remaining())
+        {
+            return false;
+        }
+        const char *payloadEnd = in.position() + length;
+
+        if (kind == KIND_PLANT)
+        {
+            std::string plantType, size, potType;
+            std::int32_t quantity = 0;
+            double unitPrice = 0.0, potPrice = 0.0;
+            std::uint8_t hasPot = 0;
+            if (!in.readString(plantType) || !in.readString(size) || !in.readI32(quantity) ||
+                !in.readDouble(unitPrice) || !in.readU8(hasPot) || !in.readString(potType) ||
+                !in.readDouble(potPrice) || hasPot > 1 || quantity <= 0 || !std::isfinite(unitPrice) ||
+                !std::isfinite(potPrice) || in.position() != payloadEnd)
+            {
+                return false;
+            }
+            SinglePlant *plant = new (arena) SinglePlant(plantType, unitPrice, quantity, size);
+            if (hasPot)
+            {
+                plant->addPot(potType, potPrice);
+            }
+            built = plant;
+            return true;
+        }
+
+        if (kind == KIND_BUNDLE)
+        {
+            std::string name, bundleType;
+            std::int32_t quantity = 0;
+            double discount = 0.0;
+            // The discount is a percentage; written as a negated range so NaN fails too
+            if (!in.readString(name) || !in.readString(bundleType) || !in.readI32(quantity) ||
+                !in.readDouble(discount) || quantity <= 0 || !(discount >= 0.0 && discount <= 100.0))
+            {
+                return false;
+            }
+            PlantBundle *bundle = new (arena) PlantBundle(name, bundleType, quantity, discount);
+            if (!decodeItems(in, arena, depth + 1, bundle, nullptr) || in.position() != payloadEnd)
+            {
+                delete bundle;
+                return false;
+            }
+            built = bundle;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool decodeHeader(BinaryReader &in, std::string &orderId, std::string &customerName, std::string &orderDate,
+                      std::string &status)
+    {
+        char magic[4];
+        std::uint16_t version = 0;
+        std::uint32_t endianMarker = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            std::uint8_t byte = 0;
+            if (!in.readU8(byte))
+            {
+                return false;
+            }
+            magic[i] = static_cast<char>(byte);
+        }
+        return std::equal(magic, magic + 4, MEMENTO_MAGIC) && in.readU16(version) &&
+               version == OrderMementoCodec::FORMAT_VERSION && in.readU32(endianMarker) &&
+               endianMarker == BINARY_ENDIAN_MARKER && in.readString(orderId) && in.readString(customerName) &&
+               in.readString(orderDate) && in.readString(status);
+    }
+}
+
+std::vector<OrderMemento::Chunk> OrderMementoCodec::encode(const Order &order, const OrderMemento *basis)
+{
+    ChunkSharer sharer(basis);
+    std::vector<OrderMemento::Chunk> chunks(1); // header goes in front once the item count is known
+
+    std::string run;
+    run.reserve(1024);
+    BinaryWriter out(run);
+    std::size_t itemsInRun = 0;
+    const FlattenedOrder &flat = order.getFlattened();
+    const Nodes &nodes = flat.getNodes();
+    for (std::size_t index = 0; index < nodes.size();)
+    {
+        std::size_t start = out.size();
+        index = encodeNode(out, nodes, index);
+        ++itemsInRun;
+        bool boundary = (hashBytes(run.data() + start, out.size() - start) & CHUNK_BOUNDARY_MASK) == 0;
+        if (boundary || itemsInRun == MAX_CHUNK_ITEMS)
+        {
+            chunks.push_back(sharer.share(run));
+            run.clear(); // keeps its capacity; chunks are exact-size copies
+            itemsInRun = 0;
+        }
+    }
+    if (!run.empty())
+    {
+        chunks.push_back(sharer.share(run));
+    }
+
+    std::string header;
+    BinaryWriter headerOut(header);
+    headerOut.writeBytes(MEMENTO_MAGIC, sizeof(MEMENTO_MAGIC));
+    headerOut.writeU16(static_cast<std::uint16_t>(FORMAT_VERSION));
+    headerOut.writeU32(BINARY_ENDIAN_MARKER);
+    headerOut.writeString(order.orderId);
+    headerOut.writeString(order.customerName);
+    headerOut.writeString(order.orderDate);
+    headerOut.writeString(order.status);
+    headerOut.writeU32(static_cast<std::uint32_t>(flat.getTopLevelCount()));
+    chunks[0] = sharer.share(header);
+    return chunks;
+}
+
+bool OrderMementoCodec::decode(const std::string &data, Order &order)
+{
+    // Decode into a fresh arena so a bad memento leaves the order untouched
+    OrderItemArena arena;
+    std::vector<OrderItem *> items;
+    std::string orderId, customerName, orderDate, status;
+    BinaryReader in(data.data(), data.size());
+    if (!decodeHeader(in, orderId, customerName, orderDate, status) ||
+        !decodeItems(in, arena, 0, nullptr, &items) || !in.atEnd())
+    {
+        for (OrderItem *item : items)
+        {
+            delete item;
+        }
+        return false;
+    }
+
+    // Swap the new tree in; the old arena is released when `arena` goes out of scope
+    order.destroyItems();
+    order.itemArena.swap(arena);
+    order.itemsTotal = 0.0;
+    order.totalAmount = 0.0;
+    order.orderId = orderId;
+    order.customerName = customerName;
+    order.orderDate = orderDate;
+    order.status = status;
+    OrderRegistry::getInstance().updateKeys(&order);
+
+    order.orderItems.reserve(items.size());
+    for (OrderItem *item : items)
+    {
+        order.addOrderItem(item);
+    }
+    return true;
+}
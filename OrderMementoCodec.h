@@ -0,0 +1,61 @@
+#ifndef ORDER_MEMENTO_CODEC_H
+#define ORDER_MEMENTO_CODEC_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Order;
+class OrderMemento;
+
+/**
+ * @class OrderMementoCodec
+ * @brief Versioned binary encoding of an Order's state for OrderMemento
+ *
+ * Replaces the old line-based text format, which lost pot information and
+ * re-parsed every number through a stream. Bundles may nest to any depth up
+ * to MAX_DEPTH.
+ *
+ * Layout (version 1, host byte order):
+ * @code
+ * header : "ORDM" | u16 version | u32 endian marker
+ * order  : orderId | customerName | orderDate | status | u32 items | items
+ * item   : u8 kind | u32 payload bytes | payload
+ * plant  : plantType | size | i32 quantity | f64 unitPrice
+ *          | u8 hasPot | potType | f64 potPrice
+ * bundle : name | bundleType | i32 quantity | f64 discount | u32 items | items
+ * @endcode
+ * Strings are u32 length-prefixed. Every item carries its payload length, so
+ * the decoder checks each record ends exactly where it claims to.
+ *
+ * The encoding is produced in chunks: the header and item count first, then
+ * runs of top-level item records. A run ends after an item whose record hash
+ * hits a boundary pattern (or after MAX_CHUNK_ITEMS items), so boundaries
+ * depend on content rather than position and an insert or removal only
+ * disturbs the run it lands in. Chunks identical to one in the basis
+ * memento are shared instead of copied.
+ */
+class OrderMementoCodec
+{
+public:
+    static const unsigned int FORMAT_VERSION = 1;
+    static const int MAX_DEPTH = 64;
+    static const std::size_t MAX_CHUNK_ITEMS = 64;
+
+    /**
+     * @brief Serialises the order's metadata and its full item tree
+     * @param basis Earlier memento of the same order whose unchanged chunks are reused; may be nullptr
+     * @return Chunks whose concatenation is the encoded order
+     */
+    static std::vector<std::shared_ptr<const std::string> > encode(const Order &order, const OrderMemento *basis);
+
+    /**
+     * @brief Replaces the order's state with a previously encoded one
+     * @return false if the data is truncated, malformed or from another version;
+     *         the order is only modified once the whole encoding has validated
+     */
+    static bool decode(const std::string &data, Order &order);
+};
+
+#endif // ORDER_MEMENTO_CODEC_H
@@ -0,0 +1,221 @@
+#include "OrderPipeline.h"
+#include "InventoryCommitHandler.h"
+#include "NotificationHandler.h"
+#include "Order.h"
+#include "OrderValidationHandler.h"
+#include "PaymentProcessHandler.h"
+
+OrderPipeline::Config::Config() : queueCapacity(64)
+{
+    // Payment is the step that waits on the outside world, so it gets the most workers
+    workers[VALIDATION] = 2;
+    workers[PAYMENT] = 4;
+    workers[INVENTORY_COMMIT] = 1;
+    workers[NOTIFICATION] = 2;
+}
+
+OrderPipeline::OrderPipeline(const Config &config)
+    : stopped(false), endToEnd(HandlerMetrics::getInstance().getStage(HandlerMetrics::PIPELINE_STAGE))
+{
+    for (int stage = 0; stage < STAGE_COUNT; ++stage)
+    {
+        queues[stage] = new BoundedQueue<Job *>(config.queueCapacity);
+    }
+    startWorkers(VALIDATION, config.workers[VALIDATION], &OrderPipeline::runValidation);
+    startWorkers(PAYMENT, config.workers[PAYMENT], &OrderPipeline::runPayment);
+    startWorkers(INVENTORY_COMMIT, config.workers[INVENTORY_COMMIT], &OrderPipeline::runInventoryCommit);
+    startWorkers(NOTIFICATION, config.workers[NOTIFICATION], &OrderPipeline::runNotification);
+}
+
+OrderPipeline::~OrderPipeline()
+{
+    shutdown();
+    for (int stage = 0; stage < STAGE_COUNT; ++stage)
+    {
+        delete queues[stage];
+    }
+}
+
+void OrderPipeline::startWorkers(Stage stage, std::size_t count, void (OrderPipeline::*run)())
+{
+    for (std::size_t i = 0; i < (count > 0 ? count : 1); ++i)
+    {
+        workers[stage].push_back(std::thread(run, this));
+    }
+}
+
+const char *OrderPipeline::getStageName(Stage stage)
+{
+    switch (stage)
+    {
+    case VALIDATION:
+        return "Order Validation";
+    case PAYMENT:
+        return "Payment Processing";
+    case INVENTORY_COMMIT:
+        return "Inventory Commit";
+    case NOTIFICATION:
+        return "Customer Notification";
+    default:
+        return "Unknown";
+    }
+}
+
+OrderPipeline::Job *OrderPipeline::createJob(Order *order, Customer *customer)
+{
+    Job *job = new Job();
+    job->order = order;
+    job->customer = customer;
+    job->outcome.orderId = order ? order->getOrderId() : std::string();
+    job->submittedAt = HandlerMetrics::Clock::now();
+    return job;
+}
+
+std::future<OrderOutcome> OrderPipeline::submit(Order *order, Customer *customer)
+{
+    Job *job = createJob(order, customer);
+    std::future<OrderOutcome> outcome = job->promise.get_future();
+    if (!order || !customer || !queues[VALIDATION]->push(job))
+    {
+        job->outcome.errors.push_back(order && customer ? "The order pipeline has been shut down."
+                                                        : "Order or customer is missing.");
+        job->promise.set_value(job->outcome);
+        delete job;
+    }
+    return outcome;
+}
+
+bool OrderPipeline::trySubmit(Order *order, Customer *customer, std::future<OrderOutcome> &outcome)
+{
+    if (!order || !customer)
+    {
+        return false;
+    }
+    Job *job = createJob(order, customer);
+    std::future<OrderOutcome> pending = job->promise.get_future();
+    if (!queues[VALIDATION]->tryPush(job))
+    {
+        delete job;
+        return false;
+    }
+    outcome = std::move(pending);
+    return true;
+}
+
+// Stages close front to back, each only after everything feeding it has drained and stopped;
+// notification, which every stage can fail over to, is therefore last
+void OrderPipeline::shutdown()
+{
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    if (stopped)
+    {
+        return;
+    }
+    stopped = true;
+    for (int stage = 0; stage < STAGE_COUNT; ++stage)
+    {
+        queues[stage]->close();
+        for (std::thread &worker : workers[stage])
+        {
+            worker.join();
+        }
+        workers[stage].clear();
+    }
+}
+
+std::size_t OrderPipeline::getQueueDepth(Stage stage) const
+{
+    return stage < STAGE_COUNT ? queues[stage]->size() : 0;
+}
+
+void OrderPipeline::forward(Job *job, Stage next)
+{
+    // Blocks while the next stage is full; never fails because later stages close after this one stops
+    queues[next]->push(job);
+}
+
+void OrderPipeline::fail(Job *job, Stage failedAt)
+{
+    job->outcome.failedStage = getStageName(failedAt);
+    forward(job, NOTIFICATION);
+}
+
+void OrderPipeline::runValidation()
+{
+    OrderValidationHandler validator;
+    Job *job = nullptr;
+    while (queues[VALIDATION]->pop(job))
+    {
+        if (validator.handleOrder(job->order, job->customer))
+        {
+            forward(job, PAYMENT);
+        }
+        else
+        {
+            job->outcome.errors = validator.getValidationErrors();
+            fail(job, VALIDATION);
+        }
+    }
+}
+
+void OrderPipeline::runPayment()
+{
+    PaymentProcessHandler payment;
+    Job *job = nullptr;
+    while (queues[PAYMENT]->pop(job))
+    {
+        if (payment.handleOrder(job->order, job->customer))
+        {
+            forward(job, INVENTORY_COMMIT);
+        }
+        else
+        {
+            fail(job, PAYMENT);
+        }
+    }
+}
+
+void OrderPipeline::runInventoryCommit()
+{
+    InventoryCommitHandler committer;
+    Job *job = nullptr;
+    while (queues[INVENTORY_COMMIT]->pop(job))
+    {
+        if (committer.handleOrder(job->order, job->customer))
+        {
+            job->outcome.success = true;
+            forward(job, NOTIFICATION);
+        }
+        else
+        {
+            // The handler has voided the payment; say so in the customer's failure notice
+            job->outcome.errors.push_back(
+                "Stock ran out before the order could be fulfilled; your payment has been voided");
+            fail(job, INVENTORY_COMMIT);
+        }
+    }
+}
+
+void OrderPipeline::runNotification()
+{
+    NotificationHandler successNotifier(false);
+    NotificationHandler failureNotifier(true);
+    Job *job = nullptr;
+    while (queues[NOTIFICATION]->pop(job))
+    {
+        if (job->outcome.success)
+        {
+            successNotifier.handleOrder(job->order, job->customer);
+        }
+        else
+        {
+            failureNotifier.setErrorMessages(job->outcome.errors);
+            failureNotifier.handleOrder(job->order, job->customer);
+        }
+        job->outcome.status = job->order->getStatus();
+        job->outcome.traceId = job->order->getTraceId();
+        endToEnd.record(HandlerMetrics::elapsedNanos(job->submittedAt), job->outcome.success);
+        job->promise.set_value(job->outcome);
+        delete job;
+    }
+}
@@ -0,0 +1,125 @@
+#ifndef ORDER_PIPELINE_H
+#define ORDER_PIPELINE_H
+
+#include "BoundedQueue.h"
+#include "HandlerMetrics.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Order;
+class Customer;
+
+/**
+ * @brief What happened to one order submitted to the OrderPipeline
+ */
+struct OrderOutcome
+{
+    std::string orderId;
+    bool success;
+    std::string failedStage;         // name of the stage that stopped the order; empty on success
+    std::string status;              // the order's status once the customer was notified
+    std::vector<std::string> errors; // validation errors, or why the inventory commit failed
+    std::uint64_t traceId;           // the order's trace ID, as shown in the handlers' log lines
+
+    OrderOutcome() : success(false), traceId(0) {}
+};
+
+/**
+ * @class OrderPipeline
+ * @brief Staged, asynchronous version of the order-processing chain
+ *
+ * The synchronous chain (OrderValidationHandler -> PaymentProcessHandler ->
+ * InventoryCommitHandler -> NotificationHandler) runs every step on the
+ * caller's thread, so one slow payment holds up the customer and everybody
+ * queued behind them. Here each step is a stage with its own worker pool,
+ * fed by a BoundedQueue:
+ * @code
+ * submit -> [validation] -> [payment] -> [inventory commit] -> [notification] -> future
+ *                 |              |                |                    ^
+ *                 +--------------+----------------+-- failures --------+
+ * @endcode
+ * Every worker owns its own handler instances, so the handlers need no
+ * locking. A full queue blocks the stage feeding it, which slows submit()
+ * down rather than letting work pile up (backpressure). An order that fails
+ * a stage goes straight to notification with a failure NotificationHandler,
+ * as in the chain.
+ *
+ * Each stage's handler time is recorded in HandlerMetrics as in the chain;
+ * the time from submit to outcome, queueing included, is recorded under
+ * HandlerMetrics::PIPELINE_STAGE.
+ *
+ * The order and customer must stay alive until the returned future is ready,
+ * and an order must not be touched by the caller while it is in flight.
+ */
+class OrderPipeline
+{
+public:
+    enum Stage
+    {
+        VALIDATION,
+        PAYMENT,
+        INVENTORY_COMMIT,
+        NOTIFICATION,
+        STAGE_COUNT
+    };
+
+    struct Config
+    {
+        std::size_t workers[STAGE_COUNT];
+        std::size_t queueCapacity; // per stage
+
+        Config();
+    };
+
+    explicit OrderPipeline(const Config &config = Config());
+    ~OrderPipeline();
+
+    OrderPipeline(const OrderPipeline &) = delete;
+    OrderPipeline &operator=(const OrderPipeline &) = delete;
+
+    /** @brief Queues an order, waiting while the validation queue is full */
+    std::future<OrderOutcome> submit(Order *order, Customer *customer);
+
+    /** @brief Queues an order only if validation has room now; false leaves `outcome` untouched */
+    bool trySubmit(Order *order, Customer *customer, std::future<OrderOutcome> &outcome);
+
+    /** @brief Stops intake, lets every queued order finish, then joins the workers */
+    void shutdown();
+
+    std::size_t getQueueDepth(Stage stage) const;
+    static const char *getStageName(Stage stage);
+
+private:
+    struct Job
+    {
+        Order *order;
+        Customer *customer;
+        std::promise<OrderOutcome> promise;
+        OrderOutcome outcome;
+        HandlerMetrics::Clock::time_point submittedAt;
+    };
+
+    BoundedQueue<Job *> *queues[STAGE_COUNT];
+    std::vector<std::thread> workers[STAGE_COUNT];
+    std::mutex lifecycleMutex;
+    bool stopped;
+    HandlerMetrics::Stage &endToEnd;
+
+    void startWorkers(Stage stage, std::size_t count, void (OrderPipeline::*run)());
+    Job *createJob(Order *order, Customer *customer);
+    void forward(Job *job, Stage next);
+    void fail(Job *job, Stage failedAt);
+
+    void runValidation();
+    void runPayment();
+    void runInventoryCommit();
+    void runNotification();
+};
+
+#endif // ORDER_PIPELINE_H
@@ -3,20 +3,32 @@
 
 #include "Order.h"
 #include "Customer.h"
+#include "HandlerMetrics.h"
+#include "IdGenerator.h"
 #include <string>
 #include <iostream>
+#include <iomanip>
+#include <sstream>
 
 /**
  * @brief Abstract base class for order processing chain of responsibility
  * This implements the Chain of Responsibility pattern for order processing workflow
+ *
+ * Every processOrder() call is timed and recorded in HandlerMetrics under the
+ * handler's name. An order is given a trace ID by the first handler that sees
+ * it, so its log lines can be followed through the chain (or the pipeline).
  */
 class OrderProcessHandler {
 protected:
     OrderProcessHandler* nextHandler;
     std::string handlerName;
+    HandlerMetrics::Stage& metrics;
+    HandlerMetrics::Stage& chainMetrics;
     
 public:
-    OrderProcessHandler(const std::string& name) : nextHandler(nullptr), handlerName(name) {}
+    OrderProcessHandler(const std::string& name)
+        : nextHandler(nullptr), handlerName(name), metrics(HandlerMetrics::getInstance().getStage(name)),
+          chainMetrics(HandlerMetrics::getInstance().getStage(HandlerMetrics::CHAIN_STAGE)) {}
     virtual ~OrderProcessHandler() {}
     
     // Chain management
@@ -31,19 +43,36 @@ public:
     // Main processing method
     bool handleOrder(Order* order, Customer* customer) {
         std::cout << "\n--- " << handlerName << " ---" << std::endl;
+        if (order && order->getTraceId() == 0) {
+            order->setTraceId(IdGenerator::getInstance().next());
+        }
+        
+        // Only the outermost call on this thread times the chain as a whole
+        int& depth = chainDepth();
+        bool timesChain = depth == 0 && nextHandler;
+        ++depth;
+        
+        HandlerMetrics::Clock::time_point start = HandlerMetrics::Clock::now();
+        bool succeeded = processOrder(order, customer);
+        std::uint64_t nanos = HandlerMetrics::elapsedNanos(start);
+        metrics.record(nanos, succeeded);
         
-        if (processOrder(order, customer)) {
-            std::cout << "[SUCCESS] " << handlerName << " completed successfully" << std::endl;
+        bool result = false;
+        if (succeeded) {
+            std::cout << "[SUCCESS] " << handlerName << " completed successfully" << traceSuffix(order, nanos) << std::endl;
             
             // Pass to next handler in chain
-            if (nextHandler) {
-                return nextHandler->handleOrder(order, customer);
-            }
-            return true; // End of chain, success
+            result = nextHandler ? nextHandler->handleOrder(order, customer) : true; // end of chain, success
         } else {
-            std::cout << "[FAILED] " << handlerName << " failed" << std::endl;
-            return false; // Stop processing on failure
+            std::cout << "[FAILED] " << handlerName << " failed" << traceSuffix(order, nanos) << std::endl;
+            // Stop processing on failure
+        }
+        
+        --depth;
+        if (timesChain) {
+            chainMetrics.record(HandlerMetrics::elapsedNanos(start), result);
         }
+        return result;
     }
     
 protected:
@@ -54,6 +83,22 @@ protected:
     void logStep(const std::string& message) {
         std::cout << "[" << handlerName << "] " << message << std::endl;
     }
+    
+private:
+    static int& chainDepth() {
+        static thread_local int depth = 0;
+        return depth;
+    }
+    
+    static std::string traceSuffix(const Order* order, std::uint64_t nanos) {
+        std::ostringstream out;
+        out << " (";
+        if (order) {
+            out << "trace " << IdGenerator::format("TRC-", order->getTraceId()) << ", ";
+        }
+        out << std::fixed << std::setprecision(3) << nanos / 1e6 << " ms)";
+        return out.str();
+    }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "OrderRegistry.h"
+#include "Order.h"
+
+OrderRegistry &OrderRegistry::getInstance()
+{
+    static OrderRegistry instance;
+    return instance;
+}
+
+// Adds the order to the ID and customer indexes using the keys stored in entry
+void OrderRegistry::index(Order *order, Entry &entry)
+{
+    ordersById.insert(std::make_pair(entry.orderId, order));
+    std::list<Order *> &customerOrders = ordersByCustomer[entry.customerName];
+    entry.inCustomer = customerOrders.insert(customerOrders.end(), order);
+}
+
+void OrderRegistry::unindex(const Order *order, Entry &entry)
+{
+    std::pair<std::unordered_multimap<std::string, Order *>::iterator,
+              std::unordered_multimap<std::string, Order *>::iterator>
+        range = ordersById.equal_range(entry.orderId);
+    for (std::unordered_multimap<std::string, Order *>::iterator it = range.first; it != range.second; ++it)
+    {
+        if (it->second == order)
+        {
+            ordersById.erase(it);
+            break;
+        }
+    }
+
+    std::unordered_map<std::string, std::list<Order *> >::iterator customer = ordersByCustomer.find(entry.customerName);
+    if (customer != ordersByCustomer.end())
+    {
+        customer->second.erase(entry.inCustomer);
+        if (customer->second.empty())
+        {
+            ordersByCustomer.erase(customer);
+        }
+    }
+}
+
+void OrderRegistry::registerOrder(Order *order)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (entries.count(order))
+    {
+        return;
+    }
+    Entry &entry = entries[order];
+    entry.orderId = order->getOrderId();
+    entry.customerName = order->getCustomerName();
+    entry.inAll = allOrders.insert(allOrders.end(), order);
+    index(order, entry);
+}
+
+void OrderRegistry::unregisterOrder(const Order *order)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<const Order *, Entry>::iterator it = entries.find(order);
+    if (it == entries.end())
+    {
+        return;
+    }
+    unindex(order, it->second);
+    allOrders.erase(it->second.inAll);
+    entries.erase(it);
+}
+
+void OrderRegistry::updateKeys(Order *order)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<const Order *, Entry>::iterator it = entries.find(order);
+    if (it == entries.end())
+    {
+        return;
+    }
+    Entry &entry = it->second;
+    if (entry.orderId == order->getOrderId() && entry.customerName == order->getCustomerName())
+    {
+        return;
+    }
+    unindex(order, entry);
+    entry.orderId = order->getOrderId();
+    entry.customerName = order->getCustomerName();
+    index(order, entry);
+}
+
+Order *OrderRegistry::findOrder(const std::string &orderId) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_multimap<std::string, Order *>::const_iterator it = ordersById.find(orderId);
+    return it != ordersById.end() ? it->second : nullptr;
+}
+
+std::vector<Order *> OrderRegistry::getAllOrders() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::vector<Order *>(allOrders.begin(), allOrders.end());
+}
+
+std::vector<Order *> OrderRegistry::getOrdersForCustomer(const std::string &customerName) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<std::string, std::list<Order *> >::const_iterator it = ordersByCustomer.find(customerName);
+    if (it == ordersByCustomer.end())
+    {
+        return std::vector<Order *>();
+    }
+    return std::vector<Order *>(it->second.begin(), it->second.end());
+}
+
+size_t OrderRegistry::getOrderCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+size_t OrderRegistry::getOrderCountForCustomer(const std::string &customerName) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<std::string, std::list<Order *> >::const_iterator it = ordersByCustomer.find(customerName);
+    return it != ordersByCustomer.end() ? it->second.size() : 0;
+}
+
+void OrderRegistry::forEachOrder(const std::function<void(const Order *)> &visit) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const Order *order : allOrders)
+    {
+        visit(order);
+    }
+}
+
+void OrderRegistry::forEachOrderOf(const std::string &customerName, const std::function<void(const Order *)> &visit) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<std::string, std::list<Order *> >::const_iterator it = ordersByCustomer.find(customerName);
+    if (it == ordersByCustomer.end())
+    {
+        return;
+    }
+    for (const Order *order : it->second)
+    {
+        visit(order);
+    }
+}
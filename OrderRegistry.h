@@ -0,0 +1,68 @@
+#ifndef ORDER_REGISTRY_H
+#define ORDER_REGISTRY_H
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Order;
+
+/**
+ * @class OrderRegistry
+ * @brief Singleton index of every live Order, by order ID and by customer
+ *
+ * Orders register themselves on construction and unregister on destruction.
+ * Each order remembers its position in the global list and in its customer's
+ * list, so both operations are O(1) and tearing down millions of historical
+ * orders stays linear. All access is guarded by a single mutex; the forEach
+ * methods hold it while visiting, so visitors must not create or destroy orders.
+ */
+class OrderRegistry
+{
+private:
+    struct Entry
+    {
+        std::list<Order *>::iterator inAll;
+        std::list<Order *>::iterator inCustomer;
+        std::string orderId;
+        std::string customerName;
+    };
+
+    std::list<Order *> allOrders; // registration order
+    std::unordered_map<const Order *, Entry> entries;
+    std::unordered_multimap<std::string, Order *> ordersById;
+    std::unordered_map<std::string, std::list<Order *> > ordersByCustomer;
+    mutable std::mutex mutex;
+
+    OrderRegistry() {}
+    ~OrderRegistry() {}
+
+    void unindex(const Order *order, Entry &entry);
+    void index(Order *order, Entry &entry);
+
+public:
+    OrderRegistry(const OrderRegistry &) = delete;
+    OrderRegistry &operator=(const OrderRegistry &) = delete;
+
+    static OrderRegistry &getInstance();
+
+    void registerOrder(Order *order);
+    void unregisterOrder(const Order *order);
+
+    /** @brief Re-files an order whose ID or customer changed (e.g. after a memento restore) */
+    void updateKeys(Order *order);
+
+    Order *findOrder(const std::string &orderId) const;
+    std::vector<Order *> getAllOrders() const;
+    std::vector<Order *> getOrdersForCustomer(const std::string &customerName) const;
+    size_t getOrderCount() const;
+    size_t getOrderCountForCustomer(const std::string &customerName) const;
+
+    void forEachOrder(const std::function<void(const Order *)> &visit) const;
+    void forEachOrderOf(const std::string &customerName, const std::function<void(const Order *)> &visit) const;
+};
+
+#endif // ORDER_REGISTRY_H
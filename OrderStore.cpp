@@ -0,0 +1,378 @@
+#include "OrderStore.h"
+#include "AtomicFile.h"
+#include "BinaryCodec.h"
+#include "Order.h"
+#include "OrderMemento.h"
+#include "OrderMementoCodec.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    const char ORDER_LOG_MAGIC[8] = {'G', 'H', 'O', 'R', 'D', 'L', 'O', 'G'};
+    const std::size_t HEADER_SIZE = sizeof(ORDER_LOG_MAGIC) + 2 * sizeof(std::uint32_t);
+    const std::size_t RECORD_PREFIX_SIZE = 2 * sizeof(std::uint32_t); // length + CRC
+
+    bool readSummary(BinaryReader &reader, StoredOrder &summary)
+    {
+        std::uint32_t itemCount = 0;
+        if (!reader.readString(summary.orderId) || !reader.readString(summary.customerName) ||
+            !reader.readString(summary.orderDate) || !reader.readString(summary.status) ||
+            !reader.readDouble(summary.totalAmount) || !reader.readU32(itemCount))
+        {
+            return false;
+        }
+        summary.itemCount = static_cast<int>(itemCount);
+        return true;
+    }
+}
+
+OrderStore::OrderStore() : logSize(0), recordCount(0)
+{
+}
+
+OrderStore::~OrderStore()
+{
+    closeLocked();
+}
+
+OrderStore &OrderStore::getInstance()
+{
+    static OrderStore instance;
+    return instance;
+}
+
+bool OrderStore::open(const std::string &logPath)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    closeLocked();
+
+    // A missing or empty file becomes a new log
+    if (!mapping.open(logPath) || mapping.getSize() == 0)
+    {
+        mapping.close();
+        std::string header;
+        BinaryWriter writer(header);
+        writer.writeBytes(ORDER_LOG_MAGIC, sizeof(ORDER_LOG_MAGIC));
+        writer.writeU32(FORMAT_VERSION);
+        writer.writeU32(BINARY_ENDIAN_MARKER);
+        std::ofstream out(logPath.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+        out.close();
+        if (!out || !mapping.open(logPath))
+        {
+            std::cout << "[ORDER STORE] Cannot create order log at " << logPath << "." << std::endl;
+            return false;
+        }
+    }
+
+    std::uint32_t version = 0, endian = 0;
+    BinaryReader header(mapping.getData(), mapping.getSize());
+    if (mapping.getSize() < HEADER_SIZE || std::memcmp(mapping.getData(), ORDER_LOG_MAGIC, sizeof(ORDER_LOG_MAGIC)) != 0 ||
+        !header.skip(sizeof(ORDER_LOG_MAGIC)) || !header.readU32(version) || !header.readU32(endian) ||
+        version != FORMAT_VERSION || endian != BINARY_ENDIAN_MARKER)
+    {
+        std::cout << "[ORDER STORE] " << logPath << " is not a version " << FORMAT_VERSION << " order log." << std::endl;
+        mapping.close();
+        return false;
+    }
+    path = logPath;
+
+    // Single forward pass over the mapping; stops at the first record that does not check out
+    const char *base = mapping.getData();
+    BinaryReader reader(base + HEADER_SIZE, mapping.getSize() - HEADER_SIZE);
+    std::uint64_t validEnd = HEADER_SIZE;
+    for (;;)
+    {
+        std::uint32_t length = 0, crc = 0;
+        if (!reader.readU32(length) || !reader.readU32(crc) || reader.remaining() < length)
+        {
+            break;
+        }
+        const char *payload = reader.position();
+        if (computeCrc32(payload, length) != crc)
+        {
+            break;
+        }
+        StoredOrder summary;
+        BinaryReader record(payload, length);
+        if (!readSummary(record, summary))
+        {
+            break;
+        }
+        RecordRef ref;
+        ref.offset = static_cast<std::uint64_t>(payload - base);
+        ref.length = length;
+        indexRecord(summary, ref);
+        ++recordCount;
+        reader.skip(length);
+        validEnd = ref.offset + length;
+    }
+
+    if (validEnd < mapping.getSize())
+    {
+        std::cout << "[ORDER STORE] Dropping " << (mapping.getSize() - validEnd)
+                  << " bytes of incomplete or corrupt records from the end of " << path << "." << std::endl;
+        if (!rewritePrefix(validEnd))
+        {
+            closeLocked();
+            return false;
+        }
+    }
+    logSize = validEnd;
+
+    appendStream.open(path.c_str(), std::ios::binary | std::ios::app);
+    if (!appendStream)
+    {
+        std::cout << "[ORDER STORE] Cannot open " << path << " for appending." << std::endl;
+        closeLocked();
+        return false;
+    }
+
+    std::cout << "[ORDER STORE] Opened " << path << " with " << latestById.size() << " orders (" << recordCount
+              << " records)." << std::endl;
+    return true;
+}
+
+// Keeps only the first validBytes of the log, rewritten beside it and moved into place like a snapshot
+bool OrderStore::rewritePrefix(std::uint64_t validBytes)
+{
+    std::string kept(mapping.getData(), static_cast<std::size_t>(validBytes));
+    mapping.close();
+
+    if (!writeFileAtomically(path, kept) || !mapping.open(path))
+    {
+        std::cout << "[ORDER STORE] Failed to move repaired log into place at " << path << "." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void OrderStore::close()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    closeLocked();
+}
+
+void OrderStore::closeLocked()
+{
+    if (appendStream.is_open())
+    {
+        appendStream.close();
+    }
+    appendStream.clear();
+    mapping.close();
+    latestById.clear();
+    idsByCustomer.clear();
+    idsByDate.clear();
+    logSize = 0;
+    recordCount = 0;
+    path.clear();
+}
+
+bool OrderStore::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return appendStream.is_open();
+}
+
+void OrderStore::indexRecord(const StoredOrder &summary, const RecordRef &ref)
+{
+    std::pair<std::unordered_map<std::string, IndexEntry>::iterator, bool> inserted =
+        latestById.insert(std::make_pair(summary.orderId, IndexEntry()));
+    IndexEntry &entry = inserted.first->second;
+    entry.ref = ref; // a later record of the same order supersedes the earlier one
+    if (!inserted.second && entry.customerName == summary.customerName && entry.orderDate == summary.orderDate)
+    {
+        return;
+    }
+
+    // New order, or a later record changed its customer or date (setOrderDate(), a memento restore)
+    if (!inserted.second)
+    {
+        unfileFromKeys(summary.orderId, entry);
+    }
+    entry.customerName = summary.customerName;
+    entry.orderDate = summary.orderDate;
+    fileUnderKeys(summary.orderId, summary.customerName, summary.orderDate);
+}
+
+void OrderStore::fileUnderKeys(const std::string &orderId, const std::string &customerName,
+                               const std::string &orderDate)
+{
+    idsByCustomer[customerName].push_back(orderId);
+    idsByDate.insert(std::make_pair(orderDate, orderId));
+}
+
+void OrderStore::unfileFromKeys(const std::string &orderId, const IndexEntry &entry)
+{
+    std::unordered_map<std::string, std::vector<std::string> >::iterator customer =
+        idsByCustomer.find(entry.customerName);
+    if (customer != idsByCustomer.end())
+    {
+        std::vector<std::string> &ids = customer->second;
+        ids.erase(std::remove(ids.begin(), ids.end(), orderId), ids.end());
+        if (ids.empty())
+        {
+            idsByCustomer.erase(customer);
+        }
+    }
+    std::pair<std::multimap<std::string, std::string>::iterator, std::multimap<std::string, std::string>::iterator>
+        dated = idsByDate.equal_range(entry.orderDate);
+    for (std::multimap<std::string, std::string>::iterator it = dated.first; it != dated.second; ++it)
+    {
+        if (it->second == orderId)
+        {
+            idsByDate.erase(it);
+            break;
+        }
+    }
+}
+
+bool OrderStore::append(const Order &order)
+{
+    // Encode outside the lock; only the write and index update are serialised
+    OrderMemento *memento = order.createMemento();
+    std::string state = memento->getState();
+    delete memento;
+
+    StoredOrder summary;
+    summary.orderId = order.getOrderId();
+    summary.customerName = order.getCustomerName();
+    summary.orderDate = order.getOrderDate();
+    summary.status = order.getStatus();
+    summary.totalAmount = order.getTotalAmount();
+    summary.itemCount = order.getItemCount();
+
+    std::string payload;
+    BinaryWriter writer(payload);
+    writer.writeString(summary.orderId);
+    writer.writeString(summary.customerName);
+    writer.writeString(summary.orderDate);
+    writer.writeString(summary.status);
+    writer.writeDouble(summary.totalAmount);
+    writer.writeU32(static_cast<std::uint32_t>(summary.itemCount));
+    writer.writeString(state);
+
+    std::string record;
+    record.reserve(RECORD_PREFIX_SIZE + payload.size());
+    BinaryWriter recordWriter(record);
+    recordWriter.writeU32(static_cast<std::uint32_t>(payload.size()));
+    recordWriter.writeU32(computeCrc32(payload.data(), payload.size()));
+    recordWriter.writeBytes(payload.data(), payload.size());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!appendStream.is_open())
+    {
+        return false;
+    }
+    appendStream.write(record.data(), static_cast<std::streamsize>(record.size()));
+    appendStream.flush();
+    if (!appendStream)
+    {
+        std::cout << "[ORDER STORE] Failed appending order " << summary.orderId << " to " << path << "." << std::endl;
+        return false;
+    }
+
+    RecordRef ref;
+    ref.offset = logSize + RECORD_PREFIX_SIZE;
+    ref.length = static_cast<std::uint32_t>(payload.size());
+    logSize += record.size();
+    ++recordCount;
+    indexRecord(summary, ref);
+    return true;
+}
+
+bool OrderStore::readRecord(const RecordRef &ref, StoredOrder &summary, std::string *memento) const
+{
+    // Records appended since the last mapping are picked up by remapping the (larger) file
+    if (ref.offset + ref.length > mapping.getSize() && !mapping.open(path))
+    {
+        return false;
+    }
+    if (ref.offset + ref.length > mapping.getSize())
+    {
+        return false;
+    }
+    BinaryReader reader(mapping.getData() + ref.offset, ref.length);
+    if (!readSummary(reader, summary))
+    {
+        return false;
+    }
+    return !memento || reader.readString(*memento);
+}
+
+bool OrderStore::findOrder(const std::string &orderId, StoredOrder &out) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<std::string, IndexEntry>::const_iterator it = latestById.find(orderId);
+    return it != latestById.end() && readRecord(it->second.ref, out, nullptr);
+}
+
+bool OrderStore::restoreOrder(const std::string &orderId, Order &into) const
+{
+    StoredOrder summary;
+    std::string state;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unordered_map<std::string, IndexEntry>::const_iterator it = latestById.find(orderId);
+        if (it == latestById.end() || !readRecord(it->second.ref, summary, &state))
+        {
+            return false;
+        }
+    }
+    return OrderMementoCodec::decode(state, into);
+}
+
+std::vector<StoredOrder> OrderStore::getOrdersForCustomer(const std::string &customerName) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<StoredOrder> orders;
+    std::unordered_map<std::string, std::vector<std::string> >::const_iterator ids = idsByCustomer.find(customerName);
+    if (ids == idsByCustomer.end())
+    {
+        return orders;
+    }
+    orders.reserve(ids->second.size());
+    for (const std::string &orderId : ids->second)
+    {
+        StoredOrder summary;
+        if (readRecord(latestById.find(orderId)->second.ref, summary, nullptr))
+        {
+            orders.push_back(summary);
+        }
+    }
+    return orders;
+}
+
+std::vector<StoredOrder> OrderStore::getOrdersBetween(const std::string &from, const std::string &to) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<StoredOrder> orders;
+    // Date strings only use characters below DEL, so this bound includes every date starting with `to`
+    std::multimap<std::string, std::string>::const_iterator end = idsByDate.upper_bound(to + '\x7f');
+    for (std::multimap<std::string, std::string>::const_iterator it = idsByDate.lower_bound(from); it != end; ++it)
+    {
+        StoredOrder summary;
+        if (readRecord(latestById.find(it->second)->second.ref, summary, nullptr))
+        {
+            orders.push_back(summary);
+        }
+    }
+    return orders;
+}
+
+std::size_t OrderStore::getOrderCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return latestById.size();
+}
+
+std::size_t OrderStore::getRecordCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return recordCount;
+}
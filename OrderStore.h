@@ -0,0 +1,132 @@
+#ifndef ORDER_STORE_H
+#define ORDER_STORE_H
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Order;
+
+/**
+ * @brief Summary of one order as last written to the OrderStore
+ */
+struct StoredOrder
+{
+    std::string orderId;
+    std::string customerName;
+    std::string orderDate;
+    std::string status;
+    double totalAmount;
+    int itemCount;
+
+    StoredOrder() : totalAmount(0.0), itemCount(0) {}
+};
+
+/**
+ * @class OrderStore
+ * @brief Durable, append-only log of orders with ID, customer and date indexes
+ *
+ * Every append writes one checksummed record holding the order's summary and
+ * its full memento encoding (see OrderMementoCodec); appending the same order
+ * again records its new state, and lookups always see the latest record.
+ * The log is read back through a memory mapping: open() scans it once to
+ * rebuild the in-memory indexes, after which any past order is found by a
+ * hash lookup plus a read of its single record.
+ *
+ * File layout (version 1, host byte order):
+ * @code
+ * header : "GHORDLOG" | u32 version | u32 endian marker
+ * record : u32 payload bytes | u32 CRC-32 of payload | payload
+ * payload: orderId | customerName | orderDate | status | f64 total
+ *          | u32 itemCount | memento
+ * @endcode
+ * A torn or corrupt record (e.g. from a crash mid-append) ends the log: it and
+ * anything after it are dropped the next time the store is opened.
+ *
+ * Singleton like InventoryManager; appends are ignored until open() succeeds.
+ */
+class OrderStore
+{
+private:
+    struct RecordRef
+    {
+        std::uint64_t offset; // start of the payload
+        std::uint32_t length;
+    };
+
+    // The latest record of an order and the keys it is currently filed under
+    struct IndexEntry
+    {
+        RecordRef ref;
+        std::string customerName;
+        std::string orderDate;
+    };
+
+    std::string path;
+    std::ofstream appendStream;
+    std::uint64_t logSize;
+    std::size_t recordCount;
+    mutable MappedFile mapping; // remapped lazily when a lookup reaches past it
+
+    std::unordered_map<std::string, IndexEntry> latestById;
+    std::unordered_map<std::string, std::vector<std::string> > idsByCustomer; // order first filed under the name
+    std::multimap<std::string, std::string> idsByDate;
+
+    mutable std::mutex mutex;
+
+    OrderStore();
+    ~OrderStore();
+
+    void closeLocked();
+    void indexRecord(const StoredOrder &summary, const RecordRef &ref);
+    void fileUnderKeys(const std::string &orderId, const std::string &customerName, const std::string &orderDate);
+    void unfileFromKeys(const std::string &orderId, const IndexEntry &entry);
+    bool readRecord(const RecordRef &ref, StoredOrder &summary, std::string *memento) const;
+    bool rewritePrefix(std::uint64_t validBytes);
+
+public:
+    static const unsigned int FORMAT_VERSION = 1;
+
+    OrderStore(const OrderStore &) = delete;
+    OrderStore &operator=(const OrderStore &) = delete;
+
+    static OrderStore &getInstance();
+
+    /**
+     * @brief Opens (or creates) the log and rebuilds the indexes from it
+     * @return false if the file cannot be created or is not an order log
+     */
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const;
+
+    /** @brief Appends the order's current state; returns false if the store is closed or the write failed */
+    bool append(const Order &order);
+
+    /** @brief Latest recorded state of an order, in constant time */
+    bool findOrder(const std::string &orderId, StoredOrder &out) const;
+
+    /** @brief Rebuilds the full item tree of a past order into `into` */
+    bool restoreOrder(const std::string &orderId, Order &into) const;
+
+    std::vector<StoredOrder> getOrdersForCustomer(const std::string &customerName) const;
+
+    /**
+     * @brief Orders placed between two dates, oldest first
+     * @param from Inclusive lower bound, e.g. "2025-01-01"
+     * @param to Inclusive upper bound; matched as a prefix, so "2025-01-31" covers that whole day
+     */
+    std::vector<StoredOrder> getOrdersBetween(const std::string &from, const std::string &to) const;
+
+    std::size_t getOrderCount() const;
+    std::size_t getRecordCount() const;
+};
+
+#endif // ORDER_STORE_H
@@ -53,8 +53,8 @@ int OrderUIFacade::countTotalPlantsInOrder(ConcreteOrderBuilder* builder) const
         return 0;
     }
     
-    // Get temporary order to count plants
-    Order* tempOrder = builder->getOrder();
+    // Look at the cart without taking it from the builder
+    Order* tempOrder = builder->getCurrentOrder();
     if (!tempOrder) {
         return 0;
     }
@@ -89,8 +89,8 @@ void OrderUIFacade::viewCurrentOrder() {
         return;
     }
     
-    // Get temporary order to display
-    Order* tempOrder = builder->getOrder();
+    // Get the cart to display (still owned by the builder)
+    Order* tempOrder = builder->getCurrentOrder();
     
     // Delegate to TerminalUI for order display
     TerminalUI::displayCurrentOrder(tempOrder);
@@ -145,6 +145,7 @@ bool OrderUIFacade::addPlantToOrderWithAutoDiscount(int plantIndex, int quantity
     ConcreteOrderBuilder* builder = customer->getOrderBuilder();
     if (builder) {
         builder->buildPlant(plantType, quantity);
+        TerminalUI::displayCartStock(builder->getCurrentOrder());
         
         // Calculate and show potential discount after addition
         int newPlantCount = countTotalPlantsInOrder(builder);
@@ -215,6 +216,7 @@ bool OrderUIFacade::addBundleToOrderWithAutoDiscount(const std::string& bundleNa
         }
         
         std::cout << "[BUNDLE] Bundle created successfully with automatic discount!" << std::endl;
+        TerminalUI::displayCartStock(builder->getCurrentOrder());
         return true;
     }
     
@@ -3,14 +3,18 @@
 
 #include "OrderProcessHandler.h"
 #include "InventoryManager.h"
-#include "SinglePlant.h"
-#include "PlantBundle.h"
+#include "CartDemandTracker.h"
+#include <cstdint>
 #include <vector>
 #include <string>
 
 /**
  * @brief Concrete handler for order validation
- * Validates that all items in the order are available in inventory
+ * Validates that all items in the order are available in inventory and holds
+ * them for the order (see InventoryManager::reserveOrder) until payment
+ * commits or releases the reservation. A cart whose demand was tracked while
+ * it was built (see CartDemandTracker) is turned away on the tracker's word
+ * when it is short, without touching the inventory
  */
 class OrderValidationHandler : public OrderProcessHandler {
 private:
@@ -37,111 +41,81 @@ protected:
         }
         
         InventoryManager& inventory = InventoryManager::getInstance();
-        auto availablePlants = inventory.getReadyForSalePlants();
+        int plantsOnFloor = inventory.getPlantCount(InventoryManager::ON_SALES_FLOOR);
         
-        logStep("Available plants in sales floor: " + std::to_string(availablePlants.size()));
+        logStep("Available plants in sales floor: " + std::to_string(plantsOnFloor));
         
-        if (availablePlants.empty()) {
+        if (plantsOnFloor == 0) {
             std::string error = "No plants are currently available on the sales floor. Please check back later or contact staff for assistance.";
             validationErrors.push_back(error);
             std::cout << "\n[VALIDATION ERROR] " << error << std::endl;
             return false;
         }
         
-        // Validate each order item
-        bool allValid = true;
-        for (const auto* orderItem : order->getOrderItems()) {
-            if (!validateOrderItem(orderItem, availablePlants)) {
-                allValid = false;
+        // A re-validated order gives back what it held before claiming its current demand
+        if (order->getReservationId() != 0) {
+            inventory.releaseReservation(order->getReservationId());
+            order->setReservationId(0);
+        }
+        
+        // A tracked cart already knows its shortages; only stock that moved since the last edit is re-read
+        CartDemandTracker* tracker = order->getDemandTracker();
+        if (tracker && !tracker->isSatisfiable()) {
+            for (const auto& shortage : tracker->getShortages()) {
+                reportShortage(shortage);
             }
+            reportFailure();
+            return false;
+        }
+        
+        // One pass over the order's per-species and per-pot totals, checked and held in the same step
+        const FlattenedOrder& flat = order->getFlattened();
+        std::vector<InventoryManager::StockShortage> shortages;
+        std::uint64_t reservationId = inventory.reserveOrder(flat, &shortages);
+        bool allValid = reservationId != 0;
+        for (const auto& shortage : shortages) {
+            reportShortage(shortage);
         }
         
         if (!allValid) {
-            std::cout << "\n╔════════════════════════════════════════╗" << std::endl;
-            std::cout << "║     VALIDATION FAILED                 ║" << std::endl;
-            std::cout << "╚════════════════════════════════════════╝" << std::endl;
-            std::cout << "\nThe following issues were found with your order:\n" << std::endl;
-            for (size_t i = 0; i < validationErrors.size(); i++) {
-                std::cout << (i+1) << ". " << validationErrors[i] << std::endl;
-            }
-            std::cout << "\nPlease modify your order and try again." << std::endl;
+            reportFailure();
             return false;
         }
         
-        logStep("✓ All items are available in inventory");
+        // The stock is held now; a cart edited after this is tracked afresh
+        order->stopTrackingDemand();
+        order->setReservationId(reservationId);
+        logStep("✓ All items are available in inventory (" + std::to_string(flat.getPlantUnits()) +
+               " plants across " + std::to_string(flat.getSpeciesDemand().size()) + " species reserved)");
         order->setStatus("Validated");
         return true;
     }
     
 private:
-    bool validateOrderItem(const OrderItem* item, const std::vector<PlantProduct*>& availablePlants) {
-        // Check if it's a SinglePlant
-        if (const SinglePlant* singlePlant = dynamic_cast<const SinglePlant*>(item)) {
-            return validateSinglePlant(singlePlant, availablePlants);
-        }
-        // Check if it's a PlantBundle
-        else if (const PlantBundle* bundle = dynamic_cast<const PlantBundle*>(item)) {
-            return validatePlantBundle(bundle, availablePlants);
-        }
-        
-        std::string error = "Unknown order item type encountered.";
-        validationErrors.push_back(error);
-        logStep("ERROR: " + error);
-        return false;
-    }
-    
-    bool validateSinglePlant(const SinglePlant* plant, const std::vector<PlantProduct*>& availablePlants) {
-        std::string plantType = plant->getPlantType();
-        int requiredQuantity = plant->getQuantity();
-        int availableCount = 0;
-        
-        // Count available plants of this type
-        for (const auto* availablePlant : availablePlants) {
-            if (availablePlant->getProfile() && 
-                availablePlant->getProfile()->getSpeciesName() == plantType) {
-                availableCount++;
-            }
-        }
-        
-        if (availableCount >= requiredQuantity) {
-            logStep("✓ " + plantType + ": " + std::to_string(requiredQuantity) + 
-                   " required, " + std::to_string(availableCount) + " available");
-            return true;
-        } else {
-            std::string error;
-            if (availableCount == 0) {
-                error = "'" + plantType + "' is currently out of stock. We don't have any available at the moment.";
-            } else {
-                error = "Insufficient '" + plantType + "' plants available. You requested " + 
-                       std::to_string(requiredQuantity) + " but we only have " + 
-                       std::to_string(availableCount) + " in stock.";
-            }
-            validationErrors.push_back(error);
-            std::cout << "  [✗] " << error << std::endl;
-            return false;
+    void reportFailure() const {
+        std::cout << "\n╔════════════════════════════════════════╗" << std::endl;
+        std::cout << "║     VALIDATION FAILED                 ║" << std::endl;
+        std::cout << "╚════════════════════════════════════════╝" << std::endl;
+        std::cout << "\nThe following issues were found with your order:\n" << std::endl;
+        for (size_t i = 0; i < validationErrors.size(); i++) {
+            std::cout << (i+1) << ". " << validationErrors[i] << std::endl;
         }
+        std::cout << "\nPlease modify your order and try again." << std::endl;
     }
     
-    bool validatePlantBundle(const PlantBundle* bundle, const std::vector<PlantProduct*>& availablePlants) {
-        logStep("Validating bundle: " + bundle->getName());
-        
-        bool bundleValid = true;
-        // Validate all items in the bundle
-        for (const auto* bundleItem : bundle->getItems()) {
-            if (!validateOrderItem(bundleItem, availablePlants)) {
-                bundleValid = false;
-            }
-        }
-        
-        if (bundleValid) {
-            logStep("✓ Bundle '" + bundle->getName() + "' validation completed");
+    void reportShortage(const InventoryManager::StockShortage& shortage) {
+        const char* noun = shortage.isPot ? " pots" : " plants";
+        std::string error;
+        if (shortage.available <= 0) {
+            error = "'" + shortage.itemType + "'" + (shortage.isPot ? " pots are" : " is") +
+                   " currently out of stock. We don't have any available at the moment.";
         } else {
-            std::string error = "Bundle '" + bundle->getName() + "' contains items that are not available.";
-            // Don't add to validationErrors as individual items already added their errors
-            logStep("✗ " + error);
+            error = "Insufficient '" + shortage.itemType + "'" + noun + " available. You requested " + 
+                   std::to_string(shortage.requested) + " but we only have " + 
+                   std::to_string(shortage.available) + " in stock.";
         }
-        
-        return bundleValid;
+        validationErrors.push_back(error);
+        std::cout << "  [✗] " << error << std::endl;
     }
 };
 
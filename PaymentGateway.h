@@ -0,0 +1,52 @@
+#ifndef PAYMENT_GATEWAY_H
+#define PAYMENT_GATEWAY_H
+
+#include "PaymentProcessor.h"
+
+#include <functional>
+#include <string>
+
+/**
+ * @class PaymentGateway
+ * @brief Non-blocking connection to an external payment provider
+ *
+ * Unlike PaymentProcessor, which blocks until the charge is done, charge()
+ * returns at once and the gateway answers later through a callback. It
+ * separates a decline (the provider said no) from the provider being
+ * unavailable, so callers know which failures are worth retrying. See
+ * AsyncPaymentProcessor for timeouts and retries on top of a gateway.
+ */
+class PaymentGateway
+{
+public:
+    enum Response
+    {
+        APPROVED,
+        DECLINED,
+        UNAVAILABLE // transient: the same charge may succeed if retried
+    };
+
+    typedef std::function<void(Response response, const std::string &reference)> Callback;
+
+    virtual ~PaymentGateway() {}
+
+    /**
+     * @brief Starts a charge; `done` is called at most once, on any thread
+     *
+     * Every attempt at the same payment carries the same idempotency key, so
+     * a provider that already approved it answers with the original reference
+     * instead of charging again. A gateway may never answer (a lost
+     * response); callers have to time out.
+     */
+    virtual void charge(const PaymentRequest &request, const std::string &idempotencyKey, const Callback &done) = 0;
+
+    /**
+     * @brief Gives back an approved charge, e.g. one approved after the caller had given up on it
+     *
+     * Returns at once. Reversing a charge twice, or one that was never
+     * approved, does nothing.
+     */
+    virtual void reverse(const std::string &reference, const std::string &idempotencyKey) = 0;
+};
+
+#endif // PAYMENT_GATEWAY_H
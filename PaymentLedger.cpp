@@ -0,0 +1,732 @@
+#include "PaymentLedger.h"
+#include "AtomicFile.h"
+#include "BinaryCodec.h"
+#include "OrderStore.h"
+#include "SettlementEngine.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    const char LEDGER_MAGIC[8] = {'G', 'H', 'L', 'E', 'D', 'G', 'E', 'R'};
+    const std::size_t HEADER_SIZE = sizeof(LEDGER_MAGIC) + 2 * sizeof(std::uint32_t);
+    const std::size_t RECORD_PREFIX_SIZE = 2 * sizeof(std::uint32_t); // length + CRC
+
+    // Methods are stored as one byte; index 0 is an unknown method
+    const char *const METHOD_NAMES[] = {"", "CASH", "CREDIT_CARD", "EFT", "GATEWAY"};
+    const std::uint8_t METHOD_COUNT = sizeof(METHOD_NAMES) / sizeof(METHOD_NAMES[0]);
+
+    std::uint8_t methodCode(const std::string &method)
+    {
+        for (std::uint8_t code = 1; code < METHOD_COUNT; ++code)
+        {
+            if (method == METHOD_NAMES[code])
+            {
+                return code;
+            }
+        }
+        return 0;
+    }
+
+    LedgerEntry::Account clearingAccount(const std::string &method)
+    {
+        if (method == "CASH")
+        {
+            return LedgerEntry::CASH_ON_HAND;
+        }
+        if (method == "CREDIT_CARD")
+        {
+            return LedgerEntry::CARD_CLEARING;
+        }
+        return method == "EFT" ? LedgerEntry::EFT_CLEARING : LedgerEntry::GATEWAY_CLEARING;
+    }
+
+    std::int64_t toCents(double amount)
+    {
+        return static_cast<std::int64_t>(std::llround(amount * 100.0));
+    }
+
+    std::string formatCents(std::int64_t cents)
+    {
+        char buf[32];
+        std::int64_t whole = cents / 100;
+        std::int64_t fraction = cents % 100;
+        std::snprintf(buf, sizeof(buf), "%s%lld.%02lld", cents < 0 ? "-" : "",
+                      static_cast<long long>(whole < 0 ? -whole : whole),
+                      static_cast<long long>(fraction < 0 ? -fraction : fraction));
+        return buf;
+    }
+
+    LedgerEntry::Posting posting(LedgerEntry::Account account, std::int64_t cents)
+    {
+        LedgerEntry::Posting p;
+        p.account = account;
+        p.cents = cents;
+        return p;
+    }
+
+    void encodePayload(const LedgerEntry &entry, std::string &payload)
+    {
+        BinaryWriter writer(payload);
+        writer.writeU64(entry.sequence);
+        writer.writeU64(entry.recordedAtMillis);
+        writer.writeU8(static_cast<std::uint8_t>(entry.kind));
+        writer.writeU8(methodCode(entry.method));
+        writer.writeString(entry.reference);
+        writer.writeString(entry.orderId);
+        writer.writeString(entry.customerId);
+        writer.writeI64(entry.amountCents);
+        writer.writeI32(entry.plantUnits);
+        writer.writeU8(static_cast<std::uint8_t>(entry.postings.size()));
+        for (const LedgerEntry::Posting &p : entry.postings)
+        {
+            writer.writeU8(static_cast<std::uint8_t>(p.account));
+            writer.writeI64(p.cents);
+        }
+    }
+
+    bool decodePayload(BinaryReader &reader, LedgerEntry &entry)
+    {
+        std::uint8_t kind = 0, method = 0, count = 0;
+        if (!reader.readU64(entry.sequence) || !reader.readU64(entry.recordedAtMillis) || !reader.readU8(kind) ||
+            !reader.readU8(method) || !reader.readString(entry.reference) || !reader.readString(entry.orderId) ||
+            !reader.readString(entry.customerId) || !reader.readI64(entry.amountCents) ||
+            !reader.readI32(entry.plantUnits) || !reader.readU8(count) || kind < LedgerEntry::PAYMENT ||
+            kind > LedgerEntry::SETTLEMENT)
+        {
+            return false;
+        }
+        entry.kind = static_cast<LedgerEntry::Kind>(kind);
+        entry.method = METHOD_NAMES[method < METHOD_COUNT ? method : 0];
+        entry.postings.clear();
+        for (std::uint8_t i = 0; i < count; ++i)
+        {
+            std::uint8_t account = 0;
+            std::int64_t cents = 0;
+            if (!reader.readU8(account) || !reader.readI64(cents) || account >= LedgerEntry::ACCOUNT_COUNT)
+            {
+                return false;
+            }
+            entry.postings.push_back(posting(static_cast<LedgerEntry::Account>(account), cents));
+        }
+        return true;
+    }
+
+    // A length-prefixed string left in place in the mapping
+    bool readStringRef(BinaryReader &reader, const char *&data, std::uint32_t &length)
+    {
+        if (!reader.readU32(length))
+        {
+            return false;
+        }
+        data = reader.position();
+        return reader.skip(length);
+    }
+}
+
+LedgerReconciliation::LedgerReconciliation()
+    : entriesScanned(0), ordersChecked(0), matched(0), matchedCents(0), plantUnitsPaid(0), plantsSold(0), millis(0.0)
+{
+    std::fill(balances, balances + LedgerEntry::ACCOUNT_COUNT, 0);
+}
+
+const char *LedgerReconciliation::getKindName(Discrepancy::Kind kind)
+{
+    switch (kind)
+    {
+    case Discrepancy::UNBALANCED_ENTRY:
+        return "Unbalanced entry";
+    case Discrepancy::CORRUPT_RECORD:
+        return "Corrupt record";
+    case Discrepancy::AMOUNT_MISMATCH:
+        return "Amount mismatch";
+    case Discrepancy::PAID_NOT_IN_LEDGER:
+        return "Paid order missing from the ledger";
+    case Discrepancy::PAYMENT_FOR_UNPAID_ORDER:
+        return "Payment kept for an incomplete order";
+    case Discrepancy::NO_MATCHING_ORDER:
+        return "No matching order";
+    default:
+        return "Unknown";
+    }
+}
+
+void LedgerReconciliation::print(std::ostream &out) const
+{
+    out << "[LEDGER] Reconciliation: " << entriesScanned << " entries in " << millis << " ms, " << ordersChecked
+        << " orders checked, " << matched << " matched (R" << formatCents(matchedCents) << "), " << plantUnitsPaid
+        << " plants paid for vs " << plantsSold << " sold, " << discrepancies.size() << " discrepancies" << std::endl;
+    out << "  Balances:";
+    for (int account = 0; account < LedgerEntry::ACCOUNT_COUNT; ++account)
+    {
+        out << " " << PaymentLedger::getAccountName(static_cast<LedgerEntry::Account>(account)) << " R"
+            << formatCents(balances[account]);
+    }
+    out << std::endl;
+    for (const Discrepancy &d : discrepancies)
+    {
+        out << "  " << getKindName(d.kind) << ": order " << (d.orderId.empty() ? "(none)" : d.orderId)
+            << ", entry " << (d.reference.empty() ? "(none)" : d.reference) << ", order total R"
+            << formatCents(d.orderCents) << ", ledger R" << formatCents(d.ledgerCents) << std::endl;
+    }
+}
+
+PaymentLedger::PaymentLedger() : logSize(0), nextSequence(1), entryCount(0)
+{
+    std::fill(balances, balances + LedgerEntry::ACCOUNT_COUNT, 0);
+}
+
+PaymentLedger::~PaymentLedger()
+{
+    closeLocked();
+}
+
+PaymentLedger &PaymentLedger::getInstance()
+{
+    static PaymentLedger instance;
+    return instance;
+}
+
+const char *PaymentLedger::getAccountName(LedgerEntry::Account account)
+{
+    switch (account)
+    {
+    case LedgerEntry::CASH_ON_HAND:
+        return "Cash on hand";
+    case LedgerEntry::CARD_CLEARING:
+        return "Card clearing";
+    case LedgerEntry::EFT_CLEARING:
+        return "EFT clearing";
+    case LedgerEntry::GATEWAY_CLEARING:
+        return "Gateway clearing";
+    case LedgerEntry::BANK:
+        return "Bank";
+    case LedgerEntry::SALES_REVENUE:
+        return "Sales revenue";
+    default:
+        return "Unknown";
+    }
+}
+
+bool PaymentLedger::open(const std::string &ledgerPath)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    closeLocked();
+
+    // A missing or empty file becomes a new ledger
+    if (!mapping.open(ledgerPath) || mapping.getSize() == 0)
+    {
+        mapping.close();
+        std::string header;
+        BinaryWriter writer(header);
+        writer.writeBytes(LEDGER_MAGIC, sizeof(LEDGER_MAGIC));
+        writer.writeU32(FORMAT_VERSION);
+        writer.writeU32(BINARY_ENDIAN_MARKER);
+        std::ofstream out(ledgerPath.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+        out.close();
+        if (!out || !mapping.open(ledgerPath))
+        {
+            std::cout << "[LEDGER] Cannot create payment ledger at " << ledgerPath << "." << std::endl;
+            return false;
+        }
+    }
+
+    std::uint32_t version = 0, endian = 0;
+    BinaryReader header(mapping.getData(), mapping.getSize());
+    if (mapping.getSize() < HEADER_SIZE || std::memcmp(mapping.getData(), LEDGER_MAGIC, sizeof(LEDGER_MAGIC)) != 0 ||
+        !header.skip(sizeof(LEDGER_MAGIC)) || !header.readU32(version) || !header.readU32(endian) ||
+        version != FORMAT_VERSION || endian != BINARY_ENDIAN_MARKER)
+    {
+        std::cout << "[LEDGER] " << ledgerPath << " is not a version " << FORMAT_VERSION << " payment ledger."
+                  << std::endl;
+        mapping.close();
+        return false;
+    }
+    path = ledgerPath;
+
+    // Single forward pass: rebuilds the indexes and balances, stopping at the first record that does not check out
+    const char *base = mapping.getData();
+    BinaryReader reader(base + HEADER_SIZE, mapping.getSize() - HEADER_SIZE);
+    std::uint64_t validEnd = HEADER_SIZE;
+    LedgerEntry entry;
+    for (;;)
+    {
+        std::uint32_t length = 0, crc = 0;
+        if (!reader.readU32(length) || !reader.readU32(crc) || reader.remaining() < length)
+        {
+            break;
+        }
+        const char *payload = reader.position();
+        BinaryReader record(payload, length);
+        if (computeCrc32(payload, length) != crc || !decodePayload(record, entry))
+        {
+            break;
+        }
+        RecordRef ref;
+        ref.offset = static_cast<std::uint64_t>(payload - base);
+        ref.length = length;
+        ref.kind = static_cast<std::uint8_t>(entry.kind);
+        indexEntry(entry, ref);
+        if (entry.sequence >= nextSequence)
+        {
+            nextSequence = entry.sequence + 1;
+        }
+        reader.skip(length);
+        validEnd = ref.offset + length;
+    }
+
+    if (validEnd < mapping.getSize())
+    {
+        std::cout << "[LEDGER] Dropping " << (mapping.getSize() - validEnd)
+                  << " bytes of incomplete or corrupt records from the end of " << path << "." << std::endl;
+        if (!rewritePrefix(validEnd))
+        {
+            closeLocked();
+            return false;
+        }
+    }
+    logSize = validEnd;
+
+    appendStream.open(path.c_str(), std::ios::binary | std::ios::app);
+    if (!appendStream)
+    {
+        std::cout << "[LEDGER] Cannot open " << path << " for appending." << std::endl;
+        closeLocked();
+        return false;
+    }
+
+    std::cout << "[LEDGER] Opened " << path << " with " << entryCount << " entries." << std::endl;
+    return true;
+}
+
+// Keeps only the first validBytes of the ledger, rewritten beside it and moved into place
+bool PaymentLedger::rewritePrefix(std::uint64_t validBytes)
+{
+    std::string kept(mapping.getData(), static_cast<std::size_t>(validBytes));
+    mapping.close();
+
+    if (!writeFileAtomically(path, kept) || !mapping.open(path))
+    {
+        std::cout << "[LEDGER] Failed to move repaired ledger into place at " << path << "." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void PaymentLedger::close()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    closeLocked();
+}
+
+void PaymentLedger::closeLocked()
+{
+    if (appendStream.is_open())
+    {
+        appendStream.close();
+    }
+    appendStream.clear();
+    mapping.close();
+    byReference.clear();
+    byOrder.clear();
+    std::fill(balances, balances + LedgerEntry::ACCOUNT_COUNT, 0);
+    logSize = 0;
+    nextSequence = 1;
+    entryCount = 0;
+    path.clear();
+}
+
+bool PaymentLedger::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return appendStream.is_open();
+}
+
+void PaymentLedger::indexEntry(const LedgerEntry &entry, const RecordRef &ref)
+{
+    if (!entry.reference.empty())
+    {
+        byReference[entry.reference].push_back(ref);
+    }
+    if (!entry.orderId.empty())
+    {
+        byOrder[entry.orderId].push_back(ref);
+    }
+    for (const LedgerEntry::Posting &p : entry.postings)
+    {
+        balances[p.account] += p.cents;
+    }
+    ++entryCount;
+}
+
+bool PaymentLedger::appendLocked(LedgerEntry &entry)
+{
+    if (!appendStream.is_open())
+    {
+        return false;
+    }
+    entry.sequence = nextSequence;
+    entry.recordedAtMillis = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                            std::chrono::system_clock::now().time_since_epoch())
+                                                            .count());
+
+    std::string payload;
+    encodePayload(entry, payload);
+    std::string record;
+    record.reserve(RECORD_PREFIX_SIZE + payload.size());
+    BinaryWriter writer(record);
+    writer.writeU32(static_cast<std::uint32_t>(payload.size()));
+    writer.writeU32(computeCrc32(payload.data(), payload.size()));
+    writer.writeBytes(payload.data(), payload.size());
+
+    appendStream.write(record.data(), static_cast<std::streamsize>(record.size()));
+    appendStream.flush();
+    if (!appendStream)
+    {
+        std::cout << "[LEDGER] Failed appending entry " << entry.sequence << " to " << path << "." << std::endl;
+        return false;
+    }
+
+    RecordRef ref;
+    ref.offset = logSize + RECORD_PREFIX_SIZE;
+    ref.length = static_cast<std::uint32_t>(payload.size());
+    ref.kind = static_cast<std::uint8_t>(entry.kind);
+    logSize += record.size();
+    ++nextSequence;
+    indexEntry(entry, ref);
+    return true;
+}
+
+bool PaymentLedger::recordPayment(const std::string &method, const std::string &reference, const std::string &orderId,
+                                  const std::string &customerId, double amount, int plantUnits)
+{
+    LedgerEntry entry;
+    entry.kind = LedgerEntry::PAYMENT;
+    entry.method = method;
+    entry.reference = reference;
+    entry.orderId = orderId;
+    entry.customerId = customerId;
+    entry.amountCents = toCents(amount);
+    entry.plantUnits = plantUnits;
+    entry.postings.push_back(posting(clearingAccount(method), entry.amountCents));
+    entry.postings.push_back(posting(LedgerEntry::SALES_REVENUE, -entry.amountCents));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return appendLocked(entry);
+}
+
+bool PaymentLedger::recordDecline(const std::string &method, const std::string &orderId,
+                                  const std::string &customerId, double amount)
+{
+    LedgerEntry entry;
+    entry.kind = LedgerEntry::DECLINE;
+    entry.method = method;
+    entry.orderId = orderId;
+    entry.customerId = customerId;
+    entry.amountCents = toCents(amount);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return appendLocked(entry);
+}
+
+bool PaymentLedger::recordVoid(const std::string &reference)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<std::string, std::vector<RecordRef> >::const_iterator it = byReference.find(reference);
+    if (it == byReference.end())
+    {
+        return false;
+    }
+    const RecordRef *payment = nullptr;
+    for (const RecordRef &ref : it->second)
+    {
+        if (ref.kind == LedgerEntry::VOID)
+        {
+            return false;
+        }
+        if (ref.kind == LedgerEntry::PAYMENT)
+        {
+            payment = &ref;
+        }
+    }
+    LedgerEntry original;
+    if (!payment || !readRecord(*payment, original))
+    {
+        return false;
+    }
+
+    LedgerEntry entry = original;
+    entry.kind = LedgerEntry::VOID;
+    entry.plantUnits = -original.plantUnits;
+    for (LedgerEntry::Posting &p : entry.postings)
+    {
+        p.cents = -p.cents;
+    }
+    return appendLocked(entry);
+}
+
+std::size_t PaymentLedger::recordOrderVoid(const std::string &orderId)
+{
+    // Collect the receipts first: recordVoid() takes the lock itself
+    std::vector<std::string> references;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unordered_map<std::string, std::vector<RecordRef> >::const_iterator it = byOrder.find(orderId);
+        if (it == byOrder.end())
+        {
+            return 0;
+        }
+        for (const RecordRef &ref : it->second)
+        {
+            LedgerEntry entry;
+            if (ref.kind == LedgerEntry::PAYMENT && readRecord(ref, entry))
+            {
+                references.push_back(entry.reference);
+            }
+        }
+    }
+
+    std::size_t voided = 0;
+    for (const std::string &reference : references)
+    {
+        if (recordVoid(reference))
+        {
+            ++voided;
+        }
+    }
+    return voided;
+}
+
+bool PaymentLedger::recordSettlement(const std::string &batchId, const std::string &method, std::int64_t cents)
+{
+    LedgerEntry entry;
+    entry.kind = LedgerEntry::SETTLEMENT;
+    entry.method = method;
+    entry.reference = batchId;
+    entry.amountCents = cents;
+    entry.postings.push_back(posting(LedgerEntry::BANK, cents));
+    entry.postings.push_back(posting(clearingAccount(method), -cents));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return appendLocked(entry);
+}
+
+bool PaymentLedger::readRecord(const RecordRef &ref, LedgerEntry &entry) const
+{
+    // Records appended since the last mapping are picked up by remapping the (larger) file
+    if (ref.offset + ref.length > mapping.getSize() && !mapping.open(path))
+    {
+        return false;
+    }
+    if (ref.offset + ref.length > mapping.getSize())
+    {
+        return false;
+    }
+    BinaryReader reader(mapping.getData() + ref.offset, ref.length);
+    return decodePayload(reader, entry);
+}
+
+std::vector<LedgerEntry> PaymentLedger::readAll(const std::vector<RecordRef> &refs) const
+{
+    std::vector<LedgerEntry> entries;
+    entries.reserve(refs.size());
+    for (const RecordRef &ref : refs)
+    {
+        LedgerEntry entry;
+        if (readRecord(ref, entry))
+        {
+            entries.push_back(entry);
+        }
+    }
+    return entries;
+}
+
+std::vector<LedgerEntry> PaymentLedger::findByReference(const std::string &reference) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<std::string, std::vector<RecordRef> >::const_iterator it = byReference.find(reference);
+    return it == byReference.end() ? std::vector<LedgerEntry>() : readAll(it->second);
+}
+
+std::vector<LedgerEntry> PaymentLedger::getEntriesForOrder(const std::string &orderId) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<std::string, std::vector<RecordRef> >::const_iterator it = byOrder.find(orderId);
+    return it == byOrder.end() ? std::vector<LedgerEntry>() : readAll(it->second);
+}
+
+std::int64_t PaymentLedger::getBalance(LedgerEntry::Account account) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return account < LedgerEntry::ACCOUNT_COUNT ? balances[account] : 0;
+}
+
+std::size_t PaymentLedger::getEntryCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entryCount;
+}
+
+std::uint64_t PaymentLedger::getNextSequence() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return nextSequence;
+}
+
+LedgerReconciliation PaymentLedger::reconcile(const std::vector<StoredOrder> &orders, std::int64_t plantsSold,
+                                              std::uint64_t firstSequence) const
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    LedgerReconciliation report;
+    report.plantsSold = plantsSold;
+
+    // The file only ever grows, so the prefix written so far can be scanned without holding the lock
+    std::string ledgerPath;
+    std::uint64_t size = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ledgerPath = path;
+        size = logSize;
+    }
+
+    std::unordered_map<std::string, std::size_t> orderIndex;
+    orderIndex.reserve(orders.size());
+    for (std::size_t i = 0; i < orders.size(); ++i)
+    {
+        orderIndex.insert(std::make_pair(orders[i].orderId, i));
+    }
+    std::vector<std::int64_t> takings(orders.size(), 0);
+    std::vector<char> inLedger(orders.size(), 0);
+    std::unordered_map<std::string, std::pair<std::int64_t, std::string> > unmatched; // order -> takings, last receipt
+
+    MappedFile file;
+    if (!ledgerPath.empty() && size > HEADER_SIZE && file.open(ledgerPath) && file.getSize() >= size)
+    {
+        BinaryReader reader(file.getData() + HEADER_SIZE, static_cast<std::size_t>(size - HEADER_SIZE));
+        std::string orderKey; // reused, so matching an order allocates nothing
+        for (;;)
+        {
+            std::uint32_t length = 0, crc = 0;
+            if (!reader.readU32(length) || !reader.readU32(crc) || reader.remaining() < length)
+            {
+                break;
+            }
+            const char *payload = reader.position();
+            reader.skip(length);
+
+            // Only the fields the checks need are decoded; strings are left in the mapping
+            BinaryReader record(payload, length);
+            std::uint64_t sequence = 0;
+            std::uint8_t kind = 0, count = 0;
+            const char *reference = nullptr, *orderId = nullptr, *customer = nullptr;
+            std::uint32_t referenceLength = 0, orderIdLength = 0, customerLength = 0;
+            std::int64_t amount = 0;
+            std::int32_t units = 0;
+            bool intact = computeCrc32(payload, length) == crc && record.readU64(sequence) &&
+                          record.skip(sizeof(std::uint64_t)) && record.readU8(kind) && record.skip(1) &&
+                          readStringRef(record, reference, referenceLength) &&
+                          readStringRef(record, orderId, orderIdLength) &&
+                          readStringRef(record, customer, customerLength) && record.readI64(amount) &&
+                          record.readI32(units) && record.readU8(count);
+            std::int64_t sum = 0, sales = 0;
+            for (std::uint8_t i = 0; intact && i < count; ++i)
+            {
+                std::uint8_t account = 0;
+                std::int64_t cents = 0;
+                intact = record.readU8(account) && record.readI64(cents) && account < LedgerEntry::ACCOUNT_COUNT;
+                if (intact)
+                {
+                    report.balances[account] += cents;
+                    sum += cents;
+                    sales += account == LedgerEntry::SALES_REVENUE ? -cents : 0;
+                }
+            }
+            if (!intact)
+            {
+                LedgerReconciliation::Discrepancy d = {LedgerReconciliation::Discrepancy::CORRUPT_RECORD, "",
+                                                       std::to_string(sequence), 0, 0};
+                report.discrepancies.push_back(d);
+                break;
+            }
+            if (sequence < firstSequence)
+            {
+                continue;
+            }
+            ++report.entriesScanned;
+
+            if (sum != 0)
+            {
+                LedgerReconciliation::Discrepancy d = {LedgerReconciliation::Discrepancy::UNBALANCED_ENTRY,
+                                                       std::string(orderId, orderIdLength),
+                                                       std::string(reference, referenceLength), 0, sum};
+                report.discrepancies.push_back(d);
+            }
+            if (kind != LedgerEntry::PAYMENT && kind != LedgerEntry::VOID)
+            {
+                continue;
+            }
+            report.plantUnitsPaid += units;
+            orderKey.assign(orderId, orderIdLength);
+            std::unordered_map<std::string, std::size_t>::const_iterator match = orderIndex.find(orderKey);
+            if (match != orderIndex.end())
+            {
+                takings[match->second] += sales;
+                inLedger[match->second] = 1;
+            }
+            else
+            {
+                std::pair<std::int64_t, std::string> &stray = unmatched[orderKey];
+                stray.first += sales;
+                stray.second.assign(reference, referenceLength);
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < orders.size(); ++i)
+    {
+        const StoredOrder &order = orders[i];
+        std::int64_t orderCents = toCents(order.totalAmount);
+        ++report.ordersChecked;
+        LedgerReconciliation::Discrepancy d = {LedgerReconciliation::Discrepancy::AMOUNT_MISMATCH, order.orderId, "",
+                                               orderCents, takings[i]};
+        if (SettlementEngine::isPaidStatus(order.status))
+        {
+            if (!inLedger[i])
+            {
+                d.kind = LedgerReconciliation::Discrepancy::PAID_NOT_IN_LEDGER;
+                report.discrepancies.push_back(d);
+            }
+            else if (takings[i] != orderCents)
+            {
+                report.discrepancies.push_back(d);
+            }
+            else
+            {
+                ++report.matched;
+                report.matchedCents += orderCents;
+            }
+        }
+        else if (takings[i] != 0)
+        {
+            d.kind = LedgerReconciliation::Discrepancy::PAYMENT_FOR_UNPAID_ORDER;
+            report.discrepancies.push_back(d);
+        }
+    }
+    for (const std::pair<const std::string, std::pair<std::int64_t, std::string> > &stray : unmatched)
+    {
+        if (stray.second.first != 0)
+        {
+            LedgerReconciliation::Discrepancy d = {LedgerReconciliation::Discrepancy::NO_MATCHING_ORDER, stray.first,
+                                                   stray.second.second, 0, stray.second.first};
+            report.discrepancies.push_back(d);
+        }
+    }
+
+    report.millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
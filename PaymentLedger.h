@@ -0,0 +1,216 @@
+#ifndef PAYMENT_LEDGER_H
+#define PAYMENT_LEDGER_H
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct StoredOrder;
+
+/**
+ * @brief One transaction in the PaymentLedger, with its double-entry postings
+ */
+struct LedgerEntry
+{
+    enum Kind
+    {
+        PAYMENT = 1,   // money taken for an order
+        DECLINE = 2,   // payment attempt that was refused; no postings
+        VOID = 3,      // reverses an earlier payment
+        SETTLEMENT = 4 // clearing account paid out to the bank
+    };
+
+    enum Account
+    {
+        CASH_ON_HAND,
+        CARD_CLEARING,
+        EFT_CLEARING,
+        GATEWAY_CLEARING, // payments taken by the order-processing chain's simulated gateway
+        BANK,
+        SALES_REVENUE,
+        ACCOUNT_COUNT
+    };
+
+    struct Posting
+    {
+        Account account;
+        std::int64_t cents; // debit positive, credit negative; every entry's postings sum to zero
+    };
+
+    std::uint64_t sequence;
+    std::uint64_t recordedAtMillis; // Unix time
+    Kind kind;
+    std::string method;    // "CASH", "CREDIT_CARD", "EFT" or "GATEWAY"
+    std::string reference; // receipt, authorization or settlement batch; empty for declines
+    std::string orderId;
+    std::string customerId;
+    std::int64_t amountCents;
+    std::int32_t plantUnits; // plants paid for; negative on a void
+    std::vector<Posting> postings;
+
+    LedgerEntry() : sequence(0), recordedAtMillis(0), kind(PAYMENT), amountCents(0), plantUnits(0) {}
+};
+
+/**
+ * @brief Result of checking the ledger against recorded orders and sold stock
+ */
+struct LedgerReconciliation
+{
+    struct Discrepancy
+    {
+        enum Kind
+        {
+            UNBALANCED_ENTRY,         // postings that do not sum to zero
+            CORRUPT_RECORD,           // record failing its checksum; the scan stopped there
+            AMOUNT_MISMATCH,          // paid order whose net ledger takings differ from its total
+            PAID_NOT_IN_LEDGER,       // order marked paid with no payment in the ledger
+            PAYMENT_FOR_UNPAID_ORDER, // money kept for an order that did not complete
+            NO_MATCHING_ORDER         // money kept for an order not in the report (or none given)
+        };
+
+        Kind kind;
+        std::string orderId;
+        std::string reference;
+        std::int64_t orderCents;
+        std::int64_t ledgerCents;
+    };
+
+    std::size_t entriesScanned;
+    std::size_t ordersChecked;
+    std::size_t matched;
+    std::int64_t matchedCents;
+    std::int64_t plantUnitsPaid; // net of voids
+    std::int64_t plantsSold;     // as given by the caller, e.g. InventoryManager's SOLD count
+    std::int64_t balances[LedgerEntry::ACCOUNT_COUNT]; // closing balances, over the whole ledger
+    double millis;
+    std::vector<Discrepancy> discrepancies;
+
+    LedgerReconciliation();
+
+    bool isClean() const { return discrepancies.empty() && plantUnitsPaid == plantsSold; }
+    void print(std::ostream &out) const;
+
+    static const char *getKindName(Discrepancy::Kind kind);
+};
+
+/**
+ * @class PaymentLedger
+ * @brief Append-only, double-entry record of every payment outcome
+ *
+ * The payment adapters, PaymentProcessHandler and SettlementEngine post here:
+ * a payment debits the method's clearing account (or cash on hand) and
+ * credits sales; a void reverses its payment; a settlement moves a clearing
+ * balance to the bank; a decline is kept as an entry without postings. Each
+ * entry is one checksummed binary record, and the in-memory indexes map
+ * receipts and order IDs to their records, which are read back through a
+ * memory mapping like the OrderStore's.
+ *
+ * File layout (version 1, host byte order):
+ * @code
+ * header : "GHLEDGER" | u32 version | u32 endian marker
+ * record : u32 payload bytes | u32 CRC-32 of payload | payload
+ * payload: u64 sequence | u64 recorded-at ms | u8 kind | u8 method | reference
+ *          | orderId | customerId | i64 amount cents | i32 plant units
+ *          | u8 posting count | (u8 account | i64 cents) per posting
+ * @endcode
+ * A torn record at the end is dropped the next time the ledger is opened.
+ *
+ * reconcile() makes one forward pass over the mapped file, checking every
+ * entry balances and netting takings per order, then compares those with
+ * the orders' totals and the plants paid for with the plants sold.
+ *
+ * Singleton like OrderStore; postings are ignored until open() succeeds.
+ */
+class PaymentLedger
+{
+public:
+    static const unsigned int FORMAT_VERSION = 1;
+
+    PaymentLedger(const PaymentLedger &) = delete;
+    PaymentLedger &operator=(const PaymentLedger &) = delete;
+
+    static PaymentLedger &getInstance();
+
+    /**
+     * @brief Opens (or creates) the ledger and rebuilds the indexes and balances from it
+     * @return false if the file cannot be created or is not a ledger
+     */
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const;
+
+    bool recordPayment(const std::string &method, const std::string &reference, const std::string &orderId,
+                       const std::string &customerId, double amount, int plantUnits);
+    bool recordDecline(const std::string &method, const std::string &orderId, const std::string &customerId,
+                       double amount);
+
+    /** @brief Reverses the payment with this receipt; false if there is none or it was already voided */
+    bool recordVoid(const std::string &reference);
+
+    /**
+     * @brief Reverses every payment for the order that is still standing, whatever its method
+     * @return Number of payments voided; payments already voided (e.g. by SettlementEngine) are skipped
+     */
+    std::size_t recordOrderVoid(const std::string &orderId);
+
+    bool recordSettlement(const std::string &batchId, const std::string &method, std::int64_t cents);
+
+    /** @brief Every entry carrying this receipt (the payment and any void), oldest first */
+    std::vector<LedgerEntry> findByReference(const std::string &reference) const;
+    std::vector<LedgerEntry> getEntriesForOrder(const std::string &orderId) const;
+
+    std::int64_t getBalance(LedgerEntry::Account account) const;
+    std::size_t getEntryCount() const;
+    /** @brief Sequence the next entry will get; entries from here on belong to the current session */
+    std::uint64_t getNextSequence() const;
+
+    /**
+     * @brief Checks the ledger against order summaries and the number of plants sold
+     * @param orders Typically OrderStore::getOrdersBetween() for the day
+     * @param firstSequence Entries before this one are skipped, e.g. to check one session on its own
+     */
+    LedgerReconciliation reconcile(const std::vector<StoredOrder> &orders, std::int64_t plantsSold,
+                                   std::uint64_t firstSequence = 0) const;
+
+    static const char *getAccountName(LedgerEntry::Account account);
+
+private:
+    struct RecordRef
+    {
+        std::uint64_t offset; // start of the payload
+        std::uint32_t length;
+        std::uint8_t kind;
+    };
+
+    std::string path;
+    std::ofstream appendStream;
+    std::uint64_t logSize;
+    std::uint64_t nextSequence;
+    std::size_t entryCount;
+    std::int64_t balances[LedgerEntry::ACCOUNT_COUNT];
+    mutable MappedFile mapping; // remapped lazily when a lookup reaches past it
+
+    std::unordered_map<std::string, std::vector<RecordRef> > byReference;
+    std::unordered_map<std::string, std::vector<RecordRef> > byOrder;
+
+    mutable std::mutex mutex;
+
+    PaymentLedger();
+    ~PaymentLedger();
+
+    void closeLocked();
+    bool appendLocked(LedgerEntry &entry);
+    void indexEntry(const LedgerEntry &entry, const RecordRef &ref);
+    bool readRecord(const RecordRef &ref, LedgerEntry &entry) const;
+    std::vector<LedgerEntry> readAll(const std::vector<RecordRef> &refs) const;
+    bool rewritePrefix(std::uint64_t validBytes);
+};
+
+#endif // PAYMENT_LEDGER_H
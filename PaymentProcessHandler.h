@@ -3,15 +3,15 @@
 
 #include "OrderProcessHandler.h"
 #include "InventoryManager.h"
-#include "SinglePlant.h"
-#include "PlantBundle.h"
+#include "PaymentLedger.h"
 #include <random>
 #include <iostream>
-#include <map>
 
 /**
  * @brief Concrete handler for payment processing
- * Simulates payment processing for the order
+ * Simulates payment processing for the order; a declined payment releases the
+ * order's stock reservation. Both outcomes are posted to the PaymentLedger
+ * under the "GATEWAY" method
  */
 class PaymentProcessHandler : public OrderProcessHandler {
 private:
@@ -34,85 +34,28 @@ protected:
         std::uniform_int_distribution<int> dist(1, 10);
         bool paymentSuccess = (dist(rng) <= 9);
         
+        PaymentLedger& ledger = PaymentLedger::getInstance();
         if (paymentSuccess) {
-            logStep("Payment authorized and processed successfully");
+            std::string reference = IdGenerator::getInstance().nextId("GW-");
+            ledger.recordPayment("GATEWAY", reference, order->getOrderId(), customer->getEmail(), totalAmount,
+                                 order->getFlattened().getPlantUnits());
+            logStep("Payment authorized and processed successfully (reference " + reference + ")");
             order->setStatus("Paid");
             
-            // Remove sold plants from inventory
-            logStep("Updating inventory - removing sold plants from sales floor...");
-            if (removeSoldPlantsFromInventory(order)) {
-                logStep("Inventory updated successfully");
-                logStep("Payment confirmation sent to customer");
-                return true;
-            } else {
-                std::cout << "[ERROR] Failed to update inventory after payment" << std::endl;
-                order->setStatus("Payment Successful - Inventory Update Failed");
-                return false;
-            }
+            // Sold plants leave the floor in the next stage (InventoryCommitHandler)
+            logStep("Payment confirmation sent to customer");
+            return true;
         } else {
             std::cout << "[ERROR] Payment failed - Card declined or insufficient funds" << std::endl;
+            ledger.recordDecline("GATEWAY", order->getOrderId(), customer->getEmail(), totalAmount);
+            if (order->getReservationId() != 0) {
+                InventoryManager::getInstance().releaseReservation(order->getReservationId());
+                order->setReservationId(0);
+            }
             order->setStatus("Payment Failed");
             return false;
         }
     }
-    
-    /**
-     * @brief Removes sold plants from the sales floor inventory
-     * @param order The order containing the plants to remove
-     * @return true if all plants were successfully removed, false otherwise
-     */
-    bool removeSoldPlantsFromInventory(Order* order) {
-        InventoryManager& inventory = InventoryManager::getInstance();
-        
-        // Count plants by type in the order
-        std::map<std::string, int> plantCounts;
-        const std::vector<OrderItem*>& items = order->getOrderItems();
-        
-        for (OrderItem* item : items) {
-            countPlantsInItem(item, plantCounts);
-        }
-        
-        // Sell each plant type
-        bool allSold = true;
-        for (const auto& pair : plantCounts) {
-            const std::string& plantType = pair.first;
-            int quantity = pair.second;
-            
-            if (!inventory.sellPlants(plantType, quantity)) {
-                std::cout << "[ERROR] Could not sell " << quantity << " " << plantType << std::endl;
-                allSold = false;
-            }
-        }
-        
-        return allSold;
-    }
-    
-    /**
-     * @brief Recursively count plants in order items (handles bundles)
-     * @param item The order item (SinglePlant or PlantBundle)
-     * @param plantCounts Map to store plant type counts
-     */
-    void countPlantsInItem(OrderItem* item, std::map<std::string, int>& plantCounts) {
-        if (!item) return;
-        
-        // Check if it's a SinglePlant
-        SinglePlant* singlePlant = dynamic_cast<SinglePlant*>(item);
-        if (singlePlant) {
-            std::string plantType = singlePlant->getPlantType();
-            int quantity = singlePlant->getQuantity();
-            plantCounts[plantType] += quantity;
-            return;
-        }
-        
-        // Check if it's a PlantBundle
-        PlantBundle* bundle = dynamic_cast<PlantBundle*>(item);
-        if (bundle) {
-            const std::vector<OrderItem*>& bundleItems = bundle->getItems();
-            for (OrderItem* bundleItem : bundleItems) {
-                countPlantsInItem(bundleItem, plantCounts);
-            }
-        }
-    }
 };
 
 #endif
\ No newline at end of file
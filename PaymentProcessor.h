@@ -2,12 +2,42 @@
 #define PAYMENT_PROCESSOR_H
 
 #include <string>
+#include <vector>
+
+/**
+ * @brief One charge in a bulk PaymentProcessor::processPayments() call
+ */
+struct PaymentRequest {
+    double amount;
+    std::string customerId;
+    std::string payload;
+    std::string orderId; // order being paid for, used to reconcile settlements; may be empty
+    int plantUnits;      // plants being paid for, kept in the PaymentLedger
+
+    PaymentRequest() : amount(0.0), plantUnits(0) {}
+};
 
 class PaymentProcessor {
 public:
     virtual ~PaymentProcessor() = default;
     // payload is format-dependent: "CASH" or "cardNumber;expiry;cvc" or other
     virtual bool processPayment(double amount, const std::string& customerId, const std::string& payload) = 0;
+
+    // Same, for callers that know which order is being paid for
+    virtual bool processRequest(const PaymentRequest& request) {
+        return processPayment(request.amount, request.customerId, request.payload);
+    }
+
+    // Charges a batch, one result per request in the same order. Processors whose
+    // gateway accepts bulk submissions override this; the default charges one by one.
+    virtual std::vector<bool> processPayments(const std::vector<PaymentRequest>& requests) {
+        std::vector<bool> results;
+        results.reserve(requests.size());
+        for (const PaymentRequest& request : requests) {
+            results.push_back(processRequest(request));
+        }
+        return results;
+    }
 };
 
 #endif // PAYMENT_PROCESSOR_H
@@ -1,8 +1,8 @@
 #include "PlaceOrderCommand.h"
 #include "Order.h"
 #include "Customer.h"
+#include "Timestamp.h"
 #include <iostream>
-#include <ctime>
 
 PlaceOrderCommand::PlaceOrderCommand(Order* order, Customer* customer)
     : order(order), customer(customer), executed(false), salesStaff(nullptr) {
@@ -55,15 +55,12 @@ bool PlaceOrderCommand::isExecuted() const {
 }
 
 std::string PlaceOrderCommand::getCommandInfo() const {
-    return "PlaceOrderCommand for Order " + order->getOrderId() + 
+    return "PlaceOrderCommand " + getCommandIdString() + " for Order " + order->getOrderId() + 
            " by " + customer->getName();
 }
 
 std::string PlaceOrderCommand::generateTimestamp() {
-    time_t now = time(0);
-    char buf[80];
-    strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", localtime(&now));
-    return std::string(buf);
+    return currentTimestamp();
 }
 
 void PlaceOrderCommand::setReceiver(PlantProduct* plant) {
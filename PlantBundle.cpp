@@ -1,12 +1,16 @@
 #include "PlantBundle.h"
+#include "OrderItemVisitor.h"
 #include <sstream>
 #include <iomanip>
 
 PlantBundle::PlantBundle(const std::string& bundleName, const std::string& bundleType, 
                          int quantity, double discount)
-    : OrderItem(bundleName, 0.0, quantity), bundleType(bundleType), discountPercentage(discount) {}
+    : OrderItem(bundleName, 0.0, quantity), bundleType(bundleType), discountPercentage(discount), itemsTotal(0.0) {}
 
 PlantBundle::~PlantBundle() {
+    // Whoever deletes a bundle has already accounted for its subtotal
+    parent = nullptr;
+    owner = nullptr;
     clearItems();
 }
 
@@ -23,29 +27,55 @@ std::string PlantBundle::getDescription() const {
     return oss.str();
 }
 
+void PlantBundle::accept(OrderItemVisitor& visitor) const {
+    visitor.visitPlantBundle(*this);
+}
+
 void PlantBundle::addItem(OrderItem* item) {
     if (item) {
         items.push_back(item);
+        item->setParent(this);
+        childSubtotalChanged(item->getPrice());
+        notifyContentsChanged();
     }
 }
 
 void PlantBundle::removeItem(OrderItem* item) {
     for (auto it = items.begin(); it != items.end(); ++it) {
         if (*it == item) {
+            double removed = item->getPrice();
             delete *it;
             items.erase(it);
+            childSubtotalChanged(-removed);
+            notifyContentsChanged();
             break;
         }
     }
 }
 
+void PlantBundle::childSubtotalChanged(double delta) {
+    double oldSubtotal = getPrice();
+    itemsTotal += delta;
+    if (items.empty()) {
+        itemsTotal = 0.0; // drop any accumulated rounding once the bundle is empty
+    }
+    notifySubtotalChanged(oldSubtotal);
+}
+
 std::vector<OrderItem*> PlantBundle::getItems() const {
     return items;
 }
 
+const std::vector<OrderItem*>& PlantBundle::getChildren() const {
+    return items;
+}
+
 void PlantBundle::setDiscount(double discount) {
     if (discount >= 0.0 && discount <= 100.0) {
+        double oldSubtotal = getPrice();
         discountPercentage = discount;
+        notifySubtotalChanged(oldSubtotal);
+        notifyContentsChanged();
     }
 }
 
@@ -62,16 +92,16 @@ int PlantBundle::getItemCount() const {
 }
 
 void PlantBundle::clearItems() {
+    double oldSubtotal = getPrice();
     for (auto* item : items) {
         delete item;
     }
     items.clear();
+    itemsTotal = 0.0;
+    notifySubtotalChanged(oldSubtotal);
+    notifyContentsChanged();
 }
 
 double PlantBundle::getBasePrice() const {
-    double total = 0.0;
-    for (const auto* item : items) {
-        total += item->getPrice();
-    }
-    return total;
+    return itemsTotal;
 }
@@ -13,6 +13,7 @@ private:
     std::vector<OrderItem*> items;
     std::string bundleType;
     double discountPercentage;
+    double itemsTotal; // sum of the children's subtotals, kept current by childSubtotalChanged
 
 public:
     PlantBundle(const std::string& bundleName, const std::string& bundleType, 
@@ -22,11 +23,14 @@ public:
     // Override OrderItem methods
     double getPrice() const override;
     std::string getDescription() const override;
+    void accept(OrderItemVisitor& visitor) const override;
     
     // Override composite operations
     void addItem(OrderItem* item) override;
     void removeItem(OrderItem* item) override;
     std::vector<OrderItem*> getItems() const override;
+    const std::vector<OrderItem*>& getChildren() const; // no-copy view for hot paths
+    void childSubtotalChanged(double delta) override;
     
     // PlantBundle specific methods
     void setDiscount(double discountPercentage);
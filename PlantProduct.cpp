@@ -1,5 +1,6 @@
 #include "PlantProduct.h"
 #include "LifeCycleObserver.h"
+#include "Logger.h"
 #include "PlantState.h"
 #include "PlantedState.h"
 #include "InNurseryState.h"
@@ -16,24 +17,42 @@
 #include "StandardPruningStrategy.h"
 #include "DripWateringStrategy.h"
 #include "MinimalPruningStrategy.h"
-#include <iostream>
 #include <string>
 #include <algorithm>
 #include <cctype>
 
 PlantProduct::PlantProduct(const std::string &id, PlantSpeciesProfile *profile)
     : currentState(nullptr), daysInCurrentState(0), stateStartTime(std::chrono::steady_clock::now()),
-      lastCareNotification(std::chrono::steady_clock::now()), monitor(nullptr), speciesProfile(profile), plantId(id)
+      lastCareNotification(std::chrono::steady_clock::now()), monitor(nullptr), inventoryObserver(nullptr), speciesProfile(profile), defaultStrategiesAdded(false), plantId(id)
 {
     transitionTo(new PlantedState());
-    addStrategy("water", new WateringStrategy());
-    addStrategy("mist", new GentleMistStrategy());
-    addStrategy("prune_artistic", new ArtisticPruningStrategy());
-    addStrategy("fertilize", new FertilizingStrategy());
-    addStrategy("flood", new FloodWateringStrategy());
-    addStrategy("prune_standard", new StandardPruningStrategy());
-    addStrategy("drip", new DripWateringStrategy());
-    addStrategy("prune_minimal", new MinimalPruningStrategy());
+    addDefaultStrategies();
+}
+
+PlantProduct::PlantProduct(const std::string &id, PlantSpeciesProfile *profile, PlantState *restoredState)
+    : currentState(restoredState), daysInCurrentState(0), stateStartTime(std::chrono::steady_clock::now()),
+      lastCareNotification(std::chrono::steady_clock::now()), monitor(nullptr), inventoryObserver(nullptr), speciesProfile(profile), defaultStrategiesAdded(false), plantId(id)
+{
+    // Care strategies are only created once the plant is actually cared for,
+    // which keeps bulk restores cheap
+}
+
+void PlantProduct::addDefaultStrategies() const
+{
+    if (defaultStrategiesAdded)
+    {
+        return;
+    }
+    defaultStrategiesAdded = true;
+
+    strategy_map["water"] = new WateringStrategy();
+    strategy_map["mist"] = new GentleMistStrategy();
+    strategy_map["prune_artistic"] = new ArtisticPruningStrategy();
+    strategy_map["fertilize"] = new FertilizingStrategy();
+    strategy_map["flood"] = new FloodWateringStrategy();
+    strategy_map["prune_standard"] = new StandardPruningStrategy();
+    strategy_map["drip"] = new DripWateringStrategy();
+    strategy_map["prune_minimal"] = new MinimalPruningStrategy();
 }
 
 PlantProduct::~PlantProduct()
@@ -57,6 +76,11 @@ void PlantProduct::transitionTo(PlantState *state)
     daysInCurrentState = 0; // Reset days when transitioning
     stateStartTime = std::chrono::steady_clock::now();
     lastCareNotification = std::chrono::steady_clock::now();
+
+    if (inventoryObserver)
+    {
+        inventoryObserver->update(this, "StateChanged");
+    }
 }
 
 std::string PlantProduct::getCurrentStateName() const
@@ -70,7 +94,7 @@ std::string PlantProduct::getCurrentStateName() const
 
 void PlantProduct::transitionToWithering()
 {
-    std::cout << "Transitioning plant to withering state due to an error or neglect." << std::endl;
+    GH_LOG_WARN(Logger::PLANT_STATE, "Transitioning plant to withering state due to an error or neglect.");
     transitionTo(new WitheringState());
 }
 
@@ -89,6 +113,7 @@ PlantSpeciesProfile *PlantProduct::getProfile() const
 
 void PlantProduct::addStrategy(const std::string &careType, CareStrategy *strategy)
 {
+    addDefaultStrategies(); // so later lazy defaults never overwrite this one
     strategy_map[careType] = strategy;
 }
 
@@ -133,6 +158,7 @@ void PlantProduct::performCare(const std::string &careType)
         }
     }
 
+    addDefaultStrategies();
     auto it = strategy_map.find(normalized);
     if (it != strategy_map.end())
     {
@@ -154,12 +180,13 @@ void PlantProduct::performCare(const std::string &careType)
             amount = amountStr.empty() ? 100 : std::stoi(amountStr);
         }
 
-        std::cout << "Performing '" << normalized << "' care for " << speciesProfile->getSpeciesName() << "." << std::endl;
+        GH_LOG_DEBUG(Logger::CARE, "Performing '" << normalized << "' care for " << speciesProfile->getSpeciesName() << ".");
         it->second->applyCare(amount, normalized);
     }
     else
     {
-        std::cout << "Warning: No strategy found for care type '" << careType << "' for " << speciesProfile->getSpeciesName() << " plants." << std::endl;
+        GH_LOG_WARN(Logger::CARE, "No strategy found for care type '" << careType << "' for "
+                                                                     << speciesProfile->getSpeciesName() << " plants.");
     }
 }
 
@@ -189,6 +216,16 @@ void PlantProduct::resetLastCareTime()
     lastCareNotification = std::chrono::steady_clock::now();
 }
 
+void PlantProduct::restoreTimers(int daysInState, int secondsInState, int secondsSinceCare)
+{
+    // steady_clock has no meaning across processes, so saved timers are elapsed
+    // seconds that get re-anchored to the current clock
+    auto now = std::chrono::steady_clock::now();
+    daysInCurrentState = daysInState;
+    stateStartTime = now - std::chrono::seconds(secondsInState);
+    lastCareNotification = now - std::chrono::seconds(secondsSinceCare);
+}
+
 std::string PlantProduct::getStrategyNameForCareType(const std::string &careType) const
 {
     std::string normalized = careType;
@@ -228,6 +265,7 @@ std::string PlantProduct::getStrategyNameForCareType(const std::string &careType
         }
     }
 
+    addDefaultStrategies();
     auto it = strategy_map.find(normalized);
     if (it != strategy_map.end())
     {
@@ -27,14 +27,19 @@ private:
 
     // Observer Pattern
     LifeCycleObserver* monitor;
+    LifeCycleObserver* inventoryObserver; // told about every state change
     // Bridge Pattern
     PlantSpeciesProfile *speciesProfile;
     // Strategy Pattern
-    std::map<std::string, CareStrategy *> strategy_map;
+    // Defaults are created lazily for restored plants, hence mutable
+    mutable std::map<std::string, CareStrategy *> strategy_map;
+    mutable bool defaultStrategiesAdded;
     std::string plantId;
 
 public:
     PlantProduct(const std::string &id, PlantSpeciesProfile *profile);
+    // Rebuilds a persisted plant directly in its saved state (onEnter is not replayed)
+    PlantProduct(const std::string &id, PlantSpeciesProfile *profile, PlantState *restoredState);
     ~PlantProduct();
 
     // --- State ---
@@ -45,11 +50,14 @@ public:
 
     // --- Timing ---
     int getSecondsInCurrentState() const;
+    std::chrono::steady_clock::time_point getStateStartTime() const { return stateStartTime; }
     int getSecondsSinceLastCare() const;
     void resetLastCareTime();
+    void restoreTimers(int daysInState, int secondsInState, int secondsSinceCare);
 
     // --- Observer ---
     void setObserver(LifeCycleObserver* obs) { monitor = obs; }
+    void setInventoryObserver(LifeCycleObserver* obs) { inventoryObserver = obs; }
 
     // --- Bridge ---
     PlantSpeciesProfile *getProfile() const;
@@ -69,6 +77,8 @@ public:
     std::string getId() const { return plantId; }
 
 private:
+    void addDefaultStrategies() const;
+
     // Helper method to validate care appropriateness
     bool isCareTypeAppropriate(const std::string &careType) const;
 };
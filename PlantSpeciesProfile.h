@@ -30,6 +30,11 @@ public:
 		properties[key] = value;
 	}
 
+	const std::map<std::string, std::string> &getProperties() const
+	{
+		return properties;
+	}
+
 	std::vector<std::string> getSupportedCareTypes() const
 	{
 		std::vector<std::string> careTypes;
@@ -71,6 +76,29 @@ public:
 		properties["careInterval." + toLowerKey(careType)] = std::to_string(seconds);
 	}
 
+	double getUnitPrice(double defaultPrice) const
+	{
+		std::map<std::string, std::string>::const_iterator it = properties.find("price");
+		if (it == properties.end() || it->second.empty())
+		{
+			return defaultPrice;
+		}
+
+		try
+		{
+			return std::stod(it->second);
+		}
+		catch (...)
+		{
+			return defaultPrice;
+		}
+	}
+
+	void setUnitPrice(double price)
+	{
+		properties["price"] = std::to_string(price);
+	}
+
 	static std::string sanitizeNumericString(const std::string &value, const std::string &fallback)
 	{
 		std::string digits;
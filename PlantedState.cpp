@@ -1,20 +1,20 @@
 #include "PlantedState.h"
 #include "PlantProduct.h"
 #include "InNurseryState.h"
+#include "Logger.h"
 #include "PlantSpeciesProfile.h"
-#include <iostream>
 
 void PlantedState::onEnter(PlantProduct *plant)
 {
-    PlantSpeciesProfile *profile = plant->getProfile();
-    int duration = profile ? profile->getStateDurationSeconds("Planted", 20) : 20;
-
-    std::cout << "[STATE] Plant entered Planted state (" << duration << " seconds)" << std::endl;
+    GH_LOG_INFO(Logger::PLANT_STATE,
+                "Plant entered Planted state ("
+                    << (plant->getProfile() ? plant->getProfile()->getStateDurationSeconds("Planted", 20) : 20)
+                    << " seconds)");
 }
 
 void PlantedState::onExit(PlantProduct *plant)
 {
-    std::cout << "[STATE] Plant exiting Planted state" << std::endl;
+    GH_LOG_DEBUG(Logger::PLANT_STATE, "Plant exiting Planted state");
 }
 
 void PlantedState::advanceState(PlantProduct *plant)
@@ -32,7 +32,7 @@ void PlantedState::advanceState(PlantProduct *plant)
     // Request water at appropriate interval
     if (secondsSinceCare >= waterInterval)
     {
-        std::cout << "[PLANTED] Requesting water (interval: " << waterInterval << "s)..." << std::endl;
+        GH_LOG_DEBUG(Logger::PLANT_STATE, "Planted: requesting water (interval: " << waterInterval << "s)");
         plant->notify("Watering");
         plant->resetLastCareTime();
     }
@@ -47,7 +47,7 @@ void PlantedState::advanceState(PlantProduct *plant)
     // Advance to next state when duration is complete
     if (secondsInState >= plantedDuration)
     {
-        std::cout << "[PLANTED] Growth stage complete. Moving to InNursery." << std::endl;
+        GH_LOG_INFO(Logger::PLANT_STATE, "Planted: growth stage complete. Moving to InNursery.");
         plant->transitionTo(new InNurseryState());
     }
 }
\ No newline at end of file
@@ -26,3 +26,8 @@ std::string Pot::getDrainage()
 {
     return this->drainage ? "Yes" : "No";
 }
+
+void Pot::getDecorations(std::vector<std::pair<std::string, std::string> > &decorations) const
+{
+    (void)decorations; // Base pots carry no decorations
+}
@@ -3,6 +3,8 @@
 
 #include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 /**
  * @class Pot
@@ -34,6 +36,15 @@ public:
     std::string getDrainage();
     std::string getShape();
     virtual std::string getPotType() const = 0;
+
+    /**
+     * @brief Collects the decorations applied to this pot, innermost first
+     * @param decorations Receives (kind, value) pairs, e.g. ("Color", "Gold")
+     *
+     * Undecorated pots add nothing; each decorator appends its own entry
+     * after its wrapped pot, so the list can be replayed to rebuild the chain.
+     */
+    virtual void getDecorations(std::vector<std::pair<std::string, std::string> > &decorations) const;
 };
 
 #endif
\ No newline at end of file
@@ -16,4 +16,9 @@ bool ColorDecorator::isMetallic(const std::string& color) const {
            color.find("Silver") != std::string::npos ||
            color.find("Copper") != std::string::npos ||
            color.find("Bronze") != std::string::npos;
-}
\ No newline at end of file
+}
+
+void ColorDecorator::getDecorations(std::vector<std::pair<std::string, std::string> >& decorations) const {
+    wrappedPot->getDecorations(decorations);
+    decorations.push_back(std::make_pair(std::string("Color"), color));
+}
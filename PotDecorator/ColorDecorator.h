@@ -100,6 +100,12 @@ public:
      */
     void print() override;
     
+    /**
+     * @brief Appends this color to the decoration list after the wrapped pot's
+     * @param decorations Receives ("Color", color) as the outermost entry
+     */
+    void getDecorations(std::vector<std::pair<std::string, std::string> >& decorations) const override;
+    
     /**
      * @brief Gets the color of this decorator
      * @return Color name string
@@ -19,4 +19,9 @@ double FeatureDecorator::getFeaturePrice(const std::string& feature) const {
     if (feature == "UV Protection") return 10.0;
     if (feature == "Drainage Tray") return 8.0;
     return 5.0;
-}
\ No newline at end of file
+}
+
+void FeatureDecorator::getDecorations(std::vector<std::pair<std::string, std::string> >& decorations) const {
+    wrappedPot->getDecorations(decorations);
+    decorations.push_back(std::make_pair(std::string("Feature"), feature));
+}
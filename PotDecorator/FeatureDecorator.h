@@ -169,6 +169,12 @@ public:
      */
     void print() override;
     
+    /**
+     * @brief Appends this feature to the decoration list after the wrapped pot's
+     * @param decorations Receives ("Feature", feature) as the outermost entry
+     */
+    void getDecorations(std::vector<std::pair<std::string, std::string> >& decorations) const override;
+    
     /**
      * @brief Gets the feature type of this decorator
      * @return Feature name string
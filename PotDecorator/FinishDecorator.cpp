@@ -15,4 +15,9 @@ double FinishDecorator::getFinishPrice(const std::string& finish) const {
     if (finish == "Glazed" || finish == "Weathered") return 4.0;
     if (finish == "Textured") return 3.0;
     return 2.0;
-}
\ No newline at end of file
+}
+
+void FinishDecorator::getDecorations(std::vector<std::pair<std::string, std::string> >& decorations) const {
+    wrappedPot->getDecorations(decorations);
+    decorations.push_back(std::make_pair(std::string("Finish"), finish));
+}
@@ -99,6 +99,12 @@ public:
      */
     void print() override;
     
+    /**
+     * @brief Appends this finish to the decoration list after the wrapped pot's
+     * @param decorations Receives ("Finish", finish) as the outermost entry
+     */
+    void getDecorations(std::vector<std::pair<std::string, std::string> >& decorations) const override;
+    
     /**
      * @brief Gets the finish type of this decorator
      * @return Finish type name
@@ -16,4 +16,9 @@ double PatternDecorator::getPatternPrice(const std::string& pattern) const {
     if (pattern.find("Floral") != std::string::npos || 
         pattern.find("Botanical") != std::string::npos) return 6.0;
     return 4.0;
-}
\ No newline at end of file
+}
+
+void PatternDecorator::getDecorations(std::vector<std::pair<std::string, std::string> >& decorations) const {
+    wrappedPot->getDecorations(decorations);
+    decorations.push_back(std::make_pair(std::string("Pattern"), pattern));
+}
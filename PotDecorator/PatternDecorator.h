@@ -132,6 +132,12 @@ public:
      */
     void print() override;
     
+    /**
+     * @brief Appends this pattern to the decoration list after the wrapped pot's
+     * @param decorations Receives ("Pattern", pattern) as the outermost entry
+     */
+    void getDecorations(std::vector<std::pair<std::string, std::string> >& decorations) const override;
+    
     /**
      * @brief Gets the pattern type of this decorator
      * @return Pattern name string
@@ -15,4 +15,9 @@ double TextureDecorator::getTexturePrice(const std::string& texture) const {
     if (texture == "Embossed" || texture == "Woven") return 6.0;
     if (texture == "Hammered" || texture == "Ribbed") return 4.0;
     return 3.0;
-}
\ No newline at end of file
+}
+
+void TextureDecorator::getDecorations(std::vector<std::pair<std::string, std::string> >& decorations) const {
+    wrappedPot->getDecorations(decorations);
+    decorations.push_back(std::make_pair(std::string("Texture"), texture));
+}
@@ -173,6 +173,12 @@ public:
      */
     void print() override;
     
+    /**
+     * @brief Appends this texture to the decoration list after the wrapped pot's
+     * @param decorations Receives ("Texture", texture) as the outermost entry
+     */
+    void getDecorations(std::vector<std::pair<std::string, std::string> >& decorations) const override;
+    
     /**
      * @brief Gets the texture type of this decorator
      * @return Texture type name
@@ -0,0 +1,267 @@
+/**
+ * @file PricingCheckMain.cpp
+ * @brief Checks BatchPricingEngine against Order::calculateTotalAmount()
+ *
+ * Builds seeded random carts (single plants with and without pots, discounted
+ * bundles, some with a bundle nested inside) and prices every cart both ways:
+ * - captured prices: the engine's cent totals must equal each Order's total
+ *   rounded to cents;
+ * - a new price list with bundle discount tiers: the engine, repriced with
+ *   applyPriceList(), must equal the same carts rebuilt at the new prices;
+ * - resetPrices() must bring back the captured totals.
+ *
+ * The engine rounds an exact half cent up where the double sum can land just
+ * under it, so a one-cent difference is accepted only when the Order total is
+ * within a rounding error of a half cent. Anything else is reported and the
+ * program exits with status 1.
+ *
+ * Build with `make pricing_check`; `make test` runs it.
+ *
+ * Usage:
+ * @code
+ * PricingCheck [--carts N] [--seed S] [--verbose]
+ * @endcode
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "BatchPricingEngine.h"
+#include "Order.h"
+#include "PlantBundle.h"
+#include "SinglePlant.h"
+
+namespace {
+
+struct Options {
+    int carts;
+    unsigned int seed;
+    bool verbose;
+
+    Options() : carts(20000), seed(37), verbose(false) {}
+};
+
+struct PlantPrice {
+    const char* type;
+    std::int64_t cents;
+};
+
+const PlantPrice PLANTS[] = {
+    {"Rose", 2599}, {"Tulip", 1250}, {"Orchid", 4575}, {"Lavender", 899},
+    {"Cactus", 1530}, {"Fern", 1105}, {"Bonsai", 12999}, {"Sunflower", 735}};
+const PlantPrice POTS[] = {{"Clay", 1200}, {"Plastic", 450}, {"Glass", 2375}, {"Metal", 3010}};
+const int PLANT_TYPES = sizeof(PLANTS) / sizeof(PLANTS[0]);
+const int POT_TYPES = sizeof(POTS) / sizeof(POTS[0]);
+
+// The price list applied to the carts; types left out keep their captured price
+BatchPricingEngine::PriceList makePriceList() {
+    BatchPricingEngine::PriceList prices;
+    prices.plantCents["Rose"] = 2799;
+    prices.plantCents["Orchid"] = 4350;
+    prices.plantCents["Bonsai"] = 13333;
+    prices.plantCents["Sunflower"] = 699;
+    prices.potCents["Clay"] = 1325;
+    prices.potCents["Glass"] = 2199;
+    BatchPricingEngine::DiscountTier small = {3, 500};
+    BatchPricingEngine::DiscountTier large = {5, 1250};
+    prices.bundleTiers.push_back(small);
+    prices.bundleTiers.push_back(large);
+    return prices;
+}
+
+/**
+ * @brief Builds carts from a seeded generator, either at captured prices or at a price list
+ *
+ * The generator's draws do not depend on the prices, so two builders with the
+ * same seed produce the same carts and only the prices differ.
+ */
+class CartBuilder {
+public:
+    CartBuilder(unsigned int seed, const BatchPricingEngine::PriceList* prices)
+        : rng(seed), prices(prices) {}
+
+    Order* build(int number) {
+        Order* order = new Order("CHECK-" + std::to_string(number), "Pricing Check");
+        int items = pick(1, 8);
+        for (int i = 0; i < items; ++i) {
+            order->addOrderItem(pick(1, 4) == 1 ? static_cast<OrderItem*>(makeBundle(true)) : makePlant());
+        }
+        return order;
+    }
+
+private:
+    std::mt19937 rng;
+    const BatchPricingEngine::PriceList* prices;
+
+    int pick(int low, int high) {
+        return std::uniform_int_distribution<int>(low, high)(rng);
+    }
+
+    double priceOf(const PlantPrice& item, const std::unordered_map<std::string, std::int64_t>* overrides) const {
+        std::int64_t cents = item.cents;
+        if (overrides) {
+            std::unordered_map<std::string, std::int64_t>::const_iterator it = overrides->find(item.type);
+            if (it != overrides->end()) {
+                cents = it->second;
+            }
+        }
+        return cents / 100.0;
+    }
+
+    SinglePlant* makePlant() {
+        const PlantPrice& plant = PLANTS[pick(0, PLANT_TYPES - 1)];
+        SinglePlant* single = new SinglePlant(plant.type, priceOf(plant, prices ? &prices->plantCents : nullptr),
+                                              pick(1, 5));
+        if (pick(1, 5) <= 2) {
+            const PlantPrice& pot = POTS[pick(0, POT_TYPES - 1)];
+            single->addPot(pot.type, priceOf(pot, prices ? &prices->potCents : nullptr));
+        }
+        return single;
+    }
+
+    PlantBundle* makeBundle(bool mayNest) {
+        int quantity = pick(1, 3);
+        int discount = pick(0, 25);
+        int children = pick(2, 6);
+        std::vector<OrderItem*> items;
+        for (int i = 0; i < children; ++i) {
+            items.push_back(mayNest && pick(1, 7) == 1 ? static_cast<OrderItem*>(makeBundle(false)) : makePlant());
+        }
+
+        double percent = discount;
+        if (prices && !prices->bundleTiers.empty()) {
+            percent = 0.0;
+            int best = -1;
+            for (const BatchPricingEngine::DiscountTier& tier : prices->bundleTiers) {
+                if (children >= tier.minItems && tier.minItems > best) {
+                    best = tier.minItems;
+                    percent = tier.basisPoints / 100.0;
+                }
+            }
+        }
+        PlantBundle* bundle = new PlantBundle("Check Bundle", "Custom", quantity, percent);
+        for (OrderItem* item : items) {
+            bundle->addItem(item);
+        }
+        return bundle;
+    }
+};
+
+struct CheckResult {
+    int exact;
+    int halfCent;
+    int mismatched;
+
+    CheckResult() : exact(0), halfCent(0), mismatched(0) {}
+};
+
+// Compares each engine total with its Order's double total
+CheckResult compare(const char* pass, const BatchPricingEngine& engine, const std::vector<Order*>& orders, bool verbose) {
+    CheckResult result;
+    for (std::size_t i = 0; i < orders.size(); ++i) {
+        double total = orders[i]->calculateTotalAmount();
+        std::int64_t expected = BatchPricingEngine::toCents(total);
+        std::int64_t actual = engine.getOrderTotalCents(i);
+        double fraction = total * 100.0 - std::floor(total * 100.0);
+        if (actual == expected) {
+            ++result.exact;
+        } else if (actual == expected + 1 && std::fabs(fraction - 0.5) < 1e-6) {
+            ++result.halfCent;
+        } else {
+            ++result.mismatched;
+            if (verbose || result.mismatched <= 5) {
+                std::cout << "[PRICING] " << pass << ": " << orders[i]->getOrderId() << " engine " << actual
+                          << " cents, order " << std::setprecision(12) << total << std::endl;
+            }
+        }
+    }
+    std::cout << "[PRICING] " << std::left << std::setw(16) << pass << std::right << result.exact << " exact, "
+              << result.halfCent << " half-cent round-ups, " << result.mismatched << " mismatched" << std::endl;
+    return result;
+}
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--carts" && i + 1 < argc) {
+            options.carts = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            options.seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--verbose") {
+            options.verbose = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--carts N] [--seed S] [--verbose]" << std::endl;
+            return false;
+        }
+    }
+    if (options.carts < 1) {
+        std::cerr << "--carts must be at least 1" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 2;
+    }
+
+    const BatchPricingEngine::PriceList priceList = makePriceList();
+    CartBuilder capturedCarts(options.seed, nullptr);
+    CartBuilder repricedCarts(options.seed, &priceList);
+    std::vector<Order*> captured, repriced;
+    captured.reserve(options.carts);
+    repriced.reserve(options.carts);
+    for (int i = 0; i < options.carts; ++i) {
+        captured.push_back(capturedCarts.build(i));
+        repriced.push_back(repricedCarts.build(i));
+    }
+
+    BatchPricingEngine engine;
+    for (Order* order : captured) {
+        engine.addOrder(*order);
+    }
+    std::cout << "[PRICING] " << engine.getOrderCount() << " carts, " << engine.getItemCount()
+              << " flattened items, seed " << options.seed << std::endl;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    engine.computeTotals();
+    double capturedMs = millisecondsSince(start);
+    CheckResult before = compare("captured", engine, captured, options.verbose);
+
+    start = std::chrono::steady_clock::now();
+    engine.applyPriceList(priceList);
+    engine.computeTotals();
+    double repriceMs = millisecondsSince(start);
+    CheckResult after = compare("price list", engine, repriced, options.verbose);
+
+    engine.resetPrices();
+    engine.computeTotals();
+    CheckResult reset = compare("reset", engine, captured, options.verbose);
+
+    std::cout << std::fixed << std::setprecision(3) << "[PRICING] computeTotals " << capturedMs
+              << " ms, applyPriceList + computeTotals " << repriceMs << " ms" << std::endl;
+
+    for (std::size_t i = 0; i < captured.size(); ++i) {
+        delete captured[i];
+        delete repriced[i];
+    }
+
+    int mismatched = before.mismatched + after.mismatched + reset.mismatched;
+    std::cout << "[PRICING] " << (mismatched == 0 ? "PASS" : "FAIL") << std::endl;
+    return mismatched == 0 ? 0 : 1;
+}
@@ -1,16 +1,16 @@
 #include "ReadyForSaleState.h"
+#include "Logger.h"
 #include "PlantProduct.h"
-#include <iostream>
 
 void ReadyForSaleState::onEnter(PlantProduct *plant)
 {
-    std::cout << "[STATE] Plant has entered ReadyForSale state (terminal state)" << std::endl;
+    GH_LOG_INFO(Logger::PLANT_STATE, "Plant has entered ReadyForSale state (terminal state)");
     hasRequestedMove = false;
 }
 
 void ReadyForSaleState::onExit(PlantProduct *plant)
 {
-    std::cout << "[STATE] Plant is exiting ReadyForSale state" << std::endl;
+    GH_LOG_DEBUG(Logger::PLANT_STATE, "Plant is exiting ReadyForSale state");
 }
 
 void ReadyForSaleState::advanceState(PlantProduct *plant)
@@ -23,7 +23,7 @@ void ReadyForSaleState::advanceState(PlantProduct *plant)
         // Wait 5 seconds before requesting move (give time to see the state change)
         if (secondsInState >= 5)
         {
-            std::cout << "[READY_FOR_SALE] Requesting move to sales floor..." << std::endl;
+            GH_LOG_DEBUG(Logger::PLANT_STATE, "ReadyForSale: requesting move to sales floor");
             plant->notify("MoveToSalesFloor");
             hasRequestedMove = true;
         }
@@ -0,0 +1,510 @@
+#include "SettlementEngine.h"
+#include "AtomicFile.h"
+#include "IdGenerator.h"
+#include "OrderStore.h"
+#include "PaymentLedger.h"
+#include "Timestamp.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <unordered_set>
+
+namespace
+{
+    const std::size_t CHUNK_BYTES = 64 * 1024;
+
+    std::string formatCents(std::int64_t cents)
+    {
+        char buf[32];
+        std::int64_t whole = cents / 100;
+        std::int64_t fraction = cents % 100;
+        std::snprintf(buf, sizeof(buf), "%s%lld.%02lld", cents < 0 ? "-" : "",
+                      static_cast<long long>(whole < 0 ? -whole : whole),
+                      static_cast<long long>(fraction < 0 ? -fraction : fraction));
+        return buf;
+    }
+
+    // Appends a CSV field; separators in free text would shift the columns, so they become spaces
+    void appendField(std::string &line, const std::string &value)
+    {
+        line += ',';
+        for (char c : value)
+        {
+            line += (c == ',' || c == '\n' || c == '\r') ? ' ' : c;
+        }
+    }
+}
+
+const char *ReconciliationReport::getKindName(Discrepancy::Kind kind)
+{
+    switch (kind)
+    {
+    case Discrepancy::AMOUNT_MISMATCH:
+        return "Amount mismatch";
+    case Discrepancy::NOT_SETTLED:
+        return "Not settled";
+    case Discrepancy::CHARGED_UNPAID:
+        return "Charged for an incomplete order";
+    case Discrepancy::NO_MATCHING_ORDER:
+        return "No matching order";
+    default:
+        return "Unknown";
+    }
+}
+
+void ReconciliationReport::print(std::ostream &out) const
+{
+    out << "[SETTLEMENT] Reconciliation: " << ordersChecked << " orders checked, " << matched << " matched (R"
+        << formatCents(matchedCents) << "), " << ordersWithoutAuthorization << " without a card or EFT payment, "
+        << discrepancies.size() << " discrepancies" << std::endl;
+    for (const Discrepancy &d : discrepancies)
+    {
+        out << "  " << getKindName(d.kind) << ": order " << (d.orderId.empty() ? "(none)" : d.orderId)
+            << ", payment " << (d.reference.empty() ? "(none)" : d.reference) << ", order total R"
+            << formatCents(d.orderCents) << ", settled R" << formatCents(d.settledCents) << std::endl;
+    }
+}
+
+SettlementEngine::SettlementEngine() : scheduleRunning(false)
+{
+}
+
+SettlementEngine::~SettlementEngine()
+{
+    stopSchedule();
+}
+
+SettlementEngine &SettlementEngine::getInstance()
+{
+    static SettlementEngine instance;
+    return instance;
+}
+
+bool SettlementEngine::isPaidStatus(const std::string &status)
+{
+    return status == "Paid" || status.compare(0, 9, "Completed") == 0;
+}
+
+void SettlementEngine::recordAuthorization(const std::string &reference, const std::string &method,
+                                           const std::string &orderId, const std::string &customerId, double amount)
+{
+    Authorization authorization;
+    authorization.reference = reference;
+    authorization.method = method;
+    authorization.orderId = orderId;
+    authorization.customerId = customerId;
+    authorization.amountCents = static_cast<std::int64_t>(std::llround(amount * 100.0));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (byReference.count(reference))
+    {
+        return; // already recorded
+    }
+    authorization.authorizedAt = currentTimestamp();
+    byReference[reference] = authorizations.size();
+    if (!orderId.empty())
+    {
+        byOrder[orderId].push_back(authorizations.size());
+    }
+    authorizations.push_back(authorization);
+}
+
+// Authorizations a settle() is writing stay SETTLING; the flag makes it drop them from the batch
+bool SettlementEngine::voidLocked(Authorization &authorization)
+{
+    if (authorization.state == Authorization::AUTHORIZED)
+    {
+        authorization.state = Authorization::VOIDED;
+        return true;
+    }
+    if (authorization.state == Authorization::SETTLING && !authorization.voidRequested)
+    {
+        authorization.voidRequested = true;
+        return true;
+    }
+    return false;
+}
+
+bool SettlementEngine::voidAuthorization(const std::string &reference)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unordered_map<std::string, std::size_t>::const_iterator it = byReference.find(reference);
+        if (it == byReference.end() || !voidLocked(authorizations[it->second]))
+        {
+            return false;
+        }
+    }
+    PaymentLedger::getInstance().recordVoid(reference);
+    return true;
+}
+
+std::size_t SettlementEngine::voidOrder(const std::string &orderId)
+{
+    std::vector<std::string> voided;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unordered_map<std::string, std::vector<std::size_t> >::const_iterator it = byOrder.find(orderId);
+        if (it == byOrder.end())
+        {
+            return 0;
+        }
+        for (std::size_t index : it->second)
+        {
+            if (voidLocked(authorizations[index]))
+            {
+                voided.push_back(authorizations[index].reference);
+            }
+        }
+    }
+    for (const std::string &reference : voided)
+    {
+        PaymentLedger::getInstance().recordVoid(reference);
+    }
+    return voided.size();
+}
+
+bool SettlementEngine::settle(const std::string &directory, SettlementBatch *batchOut)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Claim the outstanding authorizations, then write without holding the lock
+    std::vector<std::size_t> claimed;
+    std::vector<Authorization> records;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (std::size_t i = 0; i < authorizations.size(); ++i)
+        {
+            if (authorizations[i].state == Authorization::AUTHORIZED)
+            {
+                authorizations[i].state = Authorization::SETTLING;
+                claimed.push_back(i);
+                records.push_back(authorizations[i]);
+            }
+        }
+    }
+
+    SettlementBatch batch;
+    if (records.empty())
+    {
+        if (batchOut)
+        {
+            *batchOut = batch;
+        }
+        return true;
+    }
+    batch.batchId = IdGenerator::getInstance().nextId("STL-");
+    batch.path = (directory.empty() ? std::string() : directory + "/") + "settlement-" + batch.batchId + ".csv";
+    bool written = writeBatch(batch.path, batch.batchId, records, batch);
+
+    // Voids that came in during the write take their authorizations out; the file is rewritten without them
+    // until a pass finishes with none, and only then does the batch count as settled
+    bool rewrite = true;
+    while (rewrite)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::vector<std::size_t> kept;
+            std::vector<Authorization> keptRecords;
+            for (std::size_t index : claimed)
+            {
+                Authorization &authorization = authorizations[index];
+                if (authorization.voidRequested)
+                {
+                    authorization.voidRequested = false;
+                    authorization.state = Authorization::VOIDED;
+                }
+                else
+                {
+                    kept.push_back(index);
+                    keptRecords.push_back(authorization);
+                }
+            }
+            claimed.swap(kept);
+            records.swap(keptRecords);
+            rewrite = written && !records.empty() && records.size() != keptRecords.size();
+            if (!rewrite)
+            {
+                written = written && !records.empty();
+                for (std::size_t index : claimed)
+                {
+                    authorizations[index].state = written ? Authorization::SETTLED : Authorization::AUTHORIZED;
+                    if (written)
+                    {
+                        authorizations[index].batchId = batch.batchId;
+                    }
+                }
+                if (written)
+                {
+                    batches.push_back(batch);
+                }
+            }
+        }
+        if (rewrite)
+        {
+            SettlementBatch rewritten;
+            rewritten.batchId = batch.batchId;
+            rewritten.path = batch.path;
+            batch = rewritten;
+            written = writeBatch(batch.path, batch.batchId, records, batch);
+        }
+    }
+    batch.millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (written)
+    {
+        for (std::map<std::string, std::int64_t>::const_iterator it = batch.centsByMethod.begin();
+             it != batch.centsByMethod.end(); ++it)
+        {
+            PaymentLedger::getInstance().recordSettlement(batch.batchId, it->first, it->second);
+        }
+        std::cout << "[SETTLEMENT] Settled " << batch.count << " authorizations (R" << formatCents(batch.totalCents)
+                  << ") into " << batch.path << " in " << batch.millis << " ms." << std::endl;
+    }
+    else if (records.empty())
+    {
+        std::remove(batch.path.c_str()); // every authorization in it was voided
+        std::cout << "[SETTLEMENT] Every authorization in " << batch.batchId << " was voided; nothing settled."
+                  << std::endl;
+        if (batchOut)
+        {
+            *batchOut = SettlementBatch();
+        }
+        return true;
+    }
+    else
+    {
+        std::cout << "[SETTLEMENT] Failed writing " << batch.path << "; " << records.size()
+                  << " authorizations remain outstanding." << std::endl;
+    }
+    if (batchOut)
+    {
+        *batchOut = batch;
+    }
+    return written;
+}
+
+bool SettlementEngine::writeBatch(const std::string &path, const std::string &batchId,
+                                  const std::vector<Authorization> &records, SettlementBatch &batch) const
+{
+    std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        return false;
+    }
+
+    std::string chunk;
+    chunk.reserve(CHUNK_BYTES + 512);
+    chunk += "H";
+    appendField(chunk, batchId);
+    appendField(chunk, currentTimestamp());
+    appendField(chunk, std::to_string(records.size()));
+    chunk += '\n';
+
+    for (const Authorization &record : records)
+    {
+        chunk += "D";
+        appendField(chunk, record.reference);
+        appendField(chunk, record.method);
+        appendField(chunk, record.orderId);
+        appendField(chunk, record.customerId);
+        appendField(chunk, formatCents(record.amountCents));
+        appendField(chunk, record.authorizedAt);
+        chunk += '\n';
+        batch.totalCents += record.amountCents;
+        batch.centsByMethod[record.method] += record.amountCents;
+        if (chunk.size() >= CHUNK_BYTES)
+        {
+            out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            chunk.clear();
+        }
+    }
+    batch.count = records.size();
+
+    chunk += "T";
+    appendField(chunk, std::to_string(records.size()));
+    appendField(chunk, formatCents(batch.totalCents));
+    chunk += '\n';
+    out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    out.close();
+    if (!out)
+    {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return replaceFile(tempPath, path);
+}
+
+void SettlementEngine::startSchedule(const std::string &directory, std::chrono::milliseconds interval)
+{
+    stopSchedule();
+    {
+        std::lock_guard<std::mutex> lock(scheduleMutex);
+        scheduleRunning = true;
+    }
+    scheduler = std::thread([this, directory, interval]() {
+        std::unique_lock<std::mutex> lock(scheduleMutex);
+        while (!scheduleWake.wait_for(lock, interval, [this]() { return !scheduleRunning; }))
+        {
+            lock.unlock();
+            settle(directory);
+            lock.lock();
+        }
+    });
+}
+
+void SettlementEngine::stopSchedule()
+{
+    {
+        std::lock_guard<std::mutex> lock(scheduleMutex);
+        scheduleRunning = false;
+    }
+    scheduleWake.notify_all();
+    if (scheduler.joinable())
+    {
+        scheduler.join();
+    }
+}
+
+ReconciliationReport SettlementEngine::reconcile(const std::vector<StoredOrder> &orders,
+                                                 const std::string &batchId) const
+{
+    ReconciliationReport report;
+    std::unordered_set<std::string> orderIds;
+    orderIds.reserve(orders.size());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const StoredOrder &order : orders)
+    {
+        orderIds.insert(order.orderId);
+        std::int64_t orderCents = static_cast<std::int64_t>(std::llround(order.totalAmount * 100.0));
+        std::int64_t settledCents = 0;
+        std::size_t settledCount = 0;
+        std::string settledReference, pendingReference;
+
+        std::unordered_map<std::string, std::vector<std::size_t> >::const_iterator found = byOrder.find(order.orderId);
+        if (found != byOrder.end())
+        {
+            for (std::size_t index : found->second)
+            {
+                const Authorization &authorization = authorizations[index];
+                if (authorization.state == Authorization::SETTLED &&
+                    (batchId.empty() || authorization.batchId == batchId))
+                {
+                    settledCents += authorization.amountCents;
+                    settledReference = authorization.reference;
+                    ++settledCount;
+                }
+                else if (batchId.empty() && (authorization.state == Authorization::AUTHORIZED ||
+                                             authorization.state == Authorization::SETTLING))
+                {
+                    pendingReference = authorization.reference;
+                }
+            }
+        }
+        if (settledCount == 0 && pendingReference.empty() && !batchId.empty())
+        {
+            continue; // not part of this batch
+        }
+        ++report.ordersChecked;
+
+        ReconciliationReport::Discrepancy discrepancy;
+        discrepancy.orderId = order.orderId;
+        discrepancy.orderCents = orderCents;
+        discrepancy.settledCents = settledCents;
+        discrepancy.reference = settledReference;
+        if (!isPaidStatus(order.status))
+        {
+            if (settledCount > 0)
+            {
+                discrepancy.kind = ReconciliationReport::Discrepancy::CHARGED_UNPAID;
+                report.discrepancies.push_back(discrepancy);
+            }
+        }
+        else if (settledCount > 0)
+        {
+            if (settledCents == orderCents)
+            {
+                ++report.matched;
+                report.matchedCents += settledCents;
+            }
+            else
+            {
+                discrepancy.kind = ReconciliationReport::Discrepancy::AMOUNT_MISMATCH;
+                report.discrepancies.push_back(discrepancy);
+            }
+        }
+        else if (!pendingReference.empty())
+        {
+            discrepancy.kind = ReconciliationReport::Discrepancy::NOT_SETTLED;
+            discrepancy.reference = pendingReference;
+            report.discrepancies.push_back(discrepancy);
+        }
+        else
+        {
+            ++report.ordersWithoutAuthorization;
+        }
+    }
+
+    // Settled money nobody can account for
+    for (const Authorization &authorization : authorizations)
+    {
+        if (authorization.state != Authorization::SETTLED || (!batchId.empty() && authorization.batchId != batchId) ||
+            (!authorization.orderId.empty() && orderIds.count(authorization.orderId)))
+        {
+            continue;
+        }
+        ReconciliationReport::Discrepancy discrepancy;
+        discrepancy.kind = ReconciliationReport::Discrepancy::NO_MATCHING_ORDER;
+        discrepancy.orderId = authorization.orderId;
+        discrepancy.reference = authorization.reference;
+        discrepancy.orderCents = 0;
+        discrepancy.settledCents = authorization.amountCents;
+        report.discrepancies.push_back(discrepancy);
+    }
+    return report;
+}
+
+bool SettlementEngine::findAuthorization(const std::string &reference, Authorization &out) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<std::string, std::size_t>::const_iterator it = byReference.find(reference);
+    if (it == byReference.end())
+    {
+        return false;
+    }
+    out = authorizations[it->second];
+    return true;
+}
+
+std::size_t SettlementEngine::getOutstandingCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t outstanding = 0;
+    for (const Authorization &authorization : authorizations)
+    {
+        if (authorization.state == Authorization::AUTHORIZED || authorization.state == Authorization::SETTLING)
+        {
+            ++outstanding;
+        }
+    }
+    return outstanding;
+}
+
+std::vector<SettlementBatch> SettlementEngine::getBatches() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return batches;
+}
+
+void SettlementEngine::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    authorizations.clear();
+    byReference.clear();
+    byOrder.clear();
+    batches.clear();
+}
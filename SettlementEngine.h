@@ -0,0 +1,187 @@
+#ifndef SETTLEMENT_ENGINE_H
+#define SETTLEMENT_ENGINE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct StoredOrder;
+
+/**
+ * @brief A card or EFT payment that has been authorized but not necessarily settled
+ */
+struct Authorization
+{
+    enum State
+    {
+        AUTHORIZED,
+        SETTLING, // being written to a settlement file
+        SETTLED,
+        VOIDED
+    };
+
+    std::string reference; // authorization code from the adaptee
+    std::string method;    // "CREDIT_CARD" or "EFT"
+    std::string orderId;   // empty if the payer did not say
+    std::string customerId;
+    std::int64_t amountCents;
+    std::string authorizedAt;
+    std::string batchId; // settlement batch, once settled
+    State state;
+    bool voidRequested; // voided while SETTLING; settle() takes it back out of the batch
+
+    Authorization() : amountCents(0), state(AUTHORIZED), voidRequested(false) {}
+};
+
+/**
+ * @brief One settlement file written by SettlementEngine::settle()
+ */
+struct SettlementBatch
+{
+    std::string batchId;
+    std::string path;
+    std::size_t count;
+    std::int64_t totalCents;
+    std::map<std::string, std::int64_t> centsByMethod;
+    double millis;
+
+    SettlementBatch() : count(0), totalCents(0), millis(0.0) {}
+};
+
+/**
+ * @brief Result of checking settled payments against recorded orders
+ */
+struct ReconciliationReport
+{
+    struct Discrepancy
+    {
+        enum Kind
+        {
+            AMOUNT_MISMATCH,    // paid order whose settled total differs from the order total
+            NOT_SETTLED,        // paid order whose authorization is still waiting to settle
+            CHARGED_UNPAID,     // settled payment for an order that did not complete
+            NO_MATCHING_ORDER   // settled payment for an order not in the report (or none given)
+        };
+
+        Kind kind;
+        std::string orderId;
+        std::string reference;
+        std::int64_t orderCents;
+        std::int64_t settledCents;
+    };
+
+    std::size_t ordersChecked;
+    std::size_t matched;
+    std::size_t ordersWithoutAuthorization; // paid some other way, e.g. cash
+    std::int64_t matchedCents;
+    std::vector<Discrepancy> discrepancies;
+
+    ReconciliationReport() : ordersChecked(0), matched(0), ordersWithoutAuthorization(0), matchedCents(0) {}
+
+    bool isClean() const { return discrepancies.empty(); }
+    void print(std::ostream &out) const;
+
+    static const char *getKindName(Discrepancy::Kind kind);
+};
+
+/**
+ * @class SettlementEngine
+ * @brief Holds card and EFT authorizations and settles them in end-of-day batches
+ *
+ * CreditCardAdapter and EFTAdapter only authorize payments and record the
+ * authorization here. settle() moves every outstanding authorization into a
+ * settlement file in one pass, streaming records to disk in fixed-size
+ * chunks so a batch of tens of thousands costs a few large writes. The file
+ * is written beside its final name and renamed into place, so a crash never
+ * leaves a half-written batch behind, and authorizations only count as
+ * settled once their file is complete. startSchedule() runs settle() on a
+ * background thread at a fixed interval (e.g. daily). An authorization voided
+ * while its batch is being written is left out: settle() rewrites the file
+ * without it before the batch counts as settled.
+ *
+ * Settlement file (CSV, one record per line):
+ * @code
+ * H,<batch id>,<created>,<record count>
+ * D,<reference>,<method>,<order id>,<customer>,<amount>,<authorized at>
+ * T,<record count>,<total amount>
+ * @endcode
+ *
+ * reconcile() compares settled payments with order summaries from the
+ * OrderStore, matching them by order ID.
+ *
+ * Singleton like InventoryManager and OrderStore; thread-safe.
+ */
+class SettlementEngine
+{
+public:
+    SettlementEngine(const SettlementEngine &) = delete;
+    SettlementEngine &operator=(const SettlementEngine &) = delete;
+
+    static SettlementEngine &getInstance();
+
+    void recordAuthorization(const std::string &reference, const std::string &method, const std::string &orderId,
+                             const std::string &customerId, double amount);
+
+    /** @brief Cancels an authorization that has not been settled yet, including one a settle() is writing */
+    bool voidAuthorization(const std::string &reference);
+
+    /** @brief Voids every unsettled authorization for an order, e.g. when it fails after payment */
+    std::size_t voidOrder(const std::string &orderId);
+
+    /**
+     * @brief Writes every outstanding authorization to a new settlement file in `directory`
+     * @param batch If given, receives the batch details (count 0 if there was nothing to settle)
+     * @return false if the file could not be written; the authorizations stay outstanding
+     */
+    bool settle(const std::string &directory, SettlementBatch *batch = nullptr);
+
+    /** @brief Settles into `directory` every `interval`, on a background thread, until stopSchedule() */
+    void startSchedule(const std::string &directory, std::chrono::milliseconds interval);
+    void stopSchedule();
+
+    /**
+     * @brief Checks settled payments against the given orders
+     * @param batchId Only consider payments settled in this batch; all settled payments if empty
+     */
+    ReconciliationReport reconcile(const std::vector<StoredOrder> &orders, const std::string &batchId = "") const;
+
+    bool findAuthorization(const std::string &reference, Authorization &out) const;
+    std::size_t getOutstandingCount() const;
+    std::vector<SettlementBatch> getBatches() const;
+
+    /** @brief Forgets all authorizations and batches (the files are left alone) */
+    void clear();
+
+    /** @brief Whether an order status means the customer was charged and the order went through */
+    static bool isPaidStatus(const std::string &status);
+
+private:
+    std::vector<Authorization> authorizations;
+    std::unordered_map<std::string, std::size_t> byReference;
+    std::unordered_map<std::string, std::vector<std::size_t> > byOrder;
+    std::vector<SettlementBatch> batches;
+    mutable std::mutex mutex;
+
+    std::thread scheduler;
+    std::mutex scheduleMutex;
+    std::condition_variable scheduleWake;
+    bool scheduleRunning;
+
+    SettlementEngine();
+
+    bool voidLocked(Authorization &authorization);
+    ~SettlementEngine();
+
+    bool writeBatch(const std::string &path, const std::string &batchId, const std::vector<Authorization> &records,
+                    SettlementBatch &batch) const;
+};
+
+#endif // SETTLEMENT_ENGINE_H
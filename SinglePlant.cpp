@@ -1,14 +1,15 @@
 #include "SinglePlant.h"
+#include "OrderItemVisitor.h"
 #include <sstream>
 #include <iomanip>
 
 SinglePlant::SinglePlant(const std::string& plantType, double price, int quantity, const std::string& size)
-    : OrderItem(plantType, price, quantity), plantType(plantType), size(size), hasPot(false), potType("") {}
+    : OrderItem(plantType, price, quantity), plantType(plantType), size(size), hasPot(false), potType(""), potPrice(0.0) {}
 
 SinglePlant::~SinglePlant() {}
 
 double SinglePlant::getPrice() const {
-    return price * quantity;
+    return (price + potPrice) * quantity;
 }
 
 std::string SinglePlant::getDescription() const {
@@ -21,18 +22,28 @@ std::string SinglePlant::getDescription() const {
     return oss.str();
 }
 
+void SinglePlant::accept(OrderItemVisitor& visitor) const {
+    visitor.visitSinglePlant(*this);
+}
+
+// Adding a pot to a plant that already has one replaces it
 void SinglePlant::addPot(const std::string& potType, double potPrice) {
+    double oldSubtotal = getPrice();
     this->potType = potType;
-    this->price += potPrice;
+    this->potPrice = potPrice;
     this->hasPot = true;
+    notifySubtotalChanged(oldSubtotal);
+    notifyContentsChanged();
 }
 
 void SinglePlant::removePot() {
     if (hasPot) {
-        // Note: We don't decrease price here as we don't know the pot price
-        // In a real system, we'd track the pot price separately
+        double oldSubtotal = getPrice();
         this->potType = "";
+        this->potPrice = 0.0;
         this->hasPot = false;
+        notifySubtotalChanged(oldSubtotal);
+        notifyContentsChanged();
     }
 }
 
@@ -51,3 +62,11 @@ std::string SinglePlant::getSize() const {
 std::string SinglePlant::getPotType() const {
     return potType;
 }
+
+double SinglePlant::getPotPrice() const {
+    return potPrice;
+}
+
+double SinglePlant::getUnitPrice() const {
+    return price;
+}
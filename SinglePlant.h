@@ -13,6 +13,7 @@ private:
     std::string size;
     bool hasPot;
     std::string potType;
+    double potPrice; // per-unit pot price, kept apart from the plant's own price
 
 public:
     SinglePlant(const std::string& plantType, double price, int quantity, 
@@ -22,6 +23,7 @@ public:
     // Override OrderItem methods
     double getPrice() const override;
     std::string getDescription() const override;
+    void accept(OrderItemVisitor& visitor) const override;
     
     // SinglePlant specific methods
     void addPot(const std::string& potType, double potPrice);
@@ -30,6 +32,8 @@ public:
     std::string getPlantType() const;
     std::string getSize() const;
     std::string getPotType() const;
+    double getPotPrice() const;
+    double getUnitPrice() const; // plant price per unit, excluding the pot
 };
 
 #endif
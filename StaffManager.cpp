@@ -4,7 +4,7 @@
 #include "Order.h"
 #include "Command.h"
 #include "PlantProduct.h"
-#include <iostream>
+#include "Logger.h"
 
 /**
  * @file StaffManager.cpp
@@ -19,6 +19,20 @@
  * the staff chain via StaffMember.
  */
 
+namespace {
+    // What staff do about each type of customer interaction
+    const char* describeInteraction(const std::string& interactionType) {
+        if (interactionType == "PlantSelection") {
+            return "Staff noting customer plant selection";
+        } else if (interactionType == "BundleCreation") {
+            return "Staff assisting with bundle creation";
+        } else if (interactionType == "AssistanceNeeded") {
+            return "Dispatching staff to assist customer";
+        }
+        return "Staff monitoring customer activity";
+    }
+}
+
 StaffManager::StaffManager(StaffMember* dispatcher) 
     : staffDispatcher(dispatcher) {}
 
@@ -33,13 +47,12 @@ StaffManager::~StaffManager() {
 
 void StaffManager::update(PlantProduct* plant, const std::string& commandType) {
     if (!plant) {
-        std::cout << "[STAFF MANAGER] Error: Received null plant reference." << std::endl;
+        GH_LOG_ERROR(Logger::STAFF, "Staff manager received a null plant reference.");
         return;
     }
     
-    std::cout << "[STAFF MANAGER] Plant lifecycle event detected" << std::endl;
-    std::cout << "   Plant State: " << plant->getCurrentStateName() << std::endl;
-    std::cout << "   Command Type: " << commandType << std::endl;
+    GH_LOG_DEBUG(Logger::STAFF, "Plant lifecycle event detected (state: "
+                                    << plant->getCurrentStateName() << ", command: " << commandType << ")");
     
     // Create command using the Prototype pattern (Command factory)
     Command* command = Command::createCommand(commandType);
@@ -48,14 +61,11 @@ void StaffManager::update(PlantProduct* plant, const std::string& commandType) {
         // Set the plant as the receiver of the command
         command->setReceiver(plant);
         
-        std::cout << "[STAFF MANAGER] Command created successfully. Dispatching to staff chain..." << std::endl;
-        
         // Dispatch the command through the staff chain
         dispatchCommand(command);
     } else {
-        std::cout << "[STAFF MANAGER] Error: Failed to create command of type '" 
-                  << commandType << "'." << std::endl;
-        std::cout << "[STAFF MANAGER] Plant may be transitioning to withering state..." << std::endl;
+        GH_LOG_ERROR(Logger::STAFF, "Failed to create command of type '"
+                                        << commandType << "'. Plant may be transitioning to withering state.");
         
         // If command creation fails, transition plant to withering
         plant->transitionToWithering();
@@ -64,22 +74,21 @@ void StaffManager::update(PlantProduct* plant, const std::string& commandType) {
 
 void StaffManager::dispatchCommand(Command* command) {
     if (!staffDispatcher) {
-        std::cout << "[STAFF MANAGER] Error: No staff dispatcher available!" << std::endl;
+        GH_LOG_ERROR(Logger::STAFF, "No staff dispatcher available!");
         if (command) {
-            std::cout << "[STAFF MANAGER] Command '" << command->getType() << "' dropped." << std::endl;
+            GH_LOG_ERROR(Logger::STAFF, "Command '" << command->getType() << "' dropped.");
             delete command;
         }
         return;
     }
     
     if (!command) {
-        std::cout << "[STAFF MANAGER] Error: Cannot dispatch null command." << std::endl;
+        GH_LOG_ERROR(Logger::STAFF, "Cannot dispatch null command.");
         return;
     }
     
-    std::cout << "[STAFF MANAGER] Dispatching command '" << command->getType() 
-              << "' to staff chain..." << std::endl;
-    std::cout << "   Required Role: " << command->getRequiredRole() << std::endl;
+    GH_LOG_DEBUG(Logger::STAFF, "Dispatching command '" << command->getType() << "' to staff chain (required role: "
+                                                        << command->getRequiredRole() << ")");
     
     // StaffMember will route the command to the appropriate team based on required role
     // The command will then travel through the chain of responsibility until handled
@@ -88,45 +97,29 @@ void StaffManager::dispatchCommand(Command* command) {
 
 // CustomerObserver implementation - for customer interaction events
 void StaffManager::updateCustomerInteraction(Customer* customer, const std::string& interactionType, const std::string& details) {
-    std::cout << "\n[STAFF MANAGER] Received customer interaction notification" << std::endl;
-    std::cout << "   Customer: " << customer->getName() << std::endl;
-    std::cout << "   Interaction: " << interactionType << std::endl;
-    
-    if (!details.empty()) {
-        std::cout << "   Details: " << details << std::endl;
-    }
-    
-    // Handle different types of customer interactions
-    if (interactionType == "PlantSelection") {
-        std::cout << "   [ACTION] Staff noting customer plant selection" << std::endl;
-    } else if (interactionType == "BundleCreation") {
-        std::cout << "   [ACTION] Staff assisting with bundle creation" << std::endl;
-    } else if (interactionType == "AssistanceNeeded") {
-        std::cout << "   [ACTION] Dispatching staff to assist customer" << std::endl;
-    } else {
-        std::cout << "   [ACTION] Staff monitoring customer activity" << std::endl;
-    }
+    GH_LOG_INFO(Logger::STAFF, "Customer " << customer->getName() << ": " << interactionType
+                                           << (details.empty() ? "" : " (") << details
+                                           << (details.empty() ? "" : ")") << " - "
+                                           << describeInteraction(interactionType));
 }
 
 bool StaffManager::validateCustomerOrder(Order* order, Customer* customer) {
-    std::cout << "\n[STAFF MANAGER] Validating customer order" << std::endl;
-    std::cout << "   Customer: " << customer->getName() << " (" << customer->getEmail() << ")" << std::endl;
-    std::cout << "   Order ID: " << order->getOrderId() << std::endl;
-    std::cout << "   Total Items: " << order->getItemCount() << std::endl;
-    std::cout << "   Total Amount: $" << order->getTotalAmount() << std::endl;
+    GH_LOG_INFO(Logger::STAFF, "Validating order " << order->getOrderId() << " for " << customer->getName() << " ("
+                                                   << customer->getEmail() << "): " << order->getItemCount()
+                                                   << " items, $" << order->getTotalAmount());
     
     // Basic validation checks
     if (order->isEmpty()) {
-        std::cout << "   [VALIDATION FAILED] Order is empty" << std::endl;
+        GH_LOG_WARN(Logger::STAFF, "Validation failed: order is empty");
         return false;
     }
     
     if (order->getTotalAmount() <= 0) {
-        std::cout << "   [VALIDATION FAILED] Invalid order total" << std::endl;
+        GH_LOG_WARN(Logger::STAFF, "Validation failed: invalid order total");
         return false;
     }
     
-    std::cout << "   [VALIDATION PASSED] Order approved by staff" << std::endl;
+    GH_LOG_INFO(Logger::STAFF, "Validation passed: order approved by staff");
     return true;
 }
 
@@ -1,7 +1,7 @@
 #include "StaffMember.h"
 #include "Command.h"
 #include "PlantProduct.h"
-#include <iostream>
+#include "Logger.h"
 
 /**
  * @file StaffMember.cpp
@@ -24,60 +24,54 @@
 
 void StaffMember::queueUnhandledCommand(Command* command) {
     if (command) {
-        std::cout << "[STAFF MEMBER] Queueing unhandled command '" << command->getType() 
-                  << "' for later processing." << std::endl;
+        GH_LOG_INFO(Logger::STAFF, "Queueing unhandled command '" << command->getType() << "' for later processing.");
         unhandledCommands.push(command);
     } else {
-        std::cout << "[STAFF MEMBER] Warning: Attempted to queue null command." << std::endl;
+        GH_LOG_WARN(Logger::STAFF, "Attempted to queue null command.");
     }
 }
 
 void StaffMember::processUnhandledQueue() {
     if (unhandledCommands.empty()) {
-        std::cout << "[STAFF MEMBER] No unhandled commands in queue." << std::endl;
+        GH_LOG_DEBUG(Logger::STAFF, "No unhandled commands in queue.");
         return;
     }
     
-    std::cout << "[STAFF MEMBER] Processing unhandled command queue (" 
-              << unhandledCommands.size() << " commands)..." << std::endl;
+    GH_LOG_INFO(Logger::STAFF, "Processing unhandled command queue (" << unhandledCommands.size() << " commands)");
     
     Command* command = unhandledCommands.front();
     unhandledCommands.pop();
     
-    std::cout << "[STAFF MEMBER] Re-dispatching command '" << command->getType() 
-              << "' from the unhandled queue." << std::endl;
+    GH_LOG_DEBUG(Logger::STAFF, "Re-dispatching command '" << command->getType() << "' from the unhandled queue.");
     
     dispatch(command);
 }
 
 void StaffMember::dispatch(Command* command) {
     if (!command) {
-        std::cout << "[STAFF MEMBER] Error: Received a null command." << std::endl;
+        GH_LOG_ERROR(Logger::STAFF, "Staff member received a null command.");
         return;
     }
 
     std::string role = command->getRequiredRole();
-    std::cout << "[STAFF MEMBER] Routing command '" << command->getType() 
-              << "' to '" << role << "' team..." << std::endl;
+    GH_LOG_DEBUG(Logger::STAFF, "Routing command '" << command->getType() << "' to '" << role << "' team");
     
     // Look up the team responsible for this role
     std::map<std::string, StaffChainHandler*>::iterator it = teams.find(role);
 
     if (it != teams.end()) {
         // Team found - pass command to the head of the chain
-        std::cout << "[STAFF MEMBER] Team found. Passing to chain of responsibility..." << std::endl;
         it->second->handleCommand(command);
     } else {
         // No team registered for this role - system error
-        std::cout << "[STAFF MEMBER] CRITICAL ERROR: No team registered for role '" 
-                  << role << "'." << std::endl;
-        std::cout << "[STAFF MEMBER] Command '" << command->getType() << "' cannot be processed." << std::endl;
+        GH_LOG_ERROR(Logger::STAFF, "No team registered for role '" << role << "'. Command '" << command->getType()
+                                                                    << "' cannot be processed.");
         
         // If the command has a plant receiver, transition it to withering
         // (represents neglected plant care due to lack of staff)
         PlantProduct* plant = command->getReceiver();
         if (plant) {
-            std::cout << "[STAFF MEMBER] Plant will transition to withering due to lack of care." << std::endl;
+            GH_LOG_WARN(Logger::STAFF, "Plant will transition to withering due to lack of care.");
             plant->transitionToWithering();
         }
         
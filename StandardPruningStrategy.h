@@ -2,7 +2,7 @@
 #define STANDARDPRUNINGSTRATEGY_H
 
 #include "CareStrategy.h"
-#include <iostream>
+#include "Logger.h"
 
 /**
  * @class StandardPruningStrategy
@@ -18,11 +18,11 @@ public:
     {
         if (careType == "prune_standard")
         {
-            std::cout << "Performing standard pruning focusing on " << amount << " dead leaves and branches." << std::endl;
+            GH_LOG_DEBUG(Logger::CARE, "Performing standard pruning focusing on " << amount << " dead leaves and branches.");
         }
         else
         {
-            std::cout << "StandardPruningStrategy does not handle care type: " << careType << std::endl;
+            GH_LOG_WARN(Logger::CARE, "StandardPruningStrategy does not handle care type: " << careType);
         }
     }
     std::string getName() const override { return "Standard Pruning"; }
@@ -9,6 +9,7 @@
 #include "SinglePlant.h"
 #include "PlantBundle.h"
 #include "OrderUIFacade.h"
+#include "CartDemandTracker.h"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -229,6 +230,19 @@ void TerminalUI::displayCurrentOrder(Order* order) {
     std::cout << BOLD << "Total Items: " << RESET << items.size() << std::endl;
     std::cout << BOLD << GREEN << "Order Total: $" << std::fixed << std::setprecision(2) 
               << subtotal << RESET << "\n" << std::endl;
+    displayCartStock(order);
+}
+
+void TerminalUI::displayCartStock(Order* order) {
+    if (!order || order->isEmpty()) {
+        return;
+    }
+    std::vector<InventoryManager::StockShortage> shortages = order->trackDemand()->getShortages();
+    for (const auto& shortage : shortages) {
+        printWarning("Only " + std::to_string(shortage.available > 0 ? shortage.available : 0) + " " +
+                     shortage.itemType + (shortage.isPot ? " pots" : "") + " available - your cart has " +
+                     std::to_string(shortage.requested));
+    }
 }
 
 void TerminalUI::displayOrderSummary(Order* order) {
@@ -294,10 +308,10 @@ void TerminalUI::displayInventoryStatus() {
     InventoryManager& inventory = InventoryManager::getInstance();
     
     std::cout << "\n" << BOLD << "Sales Floor:" << RESET << std::endl;
-    std::cout << "  Plants available: " << GREEN << inventory.getReadyForSalePlants().size() << RESET << std::endl;
+    std::cout << "  Plants available: " << GREEN << inventory.getPlantCount(InventoryManager::ON_SALES_FLOOR) << RESET << std::endl;
     
     std::cout << "\n" << BOLD << "Greenhouse:" << RESET << std::endl;
-    std::cout << "  Plants growing: " << YELLOW << inventory.getGreenHouseInventory().size() << RESET << std::endl;
+    std::cout << "  Plants growing: " << YELLOW << inventory.getPlantCount(InventoryManager::IN_GREENHOUSE) << RESET << std::endl;
     
     std::cout << "\n" << BOLD << "Total Stock:" << RESET << std::endl;
     std::cout << "  Total plants: " << CYAN << inventory.getStockCount() << RESET << std::endl;
@@ -335,12 +349,13 @@ bool TerminalUI::addPlantToOrder(Order* order, int plantIndex, int quantity) {
     
     // Create SinglePlant order item
     // Note: In a real system, price would come from the plant profile or database
-    SinglePlant* plantItem = new SinglePlant(plantType, 25.99, quantity, "Medium");
+    SinglePlant* plantItem = new (order->getItemArena()) SinglePlant(plantType, 25.99, quantity, "Medium");
     
     // Add to order
     order->addOrderItem(plantItem);
     
     printSuccess("Added " + std::to_string(quantity) + "x " + plantType + " to order");
+    displayCartStock(order);
     return true;
 }
 
@@ -367,7 +382,7 @@ bool TerminalUI::addBundleToOrder(Order* order, const std::string& bundleName,
     std::vector<PlantProduct*> plants = inventory.getReadyForSalePlants();
     
     // Create bundle
-    PlantBundle* bundle = new PlantBundle(bundleName, "Custom", 1, discount);
+    PlantBundle* bundle = new (order->getItemArena()) PlantBundle(bundleName, "Custom", 1, discount);
     
     // Add plants to bundle
     for (size_t i = 0; i < plantIndices.size(); ++i) {
@@ -390,7 +405,7 @@ bool TerminalUI::addBundleToOrder(Order* order, const std::string& bundleName,
         // Get plant information and add to bundle
         PlantProduct* selectedPlant = plants[plantIndex];
         std::string plantType = selectedPlant->getProfile()->getSpeciesName();
-        SinglePlant* bundlePlant = new SinglePlant(plantType, 25.99, quantity, "Medium");
+        SinglePlant* bundlePlant = new (order->getItemArena()) SinglePlant(plantType, 25.99, quantity, "Medium");
         bundle->addItem(bundlePlant);
     }
     
@@ -404,6 +419,7 @@ bool TerminalUI::addBundleToOrder(Order* order, const std::string& bundleName,
         oss << " (" << discount << "% discount)";
     }
     printSuccess(oss.str());
+    displayCartStock(order);
     
     return true;
 }
@@ -8,6 +8,7 @@
 #include <iomanip>
 #include <chrono>
 #include <thread>
+#include "Timestamp.h"
 
 // Forward declarations
 class Customer;
@@ -171,7 +172,7 @@ public:
     static void printWithTimestamp(const std::string& msg, const std::string& color = RESET) {
         auto now = std::chrono::system_clock::now();
         auto time = std::chrono::system_clock::to_time_t(now);
-        std::cout << GRAY << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " 
+        std::cout << GRAY << "[" << formatLocalTime(time, "%H:%M:%S") << "] " 
                   << RESET << color << msg << RESET << std::endl;
     }
 
@@ -197,6 +198,14 @@ public:
      */
     static void displayCurrentOrder(Order* order);
     
+    /**
+     * @brief Warn about any cart line the sales floor cannot cover
+     * Starts tracking the cart's demand (see CartDemandTracker) if it is not
+     * tracked yet; later calls only look up stock for lines that changed
+     * @param order The cart to check
+     */
+    static void displayCartStock(Order* order);
+    
     /**
      * @brief Display detailed order summary before submission
      * @param order The order to summarize
@@ -0,0 +1,21 @@
+#include "Timestamp.h"
+
+const char *const TIMESTAMP_FORMAT = "%Y-%m-%d %H:%M:%S";
+
+std::string formatLocalTime(std::time_t time, const char *format)
+{
+    std::tm local = std::tm();
+#ifdef _WIN32
+    localtime_s(&local, &time);
+#else
+    localtime_r(&time, &local);
+#endif
+    char buffer[64];
+    std::size_t length = std::strftime(buffer, sizeof(buffer), format, &local);
+    return std::string(buffer, length);
+}
+
+std::string currentTimestamp()
+{
+    return formatLocalTime(std::time(nullptr));
+}
@@ -0,0 +1,26 @@
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include <ctime>
+#include <string>
+
+/**
+ * @file Timestamp.h
+ * @brief Local-time formatting that is safe to call from any thread
+ *
+ * std::localtime() returns a pointer into one buffer shared by the whole
+ * process, so two threads formatting a time at once can read each other's
+ * fields. These helpers convert with localtime_r (localtime_s on Windows)
+ * into a caller-owned std::tm instead, with no lock.
+ */
+
+/** @brief Orders, ledgers and reports all stamp times in this format */
+extern const char *const TIMESTAMP_FORMAT;
+
+/** @brief Formats a time in the local time zone with a strftime format */
+std::string formatLocalTime(std::time_t time, const char *format = TIMESTAMP_FORMAT);
+
+/** @brief The current local time as "YYYY-MM-DD HH:MM:SS" */
+std::string currentTimestamp();
+
+#endif // TIMESTAMP_H
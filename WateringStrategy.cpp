@@ -1,14 +1,14 @@
 #include "WateringStrategy.h"
-#include <iostream>
+#include "Logger.h"
 
 void WateringStrategy::applyCare(int amount, const std::string &careType)
 {
     if (careType == "water" || careType == "watering")
     {
-        std::cout << "Watering plant with " << amount << " ml of water." << std::endl;
+        GH_LOG_DEBUG(Logger::CARE, "Watering plant with " << amount << " ml of water.");
     }
     else
     {
-        std::cout << "WateringStrategy does not handle care type: " << careType << std::endl;
+        GH_LOG_WARN(Logger::CARE, "WateringStrategy does not handle care type: " << careType);
     }
 }
\ No newline at end of file
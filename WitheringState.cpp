@@ -1,24 +1,24 @@
 #include "WitheringState.h"
+#include "Logger.h"
 #include "PlantProduct.h"
-#include <iostream>
 
 void WitheringState::onEnter(PlantProduct* plant) {
     if (plant && plant->getProfile()) {
-        std::cout << "Plant " << plant->getProfile()->getSpeciesName() 
-                  << " is now withering due to neglect." << std::endl;
+        GH_LOG_WARN(Logger::PLANT_STATE,
+                    "Plant " << plant->getProfile()->getSpeciesName() << " is now withering due to neglect.");
     } else {
-        std::cout << "A plant has entered the withering state due to neglect." << std::endl;
+        GH_LOG_WARN(Logger::PLANT_STATE, "A plant has entered the withering state due to neglect.");
     }
 }
 
 void WitheringState::onExit(PlantProduct* plant) {
     // Typically no action needed when exiting a terminal state
-    std::cout << "Plant is exiting the withering state." << std::endl;
+    GH_LOG_DEBUG(Logger::PLANT_STATE, "Plant is exiting the withering state.");
 }
 
 void WitheringState::advanceState(PlantProduct* plant) {
     // WitheringState might not advance further
-    std::cout << "Plant remains in withering state." << std::endl;
+    GH_LOG_TRACE(Logger::PLANT_STATE, "Plant remains in withering state.");
 }
 
 std::string WitheringState::getName() const {
@@ -49,6 +49,7 @@
 #include <cfloat>
 #include <chrono>
 #include <climits>
+#include <ctime>
 #include <iomanip>
 #include <iostream>
 #include <limits>
@@ -76,6 +77,7 @@
 #include "SucculentProfile.h"
 #include "TreeProfile.h"
 #include "InventoryManager.h"
+#include "Logger.h"
 
 // Customer Order Infrastructure
 #include "Customer.h"
@@ -88,6 +90,12 @@
 #include "PaymentProcessHandler.h"
 #include "NotificationHandler.h"
 #include "OrderMemento.h"
+#include "HandlerMetrics.h"
+#include "NotificationOutbox.h"
+#include "OrderStore.h"
+#include "PaymentLedger.h"
+#include "SettlementEngine.h"
+#include "Timestamp.h"
 #include "SuggestionTemplate/BouquetSuggestionFactory.h"
 
 // UI Infrastructure
@@ -288,20 +296,40 @@ std::vector<PlantProduct*> createPlants(const std::vector<PlantSpeciesProfile*>&
  * @param history Map tracking previous state of each plant
  */
 void displayStateTransitions(const std::vector<PlantProduct*>& plants,
-                             std::map<std::string, std::string>& history) {
+                             std::map<std::string, std::string>& history,
+                             InventoryChangeStream::Cursor& cursor) {
     TerminalUI::printSection("STATE TRANSITIONS");
     bool transitionLogged = false;
-    for (size_t i = 0; i < plants.size(); ++i) {
-        const PlantProduct* plant = plants[i];
-        const std::string& currentState = plant->getCurrentStateName();
-        std::string plantId = plant->getId();
-        if (history[plantId] != currentState) {
-            if (!history[plantId].empty()) {
-                TerminalUI::printSuccess(plantId + " " + plant->getProfile()->getSpeciesName() + " [" +
-                                         history[plantId] + " -> " + currentState + "]");
+    std::vector<InventoryChangeEvent> events;
+    if (InventoryManager::getInstance().getChangeStream().poll(cursor, events)) {
+        // Only plants that actually changed since the last frame are touched
+        for (size_t i = 0; i < events.size(); ++i) {
+            const InventoryChangeEvent& event = events[i];
+            if (event.type != InventoryChangeEvent::PLANT_STATE_CHANGED) {
+                continue;
+            }
+            std::string& previousState = history[event.plant->getId()];
+            if (!previousState.empty() && previousState != event.state) {
+                TerminalUI::printSuccess(event.plant->getId() + " " + event.species + " [" +
+                                         previousState + " -> " + event.state + "]");
+                transitionLogged = true;
+            }
+            previousState = event.state;
+        }
+    } else {
+        // Fell behind the change stream - compare every plant once to resync
+        for (size_t i = 0; i < plants.size(); ++i) {
+            const PlantProduct* plant = plants[i];
+            const std::string& currentState = plant->getCurrentStateName();
+            std::string plantId = plant->getId();
+            if (history[plantId] != currentState) {
+                if (!history[plantId].empty()) {
+                    TerminalUI::printSuccess(plantId + " " + plant->getProfile()->getSpeciesName() + " [" +
+                                             history[plantId] + " -> " + currentState + "]");
+                }
+                history[plantId] = currentState;
+                transitionLogged = true;
             }
-            history[plantId] = currentState;
-            transitionLogged = true;
         }
     }
     if (!transitionLogged) {
@@ -436,7 +464,7 @@ void runGreenhouseSimulation(StaffContext& staff) {
     
     TerminalUI::printSuccess("All plants added to greenhouse inventory");
     TerminalUI::printInfo("Greenhouse inventory count: " + 
-                         std::to_string(InventoryManager::getInstance().getGreenHouseInventory().size()));
+                         std::to_string(InventoryManager::getInstance().getPlantCount(InventoryManager::IN_GREENHOUSE)));
 
     // ============================================================================
     // Phase 1.2: Simulate plant lifecycle
@@ -445,10 +473,11 @@ void runGreenhouseSimulation(StaffContext& staff) {
     std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
     std::map<std::string, std::string> stateHistory;
     
-    // Initialize state history
+    // Initialize state history; later changes arrive through the inventory change stream
     for (size_t i = 0; i < plants.size(); ++i) {
         stateHistory[plants[i]->getId()] = plants[i]->getCurrentStateName();
     }
+    InventoryChangeStream::Cursor inventoryCursor = InventoryManager::getInstance().getChangeStream().subscribe();
 
     int loopCounter = 0;
     int allReadyCounter = 0;  // Track how long all plants have been ready
@@ -480,7 +509,7 @@ void runGreenhouseSimulation(StaffContext& staff) {
         TerminalUI::printInfo("Elapsed: " + std::to_string(elapsed) + "s (limit " +
                               std::to_string(maxSimulationSeconds) + "s)");
 
-        displayStateTransitions(plants, stateHistory);
+        displayStateTransitions(plants, stateHistory, inventoryCursor);
         renderPlantVisualizer(plants);
         displayStaffStatus(staff.roster);
 
@@ -516,7 +545,7 @@ void runGreenhouseSimulation(StaffContext& staff) {
                 
                 if (!cashierActive && allReadyCounter > 2) {
                     // Show progress update
-                    int salesFloorCount = InventoryManager::getInstance().getReadyForSalePlants().size();
+                    int salesFloorCount = InventoryManager::getInstance().getPlantCount(InventoryManager::ON_SALES_FLOOR);
                     std::cout << ANSI_YELLOW << "[UPDATE] Sales floor inventory: " 
                              << salesFloorCount << " plants available" << ANSI_RESET << std::endl;
                 }
@@ -545,7 +574,7 @@ void runGreenhouseSimulation(StaffContext& staff) {
                   << " -> " << plant->getCurrentStateName() << std::endl;
     }
     
-    int readyForSale = InventoryManager::getInstance().getReadyForSalePlants().size();
+    int readyForSale = InventoryManager::getInstance().getPlantCount(InventoryManager::ON_SALES_FLOOR);
     TerminalUI::printSuccess("Greenhouse simulation complete!");
     TerminalUI::printInfo("Plants ready for sale: " + std::to_string(readyForSale));
     std::cout << std::endl;
@@ -990,6 +1019,7 @@ void runCustomerOrderTest(StaffContext& staff) {
                 currentOrder->addOrderItem(plant);
                 
                 std::cout << "\n    " << ANSI_GREEN << "✓ Added " << quantity << "x " << plantType << " to cart!\n" << ANSI_RESET;
+                TerminalUI::displayCartStock(currentOrder);
                 std::this_thread::sleep_for(std::chrono::milliseconds(800));
                 break;
             }
@@ -1129,6 +1159,7 @@ void runCustomerOrderTest(StaffContext& staff) {
                 currentOrder->addOrderItem(bundle);
                 std::cout << "\n    " << ANSI_GREEN << ANSI_BOLD << "✓ Bundle '" << bundleName 
                          << "' created successfully!\n" << ANSI_RESET;
+                TerminalUI::displayCartStock(currentOrder);
                 std::this_thread::sleep_for(std::chrono::milliseconds(1200));
                 break;
             }
@@ -1320,25 +1351,25 @@ void runCustomerOrderTest(StaffContext& staff) {
                 showLoadingBar("Processing payment", 1200);
                 
                 double totalAmount = currentOrder->getTotalAmount();
-                bool paymentSuccess = customer->processPayment(paymentType, totalAmount, paymentDetails);
+                bool paymentSuccess = customer->processPayment(paymentType, totalAmount, paymentDetails,
+                                                               currentOrder->getOrderId(),
+                                                               currentOrder->getFlattened().getPlantUnits());
                 
-                if (paymentSuccess) {
-                    // Update inventory - remove sold plants
-                    InventoryManager& inventory = InventoryManager::getInstance();
-                    
-                    for (OrderItem* item : currentOrder->getOrderItems()) {
-                        if (SinglePlant* plant = dynamic_cast<SinglePlant*>(item)) {
-                            inventory.sellPlants(plant->getPlantType(), plant->getQuantity());
-                        } else if (PlantBundle* bundle = dynamic_cast<PlantBundle*>(item)) {
-                            for (OrderItem* bundleItem : bundle->getItems()) {
-                                if (SinglePlant* bplant = dynamic_cast<SinglePlant*>(bundleItem)) {
-                                    inventory.sellPlants(bplant->getPlantType(), bplant->getQuantity());
-                                }
-                            }
-                        }
-                    }
+                // Update inventory - sell the stock validation reserved for this order (all or nothing)
+                InventoryManager& inventory = InventoryManager::getInstance();
+                bool stockCommitted = paymentSuccess && inventory.commitReservation(currentOrder->getReservationId());
+                if (paymentSuccess && !stockCommitted) {
+                    // Held stock went missing after payment: void card and EFT authorizations before they settle,
+                    // then reverse whatever is left (cash) in the ledger
+                    SettlementEngine::getInstance().voidOrder(currentOrder->getOrderId());
+                    PaymentLedger::getInstance().recordOrderVoid(currentOrder->getOrderId());
+                }
+                
+                if (stockCommitted) {
+                    currentOrder->setReservationId(0);
                     
                     currentOrder->setStatus("Completed - Paid");
+                    OrderStore::getInstance().append(*currentOrder);
                     
                     std::cout << "\n" << ANSI_GREEN << ANSI_BOLD;
                     std::cout << "    ╔══════════════════════════════════════════════════════════════════╗\n";
@@ -1357,13 +1388,27 @@ void runCustomerOrderTest(StaffContext& staff) {
                     orderBuilder->reset();
                     
                 } else {
+                    // Let other customers have the held stock; a retry validates (and reserves) again
+                    inventory.releaseReservation(currentOrder->getReservationId());
+                    currentOrder->setReservationId(0);
+                    
                     std::cout << "\n" << ANSI_RED << ANSI_BOLD;
                     std::cout << "    ╔══════════════════════════════════════════════════════════════════╗\n";
-                    std::cout << "    ║                  ✗ PAYMENT FAILED                                ║\n";
+                    if (paymentSuccess) {
+                        std::cout << "    ║                  ✗ STOCK UNAVAILABLE                             ║\n";
+                    } else {
+                        std::cout << "    ║                  ✗ PAYMENT FAILED                                ║\n";
+                    }
                     std::cout << "    ╚══════════════════════════════════════════════════════════════════╝\n";
                     std::cout << ANSI_RESET << "\n";
-                    std::cout << "    Payment could not be processed.\n";
-                    std::cout << "    Please check your payment details and try again.\n";
+                    if (paymentSuccess) {
+                        currentOrder->setStatus("Payment Voided - Stock Unavailable");
+                        std::cout << "    Some of the reserved stock is no longer available.\n";
+                        std::cout << "    Your payment has been voided; please review your order and try again.\n";
+                    } else {
+                        std::cout << "    Payment could not be processed.\n";
+                        std::cout << "    Please check your payment details and try again.\n";
+                    }
                 }
                 
                 std::cout << "\n    " << ANSI_CYAN << "Press Enter to continue..." << ANSI_RESET;
@@ -1419,8 +1464,14 @@ void runCustomerOrderTest(StaffContext& staff) {
  * 
  * @param ctx Staff context
  * @param profiles Plant species profiles to delete
+ * @param sessionStarted Local time the session began, in Order's date format
+ * @param firstLedgerEntry First payment ledger entry written this session
+ * @param soldAtStart Sold plants restored from the inventory snapshot at startup
  */
-void cleanup(StaffContext& ctx, std::vector<PlantSpeciesProfile*>& profiles) {
+void cleanup(StaffContext& ctx, std::vector<PlantSpeciesProfile*>& profiles,
+             const std::string& sessionStarted, std::uint64_t firstLedgerEntry, int soldAtStart) {
+    // Let the simulation's queued log lines out before the end-of-day reports
+    Logger::getInstance().flush();
     TerminalUI::printSection("SYSTEM CLEANUP");
     
     // Clean up profiles (plants are owned by InventoryManager)
@@ -1444,10 +1495,38 @@ void cleanup(StaffContext& ctx, std::vector<PlantSpeciesProfile*>& profiles) {
     Command::cleanupPrototypes();
     TerminalUI::printInfo("Command prototypes cleaned up");
     
-    // Clean up inventory (this deletes all plants)
+    // Give queued customer messages a moment to go out; anything left is delivered next run
+    NotificationOutbox::getInstance().waitUntilIdle(std::chrono::seconds(2));
+    NotificationOutbox::getInstance().close();
+    
+    // End of day: settle this session's card and EFT authorizations and check them against the order log
+    SettlementBatch settlement;
+    if (SettlementEngine::getInstance().settle(".", &settlement) && settlement.count > 0) {
+        std::vector<StoredOrder> orders = OrderStore::getInstance().getOrdersBetween("", "9999");
+        SettlementEngine::getInstance().reconcile(orders, settlement.batchId).print(std::cout);
+    }
+    
+    // Every payment outcome this session against its orders and the plants that left the floor
+    // (sold plants restored from the snapshot belong to earlier sessions, so they are left out)
+    PaymentLedger& ledger = PaymentLedger::getInstance();
+    if (ledger.isOpen()) {
+        ledger.reconcile(OrderStore::getInstance().getOrdersBetween(sessionStarted, "9999"),
+                         InventoryManager::getInstance().getPlantCount(InventoryManager::SOLD) - soldAtStart,
+                         firstLedgerEntry).print(std::cout);
+        ledger.close();
+    }
+    
+    // Keep each session's checkout latencies so runs can be compared
+    if (!HandlerMetrics::getInstance().getStages().empty()) {
+        HandlerMetrics::getInstance().print(std::cout);
+        HandlerMetrics::getInstance().exportTo("handler_latency.csv", true);
+    }
+    
+    // Clean up inventory (this saves the snapshot for the next start, then deletes all plants)
     InventoryManager::getInstance().cleanup();
     TerminalUI::printInfo("Inventory manager cleaned up");
     
+    Logger::getInstance().shutdown();
     TerminalUI::printSuccess("System cleanup complete");
 }
 
@@ -1506,6 +1585,24 @@ int main() {
 
     // Create staff context (dispatcher, manager, chains)
     StaffContext staff = createStaffContext();
+
+    // Completed orders are kept across runs in an append-only log
+    OrderStore::getInstance().open("greenhouse_orders.log");
+    // Customer messages not delivered before the last shutdown go out again
+    NotificationOutbox::getInstance().open("greenhouse_outbox.log");
+    // Every payment, decline, void and settlement is posted to a double-entry ledger
+    PaymentLedger::getInstance().open("greenhouse_ledger.dat");
+    const std::uint64_t firstLedgerEntry = PaymentLedger::getInstance().getNextSequence();
+    // Pick up the nursery where the last session left it; cleanup() writes it back at shutdown
+    InventoryManager& inventory = InventoryManager::getInstance();
+    if (inventory.loadSnapshot("greenhouse_inventory.snap")) {
+        TerminalUI::printInfo("Restored " + std::to_string(inventory.getPlantCount(InventoryManager::IN_GREENHOUSE)) +
+                              " greenhouse and " + std::to_string(inventory.getPlantCount(InventoryManager::ON_SALES_FLOOR)) +
+                              " sales floor plants from the last session");
+    }
+    inventory.setAutoSnapshotPath("greenhouse_inventory.snap");
+    const int soldAtStart = inventory.getPlantCount(InventoryManager::SOLD);
+    const std::string sessionStarted = currentTimestamp();
     
     // Store profiles for cleanup
     std::vector<PlantSpeciesProfile*> profiles;
@@ -1539,7 +1636,7 @@ int main() {
     // ============================================================================
     std::cout << std::endl;
     profiles = createProfiles();  // Get profiles for cleanup
-    cleanup(staff, profiles);
+    cleanup(staff, profiles, sessionStarted, firstLedgerEntry, soldAtStart);
     
     std::cout << std::endl;
     TerminalUI::printSuccess("Program execution complete. Goodbye!");